@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Ast/astBase.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Fig::Ast
+{
+    /*
+        Arena
+        bump allocator owning every node of one parsed unit (a module, a repl line)
+
+        nodes are handed out as raw pointers and die with the arena, never one by one, so walking the tree
+        does no refcount traffic and siblings sit next to each other in memory.
+        whoever keeps the arena has to keep it for as long as any Function / StructType built from its nodes
+        can run: the ModuleRegistry holds module arenas, main and the Repl hold their own
+    */
+    class Arena
+    {
+    private:
+        static constexpr size_t BlockSize = 64 * 1024;
+
+        std::vector<std::unique_ptr<std::byte[]>> blocks;
+        std::byte *cur = nullptr;
+        std::byte *end = nullptr;
+
+        std::vector<_AstBase *> nodes; // construction order, destroyed in reverse
+
+        void *allocate(size_t size, size_t align)
+        {
+            std::byte *p = alignUp(cur, align);
+            if (cur == nullptr || p + size > end)
+            {
+                size_t blockSize = std::max(BlockSize, size + align);
+                blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+                cur = blocks.back().get();
+                end = cur + blockSize;
+                p = alignUp(cur, align);
+            }
+            cur = p + size;
+            return p;
+        }
+
+        static std::byte *alignUp(std::byte *p, size_t align)
+        {
+            auto addr = reinterpret_cast<std::uintptr_t>(p);
+            return reinterpret_cast<std::byte *>((addr + align - 1) & ~(align - 1));
+        }
+
+    public:
+        Arena() = default;
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        Arena(Arena &&other) noexcept :
+            blocks(std::move(other.blocks)),
+            cur(std::exchange(other.cur, nullptr)),
+            end(std::exchange(other.end, nullptr)),
+            nodes(std::move(other.nodes))
+        {
+            other.blocks.clear();
+            other.nodes.clear();
+        }
+        Arena &operator=(Arena &&) = delete;
+
+        ~Arena()
+        {
+            for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) { (*it)->~_AstBase(); }
+        }
+
+        template <class _Tp, class... Args>
+        _Tp *make(Args &&...args)
+        {
+            static_assert(std::is_base_of_v<_AstBase, _Tp>, "_Tp must derive from _AstBase");
+            _Tp *node = new (allocate(sizeof(_Tp), alignof(_Tp))) _Tp(std::forward<Args>(args)...);
+            nodes.push_back(node);
+            return node;
+        }
+
+        size_t nodeCount() const { return nodes.size(); }
+
+        // nodes the interpreter builds itself (builtin method bodies), live for the whole process
+        static Arena &builtins()
+        {
+            static Arena *arena = new Arena(); // never destroyed, builtin Functions outlive static teardown
+            return *arena;
+        }
+    };
+}; // namespace Fig::Ast
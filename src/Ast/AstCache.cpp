@@ -0,0 +1,947 @@
+#include <Ast/AstCache.hpp>
+
+#include <Core/core.hpp>
+#include <Error/error.hpp>
+#include <Lexer/lexer.hpp>
+#include <Parser/parser.hpp>
+#include <Utils/utils.hpp>
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+
+namespace Fig::AstCache
+{
+    namespace
+    {
+        constexpr char MAGIC[4] = {'F', 'I', 'G', 'C'};
+        constexpr uint32_t FORMAT_VERSION = 1;
+
+        constexpr uint8_t NULL_NODE = 0xFF;
+
+        enum class LiteralKind : uint8_t
+        {
+            Null,
+            Int,
+            Double,
+            String,
+            Bool,
+        };
+
+        struct Header
+        {
+            uint64_t sourceSize = 0;
+            int64_t sourceMtime = 0;
+            uint64_t sourceHash = 0;
+        };
+
+        // the tree format is only stable within one build
+        std::string buildStamp()
+        {
+            return std::string(Core::VERSION) + " " + std::string(Core::COMPILE_TIME);
+        }
+
+        uint64_t fnv1a(std::string_view data)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : data)
+            {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        bool statSource(const std::filesystem::path &path, uint64_t &size, int64_t &mtime)
+        {
+            std::error_code ec;
+            size = std::filesystem::file_size(path, ec);
+            if (ec) return false;
+            auto time = std::filesystem::last_write_time(path, ec);
+            if (ec) return false;
+            mtime = static_cast<int64_t>(time.time_since_epoch().count());
+            return true;
+        }
+
+        bool readFile(const std::filesystem::path &path, std::string &out)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) return false;
+
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(path, ec);
+            if (ec) return false;
+
+            out.resize(size);
+            file.read(out.data(), static_cast<std::streamsize>(size));
+            out.resize(static_cast<size_t>(file.gcount()));
+            return true;
+        }
+
+        /* ===== writing ===== */
+
+        struct UnsupportedNode
+        {
+        };
+
+        class Writer
+        {
+            std::unordered_map<FString, uint32_t> stringIndex;
+            std::vector<const FString *> strings;
+
+            std::vector<std::pair<uint32_t, uint32_t>> positions;
+            std::string nodes;
+
+            static void put(std::string &out, const void *data, size_t n)
+            {
+                out.append(static_cast<const char *>(data), n);
+            }
+
+            template <class T>
+            static void putInt(std::string &out, T v)
+            {
+                static_assert(std::endian::native == std::endian::little, "figc is little endian");
+                put(out, &v, sizeof(T));
+            }
+
+            void u8(uint8_t v) { putInt(nodes, v); }
+            void u32(uint32_t v) { putInt(nodes, v); }
+            void i64(int64_t v) { putInt(nodes, v); }
+            void boolean(bool v) { u8(v ? 1 : 0); }
+
+        public:
+            uint32_t intern(const FString &s)
+            {
+                auto it = stringIndex.find(s);
+                if (it != stringIndex.end()) return it->second;
+
+                uint32_t index = static_cast<uint32_t>(strings.size());
+                auto [pos, _] = stringIndex.emplace(s, index);
+                strings.push_back(&pos->first);
+                return index;
+            }
+
+            void str(const FString &s) { u32(intern(s)); }
+
+            void node(const Ast::AstBase &ast);
+
+            void expr(const Ast::Expression &e) { node(e); }
+            void stmt(const Ast::Statement &s) { node(s); }
+
+            template <class T>
+            void list(const std::vector<T> &v, auto &&each)
+            {
+                u32(static_cast<uint32_t>(v.size()));
+                for (const T &x : v) { each(x); }
+            }
+
+            void paras(const Ast::FunctionParameters &p)
+            {
+                list(p.posParas, [&](const auto &pp) {
+                    str(pp.first);
+                    expr(pp.second);
+                });
+                list(p.defParas, [&](const auto &dp) {
+                    str(dp.first);
+                    expr(dp.second.first);
+                    expr(dp.second.second);
+                });
+                str(p.variadicPara);
+                boolean(p.variadic);
+            }
+
+            void literal(const ObjectPtr &val)
+            {
+                if (val->is<ValueType::IntClass>())
+                {
+                    u8(static_cast<uint8_t>(LiteralKind::Int));
+                    i64(val->as<ValueType::IntClass>());
+                }
+                else if (val->is<ValueType::DoubleClass>())
+                {
+                    u8(static_cast<uint8_t>(LiteralKind::Double));
+                    i64(std::bit_cast<int64_t>(val->as<ValueType::DoubleClass>()));
+                }
+                else if (val->is<ValueType::StringClass>())
+                {
+                    u8(static_cast<uint8_t>(LiteralKind::String));
+                    str(ValueType::toFString(val->as<ValueType::StringClass>()));
+                }
+                else if (val->is<ValueType::BoolClass>())
+                {
+                    u8(static_cast<uint8_t>(LiteralKind::Bool));
+                    boolean(val->as<ValueType::BoolClass>());
+                }
+                else if (val->is<ValueType::NullClass>())
+                {
+                    u8(static_cast<uint8_t>(LiteralKind::Null));
+                }
+                else
+                {
+                    throw UnsupportedNode{};
+                }
+            }
+
+            std::string finish(const Header &header, const std::vector<uint32_t> &lines, uint32_t topCount)
+            {
+                std::string body;
+                body.reserve(nodes.size() + positions.size() * 8 + 64);
+
+                putInt(body, static_cast<uint32_t>(strings.size()));
+                for (const FString *s : strings)
+                {
+                    putInt(body, static_cast<uint32_t>(s->size()));
+                    put(body, s->data(), s->size());
+                }
+
+                putInt(body, static_cast<uint32_t>(lines.size()));
+                for (uint32_t line : lines) { putInt(body, line); }
+
+                putInt(body, static_cast<uint32_t>(positions.size()));
+                for (auto [line, column] : positions)
+                {
+                    putInt(body, line);
+                    putInt(body, column);
+                }
+
+                putInt(body, topCount);
+                body.append(nodes);
+
+                std::string out;
+                out.reserve(body.size() + 64);
+
+                put(out, MAGIC, sizeof(MAGIC));
+                putInt(out, FORMAT_VERSION);
+
+                std::string stamp = buildStamp();
+                putInt(out, static_cast<uint32_t>(stamp.size()));
+                put(out, stamp.data(), stamp.size());
+
+                putInt(out, header.sourceSize);
+                putInt(out, header.sourceMtime);
+                putInt(out, header.sourceHash);
+                putInt(out, fnv1a(body));
+
+                out.append(body);
+                return out;
+            }
+        };
+
+        void Writer::node(const Ast::AstBase &ast)
+        {
+            using namespace Ast;
+
+            if (ast == nullptr)
+            {
+                u8(NULL_NODE);
+                return;
+            }
+
+            AstType type = ast->getType();
+            const AstAddressInfo &aai = ast->getAAI();
+
+            u8(static_cast<uint8_t>(type));
+            positions.emplace_back(static_cast<uint32_t>(aai.line), static_cast<uint32_t>(aai.column));
+
+            switch (type)
+            {
+                case AstType::StatementBase: break; // EofStmt
+
+                case AstType::ValueExpr: literal(static_cast<ValueExprAst *>(ast)->val); break;
+
+                case AstType::VarExpr: str(static_cast<VarExprAst *>(ast)->name); break;
+
+                case AstType::UnaryExpr: {
+                    auto n = static_cast<UnaryExprAst *>(ast);
+                    u8(static_cast<uint8_t>(n->op));
+                    expr(n->exp);
+                    break;
+                }
+                case AstType::BinaryExpr: {
+                    auto n = static_cast<BinaryExprAst *>(ast);
+                    u8(static_cast<uint8_t>(n->op));
+                    expr(n->lexp);
+                    expr(n->rexp);
+                    break;
+                }
+                case AstType::TernaryExpr: {
+                    auto n = static_cast<TernaryExprAst *>(ast);
+                    expr(n->condition);
+                    expr(n->valueT);
+                    expr(n->valueF);
+                    break;
+                }
+                case AstType::MemberExpr: {
+                    auto n = static_cast<MemberExprAst *>(ast);
+                    expr(n->base);
+                    str(n->member);
+                    break;
+                }
+                case AstType::IndexExpr: {
+                    auto n = static_cast<IndexExprAst *>(ast);
+                    expr(n->base);
+                    expr(n->index);
+                    break;
+                }
+                case AstType::FunctionCall: {
+                    auto n = static_cast<FunctionCallExpr *>(ast);
+                    expr(n->callee);
+                    list(n->arg.argv, [&](const Expression &e) { expr(e); });
+                    break;
+                }
+                case AstType::ListExpr:
+                    list(static_cast<ListExprAst *>(ast)->val, [&](const Expression &e) { expr(e); });
+                    break;
+                case AstType::TupleExpr:
+                    list(static_cast<TupleExprAst *>(ast)->val, [&](const Expression &e) { expr(e); });
+                    break;
+                case AstType::MapExpr: {
+                    auto n = static_cast<MapExprAst *>(ast);
+                    u32(static_cast<uint32_t>(n->val.size()));
+                    for (const auto &[k, v] : n->val)
+                    {
+                        expr(k);
+                        expr(v);
+                    }
+                    break;
+                }
+                case AstType::InitExpr: {
+                    auto n = static_cast<InitExprAst *>(ast);
+                    expr(n->structe);
+                    list(n->args, [&](const auto &arg) {
+                        str(arg.first);
+                        expr(arg.second);
+                    });
+                    u8(static_cast<uint8_t>(n->initMode));
+                    break;
+                }
+                case AstType::FunctionLiteralExpr: {
+                    auto n = static_cast<FunctionLiteralExprAst *>(ast);
+                    paras(n->paras);
+                    boolean(n->isExprMode());
+                    if (n->isExprMode())
+                        expr(n->getExprBody());
+                    else
+                        stmt(n->getBlockBody());
+                    break;
+                }
+
+                case AstType::BlockStatement:
+                    list(static_cast<BlockStatementAst *>(ast)->stmts, [&](const Statement &s) { stmt(s); });
+                    break;
+                case AstType::ExpressionStmt: expr(static_cast<ExpressionStmtAst *>(ast)->exp); break;
+                case AstType::VarDefSt: {
+                    auto n = static_cast<VarDefAst *>(ast);
+                    boolean(n->isPublic);
+                    boolean(n->isConst);
+                    str(n->name);
+                    expr(n->declaredType);
+                    expr(n->expr);
+                    boolean(n->followupType);
+                    break;
+                }
+                case AstType::FunctionDefSt: {
+                    auto n = static_cast<FunctionDefSt *>(ast);
+                    str(n->name);
+                    paras(n->paras);
+                    boolean(n->isPublic);
+                    expr(n->retType);
+                    stmt(n->body);
+                    break;
+                }
+                case AstType::StructSt: {
+                    auto n = static_cast<StructDefSt *>(ast);
+                    boolean(n->isPublic);
+                    str(n->name);
+                    list(n->fields, [&](const StructDefField &f) {
+                        u8(static_cast<uint8_t>(f.am));
+                        str(f.fieldName);
+                        expr(f.declaredType);
+                        expr(f.defaultValueExpr);
+                    });
+                    stmt(n->body);
+                    break;
+                }
+                case AstType::InterfaceDefSt: {
+                    auto n = static_cast<InterfaceDefAst *>(ast);
+                    str(n->name);
+                    list(n->bundles, [&](const Expression &e) { expr(e); });
+                    list(n->methods, [&](const InterfaceMethod &m) {
+                        str(m.name);
+                        paras(m.paras);
+                        expr(m.returnType);
+                        stmt(m.defaultBody);
+                    });
+                    boolean(n->isPublic);
+                    break;
+                }
+                case AstType::ImplementSt: {
+                    auto n = static_cast<ImplementAst *>(ast);
+                    str(n->interfaceName);
+                    str(n->structName);
+                    list(n->methods, [&](const ImplementMethod &m) {
+                        str(m.name);
+                        paras(m.paras);
+                        stmt(m.body);
+                    });
+                    break;
+                }
+                case AstType::IfSt: {
+                    auto n = static_cast<IfSt *>(ast);
+                    expr(n->condition);
+                    stmt(n->body);
+                    list(n->elifs, [&](const ElseIf &e) { stmt(e); });
+                    stmt(n->els);
+                    break;
+                }
+                case AstType::ElseIfSt: {
+                    auto n = static_cast<ElseIfSt *>(ast);
+                    expr(n->condition);
+                    stmt(n->body);
+                    break;
+                }
+                case AstType::ElseSt: stmt(static_cast<ElseSt *>(ast)->body); break;
+                case AstType::WhileSt: {
+                    auto n = static_cast<WhileSt *>(ast);
+                    expr(n->condition);
+                    stmt(n->body);
+                    break;
+                }
+                case AstType::ForSt: {
+                    auto n = static_cast<ForSt *>(ast);
+                    stmt(n->initSt);
+                    expr(n->condition);
+                    stmt(n->incrementSt);
+                    stmt(n->body);
+                    break;
+                }
+                case AstType::ReturnSt: expr(static_cast<ReturnSt *>(ast)->retValue); break;
+                case AstType::BreakSt:
+                case AstType::ContinueSt: break;
+                case AstType::ImportSt: {
+                    auto n = static_cast<ImportSt *>(ast);
+                    list(n->path, [&](const FString &s) { str(s); });
+                    list(n->names, [&](const FString &s) { str(s); });
+                    str(n->rename);
+                    break;
+                }
+                case AstType::TrySt: {
+                    auto n = static_cast<TrySt *>(ast);
+                    stmt(n->body);
+                    list(n->catches, [&](const Catch &c) {
+                        str(c.errVarName);
+                        boolean(c.hasType);
+                        str(c.errVarType);
+                        stmt(c.body);
+                    });
+                    stmt(n->finallyBlock);
+                    break;
+                }
+                case AstType::ThrowSt: expr(static_cast<ThrowSt *>(ast)->value); break;
+
+                default: throw UnsupportedNode{};
+            }
+        }
+
+        /* ===== reading ===== */
+
+        struct Corrupt
+        {
+        };
+
+        class Reader
+        {
+            const char *cur;
+            const char *end;
+
+            std::vector<FString> strings;
+            std::vector<std::pair<uint32_t, uint32_t>> positions;
+            size_t nextPosition = 0;
+
+            std::shared_ptr<FString> sourcePathPtr;
+            std::shared_ptr<std::vector<FString>> sourceLinesPtr;
+
+            Ast::Arena *arena = nullptr; // the unit's, set by body()
+
+            void take(void *out, size_t n)
+            {
+                if (static_cast<size_t>(end - cur) < n) throw Corrupt{};
+                std::memcpy(out, cur, n);
+                cur += n;
+            }
+
+            template <class T>
+            T get()
+            {
+                T v;
+                take(&v, sizeof(T));
+                return v;
+            }
+
+            uint8_t u8() { return get<uint8_t>(); }
+            uint32_t u32() { return get<uint32_t>(); }
+            int64_t i64() { return get<int64_t>(); }
+            bool boolean() { return u8() != 0; }
+
+            // counts are bounded by the bytes left, a bad count can not trigger a huge allocation
+            uint32_t count()
+            {
+                uint32_t n = u32();
+                if (n > static_cast<size_t>(end - cur)) throw Corrupt{};
+                return n;
+            }
+
+            const FString &str()
+            {
+                uint32_t index = u32();
+                if (index >= strings.size()) throw Corrupt{};
+                return strings[index];
+            }
+
+            template <class T>
+            T *as(Ast::AstBase ast, Ast::AstType type)
+            {
+                if (ast != nullptr && ast->getType() != type) throw Corrupt{};
+                return static_cast<T *>(ast);
+            }
+
+            template <class T>
+            T *as(Ast::AstBase ast)
+            {
+                if (ast != nullptr && dynamic_cast<T *>(ast) == nullptr) throw Corrupt{};
+                return static_cast<T *>(ast);
+            }
+
+            Ast::Expression expr() { return as<Ast::ExpressionAst>(node()); }
+            Ast::Statement stmt() { return as<Ast::StatementAst>(node()); }
+            Ast::BlockStatement block() { return as<Ast::BlockStatementAst>(node(), Ast::AstType::BlockStatement); }
+
+            template <class T, class Fn>
+            std::vector<T> list(Fn &&each)
+            {
+                uint32_t n = count();
+                std::vector<T> v;
+                v.reserve(n);
+                for (uint32_t i = 0; i < n; ++i) { v.push_back(each()); }
+                return v;
+            }
+
+            Ast::FunctionParameters paras()
+            {
+                Ast::FunctionParameters p;
+                p.posParas = list<std::pair<FString, Ast::Expression>>([&] {
+                    FString name = str();
+                    return std::make_pair(std::move(name), expr());
+                });
+                p.defParas = list<std::pair<FString, std::pair<Ast::Expression, Ast::Expression>>>([&] {
+                    FString name = str();
+                    Ast::Expression declaredType = expr();
+                    Ast::Expression defaultValue = expr();
+                    return std::make_pair(std::move(name), std::make_pair(std::move(declaredType), std::move(defaultValue)));
+                });
+                p.variadicPara = str();
+                p.variadic = boolean();
+                return p;
+            }
+
+            ObjectPtr literal()
+            {
+                switch (static_cast<LiteralKind>(u8()))
+                {
+                    case LiteralKind::Null: return Object::getNullInstance();
+                    case LiteralKind::Int: return std::make_shared<Object>(static_cast<ValueType::IntClass>(i64()));
+                    case LiteralKind::Double: return std::make_shared<Object>(std::bit_cast<ValueType::DoubleClass>(i64()));
+                    case LiteralKind::String: return std::make_shared<Object>(str());
+                    case LiteralKind::Bool: return std::make_shared<Object>(boolean());
+                }
+                throw Corrupt{};
+            }
+
+            Ast::AstBase node();
+
+        public:
+            Reader(const std::string &buffer) : cur(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+            // header only, so a stale cache is rejected before the body is decoded
+            bool header(Header &header)
+            {
+                char magic[4];
+                take(magic, sizeof(magic));
+                if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || u32() != FORMAT_VERSION) return false;
+
+                std::string stamp(count(), '\0');
+                take(stamp.data(), stamp.size());
+                if (stamp != buildStamp()) return false;
+
+                header.sourceSize = get<uint64_t>();
+                header.sourceMtime = get<int64_t>();
+                header.sourceHash = get<uint64_t>();
+
+                // a damaged body is rejected here instead of decoding into a wrong tree
+                uint64_t bodyHash = get<uint64_t>();
+                return bodyHash == fnv1a(std::string_view(cur, end));
+            }
+
+            Unit body(const FString &sourcePath)
+            {
+                uint32_t stringCount = count();
+                strings.reserve(stringCount);
+                for (uint32_t i = 0; i < stringCount; ++i)
+                {
+                    uint32_t size = count();
+                    strings.emplace_back(std::u8string(reinterpret_cast<const char8_t *>(cur), size));
+                    cur += size;
+                }
+
+                Unit unit;
+                unit.arena = std::make_unique<Ast::Arena>();
+                arena = unit.arena.get();
+                unit.sourceLines = list<FString>([&] { return str(); });
+
+                uint32_t positionCount = count();
+                positions.reserve(positionCount);
+                for (uint32_t i = 0; i < positionCount; ++i)
+                {
+                    uint32_t line = u32();
+                    positions.emplace_back(line, u32());
+                }
+
+                sourcePathPtr = std::make_shared<FString>(sourcePath);
+                sourceLinesPtr = std::make_shared<std::vector<FString>>(unit.sourceLines);
+
+                unit.asts = list<Ast::AstBase>([&] { return node(); });
+                if (cur != end || nextPosition != positions.size()) throw Corrupt{};
+                return unit;
+            }
+        };
+
+        Ast::AstBase Reader::node()
+        {
+            using namespace Ast;
+
+            uint8_t tag = u8();
+            if (tag == NULL_NODE) return nullptr;
+
+            if (nextPosition >= positions.size()) throw Corrupt{};
+            auto [line, column] = positions[nextPosition++];
+
+            AstBase ast = nullptr;
+            switch (static_cast<AstType>(tag))
+            {
+                case AstType::StatementBase: ast = arena->make<EofStmt>(); break;
+
+                case AstType::ValueExpr: ast = arena->make<ValueExprAst>(literal()); break;
+                case AstType::VarExpr: ast = arena->make<VarExprAst>(str()); break;
+                case AstType::UnaryExpr: {
+                    Operator op = static_cast<Operator>(u8());
+                    ast = arena->make<UnaryExprAst>(op, expr());
+                    break;
+                }
+                case AstType::BinaryExpr: {
+                    Operator op = static_cast<Operator>(u8());
+                    Expression lexp = expr();
+                    ast = arena->make<BinaryExprAst>(std::move(lexp), op, expr());
+                    break;
+                }
+                case AstType::TernaryExpr: {
+                    Expression condition = expr();
+                    Expression valueT = expr();
+                    ast = arena->make<TernaryExprAst>(std::move(condition), std::move(valueT), expr());
+                    break;
+                }
+                case AstType::MemberExpr: {
+                    Expression base = expr();
+                    ast = arena->make<MemberExprAst>(std::move(base), str());
+                    break;
+                }
+                case AstType::IndexExpr: {
+                    Expression base = expr();
+                    ast = arena->make<IndexExprAst>(std::move(base), expr());
+                    break;
+                }
+                case AstType::FunctionCall: {
+                    Expression callee = expr();
+                    ast = arena->make<FunctionCallExpr>(
+                        std::move(callee), FunctionArguments{list<Expression>([&] { return expr(); })});
+                    break;
+                }
+                case AstType::ListExpr: ast = arena->make<ListExprAst>(list<Expression>([&] { return expr(); })); break;
+                case AstType::TupleExpr:
+                    ast = arena->make<TupleExprAst>(list<Expression>([&] { return expr(); }));
+                    break;
+                case AstType::MapExpr: {
+                    uint32_t n = count();
+                    std::vector<std::pair<Expression, Expression>> val;
+                    val.reserve(n);
+                    for (uint32_t i = 0; i < n; ++i)
+                    {
+                        Expression k = expr();
+                        val.emplace_back(k, expr());
+                    }
+                    ast = arena->make<MapExprAst>(std::move(val));
+                    break;
+                }
+                case AstType::InitExpr: {
+                    Expression structe = expr();
+                    auto args = list<std::pair<FString, Expression>>([&] {
+                        FString name = str();
+                        return std::make_pair(std::move(name), expr());
+                    });
+                    auto mode = static_cast<InitExprAst::InitMode>(u8());
+                    ast = arena->make<InitExprAst>(std::move(structe), std::move(args), mode);
+                    break;
+                }
+                case AstType::FunctionLiteralExpr: {
+                    FunctionParameters p = paras();
+                    if (boolean())
+                    {
+                        auto fnLiteral = arena->make<FunctionLiteralExprAst>(std::move(p), expr());
+                        fnLiteral->wrapExprBody(*arena);
+                        ast = fnLiteral;
+                    }
+                    else
+                        ast = arena->make<FunctionLiteralExprAst>(std::move(p), block());
+                    break;
+                }
+
+                case AstType::BlockStatement:
+                    ast = arena->make<BlockStatementAst>(list<Statement>([&] { return stmt(); }));
+                    break;
+                case AstType::ExpressionStmt: ast = arena->make<ExpressionStmtAst>(expr()); break;
+                case AstType::VarDefSt: {
+                    bool isPublic = boolean();
+                    bool isConst = boolean();
+                    FString name = str();
+                    Expression declaredType = expr();
+                    Expression value = expr();
+                    bool followupType = boolean();
+                    ast = arena->make<VarDefAst>(
+                        isPublic, isConst, std::move(name), std::move(declaredType), std::move(value), followupType);
+                    break;
+                }
+                case AstType::FunctionDefSt: {
+                    FString name = str();
+                    FunctionParameters p = paras();
+                    bool isPublic = boolean();
+                    Expression retType = expr();
+                    ast = arena->make<FunctionDefSt>(std::move(name), std::move(p), isPublic, std::move(retType), block());
+                    break;
+                }
+                case AstType::StructSt: {
+                    bool isPublic = boolean();
+                    FString name = str();
+                    auto fields = list<StructDefField>([&] {
+                        AccessModifier am = static_cast<AccessModifier>(u8());
+                        FString fieldName = str();
+                        Expression declaredType = expr();
+                        return StructDefField(am, std::move(fieldName), std::move(declaredType), expr());
+                    });
+                    ast = arena->make<StructDefSt>(isPublic, std::move(name), std::move(fields), block());
+                    break;
+                }
+                case AstType::InterfaceDefSt: {
+                    FString name = str();
+                    auto bundles = list<Expression>([&] { return expr(); });
+                    auto methods = list<InterfaceMethod>([&] {
+                        InterfaceMethod m;
+                        m.name = str();
+                        m.paras = paras();
+                        m.returnType = expr();
+                        m.defaultBody = block();
+                        return m;
+                    });
+                    ast = arena->make<InterfaceDefAst>(std::move(name), std::move(bundles), std::move(methods), boolean());
+                    break;
+                }
+                case AstType::ImplementSt: {
+                    FString interfaceName = str();
+                    FString structName = str();
+                    auto methods = list<ImplementMethod>([&] {
+                        ImplementMethod m;
+                        m.name = str();
+                        m.paras = paras();
+                        m.body = block();
+                        return m;
+                    });
+                    ast = arena->make<ImplementAst>(std::move(interfaceName), std::move(structName), std::move(methods));
+                    break;
+                }
+                case AstType::IfSt: {
+                    Expression condition = expr();
+                    BlockStatement body = block();
+                    auto elifs = list<ElseIf>([&] { return as<ElseIfSt>(node(), AstType::ElseIfSt); });
+                    Else els = as<ElseSt>(node(), AstType::ElseSt);
+                    ast = arena->make<IfSt>(std::move(condition), std::move(body), std::move(elifs), std::move(els));
+                    break;
+                }
+                case AstType::ElseIfSt: {
+                    Expression condition = expr();
+                    ast = arena->make<ElseIfSt>(std::move(condition), block());
+                    break;
+                }
+                case AstType::ElseSt: ast = arena->make<ElseSt>(block()); break;
+                case AstType::WhileSt: {
+                    Expression condition = expr();
+                    ast = arena->make<WhileSt>(std::move(condition), block());
+                    break;
+                }
+                case AstType::ForSt: {
+                    Statement initSt = stmt();
+                    Expression condition = expr();
+                    Statement incrementSt = stmt();
+                    ast = arena->make<ForSt>(std::move(initSt), std::move(condition), std::move(incrementSt), block());
+                    break;
+                }
+                case AstType::ReturnSt: ast = arena->make<ReturnSt>(expr()); break;
+                case AstType::BreakSt: ast = arena->make<BreakSt>(); break;
+                case AstType::ContinueSt: ast = arena->make<ContinueSt>(); break;
+                case AstType::ImportSt: {
+                    auto path = list<FString>([&] { return str(); });
+                    auto names = list<FString>([&] { return str(); });
+                    ast = arena->make<ImportSt>(std::move(path), std::move(names), str());
+                    break;
+                }
+                case AstType::TrySt: {
+                    BlockStatement body = block();
+                    auto catches = list<Catch>([&] {
+                        Catch c;
+                        c.errVarName = str();
+                        c.errVarSymbol = Symbol(c.errVarName);
+                        c.hasType = boolean();
+                        c.errVarType = str();
+                        c.body = block();
+                        return c;
+                    });
+                    ast = arena->make<TrySt>(std::move(body), std::move(catches), block());
+                    break;
+                }
+                case AstType::ThrowSt: ast = arena->make<ThrowSt>(expr()); break;
+
+                default: throw Corrupt{};
+            }
+
+            ast->setAAI(AstAddressInfo{
+                .line = line, .column = column, .sourcePath = sourcePathPtr, .sourceLines = sourceLinesPtr});
+            return ast;
+        }
+    }; // namespace
+
+    std::filesystem::path cachePathFor(const std::filesystem::path &sourcePath)
+    {
+        std::filesystem::path cachePath = sourcePath;
+        cachePath += u8"c"; // foo.fig -> foo.figc
+        return cachePath;
+    }
+
+    std::optional<Unit> load(const std::filesystem::path &path, const FString &sourcePath)
+    {
+        uint64_t size;
+        int64_t mtime;
+        if (!statSource(path, size, mtime)) return std::nullopt;
+
+        std::string buffer;
+        if (!readFile(cachePathFor(path), buffer)) return std::nullopt;
+
+        try
+        {
+            Reader reader(buffer);
+
+            Header header;
+            if (!reader.header(header) || header.sourceSize != size) return std::nullopt;
+            if (header.sourceMtime != mtime)
+            {
+                // touched but maybe not edited (checkout, copy): same bytes are still fresh
+                std::string source;
+                if (!readFile(path, source) || fnv1a(source) != header.sourceHash) return std::nullopt;
+            }
+            return reader.body(sourcePath);
+        }
+        catch (const Corrupt &)
+        {
+            return std::nullopt;
+        }
+    }
+
+    bool store(const std::filesystem::path &path,
+               const std::string &source,
+               const Unit &unit,
+               uint64_t sourceSize,
+               int64_t sourceMtime)
+    {
+        Header header;
+        header.sourceSize = sourceSize;
+        header.sourceMtime = sourceMtime;
+        header.sourceHash = fnv1a(source);
+
+        std::string data;
+        try
+        {
+            Writer writer;
+            std::vector<uint32_t> lines;
+            lines.reserve(unit.sourceLines.size());
+            for (const FString &line : unit.sourceLines) { lines.push_back(writer.intern(line)); }
+
+            for (const Ast::AstBase &ast : unit.asts) { writer.node(ast); }
+            data = writer.finish(header, lines, static_cast<uint32_t>(unit.asts.size()));
+        }
+        catch (const UnsupportedNode &)
+        {
+            return false;
+        }
+
+        // write aside and rename, a concurrent reader never sees half a file
+        std::filesystem::path cachePath = cachePathFor(path);
+        std::filesystem::path tmpPath = cachePath;
+        tmpPath += std::format(".{}.tmp", std::random_device{}());
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        std::error_code ec;
+        if (std::filesystem::file_size(tmpPath, ec) != data.size() || ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        std::filesystem::rename(tmpPath, cachePath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    Unit loadOrParse(const std::filesystem::path &path, const FString &sourcePath)
+    {
+        if (std::optional<Unit> cached = load(path, sourcePath)) { return std::move(*cached); }
+
+        // stat first: an edit racing the read leaves a newer mtime than the cache records, so the next load
+        // re-checks the hash instead of trusting a stale tree
+        uint64_t size;
+        int64_t mtime;
+        bool stamped = statSource(path, size, mtime);
+
+        std::string source;
+        if (!readFile(path, source))
+        {
+            throw RuntimeError(FString(std::format("Could not open file: {}", path.string())));
+        }
+
+        Unit unit;
+        unit.sourceLines = Utils::splitSource(FString(source));
+
+        Lexer lexer((FString(source)), sourcePath, unit.sourceLines);
+        unit.arena = std::make_unique<Ast::Arena>();
+        Parser parser(lexer, sourcePath, unit.sourceLines, *unit.arena);
+        unit.asts = parser.parseAll();
+
+        if (stamped) { store(path, source, unit, size, mtime); } // best effort, a read-only directory runs uncached
+        return unit;
+    }
+}; // namespace Fig::AstCache
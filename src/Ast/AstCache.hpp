@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Ast/ast.hpp>
+#include <Ast/AstArena.hpp>
+#include <Core/fig_string.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Fig::AstCache
+{
+    /*
+        precompiled module cache (.figc)
+
+        a parsed module is written next to its source as `<name>.figc` and reused while the source is
+        unchanged, so lexing and parsing run once per edit instead of once per process.
+        the cached tree is the parser output, the Resolver still runs on every load
+
+        layout (little endian, all counts u32):
+            header     "FIGC", format version, build stamp, source size, source mtime, source hash, body hash
+            strings    interned string table, every name / literal / source line is an index into it
+            lines      source lines, string indices
+            positions  line / column of every node, in node order
+            nodes      preorder node stream: AstType tag, then the fields of that node
+
+        the cache belongs to one build of the interpreter (build stamp) and is ignored on any mismatch,
+        a broken or foreign file just falls back to parsing
+    */
+
+    struct Unit
+    {
+        std::unique_ptr<Ast::Arena> arena; // owns `asts`, keep it while anything built from them can run
+        std::vector<FString> sourceLines;
+        std::vector<Ast::AstBase> asts;
+    };
+
+    std::filesystem::path cachePathFor(const std::filesystem::path &sourcePath);
+
+    // nullopt when there is no fresh cache for `path`
+    std::optional<Unit> load(const std::filesystem::path &path, const FString &sourcePath);
+
+    // false when the tree holds a node the format does not know or the file can not be written.
+    // sourceSize / sourceMtime: the stat of `path` taken before `source` was read from it, a later stat could
+    // already describe an edit the tree does not have
+    bool store(const std::filesystem::path &path,
+               const std::string &source,
+               const Unit &unit,
+               uint64_t sourceSize,
+               int64_t sourceMtime);
+
+    // cached tree when fresh, otherwise lex + parse and refresh the cache. parser errors propagate
+    Unit loadOrParse(const std::filesystem::path &path, const FString &sourcePath);
+}; // namespace Fig::AstCache
@@ -2,13 +2,35 @@
 
 #include <Ast/astBase.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
+namespace Fig
+{
+    struct OperationRecord;
+}; // namespace Fig
+
 namespace Fig::Ast
 {
+    /*
+        OperatorCache
+        overload lookup of a binary expression for the last struct type it saw, filled by Evaluator::evalBinary.
+        `record` nullptr with a matching type: that type has no overload here
+    */
+    struct OperatorCache
+    {
+        size_t typeId = 0; // TypeInfo id of the left operand's struct, 0: empty
+        const OperationRecord *record = nullptr;
+        uint64_t epoch = 0; // Context::registryEpoch() when filled
+    };
+
     class BinaryExprAst final : public ExpressionAst
     {
     public:
         Operator op;
-        Expression lexp, rexp;
+        Expression lexp = nullptr, rexp = nullptr;
+
+        OperatorCache overload;
 
         BinaryExprAst()
         {
@@ -24,6 +46,6 @@ namespace Fig::Ast
         }
     };
 
-    using BinaryExpr = std::shared_ptr<BinaryExprAst>;
+    using BinaryExpr = BinaryExprAst *;
 
 }; // namespace Fig
\ No newline at end of file
@@ -5,7 +5,8 @@
 
 #include <Ast/astBase.hpp>
 
-#include <map>
+#include <utility>
+#include <vector>
 
 namespace Fig::Ast
 {
@@ -25,7 +26,7 @@ namespace Fig::Ast
             type = AstType::ListExpr;
         }
     };
-    using ListExpr = std::shared_ptr<ListExprAst>;
+    using ListExpr = ListExprAst *;
 
     class TupleExprAst final : public ExpressionAst
     {
@@ -43,23 +44,23 @@ namespace Fig::Ast
             type = AstType::TupleExpr;
         }
     };
-    using TupleExpr = std::shared_ptr<TupleExprAst>;
+    using TupleExpr = TupleExprAst *;
 
     class MapExprAst final : public ExpressionAst
     {
     public:
-        std::map<Expression, Expression> val;
+        std::vector<std::pair<Expression, Expression>> val; // source order
 
         MapExprAst()
         {
             type = AstType::MapExpr;
         }
 
-        MapExprAst(std::map<Expression, Expression> _val) :
+        MapExprAst(std::vector<std::pair<Expression, Expression>> _val) :
             val(std::move(_val))
         {
             type = AstType::MapExpr;
         }
     };
-    using MapExpr = std::shared_ptr<MapExprAst>;
+    using MapExpr = MapExprAst *;
 }; // namespace Fig::Ast
\ No newline at end of file
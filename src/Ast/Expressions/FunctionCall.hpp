@@ -14,14 +14,14 @@ namespace Fig::Ast
 
     struct FunctionCallArgs final 
     {
-        std::vector<ObjectPtr> argv;
+        std::vector<Value> argv;
         size_t getLength() const { return argv.size(); }
     };
 
     class FunctionCallExpr final : public ExpressionAst
     {
     public:
-        Expression callee;
+        Expression callee = nullptr;
         FunctionArguments arg;
 
         FunctionCallExpr()
@@ -50,5 +50,5 @@ namespace Fig::Ast
         }
     };
 
-    using FunctionCall = std::shared_ptr<FunctionCallExpr>;
+    using FunctionCall = FunctionCallExpr *;
 }; // namespace Fig
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Ast/astBase.hpp>
+#include <Ast/AstArena.hpp>
 #include <Ast/functionParameters.hpp>
+#include <Ast/Statements/ControlSt.hpp>
 #include <Core/fig_string.hpp>
 #include <variant>
 
@@ -13,6 +15,8 @@ namespace Fig::Ast
         FunctionParameters paras;
         std::variant<BlockStatement, Expression> body;
 
+        BlockStatement exprBlock = nullptr; // expr mode: `{ return <expr>; }`, built once next to the node
+
         FunctionLiteralExprAst(FunctionParameters _paras, BlockStatement _body) :
             paras(std::move(_paras)), body(std::move(_body))
         {
@@ -40,8 +44,28 @@ namespace Fig::Ast
             return std::get<Expression>(body);
         }
 
+        // what a call runs, the block itself or the wrapped expression
+        BlockStatement getCallBody()
+        {
+            return isExprMode() ? exprBlock : getBlockBody();
+        }
+
+        // whoever allocates an expr mode literal calls this once, evaluation never allocates nodes
+        void wrapExprBody(Arena &arena)
+        {
+            Expression exprBody = getExprBody();
+            const AstAddressInfo &aai = exprBody->getAAI();
+
+            ReturnSt *st = arena.make<ReturnSt>(exprBody);
+            st->setAAI(aai);
+
+            exprBlock = arena.make<BlockStatementAst>();
+            exprBlock->stmts.push_back(st);
+            exprBlock->setAAI(aai);
+        }
+
         ~FunctionLiteralExprAst() = default;
     };
 
-    using FunctionLiteralExpr = std::shared_ptr<FunctionLiteralExprAst>;
+    using FunctionLiteralExpr = FunctionLiteralExprAst *;
 } // namespace Fig::Ast
\ No newline at end of file
@@ -7,9 +7,10 @@ namespace Fig::Ast
     class InitExprAst final : public ExpressionAst
     {
     public:
-        Expression structe;
+        Expression structe = nullptr;
 
         std::vector<std::pair<FString, Expression>> args;
+        std::vector<Symbol> argSymbols; // args[i].first interned, for field lookups
 
         enum class InitMode
         {
@@ -34,9 +35,11 @@ namespace Fig::Ast
             structe(std::move(_structe)), args(std::move(_args)), initMode(_initMode)
         {
             type = AstType::InitExpr;
+            argSymbols.reserve(args.size());
+            for (const auto &arg : args) { argSymbols.emplace_back(arg.first); }
         }
     };
 
-    using InitExpr = std::shared_ptr<InitExprAst>;
+    using InitExpr = InitExprAst *;
 
 }; // namespace Fig::Ast
\ No newline at end of file
@@ -2,16 +2,88 @@
 
 #include <Ast/astBase.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Fig
+{
+    class Function;
+    struct StructShape;
+    struct VariableSlot;
+}; // namespace Fig
+
 namespace Fig::Ast
 {
     // actually, function call is postfix, too
     // but it's too long, so use a single file (FunctionCall.hpp)
 
+    /*
+        MemberCache
+        inline cache of what `a.b` resolved to last time, one entry per receiver type (TypeInfo id,
+        the struct's own type for instances). only the evaluator reads and fills it, see Evaluator::evalMemberOf
+    */
+    struct MemberCache
+    {
+        enum class Kind : uint8_t
+        {
+            Empty,
+            Field,        // instance field, `fieldIndex` in the shape
+            ShapeMethod,  // method declared in the struct body
+            ImplMethod,   // impl for a builtin type, bound to the calling context
+            InstanceImpl, // impl for the struct type, bound to the instance
+        };
+
+        struct Entry
+        {
+            Kind kind = Kind::Empty;
+            size_t typeId = 0;
+            const StructShape *shape = nullptr;                    // Field / ShapeMethod guard
+            size_t fieldIndex = 0;                                 // Field
+            const std::shared_ptr<VariableSlot> *method = nullptr; // ShapeMethod, slot in the shape
+            const Function *implFn = nullptr;                      // ImplMethod / InstanceImpl
+            uint64_t epoch = 0;                                    // Context::registryEpoch() when filled
+        };
+
+        static constexpr size_t Ways = 4; // receiver types seen before giving up (megamorphic)
+
+        std::array<Entry, Ways> entries;
+        uint8_t used = 0;
+
+        const Entry *find(size_t typeId) const
+        {
+            for (uint8_t i = 0; i < used; ++i)
+            {
+                if (entries[i].typeId == typeId) return &entries[i];
+            }
+            return nullptr;
+        }
+
+        // replaces the entry of the same type (a stale impl), otherwise takes a free one if any is left
+        void fill(const Entry &entry)
+        {
+            for (uint8_t i = 0; i < used; ++i)
+            {
+                if (entries[i].typeId == entry.typeId)
+                {
+                    entries[i] = entry;
+                    return;
+                }
+            }
+            if (used < Ways) entries[used++] = entry;
+        }
+    };
+
     class MemberExprAst final : public ExpressionAst
     {
     public:
-        Expression base;
+        Expression base = nullptr;
         FString member;
+        Symbol memberSymbol; // `member` interned, for field / method / impl lookups
+
+        int methodId = -2; // interned builtin method id, -2: not looked up yet (see Object::getMemberMethodId)
+        MemberCache cache;
 
         MemberExprAst()
         {
@@ -19,19 +91,24 @@ namespace Fig::Ast
         }
 
         MemberExprAst(Expression _base, FString _member) :
-            base(std::move(_base)), member(std::move(_member))
+            base(std::move(_base)), member(std::move(_member)), memberSymbol(member)
+        {
+            type = AstType::MemberExpr;
+        }
+        MemberExprAst(Expression _base, FString _member, Symbol _memberSymbol) :
+            base(std::move(_base)), member(std::move(_member)), memberSymbol(_memberSymbol)
         {
             type = AstType::MemberExpr;
         }
     };
 
-    using MemberExpr = std::shared_ptr<MemberExprAst>;
+    using MemberExpr = MemberExprAst *;
 
     class IndexExprAst final : public ExpressionAst
     {
     public:
-        Expression base;
-        Expression index;
+        Expression base = nullptr;
+        Expression index = nullptr;
 
         IndexExprAst()
         {
@@ -45,5 +122,5 @@ namespace Fig::Ast
         }
     };
 
-    using IndexExpr = std::shared_ptr<IndexExprAst>;
+    using IndexExpr = IndexExprAst *;
 }; // namespace Fig::Ast
\ No newline at end of file
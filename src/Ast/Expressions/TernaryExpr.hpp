@@ -8,9 +8,9 @@ namespace Fig::Ast
     class TernaryExprAst final : public ExpressionAst
     {
     public:
-        Expression condition;
-        Expression valueT;
-        Expression valueF;
+        Expression condition = nullptr;
+        Expression valueT = nullptr;
+        Expression valueF = nullptr;
 
         TernaryExprAst()
         {
@@ -25,5 +25,5 @@ namespace Fig::Ast
             valueF = std::move(_valueF);
         }
     };
-    using TernaryExpr = std::shared_ptr<TernaryExprAst>;
+    using TernaryExpr = TernaryExprAst *;
 } // namespace Fig
\ No newline at end of file
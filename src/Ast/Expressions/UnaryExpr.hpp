@@ -8,7 +8,7 @@ namespace Fig::Ast
     {
     public:
         Operator op;
-        Expression exp;
+        Expression exp = nullptr;
 
         UnaryExprAst()
         {
@@ -23,5 +23,5 @@ namespace Fig::Ast
         }
     };
 
-    using UnaryExpr = std::shared_ptr<UnaryExprAst>;
+    using UnaryExpr = UnaryExprAst *;
 } // namespace Fig
\ No newline at end of file
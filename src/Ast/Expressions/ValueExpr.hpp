@@ -10,6 +10,7 @@ namespace Fig::Ast
     {
     public:
         ObjectPtr val;
+        Value value; // `val` as the evaluator hands it out, a number is held inline
 
         ValueExprAst()
         {
@@ -19,8 +20,9 @@ namespace Fig::Ast
         {
             type = AstType::ValueExpr;
             val = std::move(_val);
+            value = Value(val);
         }
     };
 
-    using ValueExpr = std::shared_ptr<ValueExprAst>;
+    using ValueExpr = ValueExprAst *;
 };
\ No newline at end of file
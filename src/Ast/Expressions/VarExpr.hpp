@@ -8,17 +8,30 @@ namespace Fig::Ast
     {
     public:
         const FString name;
+        const Symbol symbol; // `name` interned, for Context lookups
+
+        // filled by Resolver: lexical (scope depth, slot index), -1 means unresolved (hash lookup)
+        int depth = -1;
+        int slot = -1;
+
         VarExprAst() :
             name(u8"")
         {
             type = AstType::VarExpr;
         }
         VarExprAst(FString _name) :
-            name(std::move(_name))
+            name(std::move(_name)), symbol(name)
+        {
+            type = AstType::VarExpr;
+        }
+        VarExprAst(FString _name, Symbol _symbol) :
+            name(std::move(_name)), symbol(_symbol)
         {
             type = AstType::VarExpr;
         }
+
+        bool isResolved() const { return slot >= 0; }
     };
 
-    using VarExpr = std::shared_ptr<VarExprAst>;
+    using VarExpr = VarExprAst *;
 }; // namespace Fig
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace Fig::Ast
     class ReturnSt final : public StatementAst
     {
     public:
-        Expression retValue;
+        Expression retValue = nullptr;
 
         ReturnSt()
         {
@@ -20,7 +20,7 @@ namespace Fig::Ast
         }
     };
 
-    using Return = std::shared_ptr<ReturnSt>;
+    using Return = ReturnSt *;
 
     class BreakSt final : public StatementAst
     {
@@ -31,7 +31,7 @@ namespace Fig::Ast
         }
     };
 
-    using Break = std::shared_ptr<BreakSt>;
+    using Break = BreakSt *;
 
     class ContinueSt final : public StatementAst
     {
@@ -42,5 +42,5 @@ namespace Fig::Ast
         }
     };
 
-    using Continue = std::shared_ptr<ContinueSt>;
+    using Continue = ContinueSt *;
 };
\ No newline at end of file
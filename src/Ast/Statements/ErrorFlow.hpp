@@ -7,7 +7,7 @@ namespace Fig::Ast
     class ThrowSt final : public StatementAst
     {
     public:
-        Expression value;
+        Expression value = nullptr;
 
         ThrowSt()
         {
@@ -20,23 +20,27 @@ namespace Fig::Ast
             type = AstType::ThrowSt;
         }
     };
-    using Throw = std::shared_ptr<ThrowSt>;
+    using Throw = ThrowSt *;
 
     struct Catch
     {
         FString errVarName;
+        Symbol errVarSymbol; // `errVarName` interned, for the catch scope
         bool hasType = false;
         FString errVarType;
-        BlockStatement body;
+        BlockStatement body = nullptr;
 
         Catch() {}
         Catch(FString _errVarName, FString _errVarType, BlockStatement _body) :
-            errVarName(std::move(_errVarName)), errVarType(std::move(_errVarType)), body(std::move(_body))
+            errVarName(std::move(_errVarName)),
+            errVarSymbol(errVarName),
+            errVarType(std::move(_errVarType)),
+            body(std::move(_body))
         {
             hasType = true;
         }
         Catch(FString _errVarName, BlockStatement _body) :
-            errVarName(std::move(_errVarName)), body(std::move(_body))
+            errVarName(std::move(_errVarName)), errVarSymbol(errVarName), body(std::move(_body))
         {
             hasType = false;
         }
@@ -45,7 +49,7 @@ namespace Fig::Ast
     class TrySt final : public StatementAst
     {
     public:
-        BlockStatement body;
+        BlockStatement body = nullptr;
         std::vector<Catch> catches;
         BlockStatement finallyBlock = nullptr;
 
@@ -60,5 +64,5 @@ namespace Fig::Ast
         }
     };
 
-    using Try = std::shared_ptr<TrySt>;
+    using Try = TrySt *;
 } // namespace Fig::Ast
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace Fig::Ast
     class ExpressionStmtAst final : public StatementAst
     {
     public:
-        Expression exp;
+        Expression exp = nullptr;
         ExpressionStmtAst()
         {
             type = AstType::ExpressionStmt;
@@ -17,5 +17,5 @@ namespace Fig::Ast
             type = AstType::ExpressionStmt;
         }
     };
-    using ExpressionStmt = std::shared_ptr<ExpressionStmtAst>;
+    using ExpressionStmt = ExpressionStmtAst *;
 }
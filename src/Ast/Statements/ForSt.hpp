@@ -7,10 +7,10 @@ namespace Fig::Ast
     class ForSt final : public StatementAst
     {
     public:
-        Statement initSt;
-        Expression condition;
-        Statement incrementSt;
-        BlockStatement body;
+        Statement initSt = nullptr;
+        Expression condition = nullptr;
+        Statement incrementSt = nullptr;
+        BlockStatement body = nullptr;
 
         ForSt()
         {
@@ -26,5 +26,5 @@ namespace Fig::Ast
         }
     };
 
-    using For = std::shared_ptr<ForSt>; 
+    using For = ForSt *; 
 };
\ No newline at end of file
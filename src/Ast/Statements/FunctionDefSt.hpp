@@ -21,10 +21,13 @@ namespace Fig::Ast
     {
     public:
         FString name;
+        Symbol symbol; // `name` interned, for Context definitions
         FunctionParameters paras;
         bool isPublic;
-        Expression retType; 
-        BlockStatement body;
+        Expression retType = nullptr;
+        BlockStatement body = nullptr;
+
+        int slot = -1; // filled by Resolver
 
         FunctionDefSt()
         {
@@ -35,11 +38,12 @@ namespace Fig::Ast
             type = AstType::FunctionDefSt;
 
             name = std::move(_name);
+            symbol = Symbol(name);
             paras = std::move(_paras);
             isPublic = _isPublic;
             retType = std::move(_retType);
             body = std::move(_body);
         }
     };
-    using FunctionDef = std::shared_ptr<FunctionDefSt>;
+    using FunctionDef = FunctionDefSt *;
 }; // namespace Fig
\ No newline at end of file
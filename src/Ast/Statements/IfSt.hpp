@@ -7,7 +7,7 @@ namespace Fig::Ast
     class ElseSt final : public StatementAst
     {
     public:
-        BlockStatement body;
+        BlockStatement body = nullptr;
         ElseSt()
         {
             type = AstType::ElseSt;
@@ -22,12 +22,12 @@ namespace Fig::Ast
             return FString(std::format("<Else Ast at {}:{}>", aai.line, aai.column));
         }
     };
-    using Else = std::shared_ptr<ElseSt>;
+    using Else = ElseSt *;
     class ElseIfSt final : public StatementAst
     {
     public:
-        Expression condition;
-        BlockStatement body;
+        Expression condition = nullptr;
+        BlockStatement body = nullptr;
         ElseIfSt()
         {
             type = AstType::ElseIfSt;
@@ -43,14 +43,14 @@ namespace Fig::Ast
             return FString(std::format("<ElseIf Ast at {}:{}>", aai.line, aai.column));
         }
     };
-    using ElseIf = std::shared_ptr<ElseIfSt>;
+    using ElseIf = ElseIfSt *;
     class IfSt final : public StatementAst
     {
     public:
-        Expression condition;
-        BlockStatement body;
+        Expression condition = nullptr;
+        BlockStatement body = nullptr;
         std::vector<ElseIf> elifs;
-        Else els;
+        Else els = nullptr;
         IfSt()
         {
             type = AstType::IfSt;
@@ -64,5 +64,5 @@ namespace Fig::Ast
             type = AstType::IfSt;
         }
     };
-    using If = std::shared_ptr<IfSt>;
+    using If = IfSt *;
 }; // namespace Fig
\ No newline at end of file
@@ -19,7 +19,7 @@ namespace Fig::Ast
     {
         FString name;
         FunctionParameters paras;
-        BlockStatement body;
+        BlockStatement body = nullptr;
     };
 
     class ImplementAst final : public StatementAst
@@ -42,5 +42,5 @@ namespace Fig::Ast
         }
     };
 
-    using Implement = std::shared_ptr<ImplementAst>;
+    using Implement = ImplementAst *;
 };
\ No newline at end of file
@@ -31,5 +31,5 @@ namespace Fig::Ast
         }
     };
 
-    using Import = std::shared_ptr<ImportSt>;
+    using Import = ImportSt *;
 };
\ No newline at end of file
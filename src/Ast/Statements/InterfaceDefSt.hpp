@@ -25,7 +25,7 @@ namespace Fig::Ast
     {
         FString name;
         FunctionParameters paras;
-        Expression returnType;
+        Expression returnType = nullptr;
 
         BlockStatement defaultBody = nullptr; // nullptr is non-default func
 
@@ -50,22 +50,29 @@ namespace Fig::Ast
     {
     public:
         FString name;
+        Symbol symbol; // `name` interned, for Context definitions
         std::vector<Expression> bundles;
         std::vector<InterfaceMethod> methods;
         std::vector<FString> parents; // Feature, NOT NOW
         bool isPublic;
 
+        int slot = -1; // filled by Resolver
+
         InterfaceDefAst()
         {
             type = AstType::InterfaceDefSt;
         }
 
         InterfaceDefAst(FString _name, std::vector<Expression> _bundles, std::vector<InterfaceMethod> _methods, bool _isPublic) :
-            name(std::move(_name)), bundles(std::move(_bundles)), methods(std::move(_methods)), isPublic(_isPublic)
+            name(std::move(_name)),
+            symbol(name),
+            bundles(std::move(_bundles)),
+            methods(std::move(_methods)),
+            isPublic(_isPublic)
         {
             type = AstType::InterfaceDefSt;
         }
     };
 
-    using InterfaceDef = std::shared_ptr<InterfaceDefAst>;
+    using InterfaceDef = InterfaceDefAst *;
 };
\ No newline at end of file
@@ -12,8 +12,8 @@ namespace Fig::Ast
     {
         AccessModifier am;
         FString fieldName;
-        Expression declaredType; 
-        Expression defaultValueExpr;
+        Expression declaredType = nullptr;
+        Expression defaultValueExpr = nullptr;
 
         StructDefField() {}
         StructDefField(AccessModifier _am, FString _fieldName,  Expression _declaredType, Expression _defaultValueExpr) :
@@ -26,19 +26,26 @@ namespace Fig::Ast
     public:
         bool isPublic;
         const FString name;
+        const Symbol symbol; // `name` interned, for Context definitions
         const std::vector<StructDefField> fields; // field name (:type name = default value expression)
                                                   // name / name: String / name: String = "Fig"
-        const BlockStatement body;
+        const BlockStatement body = nullptr;
+
+        int slot = -1; // filled by Resolver
         StructDefSt()
         {
             type = AstType::StructSt;
         }
         StructDefSt(bool _isPublic, FString _name, std::vector<StructDefField> _fields, BlockStatement _body) :
-            isPublic(std::move(_isPublic)), name(std::move(_name)), fields(std::move(_fields)), body(std::move(_body))
+            isPublic(std::move(_isPublic)),
+            name(std::move(_name)),
+            symbol(name),
+            fields(std::move(_fields)),
+            body(std::move(_body))
         {
             type = AstType::StructSt;
         }
     };
 
-    using StructDef = std::shared_ptr<StructDefSt>;
+    using StructDef = StructDefSt *;
 }; // namespace Fig
\ No newline at end of file
@@ -11,12 +11,15 @@ namespace Fig::Ast
         bool isPublic;
         bool isConst;
         FString name;
+        Symbol symbol; // `name` interned, for Context definitions
         // FString typeName;
-        Expression declaredType;
-        Expression expr;
+        Expression declaredType = nullptr;
+        Expression expr = nullptr;
 
         bool followupType;
 
+        int slot = -1; // filled by Resolver
+
         VarDefAst()
         {
             type = AstType::VarDefSt;
@@ -30,11 +33,12 @@ namespace Fig::Ast
             isPublic = _isPublic;
             isConst = _isConst;
             name = std::move(_name);
+            symbol = Symbol(name);
             declaredType = std::move(_declaredType);
             expr = std::move(_expr);
             followupType = _followupType;
         }
     };
 
-    using VarDef = std::shared_ptr<VarDefAst>;
+    using VarDef = VarDefAst *;
 } // namespace Fig
\ No newline at end of file
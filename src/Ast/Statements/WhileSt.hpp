@@ -7,8 +7,8 @@ namespace Fig::Ast
     class WhileSt final : public StatementAst
     {
     public:
-        Expression condition;
-        BlockStatement body;
+        Expression condition = nullptr;
+        BlockStatement body = nullptr;
 
         WhileSt()
         {
@@ -22,5 +22,5 @@ namespace Fig::Ast
         }
     };
 
-    using While = std::shared_ptr<WhileSt>;
+    using While = WhileSt *;
 };
\ No newline at end of file
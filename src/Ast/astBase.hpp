@@ -119,6 +119,7 @@ namespace Fig::Ast
         _AstBase &operator=(_AstBase &&) = default;
 
         _AstBase() {}
+        virtual ~_AstBase() = default;
 
         void setAAI(AstAddressInfo _aai) { aai = std::move(_aai); }
 
@@ -132,9 +133,9 @@ namespace Fig::Ast
             return FString(std::format("<Base Ast '{}' at {}:{}>", typeName().toBasicString(), aai.line, aai.column));
         }
 
-        AstAddressInfo getAAI() { return aai; }
+        const AstAddressInfo &getAAI() const { return aai; }
 
-        AstType getType() { return type; }
+        AstType getType() const { return type; }
     };
 
     class StatementAst : public _AstBase
@@ -315,10 +316,10 @@ namespace Fig::Ast
         return ternaryOps.contains(op);
     }
 
-    using AstBase = std::shared_ptr<_AstBase>;
-    using Statement = std::shared_ptr<StatementAst>;
-    using Expression = std::shared_ptr<ExpressionAst>;
-    using Eof = std::shared_ptr<EofStmt>;
+    using AstBase = _AstBase *;
+    using Statement = StatementAst *;
+    using Expression = ExpressionAst *;
+    using Eof = EofStmt *;
 
     class BlockStatementAst : public StatementAst
     {
@@ -334,6 +335,6 @@ namespace Fig::Ast
         virtual ~BlockStatementAst() = default;
     };
 
-    using BlockStatement = std::shared_ptr<BlockStatementAst>;
+    using BlockStatement = BlockStatementAst *;
     // static BlockStatement builtinEmptyBlockSt(new BlockStatementAst());
 }; // namespace Fig::Ast
\ No newline at end of file
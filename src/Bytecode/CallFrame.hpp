@@ -11,7 +11,7 @@ namespace Fig
         uint64_t ip;         // 函数第一个指令 index
         uint64_t base;       // 第一个参数在栈中位置偏移量
 
-        CompiledFunction fn; // 编译过的函数体
+        const CompiledFunction *fn; // 编译过的函数体, 不持有 (owned by the constant pool that loaded it)
     };
 
-};
\ No newline at end of file
+};
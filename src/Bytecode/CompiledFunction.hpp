@@ -17,5 +17,6 @@ namespace Fig
 
         uint64_t localCount;  // 局部变量数量(不包括参数)
         uint64_t slotCount; // = 总参数数量 + 局部变量数量
+        uint64_t maxStack;  // operand stack depth reached above the slots, computed by Compiler
     };
 };
\ No newline at end of file
@@ -14,31 +14,58 @@ namespace Fig
 
         LOAD_LOCAL,
         LOAD_CONST,
+        LOAD_GLOBAL,
 
         STORE_LOCAL,
+        STORE_GLOBAL,
+
+        POP,
+        DUP,
 
         LT,
         LTET,
         GT,
         GTET,
+        EQ,
+        NEQ,
         ADD,
         SUB,
         MUL,
         DIV,
+        MOD,
+
+        NOT,
+        NEG,
 
         JUMP,          // + 64 offset (int64_t)
         JUMP_IF_FALSE, // + 64 offset (int64_t)
 
         CALL,
+        CALL_CONST,  // callee constants[callIndex], read in place + argument count (packCall)
+        CALL_GLOBAL, // callee globals[callIndex], read in place + argument count (packCall)
     };
 
     static constexpr int MAX_LOCAL_COUNT = UINT64_MAX;
     static constexpr int MAX_CONSTANT_COUNT = UINT64_MAX;
     static constexpr int MAX_FUNCTION_ARG_COUNT = UINT64_MAX;
 
-    inline OpCode getLastOpCode()
+    constexpr OpCode getLastOpCode()
+    {
+        return OpCode::CALL_GLOBAL;
+    }
+
+    // CALL_CONST / CALL_GLOBAL operand: callee index in the high 32 bits, argument count in the low 32
+    constexpr int64_t packCall(uint64_t index, uint64_t argCount)
+    {
+        return static_cast<int64_t>((index << 32) | (argCount & 0xFFFFFFFF));
+    }
+    constexpr uint64_t callIndex(int64_t operand)
+    {
+        return static_cast<uint64_t>(operand) >> 32;
+    }
+    constexpr uint64_t callArgCount(int64_t operand)
     {
-        return OpCode::RETURN;
+        return static_cast<uint64_t>(operand) & 0xFFFFFFFF;
     }
 
     struct InstructionAddressInfo
@@ -0,0 +1,124 @@
+#include <Bytecode/Chunk.hpp>
+#include <Bytecode/Instruction.hpp>
+#include <Bytecode/CompiledFunction.hpp>
+#include <VirtualMachine/VirtualMachine.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+using namespace Fig;
+
+/*
+    dispatch benchmark: switch vs labels-as-values on the fib chunk of vm_test_main.cpp
+*/
+
+static std::shared_ptr<CompiledFunction> makeFib()
+{
+    Instructions fib_ins{
+        /*  0 */ {OpCode::LOAD_LOCAL, 0},    // x
+        /*  1 */ {OpCode::LOAD_CONST, 0},    // 1
+        /*  2 */ {OpCode::LTET},             // x <= 1
+        /*  3 */ {OpCode::JUMP_IF_FALSE, 2}, // false -> jump to 6
+
+        /*  4 */ {OpCode::LOAD_LOCAL, 0}, // return x
+        /*  5 */ {OpCode::RETURN},
+
+        /*  6 */ {OpCode::LOAD_LOCAL, 0}, // x
+        /*  7 */ {OpCode::LOAD_CONST, 0}, // 1
+        /*  8 */ {OpCode::SUB},           // x - 1
+        /*  9 */ {OpCode::LOAD_CONST, 2}, // fib
+        /* 10 */ {OpCode::CALL, 1},       // fib(x-1)
+
+        /* 11 */ {OpCode::LOAD_LOCAL, 0}, // x
+        /* 12 */ {OpCode::LOAD_CONST, 1}, // 2
+        /* 13 */ {OpCode::SUB},           // x - 2
+        /* 14 */ {OpCode::LOAD_CONST, 2}, // fib
+        /* 15 */ {OpCode::CALL, 1},       // fib(x-2)
+
+        /* 16 */ {OpCode::ADD},
+        /* 17 */ {OpCode::RETURN},
+    };
+
+    auto fib_fn = std::make_shared<CompiledFunction>();
+    fib_fn->name = u8"fib";
+    fib_fn->posArgCount = 1;
+    fib_fn->defArgCount = 0;
+    fib_fn->variadicPara = false;
+    fib_fn->localCount = 0;
+    fib_fn->slotCount = 1;
+    fib_fn->maxStack = 3;
+
+    std::vector<Object> fib_consts;
+    fib_consts.push_back(Object((int64_t) 1));
+    fib_consts.push_back(Object((int64_t) 2));
+    fib_consts.push_back(Object(Function(u8"fib", fib_fn))); // 自引用, leaks on purpose
+
+    fib_fn->chunk = Chunk{fib_ins, fib_consts, {}, ChunkAddressInfo{}};
+    return fib_fn;
+}
+
+template <class Run>
+static void bench(const char *name, Run run, int rounds)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Object result;
+    auto best = Clock::duration::max();
+    for (int i = 0; i < rounds; ++i)
+    {
+        auto start = Clock::now();
+        result = run();
+        auto cost = Clock::now() - start;
+        if (cost < best) best = cost;
+    }
+    std::cout << name << ": " << result.toString().toBasicString() << ", best of " << rounds << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(best).count() << "ms\n";
+}
+
+int main(int argc, char **argv)
+{
+    int64_t n = (argc > 1 ? std::stoll(argv[1]) : 30);
+    int rounds = (argc > 2 ? std::stoi(argv[2]) : 5);
+
+    auto fib_fn = makeFib();
+
+    std::vector<Object> main_consts;
+    main_consts.push_back(Object(n));
+    main_consts.push_back(Object(Function(u8"fib", fib_fn)));
+
+    CompiledFunction main_fn;
+    main_fn.chunk = Chunk{Instructions{{OpCode::LOAD_CONST, 0}, {OpCode::LOAD_CONST, 1}, {OpCode::CALL, 1}, {OpCode::RETURN}},
+                          main_consts,
+                          {},
+                          ChunkAddressInfo{}};
+    main_fn.name = u8"main";
+    main_fn.posArgCount = 0;
+    main_fn.defArgCount = 0;
+    main_fn.variadicPara = false;
+    main_fn.localCount = 0;
+    main_fn.slotCount = 0;
+    main_fn.maxStack = 2;
+
+    std::cout << "fib(" << n << ")\n";
+
+    bench(
+        "switch  ",
+        [&]() {
+            VirtualMachine vm(CallFrame{0, 0, &main_fn});
+            return vm.ExecuteSwitch();
+        },
+        rounds);
+
+#if FIG_VM_COMPUTED_GOTO
+    bench(
+        "threaded",
+        [&]() {
+            VirtualMachine vm(CallFrame{0, 0, &main_fn});
+            return vm.ExecuteThreaded();
+        },
+        rounds);
+#else
+    std::cout << "threaded: not available with this compiler\n";
+#endif
+}
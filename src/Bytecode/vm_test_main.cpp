@@ -48,28 +48,24 @@ int main()
         /* 17 */ {OpCode::RETURN},
     };
 
-    std::vector<Object> fib_consts{
-        Object((int64_t) 1), // 0
-        Object((int64_t) 2), // 1
-        Object(),            // 2 fib (回填)
-    };
-
-    CompiledFunction fib_fn{
-        {},
-        u8"fib",
-        1, // posArgCount
-        0,
-        false,
-        0, // localCount
-        1  // slotCount = 参数 x
-    };
+    std::vector<Object> fib_consts;
+    fib_consts.push_back(Object((int64_t) 1)); // 0
+    fib_consts.push_back(Object((int64_t) 2)); // 1
+    fib_consts.push_back(Object());            // 2 fib (回填)
+
+    auto fib_fn = std::make_shared<CompiledFunction>();
+    fib_fn->name = u8"fib";
+    fib_fn->posArgCount = 1;
+    fib_fn->defArgCount = 0;
+    fib_fn->variadicPara = false;
+    fib_fn->localCount = 0;
+    fib_fn->slotCount = 1; // = 参数 x
+    fib_fn->maxStack = 3;  // fib(x - 1), x - 2, fib
 
     // fib 自引用
-    fib_consts[2] = Object(Function(&fib_fn));
-
-    Chunk fib_chunk{fib_ins, fib_consts, {}, ChunkAddressInfo{}};
+    fib_consts[2] = Object(Function(u8"fib", fib_fn));
 
-    fib_fn.chunk = fib_chunk;
+    fib_fn->chunk = Chunk{fib_ins, fib_consts, {}, ChunkAddressInfo{}};
 
     // ---------------- main ----------------
 
@@ -80,16 +76,21 @@ int main()
         {OpCode::RETURN},
     };
 
-    std::vector<Object> main_consts{
-        Object((int64_t)251), // 0
-        Object(Function(&fib_fn)),       // 1
-    };
-
-    Chunk main_chunk{main_ins, main_consts, {}, ChunkAddressInfo{}};
-
-    CompiledFunction main_fn{main_chunk, u8"main", 0, 0, false, 0, 0};
-
-    CallFrame entry{.ip = 0, .base = 0, .fn = main_fn};
+    std::vector<Object> main_consts;
+    main_consts.push_back(Object((int64_t)251));             // 0
+    main_consts.push_back(Object(Function(u8"fib", fib_fn))); // 1
+
+    CompiledFunction main_fn;
+    main_fn.chunk = Chunk{main_ins, main_consts, {}, ChunkAddressInfo{}};
+    main_fn.name = u8"main";
+    main_fn.posArgCount = 0;
+    main_fn.defArgCount = 0;
+    main_fn.variadicPara = false;
+    main_fn.localCount = 0;
+    main_fn.slotCount = 0;
+    main_fn.maxStack = 2;
+
+    CallFrame entry{.ip = 0, .base = 0, .fn = &main_fn};
 
     VirtualMachine vm(entry);
 
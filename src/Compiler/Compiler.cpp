@@ -0,0 +1,714 @@
+#include <Compiler/Compiler.hpp>
+#include <Module/builtins.hpp>
+
+namespace Fig
+{
+    void Compiler::error(const FString &msg, Ast::AstBase ast)
+    {
+        Ast::AstAddressInfo aai = (ast ? ast->getAAI() : currentAAI);
+        throw CompileError(msg, aai.line, aai.column, sourcePath, sourceLines);
+    }
+
+    int64_t Compiler::stackEffect(OpCode code, int64_t operand)
+    {
+        switch (code)
+        {
+            case OpCode::LOAD_LOCAL:
+            case OpCode::LOAD_CONST:
+            case OpCode::LOAD_GLOBAL:
+            case OpCode::DUP: return 1;
+
+            case OpCode::RETURN:
+            case OpCode::STORE_LOCAL:
+            case OpCode::STORE_GLOBAL:
+            case OpCode::POP:
+            case OpCode::JUMP_IF_FALSE:
+            case OpCode::LT:
+            case OpCode::LTET:
+            case OpCode::GT:
+            case OpCode::GTET:
+            case OpCode::EQ:
+            case OpCode::NEQ:
+            case OpCode::ADD:
+            case OpCode::SUB:
+            case OpCode::MUL:
+            case OpCode::DIV:
+            case OpCode::MOD: return -1;
+
+            case OpCode::CALL: return -operand; // args and callee -> result
+            case OpCode::CALL_CONST:
+            case OpCode::CALL_GLOBAL: return 1 - static_cast<int64_t>(callArgCount(operand)); // args -> result
+
+            default: return 0; // HALT, NOT, NEG, JUMP
+        }
+    }
+
+    size_t Compiler::emit(OpCode code, int64_t operand)
+    {
+        Chunk &c = chunk();
+        c.ins.emplace_back(code, operand);
+        c.instructions_addr.push_back(InstructionAddressInfo{currentAAI.line, currentAAI.column});
+
+        FunctionState &state = current();
+        state.stackDepth += stackEffect(code, operand);
+        if (state.stackDepth > static_cast<int64_t>(state.maxStack))
+        {
+            state.maxStack = static_cast<uint64_t>(state.stackDepth);
+        }
+        return c.ins.size() - 1;
+    }
+
+    size_t Compiler::emitJump(OpCode code)
+    {
+        return emit(code, 0); // offset patched later
+    }
+
+    void Compiler::patchJump(size_t at)
+    {
+        // VM adds offset after ip moved past the jump
+        Instructions &ins = chunk().ins;
+        ins[at].operand = static_cast<int64_t>(ins.size()) - static_cast<int64_t>(at) - 1;
+    }
+
+    void Compiler::emitLoop(size_t loopStart)
+    {
+        int64_t here = static_cast<int64_t>(chunk().ins.size());
+        emit(OpCode::JUMP, static_cast<int64_t>(loopStart) - (here + 1));
+    }
+
+    uint64_t Compiler::addConstant(const Object &value)
+    {
+        std::vector<Object> &constants = chunk().constants;
+        constants.push_back(value);
+        return constants.size() - 1;
+    }
+
+    uint64_t Compiler::selfConstant(size_t depth)
+    {
+        auto [it, inserted] = current().selfConstants.try_emplace(depth, 0);
+        if (inserted)
+        {
+            // aliasing an empty owner: no reference count. the function is owned by the constant that defines it
+            // in the enclosing chunk, which outlives every frame of it
+            const FunctionState &state = states[depth];
+            std::shared_ptr<const CompiledFunction> handle(std::shared_ptr<void>(), state.fn.get());
+            it->second = addConstant(Object(Function(state.selfName, std::move(handle))));
+        }
+        return it->second;
+    }
+
+    uint64_t Compiler::declareLocal(const FString &name)
+    {
+        FunctionState &state = current();
+        auto &scope = state.scopes.back();
+        auto it = scope.find(name);
+        if (it != scope.end()) { return it->second; } // if/else branches may define the same name
+        uint64_t slot = state.slotCount++;
+        scope[name] = slot;
+        return slot;
+    }
+
+    bool Compiler::isVariable(const FString &name) const
+    {
+        for (const FunctionState &state : states)
+        {
+            for (const auto &scope : state.scopes)
+            {
+                if (scope.contains(name)) return true;
+            }
+            if (state.selfName == name) return true;
+        }
+        return globals.contains(name);
+    }
+
+    void Compiler::emitLoad(const FString &name, Ast::AstBase ast)
+    {
+        // innermost function first: its locals, then its own name, then the function around it.
+        // top level block locals (states.front()) are locals of <main>, capturing them is an error too
+        for (size_t depth = states.size(); depth-- > 0;)
+        {
+            FunctionState &state = states[depth];
+            for (auto it = state.scopes.rbegin(); it != state.scopes.rend(); ++it)
+            {
+                auto nit = it->find(name);
+                if (nit == it->end()) continue;
+                if (depth + 1 == states.size())
+                {
+                    emit(OpCode::LOAD_LOCAL, static_cast<int64_t>(nit->second));
+                    return;
+                }
+                error(FString(std::format("Capturing local `{}` of enclosing function is not supported on VM",
+                                          name.toBasicString())),
+                      ast);
+            }
+            if (state.selfName == name)
+            {
+                // the function object itself, no slot of the enclosing frame involved
+                emit(OpCode::LOAD_CONST, static_cast<int64_t>(selfConstant(depth)));
+                return;
+            }
+        }
+        if (auto git = globals.find(name); git != globals.end())
+        {
+            emit(OpCode::LOAD_GLOBAL, static_cast<int64_t>(git->second));
+            return;
+        }
+        if (auto iit = imported.find(name); iit != imported.end())
+        {
+            emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(iit->second)));
+            return;
+        }
+        if (Builtins::isBuiltinFunction(name))
+        {
+            Function f(name, Builtins::getBuiltinFunction(name), Builtins::getBuiltinFunctionParamCount(name));
+            emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(Object(f))));
+            return;
+        }
+        const auto &builtinValues = Builtins::getBuiltinValues();
+        if (auto bit = builtinValues.find(name); bit != builtinValues.end())
+        {
+            emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(*bit->second)));
+            return;
+        }
+        if (modules.contains(name))
+        {
+            error(FString(std::format("Module `{}` is not a value on VM, use its members", name.toBasicString())),
+                  ast);
+        }
+        error(FString(std::format("Use of undeclared identifier `{}`", name.toBasicString())), ast);
+    }
+
+    void Compiler::emitStore(const FString &name, Ast::AstBase ast)
+    {
+        for (size_t depth = states.size(); depth-- > 0;)
+        {
+            FunctionState &state = states[depth];
+            for (auto it = state.scopes.rbegin(); it != state.scopes.rend(); ++it)
+            {
+                auto nit = it->find(name);
+                if (nit == it->end()) continue;
+                if (depth + 1 == states.size())
+                {
+                    emit(OpCode::STORE_LOCAL, static_cast<int64_t>(nit->second));
+                    return;
+                }
+                error(FString(std::format("Assignment to captured variable `{}` is not supported on VM",
+                                          name.toBasicString())),
+                      ast);
+            }
+            if (state.selfName == name)
+            {
+                error(FString(std::format("Assignment to captured variable `{}` is not supported on VM",
+                                          name.toBasicString())),
+                      ast);
+            }
+        }
+        if (auto git = globals.find(name); git != globals.end())
+        {
+            emit(OpCode::STORE_GLOBAL, static_cast<int64_t>(git->second));
+            return;
+        }
+        error(FString(std::format("Assignment to undeclared variable `{}`", name.toBasicString())), ast);
+    }
+
+    void Compiler::hoist(const std::vector<Ast::Statement> &stmts)
+    {
+        // top level: every defined name gets its global slot before any body is compiled,
+        // so functions may call functions defined later
+        using enum Ast::AstType;
+        for (const auto &stmt : stmts)
+        {
+            FString name;
+            switch (stmt->getType())
+            {
+                case VarDefSt: name = static_cast<Ast::VarDefAst *>(stmt)->name; break;
+                case FunctionDefSt: name = static_cast<Ast::FunctionDefSt *>(stmt)->name; break;
+                case IfSt: {
+                    auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                    hoist(ifSt->body->stmts);
+                    for (const auto &elif : ifSt->elifs) { hoist(elif->body->stmts); }
+                    if (ifSt->els) { hoist(ifSt->els->body->stmts); }
+                    continue;
+                }
+                default: continue;
+            }
+            if (!globals.contains(name)) { globals[name] = globals.size(); }
+        }
+    }
+
+    std::shared_ptr<CompiledFunction> Compiler::compileFunction(const FString &name,
+                                                                const Ast::FunctionParameters &paras,
+                                                                const std::vector<Ast::Statement> &body,
+                                                                bool local,
+                                                                Ast::AstBase ast)
+    {
+        if (paras.variadic || !paras.defParas.empty())
+        {
+            error(FString(std::format("Function `{}`: default and variadic parameters are not supported on VM",
+                                      name.toBasicString())),
+                  ast);
+        }
+
+        auto fn = std::make_shared<CompiledFunction>();
+        fn->name = name;
+        fn->chunk.addr = ChunkAddressInfo{sourcePath, sourceLines};
+
+        states.push_back(FunctionState{
+            fn, std::vector<std::unordered_map<FString, uint64_t>>(1), 0, {}, (local ? name : FString())});
+        for (const auto &[paraName, _] : paras.posParas) { declareLocal(paraName); } // slot 0..n-1
+
+        for (const auto &stmt : body) { compileStatement(stmt); }
+        emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(*Object::getNullInstance())));
+        emit(OpCode::RETURN);
+
+        fn->posArgCount = paras.posParas.size();
+        fn->defArgCount = 0;
+        fn->variadicPara = false;
+        fn->slotCount = current().slotCount;
+        fn->localCount = fn->slotCount - fn->posArgCount;
+        fn->maxStack = current().maxStack;
+
+        states.pop_back();
+        return fn;
+    }
+
+    void Compiler::compileBlock(const std::vector<Ast::Statement> &stmts)
+    {
+        current().scopes.emplace_back();
+        for (const auto &stmt : stmts) { compileStatement(stmt); }
+        current().scopes.pop_back();
+    }
+
+    void Compiler::compileStatement(const Ast::Statement &stmt)
+    {
+        if (!stmt) return;
+        currentAAI = stmt->getAAI();
+
+        using enum Ast::AstType;
+        switch (stmt->getType())
+        {
+            case VarDefSt: {
+                auto varDef = static_cast<Ast::VarDefAst *>(stmt);
+                if (varDef->expr) { compileExpression(varDef->expr); }
+                else
+                {
+                    // `var a: Int;` -> type default value, same as Evaluator
+                    Object init = *Object::getNullInstance();
+                    if (varDef->declaredType && varDef->declaredType->getType() == VarExpr)
+                    {
+                        const FString &typeName = static_cast<Ast::VarExprAst *>(varDef->declaredType)->name;
+                        const auto &builtinValues = Builtins::getBuiltinValues();
+                        auto it = builtinValues.find(typeName);
+                        if (it != builtinValues.end() && it->second->is<StructType>())
+                        {
+                            init = Object::defaultValue(it->second->as<StructType>().type);
+                        }
+                    }
+                    emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(init)));
+                }
+                if (!isTopLevel()) { declareLocal(varDef->name); } // after init: `var x := x` reads the outer one
+                emitStore(varDef->name, stmt);
+                break;
+            }
+            case FunctionDefSt: {
+                auto fnDef = static_cast<Ast::FunctionDefSt *>(stmt);
+                bool local = !isTopLevel();
+                if (local) { declareLocal(fnDef->name); }
+
+                auto fn = compileFunction(fnDef->name, fnDef->paras, fnDef->body->stmts, local, stmt);
+                currentAAI = stmt->getAAI();
+                emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(Object(Function(fnDef->name, fn)))));
+                emitStore(fnDef->name, stmt);
+                break;
+            }
+            case IfSt: {
+                // if bodies share the enclosing scope, same as Evaluator
+                auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                std::vector<size_t> exits;
+
+                compileExpression(ifSt->condition);
+                size_t next = emitJump(OpCode::JUMP_IF_FALSE);
+                for (const auto &st : ifSt->body->stmts) { compileStatement(st); }
+                exits.push_back(emitJump(OpCode::JUMP));
+                patchJump(next);
+
+                for (const auto &elif : ifSt->elifs)
+                {
+                    currentAAI = elif->getAAI();
+                    compileExpression(elif->condition);
+                    next = emitJump(OpCode::JUMP_IF_FALSE);
+                    for (const auto &st : elif->body->stmts) { compileStatement(st); }
+                    exits.push_back(emitJump(OpCode::JUMP));
+                    patchJump(next);
+                }
+                if (ifSt->els)
+                {
+                    for (const auto &st : ifSt->els->body->stmts) { compileStatement(st); }
+                }
+                for (size_t at : exits) { patchJump(at); }
+                break;
+            }
+            case WhileSt: {
+                auto whileSt = static_cast<Ast::WhileSt *>(stmt);
+
+                size_t loopStart = chunk().ins.size();
+                compileExpression(whileSt->condition);
+                size_t exit = emitJump(OpCode::JUMP_IF_FALSE);
+
+                current().loops.emplace_back();
+                compileBlock(whileSt->body->stmts);
+                Loop loop = std::move(current().loops.back());
+                current().loops.pop_back();
+
+                for (size_t at : loop.continues) // -> condition
+                {
+                    chunk().ins[at].operand = static_cast<int64_t>(loopStart) - static_cast<int64_t>(at) - 1;
+                }
+                emitLoop(loopStart);
+                patchJump(exit);
+                for (size_t at : loop.breaks) { patchJump(at); }
+                break;
+            }
+            case ForSt: {
+                auto forSt = static_cast<Ast::ForSt *>(stmt);
+
+                current().scopes.emplace_back(); // loop scope: init, condition, increment
+                if (forSt->initSt) { compileStatement(forSt->initSt); }
+
+                size_t loopStart = chunk().ins.size();
+                size_t exit = 0;
+                bool hasCondition = static_cast<bool>(forSt->condition);
+                if (hasCondition)
+                {
+                    compileExpression(forSt->condition);
+                    exit = emitJump(OpCode::JUMP_IF_FALSE);
+                }
+
+                current().loops.emplace_back();
+                compileBlock(forSt->body->stmts);
+                Loop loop = std::move(current().loops.back());
+                current().loops.pop_back();
+
+                for (size_t at : loop.continues) { patchJump(at); } // -> increment
+                compileStatement(forSt->incrementSt);
+                emitLoop(loopStart);
+
+                if (hasCondition) { patchJump(exit); }
+                for (size_t at : loop.breaks) { patchJump(at); }
+                current().scopes.pop_back();
+                break;
+            }
+            case BreakSt: {
+                if (current().loops.empty()) { error(u8"`break` outside of loop", stmt); }
+                size_t at = emitJump(OpCode::JUMP);
+                current().loops.back().breaks.push_back(at);
+                break;
+            }
+            case ContinueSt: {
+                if (current().loops.empty()) { error(u8"`continue` outside of loop", stmt); }
+                size_t at = emitJump(OpCode::JUMP);
+                current().loops.back().continues.push_back(at);
+                break;
+            }
+            case ReturnSt: {
+                auto ret = static_cast<Ast::ReturnSt *>(stmt);
+                if (ret->retValue) { compileExpression(ret->retValue); }
+                else
+                {
+                    emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(*Object::getNullInstance())));
+                }
+                emit(OpCode::RETURN);
+                break;
+            }
+            case BlockStatement: {
+                compileBlock(static_cast<Ast::BlockStatementAst *>(stmt)->stmts);
+                break;
+            }
+            case ExpressionStmt: {
+                compileExpression(static_cast<Ast::ExpressionStmtAst *>(stmt)->exp);
+                emit(OpCode::POP);
+                break;
+            }
+            case ImportSt: {
+                compileImport(static_cast<Ast::ImportSt *>(stmt));
+                break;
+            }
+            default:
+                error(FString(std::format("Statement `{}` is not supported on VM yet", stmt->typeName().toBasicString())),
+                      stmt);
+        }
+    }
+
+    const std::unordered_map<FString, Compiler::NativeModule> &Compiler::nativeModules()
+    {
+        using Args = std::vector<Value>;
+
+        // Library/std/io/io.fig: arguments separated by one space
+        static const auto printSpaced = [](const Args &args, bool newline) {
+            static const Value space(Object(FString(u8" ")));
+            static const Value lineFeed(Object(FString(u8"\n")));
+            Args out;
+            out.reserve(args.size() * 2 + 1);
+            for (size_t i = 0; i < args.size(); ++i)
+            {
+                if (i > 0) out.push_back(space);
+                out.push_back(args[i]);
+            }
+            if (newline) out.push_back(lineFeed);
+            Builtins::getBuiltinFunction(u8"__fstdout_print")(out);
+            return Value::Int(static_cast<ValueType::IntClass>(args.size() + (newline ? 1 : 0)));
+        };
+        auto builtin = [](const FString &name, const FString &builtinName) {
+            return Object(Function(name,
+                                   Builtins::getBuiltinFunction(builtinName),
+                                   Builtins::getBuiltinFunctionParamCount(builtinName)));
+        };
+
+        static const std::unordered_map<FString, NativeModule> modules{
+            {u8"std.io",
+             {
+                 {u8"print",
+                  Object(Function(u8"print", [](const Args &args) { return printSpaced(args, false); }, -1))},
+                 {u8"println",
+                  Object(Function(u8"println", [](const Args &args) { return printSpaced(args, true); }, -1))},
+                 {u8"flush", builtin(u8"flush", u8"__fstdout_flush")},
+                 {u8"read", builtin(u8"read", u8"__fstdin_read")},
+                 {u8"readln", builtin(u8"readln", u8"__fstdin_readln")},
+             }},
+        };
+        return modules;
+    }
+
+    void Compiler::compileImport(const Ast::Import &imp)
+    {
+        if (imp->path.back() == u8"_builtins") { return; } // builtin functions are resolved by name
+
+        FString path;
+        for (const FString &part : imp->path)
+        {
+            if (!path.empty()) path += u8".";
+            path += part;
+        }
+        const auto &natives = nativeModules();
+        auto it = natives.find(path);
+        if (it == natives.end())
+        {
+            error(FString(std::format("Importing module `{}` is not supported on VM yet", path.toBasicString())), imp);
+        }
+        const NativeModule &module = it->second;
+
+        if (!imp->names.empty())
+        {
+            for (const FString &name : imp->names)
+            {
+                auto mit = module.find(name);
+                if (mit == module.end())
+                {
+                    error(FString(std::format("Module `{}` has no member `{}` on VM",
+                                              path.toBasicString(),
+                                              name.toBasicString())),
+                          imp);
+                }
+                imported.insert_or_assign(name, mit->second);
+            }
+            return;
+        }
+        modules[(imp->rename.empty() ? imp->path.back() : imp->rename)] = &module;
+    }
+
+    void Compiler::compileBinary(const Ast::BinaryExpr &bin)
+    {
+        using Ast::Operator;
+
+        static const std::unordered_map<Operator, OpCode> arithmetic{
+            {Operator::Add, OpCode::ADD},
+            {Operator::Subtract, OpCode::SUB},
+            {Operator::Multiply, OpCode::MUL},
+            {Operator::Divide, OpCode::DIV},
+            {Operator::Modulo, OpCode::MOD},
+            {Operator::Less, OpCode::LT},
+            {Operator::LessEqual, OpCode::LTET},
+            {Operator::Greater, OpCode::GT},
+            {Operator::GreaterEqual, OpCode::GTET},
+            {Operator::Equal, OpCode::EQ},
+            {Operator::NotEqual, OpCode::NEQ},
+        };
+        static const std::unordered_map<Operator, OpCode> compound{
+            {Operator::PlusAssign, OpCode::ADD},
+            {Operator::MinusAssign, OpCode::SUB},
+            {Operator::AsteriskAssign, OpCode::MUL},
+            {Operator::SlashAssign, OpCode::DIV},
+            {Operator::PercentAssign, OpCode::MOD},
+        };
+
+        Operator op = bin->op;
+        if (auto it = arithmetic.find(op); it != arithmetic.end())
+        {
+            compileExpression(bin->lexp);
+            compileExpression(bin->rexp);
+            emit(it->second);
+            return;
+        }
+
+        if (op == Operator::And || op == Operator::Or)
+        {
+            // short circuit
+            compileExpression(bin->lexp);
+            if (op == Operator::Or) { emit(OpCode::NOT); }
+            size_t shortCircuit = emitJump(OpCode::JUMP_IF_FALSE);
+            int64_t depth = current().stackDepth;
+            compileExpression(bin->rexp);
+            size_t end = emitJump(OpCode::JUMP);
+            patchJump(shortCircuit);
+            current().stackDepth = depth; // rexp's value isn't there on this path
+            emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(Object(op == Operator::Or))));
+            patchJump(end);
+            return;
+        }
+
+        if (op == Operator::Assign || compound.contains(op))
+        {
+            if (bin->lexp->getType() != Ast::AstType::VarExpr)
+            {
+                error(u8"Only variables can be assigned on VM yet", bin->lexp);
+            }
+            const FString &name = static_cast<Ast::VarExprAst *>(bin->lexp)->name;
+            if (op != Operator::Assign) { emitLoad(name, bin->lexp); }
+            compileExpression(bin->rexp);
+            if (op != Operator::Assign) { emit(compound.at(op)); }
+            emit(OpCode::DUP); // assignment is an expression
+            emitStore(name, bin->lexp);
+            return;
+        }
+
+        error(FString(std::format("Operator `{}` is not supported on VM yet", magic_enum::enum_name(op))), bin);
+    }
+
+    void Compiler::compileExpression(const Ast::Expression &exp)
+    {
+        currentAAI = exp->getAAI();
+
+        using enum Ast::AstType;
+        switch (exp->getType())
+        {
+            case ValueExpr: {
+                auto val = static_cast<Ast::ValueExprAst *>(exp);
+                emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(*val->val)));
+                break;
+            }
+            case VarExpr: emitLoad(static_cast<Ast::VarExprAst *>(exp)->name, exp); break;
+            case MemberExpr: {
+                // only members of native modules: `io.println`
+                auto me = static_cast<Ast::MemberExprAst *>(exp);
+                if (me->base->getType() == VarExpr)
+                {
+                    const FString &base = static_cast<Ast::VarExprAst *>(me->base)->name;
+                    auto mit = modules.find(base);
+                    if (mit != modules.end() && !isVariable(base))
+                    {
+                        auto it = mit->second->find(me->member);
+                        if (it == mit->second->end())
+                        {
+                            error(FString(std::format("Module `{}` has no member `{}` on VM",
+                                                      base.toBasicString(),
+                                                      me->member.toBasicString())),
+                                  exp);
+                        }
+                        emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(it->second)));
+                        break;
+                    }
+                }
+                error(u8"Member access is only supported on native modules on VM yet", exp);
+            }
+            case BinaryExpr: compileBinary(static_cast<Ast::BinaryExprAst *>(exp)); break;
+            case UnaryExpr: {
+                auto un = static_cast<Ast::UnaryExprAst *>(exp);
+                compileExpression(un->exp);
+                if (un->op == Ast::Operator::Not) { emit(OpCode::NOT); }
+                else if (un->op == Ast::Operator::Subtract) { emit(OpCode::NEG); }
+                else
+                {
+                    error(FString(std::format("Unary operator `{}` is not supported on VM yet",
+                                              magic_enum::enum_name(un->op))),
+                          exp);
+                }
+                break;
+            }
+            case TernaryExpr: {
+                auto te = static_cast<Ast::TernaryExprAst *>(exp);
+                compileExpression(te->condition);
+                size_t elseJump = emitJump(OpCode::JUMP_IF_FALSE);
+                int64_t depth = current().stackDepth;
+                compileExpression(te->valueT);
+                size_t end = emitJump(OpCode::JUMP);
+                patchJump(elseJump);
+                current().stackDepth = depth; // valueT's value isn't there on this path
+                compileExpression(te->valueF);
+                patchJump(end);
+                break;
+            }
+            case FunctionCall: {
+                // stack: args..., callee -> CALL argc
+                auto call = static_cast<Ast::FunctionCallExpr *>(exp);
+                uint64_t argCount = call->arg.getLength();
+                for (const auto &arg : call->arg.argv) { compileExpression(arg); }
+                compileExpression(call->callee);
+                currentAAI = exp->getAAI();
+
+                // a name (or native module member) loaded by one LOAD_CONST / LOAD_GLOBAL: the VM calls it where
+                // it is, without copying the Function onto the stack
+                Ast::AstType calleeType = call->callee->getType();
+                Chunk &c = chunk();
+                const Instruction &load = c.ins.back();
+                if ((calleeType == Ast::AstType::VarExpr || calleeType == Ast::AstType::MemberExpr)
+                    && (load.code == OpCode::LOAD_CONST || load.code == OpCode::LOAD_GLOBAL))
+                {
+                    OpCode fused = (load.code == OpCode::LOAD_CONST ? OpCode::CALL_CONST : OpCode::CALL_GLOBAL);
+                    uint64_t index = static_cast<uint64_t>(load.operand);
+                    c.ins.pop_back();
+                    c.instructions_addr.pop_back();
+                    current().stackDepth -= 1;
+                    emit(fused, packCall(index, argCount));
+                    break;
+                }
+                emit(OpCode::CALL, static_cast<int64_t>(argCount));
+                break;
+            }
+            default:
+                error(FString(std::format("Expression `{}` is not supported on VM yet", exp->typeName().toBasicString())),
+                      exp);
+        }
+    }
+
+    std::shared_ptr<CompiledFunction> Compiler::compile(const std::vector<Ast::AstBase> &asts)
+    {
+        globals.clear();
+        states.clear();
+        modules.clear();
+        imported.clear();
+
+        std::vector<Ast::Statement> stmts;
+        stmts.reserve(asts.size());
+        for (const auto &ast : asts) { stmts.push_back(static_cast<Ast::StatementAst *>(ast)); }
+
+        auto mainFn = std::make_shared<CompiledFunction>();
+        mainFn->name = u8"<main>";
+        mainFn->chunk.addr = ChunkAddressInfo{sourcePath, sourceLines};
+        states.push_back(FunctionState{mainFn, std::vector<std::unordered_map<FString, uint64_t>>(1), 0, {}});
+
+        hoist(stmts);
+        for (const auto &stmt : stmts) { compileStatement(stmt); }
+        emit(OpCode::LOAD_CONST, static_cast<int64_t>(addConstant(*Object::getNullInstance())));
+        emit(OpCode::RETURN);
+
+        mainFn->posArgCount = 0;
+        mainFn->defArgCount = 0;
+        mainFn->variadicPara = false;
+        mainFn->slotCount = current().slotCount; // block locals of top level code
+        mainFn->localCount = mainFn->slotCount;
+        mainFn->maxStack = current().maxStack;
+
+        states.clear();
+        return mainFn;
+    }
+}; // namespace Fig
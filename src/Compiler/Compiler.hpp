@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Ast/ast.hpp>
+#include <Bytecode/Chunk.hpp>
+#include <Bytecode/CompiledFunction.hpp>
+#include <Bytecode/CompileError.hpp>
+#include <Bytecode/Instruction.hpp>
+#include <Core/fig_string.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        Compiler
+        lowers parsed AST to Chunks for VirtualMachine (`--vm`)
+
+        top level names      -> global slots (LOAD_GLOBAL / STORE_GLOBAL)
+        names in a function  -> local slots of its frame, parameters first
+        blocks only scope names at compile time, every local of a function owns one slot
+
+        supported: var, func (positional parameters, no capture of enclosing function locals: a local function
+        may still call itself), if / while / for, return / break / continue, calls, unary / binary / ternary
+        operators, builtin functions (`import _builtins`) and the native modules below (`import std.io; io.println`)
+        anything else is a CompileError. type annotations are not checked on the VM
+
+        a native module is a fixed table of builtin Functions standing in for a library module, its members are
+        resolved at compile time: `io.println` is a constant, the module itself is not a value on the VM
+    */
+    class Compiler
+    {
+    private:
+        struct Loop
+        {
+            std::vector<size_t> breaks;    // JUMPs patched to loop end
+            std::vector<size_t> continues; // JUMPs patched to condition / increment
+        };
+
+        struct FunctionState
+        {
+            std::shared_ptr<CompiledFunction> fn;
+            std::vector<std::unordered_map<FString, uint64_t>> scopes; // name -> local slot
+            uint64_t slotCount = 0;
+            std::vector<Loop> loops;
+            FString selfName; // a local function's own name, loaded as a constant instead of captured
+
+            // constant index in this chunk of the function states[depth] named by selfName, by depth. one per
+            // function, holding it without ownership: a constant owning its own function (or one around it) would
+            // be a reference cycle through the pool
+            std::unordered_map<size_t, uint64_t> selfConstants;
+
+            // operand stack depth above the slots after the last emitted instruction, and its maximum.
+            // branches that join again (?:, &&, ||) reset it to the depth at the split
+            int64_t stackDepth = 0;
+            uint64_t maxStack = 0;
+        };
+
+        using NativeModule = std::unordered_map<FString, Object>; // member name -> builtin Function
+
+        FString sourcePath;
+        std::vector<FString> sourceLines;
+
+        std::unordered_map<FString, uint64_t> globals; // name -> global slot
+        std::vector<FunctionState> states;             // states.front(): top level <main>
+
+        std::unordered_map<FString, const NativeModule *> modules; // imported name (`io`) -> its members
+        std::unordered_map<FString, Object> imported;              // `import std.io {println}` names
+
+        // `std.io` -> members
+        static const std::unordered_map<FString, NativeModule> &nativeModules();
+
+        Ast::AstAddressInfo currentAAI;
+
+        FunctionState &current() { return states.back(); }
+        Chunk &chunk() { return current().fn->chunk; }
+        bool isTopLevel() const { return states.size() == 1 && states.back().scopes.size() == 1; }
+
+        [[noreturn]] void error(const FString &msg, Ast::AstBase ast);
+
+        static int64_t stackEffect(OpCode code, int64_t operand);
+        size_t emit(OpCode code, int64_t operand = 0);
+        size_t emitJump(OpCode code);
+        void patchJump(size_t at);
+        void emitLoop(size_t loopStart);
+        uint64_t addConstant(const Object &value);
+        uint64_t selfConstant(size_t depth); // see FunctionState::selfConstants
+
+        uint64_t declareLocal(const FString &name);
+        bool isVariable(const FString &name) const; // local of any enclosing function or global
+        void emitLoad(const FString &name, Ast::AstBase ast);
+        void emitStore(const FString &name, Ast::AstBase ast);
+
+        void hoist(const std::vector<Ast::Statement> &stmts);
+
+        std::shared_ptr<CompiledFunction> compileFunction(const FString &name,
+                                                          const Ast::FunctionParameters &paras,
+                                                          const std::vector<Ast::Statement> &body,
+                                                          bool local,
+                                                          Ast::AstBase ast);
+        void compileBlock(const std::vector<Ast::Statement> &stmts);
+        void compileStatement(const Ast::Statement &stmt);
+        void compileExpression(const Ast::Expression &exp);
+        void compileBinary(const Ast::BinaryExpr &bin);
+        void compileImport(const Ast::Import &imp);
+
+    public:
+        Compiler(FString _sourcePath, std::vector<FString> _sourceLines) :
+            sourcePath(std::move(_sourcePath)), sourceLines(std::move(_sourceLines))
+        {
+        }
+
+        // compile a whole script, returns the entry function
+        std::shared_ptr<CompiledFunction> compile(const std::vector<Ast::AstBase> &asts);
+
+        uint64_t getGlobalCount() const { return globals.size(); }
+    };
+}; // namespace Fig
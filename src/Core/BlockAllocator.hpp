@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        BlockAllocator
+        fixed-size block free list, for std::allocate_shared / shared_ptr control blocks
+
+        single-block allocations are kept (up to MaxFree) and handed back to the next allocate,
+        one free list per rebound type. interpreter is single threaded, no locking
+    */
+    template <class T, size_t MaxFree = 256>
+    struct BlockAllocator
+    {
+        using value_type = T;
+
+        template <class U>
+        struct rebind
+        {
+            using other = BlockAllocator<U, MaxFree>;
+        };
+
+        BlockAllocator() = default;
+        template <class U>
+        BlockAllocator(const BlockAllocator<U, MaxFree> &)
+        {
+        }
+
+        static std::vector<void *> &freeBlocks()
+        {
+            static std::vector<void *> *blocks = new std::vector<void *>(); // never destroyed
+            return *blocks;
+        }
+
+        T *allocate(size_t n)
+        {
+            auto &blocks = freeBlocks();
+            if (n == 1 && !blocks.empty())
+            {
+                void *p = blocks.back();
+                blocks.pop_back();
+                return static_cast<T *>(p);
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t n)
+        {
+            auto &blocks = freeBlocks();
+            if (n == 1 && blocks.size() < MaxFree)
+            {
+                blocks.push_back(p);
+                return;
+            }
+            ::operator delete(p);
+        }
+
+        template <class U>
+        bool operator==(const BlockAllocator<U, MaxFree> &) const
+        {
+            return true;
+        }
+    };
+}; // namespace Fig
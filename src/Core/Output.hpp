@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Core/String.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace Fig
+{
+    /*
+        Output
+        buffered writer for the script's stdout, the only thing print / println write through
+
+        bytes collect in a BufferSize buffer and reach the FILE* in one fwrite when it fills, on flush(),
+        before a read from stdin, before an error report and at exit. on a terminal it also flushes at
+        '\n' so interactive output still shows line by line.
+        it is string-like (value_type / append / push_back), String::appendUTF8 encodes straight into it
+    */
+    class Output
+    {
+    private:
+        static constexpr size_t BufferSize = 64 * 1024;
+
+        std::FILE *fp;
+        std::unique_ptr<char[]> buffer;
+        size_t used = 0;
+        bool lineBuffered;
+
+        explicit Output(std::FILE *_fp) : fp(_fp), buffer(new char[BufferSize])
+        {
+#ifdef _WIN32
+            lineBuffered = _isatty(_fileno(fp));
+#else
+            lineBuffered = ::isatty(::fileno(fp));
+#endif
+        }
+
+        void drain()
+        {
+            if (used != 0) std::fwrite(buffer.get(), 1, used, fp);
+            used = 0;
+        }
+
+    public:
+        using value_type = char;
+
+        Output(const Output &) = delete;
+        Output &operator=(const Output &) = delete;
+
+        ~Output() { flush(); } // exit, std::exit included
+
+        static Output &stdOut()
+        {
+            static Output out(stdout);
+            return out;
+        }
+
+        void flush()
+        {
+            drain();
+            std::fflush(fp);
+        }
+
+        void write(std::string_view bytes)
+        {
+            if (bytes.size() > BufferSize - used)
+            {
+                drain();
+                if (bytes.size() >= BufferSize) // would only be copied to be written right away
+                {
+                    std::fwrite(bytes.data(), 1, bytes.size(), fp);
+                    if (lineBuffered) std::fflush(fp);
+                    return;
+                }
+            }
+            std::memcpy(buffer.get() + used, bytes.data(), bytes.size());
+            used += bytes.size();
+            if (lineBuffered && std::memchr(bytes.data(), '\n', bytes.size()) != nullptr) flush();
+        }
+
+        void push_back(char c)
+        {
+            if (used == BufferSize) drain();
+            buffer[used++] = c;
+            if (lineBuffered && c == '\n') flush();
+        }
+
+        void append(const char *first, const char *last) { write(std::string_view(first, last - first)); }
+
+        void writeString(const String &str)
+        {
+            if (str.isAscii()) { write(str.asciiView()); }
+            else
+            {
+                str.appendUTF8(*this);
+            }
+        }
+
+        void writeInt(int64_t value)
+        {
+            char digits[24];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            write(std::string_view(digits, end - digits));
+        }
+
+        // shortest round-trip form, the same text std::format("{}", value) gives
+        void writeDouble(double value)
+        {
+            char digits[32];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            write(std::string_view(digits, end - digits));
+        }
+    };
+}; // namespace Fig
@@ -5,6 +5,9 @@
 #include <cassert>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <algorithm>
+#include <ostream>
 
 namespace Fig::StringClass::SizeFixed
 {
@@ -866,74 +869,60 @@ namespace Fig::StringClass::SizeFixed
 
 namespace Fig::StringClass::DynamicCapacity
 {
+    /*
+        String
+        code points are stored one per element, as bytes while the string is pure ASCII and as UTF-32 after
+        the first other code point: length() and indexing are O(1)
+
+        up to SSO_MAX_ASCII_LEN ASCII / SSO_MAX_UTF32_LEN UTF-32 code points live inline, longer strings on the heap,
+        growing by HEAP_GROW_FACTOR. UTF-8 is produced only at I/O boundaries (appendUTF8 / toBasicString),
+        ASCII strings expose their bytes directly (asciiView)
+
+        the hash is computed on first use and kept until the contents change (every mutator resets it)
+    */
     class String
     {
     private:
         static constexpr uint8_t SSO_SIZE = 32;
         static constexpr uint8_t SSO_MAX_ASCII_LEN = SSO_SIZE;
         static constexpr uint8_t SSO_MAX_UTF32_LEN = SSO_SIZE / 4;
-        static constexpr uint8_t DEFAULT_CAPACITY = SSO_MAX_ASCII_LEN;
         static constexpr uint64_t HEAP_GROW_FACTOR = 2;
 
-        bool is_heap;
-        bool is_ascii;
-        uint64_t _length;
-        uint64_t _capacity; // Only used in heap mode
+        bool is_heap = false;
+        bool is_ascii = true;
+        uint64_t _length = 0;
+        uint64_t _capacity = 0; // code points, heap mode only
+        mutable uint64_t _hash = 0; // 0: not computed yet
 
-        struct HeapBuffer
+        union
         {
-            unsigned char *ascii = nullptr;
-            char32_t *utf32 = nullptr;
-
-            HeapBuffer() = default;
-
-            // no copy!
-            HeapBuffer(const HeapBuffer &) = delete;
-            HeapBuffer &operator=(const HeapBuffer &) = delete;
-
-            // move is ok
-            HeapBuffer(HeapBuffer &&other) noexcept : ascii(other.ascii), utf32(other.utf32)
-            {
-                other.ascii = nullptr;
-                other.utf32 = nullptr;
-            }
-
-            HeapBuffer &operator=(HeapBuffer &&other) noexcept
+            union
             {
-                if (this != &other)
-                {
-                    delete[] ascii;
-                    delete[] utf32;
-                    ascii = other.ascii;
-                    utf32 = other.utf32;
-                    other.ascii = nullptr;
-                    other.utf32 = nullptr;
-                }
-                return *this;
-            }
+                unsigned char ascii[SSO_MAX_ASCII_LEN];
+                char32_t utf32[SSO_MAX_UTF32_LEN];
+            } sso;
 
-            ~HeapBuffer()
+            union
             {
-                delete[] ascii;
-                delete[] utf32;
-            }
+                unsigned char *ascii;
+                char32_t *utf32;
+            } heap;
         };
 
-        union
+        unsigned char *asciiData() { return is_heap ? heap.ascii : sso.ascii; }
+        const unsigned char *asciiData() const { return is_heap ? heap.ascii : sso.ascii; }
+        char32_t *utf32Data() { return is_heap ? heap.utf32 : sso.utf32; }
+        const char32_t *utf32Data() const { return is_heap ? heap.utf32 : sso.utf32; }
+
+        uint64_t storageCapacity() const
         {
-            struct
-            {
-                union
-                {
-                    unsigned char ascii[SSO_MAX_ASCII_LEN];
-                    char32_t utf32[SSO_MAX_UTF32_LEN];
-                };
-            } sso;
+            if (is_heap) return _capacity;
+            return is_ascii ? SSO_MAX_ASCII_LEN : SSO_MAX_UTF32_LEN;
+        }
 
-            HeapBuffer heap;
-        };
+        char32_t codePointAt(uint64_t idx) const { return is_ascii ? asciiData()[idx] : utf32Data()[idx]; }
 
-        void destroy_heap_memory()
+        void release()
         {
             if (is_heap)
             {
@@ -942,246 +931,183 @@ namespace Fig::StringClass::DynamicCapacity
                 else
                     delete[] heap.utf32;
             }
+            is_heap = false;
+            _capacity = 0;
         }
 
-        void destroy()
+        // empty SSO string in the given mode
+        void reset(bool ascii)
         {
-            destroy_heap_memory();
+            release();
+            is_ascii = ascii;
             _length = 0;
-            _capacity = 0;
-            is_heap = false;
-            is_ascii = true;
+            _hash = 0;
         }
 
         uint64_t calculate_growth_capacity(uint64_t min_capacity) const
         {
-            uint64_t new_capacity = _capacity > 0 ? _capacity : DEFAULT_CAPACITY;
+            uint64_t new_capacity = storageCapacity();
             while (new_capacity < min_capacity) new_capacity = (new_capacity + 1) * HEAP_GROW_FACTOR;
             return new_capacity;
         }
 
-        void ensure_capacity(uint64_t required_capacity)
+        // room for `required` code points in the current mode, contents kept
+        void ensure_capacity(uint64_t required)
         {
-            if (is_heap)
-            {
-                if (required_capacity <= _capacity) return;
+            if (required <= storageCapacity()) return;
 
-                uint64_t new_capacity = calculate_growth_capacity(required_capacity);
-                if (is_ascii)
-                {
-                    unsigned char *new_buffer = new unsigned char[new_capacity];
-                    std::memcpy(new_buffer, heap.ascii, _length);
-                    delete[] heap.ascii;
-                    heap.ascii = new_buffer;
-                }
-                else
-                {
-                    char32_t *new_buffer = new char32_t[new_capacity];
-                    std::memcpy(new_buffer, heap.utf32, _length * sizeof(char32_t));
-                    delete[] heap.utf32;
-                    heap.utf32 = new_buffer;
-                }
-                _capacity = new_capacity;
+            uint64_t new_capacity = calculate_growth_capacity(required);
+            if (is_ascii)
+            {
+                unsigned char *buffer = new unsigned char[new_capacity];
+                std::memcpy(buffer, asciiData(), _length);
+                release();
+                heap.ascii = buffer;
             }
             else
             {
-                uint64_t max_sso_capacity = is_ascii ? SSO_MAX_ASCII_LEN : SSO_MAX_UTF32_LEN;
-                if (required_capacity > max_sso_capacity)
-                {
-                    uint64_t new_capacity = calculate_growth_capacity(required_capacity);
-                    if (is_ascii)
-                    {
-                        unsigned char *new_buffer = new unsigned char[new_capacity];
-                        std::memcpy(new_buffer, sso.ascii, _length);
-                        heap.ascii = new_buffer;
-                    }
-                    else
-                    {
-                        char32_t *new_buffer = new char32_t[new_capacity];
-                        std::memcpy(new_buffer, sso.utf32, _length * sizeof(char32_t));
-                        heap.utf32 = new_buffer;
-                    }
-                    is_heap = true;
-                    _capacity = new_capacity;
-                }
+                char32_t *buffer = new char32_t[new_capacity];
+                std::memcpy(buffer, utf32Data(), _length * sizeof(char32_t));
+                release();
+                heap.utf32 = buffer;
             }
+            is_heap = true;
+            _capacity = new_capacity;
         }
 
-        void copy_from(const String &other)
+        // widen to UTF-32 with room for `required` code points
+        void convert_to_utf32_mode(uint64_t required)
         {
-            destroy();
-            is_ascii = other.is_ascii;
-            _length = other._length;
-            is_heap = other.is_heap;
-            _capacity = other._capacity;
-
-            if (is_heap)
+            if (!is_ascii)
             {
-                if (is_ascii)
-                {
-                    heap.ascii = new unsigned char[_capacity];
-                    std::memcpy(heap.ascii, other.is_heap ? other.heap.ascii : other.sso.ascii, _length);
-                }
-                else
-                {
-                    heap.utf32 = new char32_t[_capacity];
-                    std::memcpy(
-                        heap.utf32, other.is_heap ? other.heap.utf32 : other.sso.utf32, _length * sizeof(char32_t));
-                }
+                ensure_capacity(required);
+                return;
             }
-            else
+
+            uint64_t len = _length;
+            if (required <= SSO_MAX_UTF32_LEN && !is_heap)
             {
-                if (is_ascii)
-                    std::memcpy(sso.ascii, other.sso.ascii, _length);
-                else
-                    std::memcpy(sso.utf32, other.sso.utf32, _length * sizeof(char32_t));
+                char32_t tmp[SSO_MAX_UTF32_LEN];
+                for (uint64_t i = 0; i < len; ++i) tmp[i] = sso.ascii[i];
+                std::memcpy(sso.utf32, tmp, len * sizeof(char32_t));
+                is_ascii = false;
+                return;
             }
+
+            uint64_t new_capacity = calculate_growth_capacity(required);
+            char32_t *buffer = new char32_t[new_capacity];
+            const unsigned char *src = asciiData();
+            for (uint64_t i = 0; i < len; ++i) buffer[i] = src[i];
+            release();
+            is_ascii = false;
+            is_heap = true;
+            heap.utf32 = buffer;
+            _capacity = new_capacity;
+        }
+
+        void copy_from(const String &other)
+        {
+            reset(other.is_ascii);
+            ensure_capacity(other._length);
+            if (is_ascii)
+                std::memcpy(asciiData(), other.asciiData(), other._length);
+            else
+                std::memcpy(utf32Data(), other.utf32Data(), other._length * sizeof(char32_t));
+            _length = other._length;
+            _hash = other._hash;
         }
 
         void move_from(String &&other) noexcept
         {
-            destroy();
+            release();
             is_ascii = other.is_ascii;
-            _length = other._length;
             is_heap = other.is_heap;
+            _length = other._length;
             _capacity = other._capacity;
-
+            _hash = other._hash;
             if (is_heap)
-            {
-                heap = std::move(other.heap);
-            }
+                heap = other.heap;
             else
-            {
-                if (!is_ascii)
-                    std::memcpy(sso.utf32, other.sso.utf32, _length * sizeof(char32_t));
-                else
-                    std::memcpy(sso.ascii, other.sso.ascii, _length);
-            }
+                sso = other.sso;
 
-            other.destroy();
+            other.is_heap = false; // buffer moved
+            other.reset(true);
         }
 
-        void convert_to_utf32_mode()
+        // decodes one code point, invalid or truncated sequences become U+FFFD
+        static char32_t decodeUTF8(const unsigned char *p, uint64_t bytes, uint64_t &i)
         {
-            if (!is_ascii) return;
-            uint64_t len = _length;
-
-            if (is_heap)
+            unsigned char c = p[i];
+            uint64_t n = 1;
+            char32_t cp;
+            if (c <= 0x7F)
+                cp = c;
+            else if ((c & 0xE0) == 0xC0)
+                n = 2, cp = c & 0x1F;
+            else if ((c & 0xF0) == 0xE0)
+                n = 3, cp = c & 0x0F;
+            else if ((c & 0xF8) == 0xF0)
+                n = 4, cp = c & 0x07;
+            else
             {
-                unsigned char *old = heap.ascii;
-                heap.utf32 = new char32_t[_capacity];
-                for (uint64_t i = 0; i < len; ++i) heap.utf32[i] = old[i];
-                delete[] old;
+                ++i;
+                return 0xFFFD;
             }
-            else
+            if (i + n > bytes)
             {
-                char32_t tmp[SSO_MAX_UTF32_LEN];
-                for (uint64_t i = 0; i < len; ++i) tmp[i] = sso.ascii[i];
-                std::memcpy(sso.utf32, tmp, len * sizeof(char32_t));
+                i = bytes;
+                return 0xFFFD;
             }
-            is_ascii = false;
+            for (uint64_t k = 1; k < n; ++k) cp = (cp << 6) | (p[i + k] & 0x3F);
+            i += n;
+            return cp;
         }
 
-        void init_from_cstr(const char *cstr)
+        void init_from_utf8(const char *data, uint64_t bytes)
         {
-            assert(cstr);
-            is_ascii = isPureASCII(cstr);
-            uint64_t len = std::strlen(cstr);
-            _length = len;
-
-            if (is_ascii)
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+            uint64_t asciiPrefix = 0;
+            // 8 bytes per step while no high bit is set, then byte by byte to the exact position
+            for (uint64_t word; asciiPrefix + 8 <= bytes; asciiPrefix += 8)
             {
-                if (len <= SSO_MAX_ASCII_LEN)
-                {
-                    is_heap = false;
-                    _capacity = 0;
-                    std::memcpy(sso.ascii, cstr, len);
-                }
-                else
-                {
-                    is_heap = true;
-                    _capacity = len;
-                    heap.ascii = new unsigned char[_capacity];
-                    std::memcpy(heap.ascii, cstr, len);
-                }
+                std::memcpy(&word, p + asciiPrefix, 8);
+                if (word & 0x8080808080808080ull) break;
             }
-            else
-            {
-                uint64_t utf32_len = fixed_strlen(cstr);
-                _length = utf32_len;
+            while (asciiPrefix < bytes && p[asciiPrefix] <= 0x7F) ++asciiPrefix;
 
-                if (utf32_len <= SSO_MAX_UTF32_LEN)
-                {
-                    is_heap = false;
-                    _capacity = 0;
-                    uint64_t idx = 0;
-                    for (size_t i = 0; cstr[i];)
-                    {
-                        unsigned char c = cstr[i];
-                        if (c <= 0x7F)
-                            sso.utf32[idx++] = c, ++i;
-                        else if ((c & 0xE0) == 0xC0)
-                            sso.utf32[idx++] = ((c & 0x1F) << 6) | (cstr[i + 1] & 0x3F), i += 2;
-                        else if ((c & 0xF0) == 0xE0)
-                            sso.utf32[idx++] = ((c & 0x0F) << 12) | ((cstr[i + 1] & 0x3F) << 6) | (cstr[i + 2] & 0x3F),
-                            i += 3;
-                        else if ((c & 0xF8) == 0xF0)
-                            sso.utf32[idx++] = ((c & 0x07) << 18) | ((cstr[i + 1] & 0x3F) << 12)
-                                               | ((cstr[i + 2] & 0x3F) << 6) | (cstr[i + 3] & 0x3F),
-                            i += 4;
-                        else
-                            assert(false && "Invalid UTF-8");
-                    }
-                }
-                else
-                {
-                    is_heap = true;
-                    _capacity = utf32_len;
-                    heap.utf32 = new char32_t[_capacity];
-                    uint64_t idx = 0;
-                    for (size_t i = 0; cstr[i];)
-                    {
-                        unsigned char c = cstr[i];
-                        if (c <= 0x7F)
-                            heap.utf32[idx++] = c, ++i;
-                        else if ((c & 0xE0) == 0xC0)
-                            heap.utf32[idx++] = ((c & 0x1F) << 6) | (cstr[i + 1] & 0x3F), i += 2;
-                        else if ((c & 0xF0) == 0xE0)
-                            heap.utf32[idx++] = ((c & 0x0F) << 12) | ((cstr[i + 1] & 0x3F) << 6) | (cstr[i + 2] & 0x3F),
-                            i += 3;
-                        else if ((c & 0xF8) == 0xF0)
-                            heap.utf32[idx++] = ((c & 0x07) << 18) | ((cstr[i + 1] & 0x3F) << 12)
-                                                | ((cstr[i + 2] & 0x3F) << 6) | (cstr[i + 3] & 0x3F),
-                            i += 4;
-                        else
-                            assert(false && "Invalid UTF-8");
-                    }
-                }
+            if (asciiPrefix == bytes)
+            {
+                reset(true);
+                ensure_capacity(bytes);
+                std::memcpy(asciiData(), p, bytes);
+                _length = bytes;
+                return;
             }
+
+            uint64_t count = asciiPrefix;
+            for (uint64_t i = asciiPrefix; i < bytes; ++count) decodeUTF8(p, bytes, i);
+
+            reset(false);
+            ensure_capacity(count);
+            char32_t *dst = utf32Data();
+            for (uint64_t i = 0; i < bytes;) *dst++ = decodeUTF8(p, bytes, i);
+            _length = count;
         }
 
         void init_from_u32_str(const char32_t *utf32str)
         {
             assert(utf32str);
-            is_ascii = false;
-
-            // 计算长度
-            _length = 0;
-            while (utf32str[_length] != U'\0') ++_length;
+            uint64_t len = 0;
+            bool ascii = true;
+            for (; utf32str[len] != U'\0'; ++len) ascii = ascii && utf32str[len] <= 0x7F;
 
-            if (_length <= SSO_MAX_UTF32_LEN)
-            {
-                is_heap = false;
-                _capacity = 0;
-                std::memcpy(sso.utf32, utf32str, _length * sizeof(char32_t));
-            }
+            reset(ascii);
+            ensure_capacity(len);
+            if (ascii)
+                for (uint64_t i = 0; i < len; ++i) asciiData()[i] = static_cast<unsigned char>(utf32str[i]);
             else
-            {
-                is_heap = true;
-                _capacity = _length;
-                heap.utf32 = new char32_t[_capacity];
-                std::memcpy(heap.utf32, utf32str, _length * sizeof(char32_t));
-            }
+                std::memcpy(utf32Data(), utf32str, len * sizeof(char32_t));
+            _length = len;
         }
 
     public:
@@ -1202,9 +1128,14 @@ namespace Fig::StringClass::DynamicCapacity
         }
 
         // Constructors / destructors
-        String() : is_heap(false), is_ascii(true), _length(0), _capacity(0) {}
-        String(const std::string &str) { init_from_cstr(str.c_str()); }
-        String(const char *cstr) { init_from_cstr(cstr); }
+        String() {}
+        String(const std::string &str) { init_from_utf8(str.data(), str.size()); }
+        String(const char *cstr) { init_from_utf8(cstr, std::strlen(cstr)); }
+        String(const char *data, uint64_t bytes) { init_from_utf8(data, bytes); }
+        explicit String(std::u8string_view str)
+        {
+            init_from_utf8(reinterpret_cast<const char *>(str.data()), str.size());
+        }
         String(const String &other) { copy_from(other); }
         String(String &&other) noexcept { move_from(std::move(other)); }
         String(const char32_t *utf32str) { init_from_u32_str(utf32str); }
@@ -1214,7 +1145,7 @@ namespace Fig::StringClass::DynamicCapacity
             init_from_u32_str(u32_str);
         }
 
-        ~String() { destroy(); }
+        ~String() { release(); }
 
         // Assignment
         String &operator=(const String &other)
@@ -1232,54 +1163,29 @@ namespace Fig::StringClass::DynamicCapacity
         char32_t operator[](uint64_t idx) const
         {
             assert(idx < _length);
-            if (is_ascii) return is_heap ? heap.ascii[idx] : sso.ascii[idx];
-            return is_heap ? heap.utf32[idx] : sso.utf32[idx];
+            return codePointAt(idx);
         }
 
         char32_t at(uint64_t idx) const
         {
-            if (idx >= _length) throw std::out_of_range("String index out of range");
-
-            if (is_ascii) return is_heap ? heap.ascii[idx] : sso.ascii[idx];
-            return is_heap ? heap.utf32[idx] : sso.utf32[idx];
+            if (idx >= _length) throw std::out_of_range("String::at");
+            return codePointAt(idx);
         }
 
         void set(uint64_t idx, char32_t c)
         {
-            assert(idx < _length && "Index out of bounds");
-
+            if (idx >= _length) throw std::out_of_range("String::set");
+            _hash = 0;
+            if (is_ascii && c > 0x7F) convert_to_utf32_mode(_length);
             if (is_ascii)
-            {
-                if (c <= 0x7F)
-                {
-                    // ASCII
-                    if (is_heap)
-                        heap.ascii[idx] = static_cast<unsigned char>(c);
-                    else
-                        sso.ascii[idx] = static_cast<unsigned char>(c);
-                }
-                else
-                {
-                    // conv to UTF-32
-                    convert_to_utf32_mode();
-                    if (is_heap)
-                        heap.utf32[idx] = c;
-                    else
-                        sso.utf32[idx] = c;
-                }
-            }
+                asciiData()[idx] = static_cast<unsigned char>(c);
             else
-            {
-                // UTF-32
-                if (is_heap)
-                    heap.utf32[idx] = c;
-                else
-                    sso.utf32[idx] = c;
-            }
+                utf32Data()[idx] = c;
         }
 
-        uint64_t capacity() const noexcept { return _capacity; }
+        uint64_t capacity() const noexcept { return storageCapacity(); }
         uint64_t length() const noexcept { return _length; }
+        uint64_t size() const noexcept { return _length; }
         bool empty() const noexcept { return _length == 0; }
         bool isAscii() const noexcept { return is_ascii; }
         bool isOnHeap() const noexcept { return is_heap; }
@@ -1289,247 +1195,307 @@ namespace Fig::StringClass::DynamicCapacity
         {
             if (other._length == 0) return *this;
             uint64_t new_length = _length + other._length;
+            _hash = 0;
 
             if (is_ascii && other.is_ascii)
             {
                 ensure_capacity(new_length);
-                const unsigned char *src = other.is_heap ? other.heap.ascii : other.sso.ascii;
-                if (is_heap)
-                    std::memcpy(heap.ascii + _length, src, other._length);
-                else
-                    std::memcpy(sso.ascii + _length, src, other._length);
-                _length = new_length;
-                return *this;
+                std::memcpy(asciiData() + _length, other.asciiData(), other._length);
             }
-
-            // Mixed or UTF-32
-            if (is_ascii) convert_to_utf32_mode();
-            if (other.is_ascii)
+            else
             {
-                ensure_capacity(new_length);
-                const unsigned char *src = other.is_heap ? other.heap.ascii : other.sso.ascii;
-                for (uint64_t i = 0; i < other._length; ++i)
+                convert_to_utf32_mode(new_length);
+                char32_t *dst = utf32Data() + _length;
+                if (other.is_ascii)
                 {
-                    if (is_heap)
-                        heap.utf32[_length + i] = src[i];
-                    else
-                        sso.utf32[_length + i] = src[i];
+                    const unsigned char *src = other.asciiData();
+                    for (uint64_t i = 0; i < other._length; ++i) dst[i] = src[i];
                 }
-            }
-            else
-            {
-                ensure_capacity(new_length);
-                const char32_t *src = other.is_heap ? other.heap.utf32 : other.sso.utf32;
-                if (is_heap)
-                    std::memcpy(heap.utf32 + _length, src, other._length * sizeof(char32_t));
                 else
-                    std::memcpy(sso.utf32 + _length, src, other._length * sizeof(char32_t));
+                {
+                    std::memmove(dst, other.utf32Data(), other._length * sizeof(char32_t)); // s += s
+                }
             }
-
             _length = new_length;
             return *this;
         }
 
+        String &operator+=(char32_t c)
+        {
+            _hash = 0;
+            if (is_ascii && c <= 0x7F)
+            {
+                ensure_capacity(_length + 1);
+                asciiData()[_length++] = static_cast<unsigned char>(c);
+                return *this;
+            }
+            convert_to_utf32_mode(_length + 1);
+            utf32Data()[_length++] = c;
+            return *this;
+        }
+
         String operator+(const String &other) const
         {
-            String res = *this;
+            String res;
+            res.reserve(_length + other._length);
+            res += *this;
             res += other;
             return res;
         }
 
+        // Editing, positions and counts are in code points, out of range positions are ignored
+        String substr(uint64_t pos, uint64_t n = UINT64_MAX) const
+        {
+            String res;
+            if (pos >= _length) return res;
+            n = std::min(n, _length - pos);
+            res.reset(is_ascii);
+            res.ensure_capacity(n);
+            if (is_ascii)
+                std::memcpy(res.asciiData(), asciiData() + pos, n);
+            else
+                std::memcpy(res.utf32Data(), utf32Data() + pos, n * sizeof(char32_t));
+            res._length = n;
+            return res;
+        }
+
+        void erase(uint64_t pos, uint64_t n = UINT64_MAX)
+        {
+            if (pos >= _length) return;
+            n = std::min(n, _length - pos);
+            uint64_t tail = _length - pos - n;
+            _hash = 0;
+            if (is_ascii)
+                std::memmove(asciiData() + pos, asciiData() + pos + n, tail);
+            else
+                std::memmove(utf32Data() + pos, utf32Data() + pos + n, tail * sizeof(char32_t));
+            _length -= n;
+        }
+
+        void insert(uint64_t pos, const String &src)
+        {
+            if (pos > _length || src._length == 0) return;
+            if (&src == this)
+            {
+                insert(pos, String(src));
+                return;
+            }
+
+            uint64_t new_length = _length + src._length;
+            uint64_t tail = _length - pos;
+            _hash = 0;
+            if (is_ascii && src.is_ascii)
+            {
+                ensure_capacity(new_length);
+                unsigned char *d = asciiData();
+                std::memmove(d + pos + src._length, d + pos, tail);
+                std::memcpy(d + pos, src.asciiData(), src._length);
+            }
+            else
+            {
+                convert_to_utf32_mode(new_length);
+                char32_t *d = utf32Data();
+                std::memmove(d + pos + src._length, d + pos, tail * sizeof(char32_t));
+                for (uint64_t i = 0; i < src._length; ++i) d[pos + i] = src.codePointAt(i);
+            }
+            _length = new_length;
+        }
+
+        void replace(uint64_t pos, uint64_t n, const String &src)
+        {
+            if (pos >= _length) return;
+            if (n == 1 && src._length == 1)
+            {
+                set(pos, src.codePointAt(0)); // `s[i] = "x"`
+                return;
+            }
+            if (&src == this)
+            {
+                replace(pos, n, String(src));
+                return;
+            }
+            erase(pos, n);
+            insert(pos, src);
+        }
+
         // Conversion
         char *toCString() const
         {
             if (is_ascii)
             {
                 char *buf = new char[_length + 1];
-                if (is_heap)
-                    std::memcpy(buf, heap.ascii, _length);
-                else
-                    std::memcpy(buf, sso.ascii, _length);
+                std::memcpy(buf, asciiData(), _length);
                 buf[_length] = '\0';
                 return buf;
             }
-            else
-            {
-                return is_heap ? decodeUTF32String(heap.utf32, _length) : decodeUTF32String(sso.utf32, _length);
-            }
+            return decodeUTF32String(utf32Data(), _length);
         }
 
-        std::string toBasicString() const
+        // bytes of an ASCII string, no copy. empty view for UTF-32 strings
+        std::string_view asciiView() const
         {
-            if (is_ascii) return std::string(reinterpret_cast<const char *>(is_heap ? heap.ascii : sso.ascii), _length);
-            char *tmp = is_heap ? decodeUTF32String(heap.utf32, _length) : decodeUTF32String(sso.utf32, _length);
-            std::string res(tmp);
-            delete[] tmp;
-            return res;
+            if (!is_ascii) return {};
+            return std::string_view(reinterpret_cast<const char *>(asciiData()), _length);
         }
 
-        static char *decodeUTF32String(const char32_t *str, uint64_t len)
+        // appends the UTF-8 encoding to any string-like `out` (std::string, std::u8string, FString)
+        template <class Str>
+        void appendUTF8(Str &out) const
         {
-            if (!str) return nullptr;
-            size_t utf8_len = 0;
-            for (uint64_t i = 0; i < len; ++i)
+            using Char = typename Str::value_type;
+            if (is_ascii)
             {
-                char32_t c = str[i];
-                if (c <= 0x7F)
-                    utf8_len += 1;
-                else if (c <= 0x7FF)
-                    utf8_len += 2;
-                else if (c <= 0xFFFF)
-                    utf8_len += 3;
-                else
-                    utf8_len += 4;
+                const Char *p = reinterpret_cast<const Char *>(asciiData());
+                out.append(p, p + _length);
+                return;
             }
-            char *buf = new char[utf8_len + 1];
-            char *dest = buf;
-            for (uint64_t i = 0; i < len; ++i)
+            const char32_t *src = utf32Data();
+            for (uint64_t i = 0; i < _length; ++i)
             {
-                char32_t c = str[i];
+                char32_t c = src[i];
                 if (c <= 0x7F)
-                    *dest++ = c;
+                    out.push_back(static_cast<Char>(c));
                 else if (c <= 0x7FF)
                 {
-                    *dest++ = 0xC0 | (c >> 6);
-                    *dest++ = 0x80 | (c & 0x3F);
+                    out.push_back(static_cast<Char>(0xC0 | (c >> 6)));
+                    out.push_back(static_cast<Char>(0x80 | (c & 0x3F)));
                 }
                 else if (c <= 0xFFFF)
                 {
-                    *dest++ = 0xE0 | (c >> 12);
-                    *dest++ = 0x80 | ((c >> 6) & 0x3F);
-                    *dest++ = 0x80 | (c & 0x3F);
+                    out.push_back(static_cast<Char>(0xE0 | (c >> 12)));
+                    out.push_back(static_cast<Char>(0x80 | ((c >> 6) & 0x3F)));
+                    out.push_back(static_cast<Char>(0x80 | (c & 0x3F)));
                 }
                 else
                 {
-                    *dest++ = 0xF0 | (c >> 18);
-                    *dest++ = 0x80 | ((c >> 12) & 0x3F);
-                    *dest++ = 0x80 | ((c >> 6) & 0x3F);
-                    *dest++ = 0x80 | (c & 0x3F);
+                    out.push_back(static_cast<Char>(0xF0 | (c >> 18)));
+                    out.push_back(static_cast<Char>(0x80 | ((c >> 12) & 0x3F)));
+                    out.push_back(static_cast<Char>(0x80 | ((c >> 6) & 0x3F)));
+                    out.push_back(static_cast<Char>(0x80 | (c & 0x3F)));
                 }
             }
-            *dest = '\0';
+        }
+
+        std::string toBasicString() const
+        {
+            if (is_ascii) return std::string(asciiView());
+            std::string res;
+            res.reserve(_length * 3);
+            appendUTF8(res);
+            return res;
+        }
+
+        static char *decodeUTF32String(const char32_t *str, uint64_t len)
+        {
+            if (!str) return nullptr;
+            String tmp;
+            tmp.reset(false);
+            tmp.ensure_capacity(len);
+            std::memcpy(tmp.utf32Data(), str, len * sizeof(char32_t));
+            tmp._length = len;
+
+            std::string utf8;
+            tmp.appendUTF8(utf8);
+            char *buf = new char[utf8.size() + 1];
+            std::memcpy(buf, utf8.data(), utf8.size());
+            buf[utf8.size()] = '\0';
             return buf;
         }
 
-        // Comparision
+        // Comparision, by code point
 
-        bool operator==(const String &other) const
+        int compare(const String &other) const
         {
-            if (_length != other._length) return false;
+            uint64_t n = std::min(_length, other._length);
             if (is_ascii && other.is_ascii)
             {
-                const unsigned char *a = is_heap ? heap.ascii : sso.ascii;
-                const unsigned char *b = other.is_heap ? other.heap.ascii : other.sso.ascii;
-                return std::memcmp(a, b, _length) == 0;
+                int r = (n == 0 ? 0 : std::memcmp(asciiData(), other.asciiData(), n));
+                if (r != 0) return r < 0 ? -1 : 1;
             }
-
-            for (uint64_t i = 0; i < _length; ++i)
+            else
             {
-                char32_t c1 =
-                    is_ascii ? (is_heap ? heap.ascii[i] : sso.ascii[i]) : (is_heap ? heap.utf32[i] : sso.utf32[i]);
-                char32_t c2 = other.is_ascii ? (other.is_heap ? other.heap.ascii[i] : other.sso.ascii[i]) :
-                                               (other.is_heap ? other.heap.utf32[i] : other.sso.utf32[i]);
-                if (c1 != c2) return false;
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    char32_t c1 = codePointAt(i), c2 = other.codePointAt(i);
+                    if (c1 != c2) return c1 < c2 ? -1 : 1;
+                }
             }
-            return true;
+            if (_length == other._length) return 0;
+            return _length < other._length ? -1 : 1;
         }
 
-        bool operator!=(const String &other) const { return !(*this == other); }
-
-        void clear()
+        bool operator==(const String &other) const
         {
-            destroy();
-            is_ascii = true;
-            _length = 0;
-            _capacity = 0;
-            is_heap = false;
+            if (_length != other._length) return false;
+            if (is_ascii && other.is_ascii) return std::memcmp(asciiData(), other.asciiData(), _length) == 0;
+            return compare(other) == 0;
         }
 
+        bool operator!=(const String &other) const { return !(*this == other); }
+        bool operator<(const String &other) const { return compare(other) < 0; }
+        bool operator>(const String &other) const { return compare(other) > 0; }
+        bool operator<=(const String &other) const { return compare(other) <= 0; }
+        bool operator>=(const String &other) const { return compare(other) >= 0; }
+
+        void clear() { reset(true); }
+
         void reverse()
         {
             if (_length <= 1) return;
-
+            _hash = 0;
             if (is_ascii)
             {
-                if (is_heap)
-                {
-                    for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(heap.ascii[i], heap.ascii[j]);
-                }
-                else
-                {
-                    for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(sso.ascii[i], sso.ascii[j]);
-                }
+                unsigned char *d = asciiData();
+                for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(d[i], d[j]);
             }
             else
             {
-                if (is_heap)
-                {
-                    for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(heap.utf32[i], heap.utf32[j]);
-                }
-                else
-                {
-                    for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(sso.utf32[i], sso.utf32[j]);
-                }
+                char32_t *d = utf32Data();
+                for (uint64_t i = 0, j = _length - 1; i < j; ++i, --j) std::swap(d[i], d[j]);
             }
         }
 
-        void reserve(uint64_t new_capacity)
+        void reserve(uint64_t new_capacity) { ensure_capacity(new_capacity); }
+
+        void shrink_to_fit()
         {
-            if (new_capacity <= (_capacity > 0 ? _capacity : (is_ascii ? SSO_MAX_ASCII_LEN : SSO_MAX_UTF32_LEN)))
-                return; // enough
+            if (!is_heap) return;
 
-            ensure_capacity(new_capacity); // 复用你已有的 ensure_capacity
+            String tmp(*this); // copies allocate exactly, or go back to SSO
+            if (tmp.is_heap && tmp._capacity >= _capacity) return;
+            *this = std::move(tmp);
         }
 
-
-        void shrink_to_fit()
+        // FNV-1a 64-bit over code points, same value for the ASCII and UTF-32 form of a string
+        uint64_t hash() const noexcept
         {
-            if (!is_heap) return;
+            if (_hash != 0) return _hash;
+
+            const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+            const uint64_t FNV_PRIME = 1099511628211ull;
 
+            uint64_t h = FNV_OFFSET_BASIS;
             if (is_ascii)
             {
-                if (_length <= SSO_MAX_ASCII_LEN)
+                const unsigned char *p = asciiData();
+                for (uint64_t i = 0; i < _length; ++i)
                 {
-                    // back to SSO
-                    unsigned char tmp[SSO_MAX_ASCII_LEN];
-                    std::memcpy(tmp, heap.ascii, _length);
-                    delete[] heap.ascii;
-                    std::memcpy(sso.ascii, tmp, _length);
-                    is_heap = false;
-                    _capacity = 0;
-                }
-                else
-                {
-                    unsigned char *new_buffer = new unsigned char[_length];
-                    std::memcpy(new_buffer, heap.ascii, _length);
-                    delete[] heap.ascii;
-                    heap.ascii = new_buffer;
-                    _capacity = _length;
+                    h ^= static_cast<uint64_t>(p[i]);
+                    h *= FNV_PRIME;
                 }
             }
             else
             {
-                if (_length <= SSO_MAX_UTF32_LEN)
+                const char32_t *p = utf32Data();
+                for (uint64_t i = 0; i < _length; ++i)
                 {
-                    char32_t tmp[SSO_MAX_UTF32_LEN];
-                    std::memcpy(tmp, heap.utf32, _length * sizeof(char32_t));
-                    delete[] heap.utf32;
-                    std::memcpy(sso.utf32, tmp, _length * sizeof(char32_t));
-                    is_heap = false;
-                    _capacity = 0;
-                }
-                else
-                {
-                    char32_t *new_buffer = new char32_t[_length];
-                    std::memcpy(new_buffer, heap.utf32, _length * sizeof(char32_t));
-                    delete[] heap.utf32;
-                    heap.utf32 = new_buffer;
-                    _capacity = _length;
+                    h ^= static_cast<uint64_t>(p[i]);
+                    h *= FNV_PRIME;
                 }
             }
+            _hash = h; // a string hashing to 0 is just recomputed
+            return h;
         }
-
-        friend struct std::hash<String>;
     };
 }; // namespace Fig::StringClass::DynamicCapacity
 
@@ -1551,35 +1517,7 @@ namespace std
     {
         size_t operator()(const Fig::StringClass::DynamicCapacity::String &s) const noexcept
         {
-            // FNV-1a 64-bit hash
-            const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
-            const uint64_t FNV_PRIME = 1099511628211ull;
-
-            uint64_t hash = FNV_OFFSET_BASIS;
-            if (s.isAscii())
-            {
-                const unsigned char *data = s.isOnHeap() ? s.heap.ascii : s.sso.ascii;
-                for (uint64_t i = 0; i < s.length(); ++i)
-                {
-                    hash ^= static_cast<uint64_t>(data[i]);
-                    hash *= FNV_PRIME;
-                }
-            }
-            else
-            {
-                const char32_t *data = s.isOnHeap() ? s.heap.utf32 : s.sso.utf32;
-                for (uint64_t i = 0; i < s.length(); ++i)
-                {
-                    uint32_t c = data[i];
-                    // 将 char32_t -> 4 bytes
-                    for (int shift = 0; shift < 32; shift += 8)
-                    {
-                        hash ^= static_cast<uint64_t>((c >> shift) & 0xFF);
-                        hash *= FNV_PRIME;
-                    }
-                }
-            }
-            return static_cast<size_t>(hash);
+            return static_cast<size_t>(s.hash());
         }
     };
 } // namespace std
\ No newline at end of file
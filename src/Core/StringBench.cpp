@@ -0,0 +1,103 @@
+#include <Core/fig_string.hpp>
+#include <Core/String.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace Fig;
+
+/*
+    runtime string benchmark: FString (UTF-8) vs String (ASCII / UTF-32)
+    concatenation, indexing and length() on an ASCII and a CJK text, length() both on an unchanged string
+    and right after an append
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <class Fn>
+static long long measure(Fn &&fn)
+{
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static size_t sink = 0; // keeps the loops alive
+
+static void report(const char *what, long long fstringUs, long long stringUs)
+{
+    std::cout << "  " << what << ": FString " << fstringUs << "us, String " << stringUs << "us";
+    if (stringUs > 0) std::cout << " (x" << static_cast<double>(fstringUs) / stringUs << ")";
+    std::cout << "\n";
+}
+
+static void bench(const char *name, const std::string &piece, size_t n)
+{
+    std::cout << name << " (" << n << " pieces):\n";
+
+    FString fpiece(piece);
+    String spiece(piece);
+
+    FString f;
+    String s;
+    report("concat",
+           measure([&] {
+               for (size_t i = 0; i < n; ++i) { f += fpiece; }
+           }),
+           measure([&] {
+               for (size_t i = 0; i < n; ++i) { s += spiece; }
+           }));
+
+    // length() of an unchanged string: FString reads the count from the index built here
+    sink += f.length();
+    report("length",
+           measure([&] {
+               for (size_t i = 0; i < n; ++i) { sink += f.length(); }
+           }),
+           measure([&] {
+               for (size_t i = 0; i < n; ++i) { sink += s.length(); }
+           }));
+
+    size_t len = s.length();
+
+    size_t step = 7919; // prime stride, touches the whole string
+    report("index",
+           measure([&] {
+               for (size_t i = 0, at = 0; i < n; ++i, at = (at + step) % len) { sink += f.getRealChar(at).size(); }
+           }),
+           measure([&] {
+               for (size_t i = 0, at = 0; i < n; ++i, at = (at + step) % len) { sink += s[at]; }
+           }));
+
+    // length() right after a mutation: the append resets FString's index, so it rescans, String keeps a count
+    size_t rounds = 100;
+    report("length after mutation",
+           measure([&] {
+               for (size_t i = 0; i < rounds; ++i)
+               {
+                   f += fpiece;
+                   sink += f.length();
+               }
+           }),
+           measure([&] {
+               for (size_t i = 0; i < rounds; ++i)
+               {
+                   s += spiece;
+                   sink += s.length();
+               }
+           }));
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000);
+
+    bench("ascii", "hello world, ", n);
+    bench("utf8", "你好世界，", n);
+
+    std::cout << "(" << sink << ")\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Core/fig_string.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+namespace Fig
+{
+    /*
+        SymbolTable
+        process-wide identifier table: each distinct name is stored once and numbered in first-seen order
+        id 0 is the empty name. names are never removed, a Symbol stays valid for the whole run
+    */
+    class SymbolTable
+    {
+    private:
+        std::deque<FString> names; // stable addresses, `ids` views them
+        std::unordered_map<std::u8string_view, uint32_t> ids;
+
+        SymbolTable() { intern(std::u8string_view()); }
+
+    public:
+        static SymbolTable &getInstance()
+        {
+            // never destroyed: symbols may still be formatted during static destruction
+            static SymbolTable *table = new SymbolTable();
+            return *table;
+        }
+
+        uint32_t intern(std::u8string_view name)
+        {
+            auto it = ids.find(name);
+            if (it != ids.end()) { return it->second; }
+            uint32_t id = static_cast<uint32_t>(names.size());
+            const FString &stored = names.emplace_back(FString(name));
+            ids.emplace(std::u8string_view(stored.data(), stored.size()), id);
+            return id;
+        }
+
+        const FString &name(uint32_t id) const { return names[id]; }
+
+        size_t size() const { return names.size(); }
+    };
+
+    /*
+        Symbol
+        interned identifier (variable, field, method name): hashing and comparing is an integer operation
+        built from a name it interns it, so FString call sites keep working; str() gives the name back
+    */
+    class Symbol
+    {
+    private:
+        uint32_t id = 0;
+
+    public:
+        Symbol() = default;
+        Symbol(std::u8string_view name) : id(SymbolTable::getInstance().intern(name)) {}
+        Symbol(const FString &name) : Symbol(std::u8string_view(name)) {}
+        Symbol(FStringView name) : Symbol(std::u8string_view(name)) {}
+        Symbol(const char8_t *name) : Symbol(std::u8string_view(name)) {}
+
+        uint32_t getId() const { return id; }
+        bool empty() const { return id == 0; }
+
+        const FString &str() const { return SymbolTable::getInstance().name(id); }
+
+        bool operator==(const Symbol &other) const { return id == other.id; }
+        bool operator!=(const Symbol &other) const { return id != other.id; }
+    };
+
+    struct SymbolHash
+    {
+        size_t operator()(const Symbol &symbol) const { return symbol.getId(); }
+    };
+}; // namespace Fig
+
+namespace std
+{
+    template <>
+    struct hash<Fig::Symbol>
+    {
+        size_t operator()(const Fig::Symbol &symbol) const { return symbol.getId(); }
+    };
+}; // namespace std
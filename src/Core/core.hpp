@@ -54,6 +54,6 @@ namespace Fig
         inline constexpr std::string_view COMPILER = __FCORE_COMPILER;
         inline constexpr std::string_view COMPILE_TIME = __FCORE_COMPILE_TIME;
         inline constexpr std::string_view ARCH = __FCORE_ARCH;
-        inline constexpr FString MAIN_FUNCTION = u8"main";
+        inline const FString MAIN_FUNCTION = u8"main";
     }; // namespace Core
 }; // namespace Fig
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 #include <string>
 #include <string_view>
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace Fig
 {
@@ -15,7 +19,7 @@ namespace Fig
 
         static FStringView fromBasicStringView(std::string_view sv)
         {
-            return FStringView(reinterpret_cast<const char8_t *>(sv.data()));
+            return FStringView(reinterpret_cast<const char8_t *>(sv.data()), sv.size());
         }
 
         explicit FStringView(std::string_view sv)
@@ -36,17 +40,122 @@ namespace Fig
 
     class FString : public std::u8string
     {
+    private:
+        /*
+            code point index, built on first length() / real* call
+            ASCII strings index bytes directly, others sample the byte offset of every STRIDE-th code point
+
+            valid while buffer address and byte size are unchanged, FString mutators reset it.
+            bytes written through data() or iterators need invalidateIndex()
+        */
+        struct CodePointIndex
+        {
+            static constexpr size_t STRIDE = 32;
+
+            const char8_t *data = nullptr;
+            size_t bytes = std::u8string::npos;
+            size_t length = 0;
+            bool ascii = true;
+            std::unique_ptr<std::vector<size_t>> offsets; // offsets[k]: byte offset of code point k * STRIDE
+
+            CodePointIndex() = default;
+            CodePointIndex(const CodePointIndex &) {} // a copy owns another buffer
+            CodePointIndex(CodePointIndex &&other) noexcept { *this = std::move(other); }
+
+            CodePointIndex &operator=(const CodePointIndex &)
+            {
+                reset();
+                return *this;
+            }
+            CodePointIndex &operator=(CodePointIndex &&other) noexcept
+            {
+                data = other.data;
+                bytes = other.bytes;
+                length = other.length;
+                ascii = other.ascii;
+                offsets = std::move(other.offsets);
+                other.reset();
+                return *this;
+            }
+
+            void reset() { bytes = std::u8string::npos; }
+        };
+
+        mutable CodePointIndex cpIndex;
+
+        static size_t codePointLength(char8_t lead)
+        {
+            if ((lead & 0xf8) == 0xf0) return 4;
+            if ((lead & 0xf0) == 0xe0) return 3;
+            if ((lead & 0xe0) == 0xc0) return 2;
+            return 1;
+        }
+
+        // bytes of the code point starting at byte i, truncated sequences count as 1
+        size_t codePointLengthAt(size_t i) const
+        {
+            size_t n = codePointLength(data()[i]);
+            return (i + n > size() ? 1 : n);
+        }
+
+        const CodePointIndex &index() const
+        {
+            CodePointIndex &idx = cpIndex;
+            if (idx.data == data() && idx.bytes == size()) { return idx; }
+
+            idx.data = data();
+            idx.bytes = size();
+            idx.length = 0;
+            idx.ascii = true;
+
+            const char8_t *p = data();
+            size_t i = 0;
+            while (i < size() && p[i] < 0x80) { ++i; }
+            if (i == size())
+            {
+                idx.length = size();
+                return idx;
+            }
+
+            idx.ascii = false;
+            if (!idx.offsets) { idx.offsets = std::make_unique<std::vector<size_t>>(); }
+            idx.offsets->clear();
+            for (i = 0; i < size(); i += codePointLengthAt(i))
+            {
+                if (idx.length % CodePointIndex::STRIDE == 0) { idx.offsets->push_back(i); }
+                ++idx.length;
+            }
+            return idx;
+        }
+
+        // byte offset of code point `index`, size() if out of range
+        size_t byteOffset(size_t index) const
+        {
+            const CodePointIndex &idx = this->index();
+            if (index >= idx.length) return size();
+            if (idx.ascii) return index;
+
+            size_t i = (*idx.offsets)[index / CodePointIndex::STRIDE];
+            for (size_t n = index % CodePointIndex::STRIDE; n > 0; --n) { i += codePointLengthAt(i); }
+            return i;
+        }
+
     public:
         using std::u8string::u8string;
-        using std::u8string::operator=;
+        using std::u8string::operator[];
+        using std::u8string::at;
 
-        FString operator+(const FString &x)
+        FString operator+(const FString &x) const
         {
-            return FString(toBasicString() + x.toBasicString());
+            FString res(*this); // a copy starts without a code point index
+            res.std::u8string::append(x);
+            return res;
         }
-        FString operator+(const char8_t *c)
+        FString operator+(const char8_t *c) const
         {
-            return FString(*this + std::u8string(c));
+            FString res(*this);
+            res.std::u8string::append(c);
+            return res;
         }
 
         explicit FString(const std::u8string &str)
@@ -61,6 +170,93 @@ namespace Fig
         {
             *this = fromStringView(sv);
         }
+
+        // std::u8string mutators, reset the code point index
+        template <class T>
+            requires std::is_assignable_v<std::u8string &, T &&>
+        FString &operator=(T &&x)
+        {
+            std::u8string::operator=(std::forward<T>(x));
+            cpIndex.reset();
+            return *this;
+        }
+        template <class T>
+        FString &operator+=(T &&x)
+        {
+            std::u8string::operator+=(std::forward<T>(x));
+            cpIndex.reset();
+            return *this;
+        }
+        template <class... Args>
+        decltype(auto) append(Args &&...args)
+        {
+            cpIndex.reset();
+            return std::u8string::append(std::forward<Args>(args)...);
+        }
+        template <class... Args>
+        decltype(auto) assign(Args &&...args)
+        {
+            cpIndex.reset();
+            return std::u8string::assign(std::forward<Args>(args)...);
+        }
+        template <class... Args>
+        decltype(auto) insert(Args &&...args)
+        {
+            cpIndex.reset();
+            return std::u8string::insert(std::forward<Args>(args)...);
+        }
+        template <class... Args>
+        decltype(auto) erase(Args &&...args)
+        {
+            cpIndex.reset();
+            return std::u8string::erase(std::forward<Args>(args)...);
+        }
+        template <class... Args>
+        decltype(auto) replace(Args &&...args)
+        {
+            cpIndex.reset();
+            return std::u8string::replace(std::forward<Args>(args)...);
+        }
+        template <class... Args>
+        void resize(Args &&...args)
+        {
+            cpIndex.reset();
+            std::u8string::resize(std::forward<Args>(args)...);
+        }
+        void push_back(char8_t c)
+        {
+            cpIndex.reset();
+            std::u8string::push_back(c);
+        }
+        void pop_back()
+        {
+            cpIndex.reset();
+            std::u8string::pop_back();
+        }
+        void clear()
+        {
+            cpIndex.reset();
+            std::u8string::clear();
+        }
+        void swap(FString &other)
+        {
+            std::u8string::swap(other);
+            cpIndex.reset();
+            other.cpIndex.reset();
+        }
+        char8_t &operator[](size_t i)
+        {
+            cpIndex.reset();
+            return std::u8string::operator[](i);
+        }
+        char8_t &at(size_t i)
+        {
+            cpIndex.reset();
+            return std::u8string::at(i);
+        }
+
+        void invalidateIndex() { cpIndex.reset(); }
+
         std::string toBasicString() const
         {
             return std::string(this->begin(), this->end());
@@ -77,7 +273,7 @@ namespace Fig
 
         static FString fromStringView(FStringView sv)
         {
-            return FString(reinterpret_cast<const char *>(sv.data()));
+            return FString(sv.begin(), sv.end());
         }
 
         static FString fromU8String(const std::u8string &str)
@@ -85,135 +281,50 @@ namespace Fig
             return FString(str.begin(), str.end());
         }
 
+        // UTF8-String real length, O(1) after the first call until the string changes
         size_t length() const
         {
-            // get UTF8-String real length
-            size_t len = 0;
-            for (auto it = this->begin(); it != this->end(); ++it)
-            {
-                if ((*it & 0xC0) != 0x80)
-                {
-                    ++len;
-                }
-            }
-            return len;
+            return index().length;
         }
 
-        FString getRealChar(size_t index)
+        bool isAscii() const
         {
-            FString ch;
-            size_t cnt = 0;
-            for (size_t i = 0; i < size();)
-            {
-                uint8_t cplen = 1;
-                if ((at(i) & 0xf8) == 0xf0)
-                    cplen = 4;
-                else if ((at(i) & 0xf0) == 0xe0)
-                    cplen = 3;
-                else if ((at(i) & 0xe0) == 0xc0)
-                    cplen = 2;
-                if (i + cplen > size())
-                    cplen = 1;
-
-                if (cnt == index)
-                {
-                    ch += substr(i, cplen);
-                }
-
-                i += cplen;
-                ++cnt;
-            }
+            return index().ascii;
+        }
 
-            return ch;
+        FString getRealChar(size_t index) const
+        {
+            size_t pos = byteOffset(index);
+            if (pos == size()) return FString();
+            return FString(std::u8string::substr(pos, codePointLengthAt(pos)));
         }
 
         void realReplace(size_t index, const FString &src)
         {
-            size_t cnt = 0;
-            for (size_t i = 0; i < size();)
-            {
-                uint8_t cplen = 1;
-                if ((at(i) & 0xf8) == 0xf0)
-                    cplen = 4;
-                else if ((at(i) & 0xf0) == 0xe0)
-                    cplen = 3;
-                else if ((at(i) & 0xe0) == 0xc0)
-                    cplen = 2;
-                if (i + cplen > size())
-                    cplen = 1;
-
-                if (cnt == index)
-                {
-                    *this = FString(substr(0, i)) + src + FString(substr(i + cplen));
-                }
-
-                i += cplen;
-                ++cnt;
-            }
+            size_t pos = byteOffset(index);
+            if (pos == size()) return;
+
+            size_t n = codePointLengthAt(pos);
+            // `s[i] = "x"` on an ASCII string keeps it ASCII and every offset in place
+            bool keepIndex = (cpIndex.ascii && n == 1 && src.size() == 1 && src.data()[0] < 0x80);
+            std::u8string::replace(pos, n, src);
+            if (!keepIndex) { cpIndex.reset(); }
         }
+
+        // erases code points [index, index + n)
         void realErase(size_t index, size_t n)
         {
-            size_t cnt = 0;
-            size_t eraseStart = 0;
-            size_t eraseCplens = 0;
-            for (size_t i = 0; i < size();)
-            {
-                uint8_t cplen = 1;
-                if ((at(i) & 0xf8) == 0xf0)
-                    cplen = 4;
-                else if ((at(i) & 0xf0) == 0xe0)
-                    cplen = 3;
-                else if ((at(i) & 0xe0) == 0xc0)
-                    cplen = 2;
-                if (i + cplen > size())
-                    cplen = 1;
-
-                i += cplen;
-                ++cnt;
-
-                if (cnt == index)
-                {
-                    eraseStart = i;
-                }
-                if (cnt < index + n)
-                {
-                    eraseCplens += cplen;
-                }
-            }
-            erase(eraseStart, eraseCplens);
+            size_t len = length();
+            if (index >= len) return;
+            size_t from = byteOffset(index);
+            size_t to = byteOffset(std::min(len, index + n));
+            erase(from, to - from);
         }
 
         void realInsert(size_t index, const FString &src)
         {
-            if (index == length())
-            {
-                for (auto &c : src)
-                {
-                    push_back(c);
-                }
-                return;
-            }
-            size_t cnt = 0;
-            for (size_t i = 0; i < size();)
-            {
-                uint8_t cplen = 1;
-                if ((at(i) & 0xf8) == 0xf0)
-                    cplen = 4;
-                else if ((at(i) & 0xf0) == 0xe0)
-                    cplen = 3;
-                else if ((at(i) & 0xe0) == 0xc0)
-                    cplen = 2;
-                if (i + cplen > size())
-                    cplen = 1;
-
-                if (cnt == index)
-                {
-                    insert(i, src);
-                }
-
-                i += cplen;
-                ++cnt;
-            }
+            if (index > length()) return;
+            insert(byteOffset(index), src);
         }
     };
 
@@ -2,6 +2,7 @@
 
 #include <Error/error.hpp>
 #include <Core/core.hpp>
+#include <Core/Output.hpp>
 
 #include <print>
 #include <vector>
@@ -99,6 +100,7 @@ namespace Fig
 
         inline void logFigErrorInterface(const FString &errorClass, const FString &errorMessage)
         {
+            Output::stdOut().flush(); // what the script printed comes before the report
             namespace TC = TerminalColors;
             coloredPrint(TC::LightWhite, "Uncaught Fig exception:\n");
             coloredPrint(TC::LightRed, "✖  ");
@@ -108,6 +110,7 @@ namespace Fig
 
         inline void logAddressableError(const AddressableError &err)
         {
+            Output::stdOut().flush();
             const FString &fileName = err.getSourcePath();
             const std::vector<FString> &sourceLines = err.getSourceLines();
 
@@ -124,10 +127,11 @@ namespace Fig
 
             if (fileName != u8"<stdin>")
             {
-                lineContent = ((int64_t(err.getLine()) - int64_t(1)) >= 0 ? sourceLines[err.getLine() - 1] : u8"<No Source>");
+                bool inSource = (err.getLine() >= 1 && err.getLine() <= sourceLines.size());
+                lineContent = (inSource ? sourceLines[err.getLine() - 1] : u8"<No Source>");
                 for (size_t i = 1; i < err.getColumn(); ++i)
                 {
-                    if (lineContent[i - 1] == U'\t') { pointerLine += U'\t'; }
+                    if (i - 1 < lineContent.size() && lineContent[i - 1] == U'\t') { pointerLine += U'\t'; }
                     else
                     {
                         pointerLine += U' ';
@@ -148,6 +152,7 @@ namespace Fig
 
         inline void logUnaddressableError(const UnaddressableError &err)
         {
+            Output::stdOut().flush();
             std::print("\n");
             namespace TC = TerminalColors;
             coloredPrint(TC::LightWhite, "An error occurred! ");
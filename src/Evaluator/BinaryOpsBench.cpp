@@ -0,0 +1,262 @@
+#include <Evaluator/Context/context.hpp>
+#include <Evaluator/Core/BinaryOps.hpp>
+#include <Evaluator/Value/IntPool.hpp>
+#include <Evaluator/Value/structInstance.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace Fig;
+
+/*
+    binary operator throughput: each (operator, operand types) case is run `rounds` times through
+    BinaryOps::apply, what evalBinary runs now, and through a copy of the dispatch evalBinary ran before the
+    kernel table: the overload check (hasOperatorImplemented, then getBinaryOperatorFn, each walking the Context
+    chain) and a per operator fallback with its own Int fast path. operands are evaluated in a scope `depth`
+    levels below the global one, where overloads are registered
+
+    before timing, both paths have to agree (same type and value, or both raise) on every operator for every
+    pair of sample operands, compound assignments included
+    usage: BinaryOpsBench [rounds]
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+using Ast::Operator;
+
+// evalBinary before the kernel table, without operand evaluation. Int % Int and Int %= Int share the table's modII
+// instead of a copy of the arithmetic, so both paths follow whatever `%` means in the tree walker
+static Value legacyApply(Operator op, const ObjectPtr &lhs, const ObjectPtr &rhs, const ContextPtr &ctx)
+{
+    if (lhs->is<StructInstance>() && lhs->getTypeInfo() == rhs->getTypeInfo())
+    {
+        const TypeInfo &type = actualType(lhs);
+        if (ctx->hasOperatorImplemented(type, op))
+        {
+            const auto &fnOpt = ctx->getBinaryOperatorFn(type, op);
+            return (*fnOpt)(lhs, rhs).unwrap();
+        }
+    }
+
+    using ValueType::IntClass;
+    bool ints = lhs->is<IntClass>() && rhs->is<IntClass>();
+    const auto &boxInt = [](IntClass v) { return IntPool::getInstance().createInt(v); };
+    switch (op)
+    {
+        case Operator::Add:
+            if (ints) return boxInt(lhs->as<IntClass>() + rhs->as<IntClass>());
+            return Object::box(*lhs + *rhs);
+        case Operator::Subtract:
+            if (ints) return boxInt(lhs->as<IntClass>() - rhs->as<IntClass>());
+            return Object::box(*lhs - *rhs);
+        case Operator::Multiply:
+            if (ints) return boxInt(lhs->as<IntClass>() * rhs->as<IntClass>());
+            return Object::box(*lhs * *rhs);
+        case Operator::Divide: return Object::box(*lhs / *rhs);
+        case Operator::Modulo:
+            if (ints) return BinaryOps::Kernels::modII(lhs, rhs);
+            return Object::box(*lhs % *rhs);
+        case Operator::BitAnd:
+            if (ints) return boxInt(lhs->as<IntClass>() & rhs->as<IntClass>());
+            return Object::box(bit_and(*lhs, *rhs));
+        case Operator::BitOr:
+            if (ints) return boxInt(lhs->as<IntClass>() | rhs->as<IntClass>());
+            return Object::box(bit_or(*lhs, *rhs));
+        case Operator::BitXor:
+            if (ints) return boxInt(lhs->as<IntClass>() ^ rhs->as<IntClass>());
+            return Object::box(bit_xor(*lhs, *rhs));
+        case Operator::ShiftLeft:
+            if (ints) return boxInt(lhs->as<IntClass>() << rhs->as<IntClass>());
+            return Object::box(shift_left(*lhs, *rhs));
+        case Operator::ShiftRight:
+            if (ints) return boxInt(lhs->as<IntClass>() >> rhs->as<IntClass>());
+            return Object::box(shift_right(*lhs, *rhs));
+        case Operator::Equal: return Object::boxBool(*lhs == *rhs);
+        case Operator::NotEqual: return Object::boxBool(*lhs != *rhs);
+        case Operator::Less: return Object::boxBool(*lhs < *rhs);
+        case Operator::LessEqual: return Object::boxBool(*lhs <= *rhs);
+        case Operator::Greater: return Object::boxBool(*lhs > *rhs);
+        case Operator::GreaterEqual: return Object::boxBool(*lhs >= *rhs);
+        case Operator::PlusAssign: return Object::box(*lhs + *rhs);
+        case Operator::MinusAssign: return Object::box(*lhs - *rhs);
+        case Operator::AsteriskAssign: return Object::box(*lhs * *rhs);
+        case Operator::SlashAssign: return Object::box(*lhs / *rhs);
+        case Operator::PercentAssign:
+            if (ints) return BinaryOps::Kernels::modII(lhs, rhs);
+            return Object::box(*lhs % *rhs);
+        default: return Value();
+    }
+}
+
+// nullopt: the path raised
+template <class F>
+static std::optional<Value> attempt(F &&f)
+{
+    try
+    {
+        ExprResult result = f();
+        return result.unwrap();
+    }
+    catch (const std::exception &) { return std::nullopt; }
+}
+
+static bool same(const std::optional<Value> &l, const std::optional<Value> &r)
+{
+    if (!l || !r) return !l && !r;
+    return l->getTypeInfo() == r->getTypeInfo() && valueEquals(*l, *r);
+}
+
+static std::string show(const std::optional<Value> &r)
+{
+    return (r ? r->toString().toBasicString() : std::string("<error>"));
+}
+
+struct Case
+{
+    std::string name;
+    Operator op;
+    ObjectPtr lhs, rhs;
+};
+
+static double seconds(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    size_t rounds = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000);
+    constexpr size_t depth = 8; // function frame and nested blocks below the global scope
+
+    ContextPtr global = std::make_shared<Context>(FString(u8"<Global>"));
+    ContextPtr ctx = global;
+    for (size_t i = 0; i < depth; ++i) { ctx = std::make_shared<Context>(ScopeKind::Block, nullptr, ctx); }
+
+    // struct Vec with `+` overloaded in the global scope
+    TypeInfo vecType(FString(u8"Vec"), true);
+    auto shape = std::make_shared<StructShape>();
+    ObjectPtr v1 = std::make_shared<Object>(StructInstance(vecType, shape, {}));
+    ObjectPtr v2 = std::make_shared<Object>(StructInstance(vecType, shape, {}));
+    global->registerBinaryOperator(
+        vecType, Operator::Add, [](const Value &lhs, const Value &) -> ExprResult { return lhs; });
+
+    ObjectPtr i1 = std::make_shared<Object>(ValueType::IntClass(7));
+    ObjectPtr i2 = std::make_shared<Object>(ValueType::IntClass(3));
+    ObjectPtr d1 = std::make_shared<Object>(ValueType::DoubleClass(7.5));
+    ObjectPtr d2 = std::make_shared<Object>(ValueType::DoubleClass(2.25));
+    ObjectPtr s1 = std::make_shared<Object>(FString(u8"hello"));
+    ObjectPtr s2 = std::make_shared<Object>(FString(u8"world"));
+    ObjectPtr b1 = Object::getTrueInstance();
+    ObjectPtr b2 = Object::getFalseInstance();
+
+    // ===== agreement =====
+    std::vector<ObjectPtr> samples{
+        i1,
+        std::make_shared<Object>(ValueType::IntClass(-3)),
+        std::make_shared<Object>(ValueType::IntClass(0)),
+        d2,
+        std::make_shared<Object>(ValueType::DoubleClass(-0.5)),
+        s1,
+        b1,
+        b2,
+        Object::getNullInstance(),
+        v1,
+    };
+    std::vector<Operator> operators{
+        Operator::Add,        Operator::Subtract,       Operator::Multiply,    Operator::Divide,
+        Operator::Modulo,     Operator::BitAnd,         Operator::BitOr,       Operator::BitXor,
+        Operator::ShiftLeft,  Operator::ShiftRight,     Operator::Equal,       Operator::NotEqual,
+        Operator::Less,       Operator::LessEqual,      Operator::Greater,     Operator::GreaterEqual,
+        Operator::PlusAssign, Operator::MinusAssign,    Operator::SlashAssign, Operator::AsteriskAssign,
+        Operator::PercentAssign,
+    };
+    size_t checked = 0, mismatched = 0;
+    for (Operator op : operators)
+    {
+        for (const ObjectPtr &lhs : samples)
+        {
+            for (const ObjectPtr &rhs : samples)
+            {
+                Ast::OperatorCache cache;
+                auto now = attempt([&]() { return BinaryOps::apply(op, Value(lhs), Value(rhs), *ctx, cache); });
+                auto before = attempt([&]() -> ExprResult { return legacyApply(op, lhs, rhs, ctx); });
+                ++checked;
+                if (same(now, before)) continue;
+                ++mismatched;
+                std::cout << "mismatch: " << lhs->toString().toBasicString() << " " << magic_enum::enum_name(op)
+                          << " " << rhs->toString().toBasicString() << ": " << show(now) << ", before "
+                          << show(before) << "\n";
+            }
+        }
+    }
+    if (mismatched != 0)
+    {
+        std::cout << mismatched << " of " << checked << " operator / operand pairs differ, not timing\n";
+        return 1;
+    }
+    std::cout << checked << " operator / operand pairs agree\n";
+
+    // ===== timing =====
+    std::vector<Case> cases{
+        {"Int + Int", Operator::Add, i1, i2},
+        {"Int - Int", Operator::Subtract, i1, i2},
+        {"Int * Int", Operator::Multiply, i1, i2},
+        {"Int / Int", Operator::Divide, i1, i2},
+        {"Int % Int", Operator::Modulo, i1, i2},
+        {"Int & Int", Operator::BitAnd, i1, i2},
+        {"Int << Int", Operator::ShiftLeft, i1, i2},
+        {"Int == Int", Operator::Equal, i1, i2},
+        {"Int < Int", Operator::Less, i1, i2},
+        {"Int >= Int", Operator::GreaterEqual, i1, i2},
+        {"Int += Int", Operator::PlusAssign, i1, i2},
+        {"Int + Double", Operator::Add, i1, d2},
+        {"Double * Double", Operator::Multiply, d1, d2},
+        {"Double / Double", Operator::Divide, d1, d2},
+        {"Double < Double", Operator::Less, d1, d2},
+        {"String + String", Operator::Add, s1, s2},
+        {"String == String", Operator::Equal, s1, s2},
+        {"String < String", Operator::Less, s1, s2},
+        {"Bool == Bool", Operator::Equal, b1, b2},
+        {"Bool != Bool", Operator::NotEqual, b1, b2},
+        {"Vec + Vec (overload)", Operator::Add, v1, v2},
+    };
+
+    size_t sink = 0; // keeps the results alive to the optimizer
+
+    std::cout << rounds << " rounds per case, " << depth << " scopes deep, ns/op\n";
+    std::cout << "  case                    table    before    speedup\n";
+    for (const Case &c : cases)
+    {
+        Ast::OperatorCache cache; // one per expression, like BinaryExprAst::overload
+        Value lhs(c.lhs), rhs(c.rhs); // the table path takes Values, the path before it ObjectPtrs
+        auto start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            ExprResult result = BinaryOps::apply(c.op, lhs, rhs, *ctx, cache);
+            sink += static_cast<size_t>(result.unwrap().getKind());
+        }
+        double tableTime = seconds(start, Clock::now());
+
+        start = Clock::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            Value result = legacyApply(c.op, c.lhs, c.rhs, ctx);
+            sink += static_cast<size_t>(result.getKind());
+        }
+        double beforeTime = seconds(start, Clock::now());
+
+        double tableNs = tableTime * 1e9 / static_cast<double>(rounds);
+        double beforeNs = beforeTime * 1e9 / static_cast<double>(rounds);
+
+        std::string name = c.name;
+        name.resize(22, ' ');
+        std::cout << "  " << name << "  " << tableNs << "  " << beforeNs << "  " << beforeNs / tableNs << "x\n";
+    }
+    if (sink == 0) std::cout << "(no results)\n";
+    return 0;
+}
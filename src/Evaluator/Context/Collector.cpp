@@ -0,0 +1,307 @@
+#include <Evaluator/Context/Collector.hpp>
+#include <Evaluator/Context/context.hpp>
+#include <Evaluator/Value/structInstance.hpp>
+#include <Evaluator/Value/structType.hpp>
+#include <Evaluator/Value/value.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace Fig
+{
+    void Collector::track(Context *ctx)
+    {
+        ctx->gcIndex = contexts.size();
+        contexts.push_back(ctx);
+    }
+
+    void Collector::untrack(Context *ctx)
+    {
+        Context *last = contexts.back();
+        contexts[ctx->gcIndex] = last;
+        last->gcIndex = ctx->gcIndex;
+        contexts.pop_back();
+    }
+
+    namespace
+    {
+        enum class NodeKind : uint8_t
+        {
+            Context,
+            Slot,    // VariableSlot owned on its own
+            Object,
+            Storage, // StructInstance::Storage, with every field
+            Shape,
+            Field,   // owner of a field slot whose Storage hasn't been seen yet, becomes Storage once it is
+        };
+
+        struct Node
+        {
+            NodeKind kind;
+            void *ptr;
+            std::weak_ptr<const void> owner; // identifies the control block, doesn't hold it
+            long strong;                     // use_count of the owner
+            long internal = 0;               // references held by other nodes
+            long valueEdges = 0;             // Object: Values held by other nodes, see Value / Object::pin
+            bool reachable = false;
+        };
+
+        /*
+            visits every shared_ptr a node holds and the collector can see
+            opaque ones (std::function captures, opRegistry closures) aren't visited: they count as outside references
+        */
+        class Graph
+        {
+        public:
+            std::vector<Node> nodes;
+            std::map<std::weak_ptr<const void>, size_t, std::owner_less<std::weak_ptr<const void>>> index;
+
+            /*
+                node index of `owner`, added (and queued in `pending`) on first sight
+                a field slot shares the control block of its Storage, so the node is the Storage's: it waits as
+                Field, without edges, until a shared_ptr<Storage> says where the Storage is
+            */
+            size_t intern(std::weak_ptr<const void> owner, long strong, NodeKind kind, const void *ptr)
+            {
+                auto it = index.find(owner);
+                if (it != index.end())
+                {
+                    Node &node = nodes[it->second];
+                    if (node.kind == NodeKind::Field && kind == NodeKind::Storage)
+                    {
+                        node.kind = NodeKind::Storage;
+                        node.ptr = const_cast<void *>(ptr);
+                        pending.push_back(it->second);
+                    }
+                    return it->second;
+                }
+                size_t id = nodes.size();
+                nodes.push_back(Node{kind, const_cast<void *>(ptr), owner, strong});
+                index.emplace(std::move(owner), id);
+                if (kind != NodeKind::Field) { pending.push_back(id); }
+                return id;
+            }
+
+            template <class T>
+            size_t intern(const std::shared_ptr<T> &p, NodeKind kind)
+            {
+                return intern(std::weak_ptr<const void>(p), p.use_count(), kind, p.get());
+            }
+
+            template <class T>
+            size_t find(const std::shared_ptr<T> &p) const
+            {
+                return index.find(std::weak_ptr<const void>(p))->second;
+            }
+
+            std::vector<size_t> pending;
+        };
+
+        NodeKind kindOf(const Context *) { return NodeKind::Context; }
+        NodeKind kindOf(const VariableSlot *slot) { return (slot->isField ? NodeKind::Field : NodeKind::Slot); }
+        NodeKind kindOf(const Object *) { return NodeKind::Object; }
+        NodeKind kindOf(const StructInstance::Storage *) { return NodeKind::Storage; }
+        NodeKind kindOf(const StructShape *) { return NodeKind::Shape; }
+
+        // a boxed Value references its Object through the pin every Value holding it shares
+        const ObjectPtr *edgeOf(const Value &value) { return (value.isBoxed() ? &value.object() : nullptr); }
+        template <class T>
+        const std::shared_ptr<T> *edgeOf(const std::shared_ptr<T> &p)
+        {
+            return (p ? &p : nullptr);
+        }
+
+        template <class F>
+        void slotEdges(const VariableSlot &slot, F &&f)
+        {
+            f(slot.value);
+            f(slot.refTarget);
+        }
+
+        // f(shared_ptr) or f(Value) for each reference of the node
+        template <class F>
+        void forEachEdge(NodeKind kind, void *ptr, F &&f)
+        {
+            switch (kind)
+            {
+                case NodeKind::Context: static_cast<Context *>(ptr)->forEachReference(f); break;
+                case NodeKind::Slot: slotEdges(*static_cast<VariableSlot *>(ptr), f); break;
+                case NodeKind::Storage: {
+                    const StructInstance::Storage &storage = *static_cast<StructInstance::Storage *>(ptr);
+                    for (const VariableSlot &field : storage.fields) { slotEdges(field, f); }
+                    for (const auto &[method, bound] : storage.boundMethods) { f(bound); }
+                    break;
+                }
+                case NodeKind::Field: break; // its fields are visited once it is a Storage
+                case NodeKind::Shape: {
+                    const StructShape &shape = *static_cast<StructShape *>(ptr);
+                    f(shape.defContext);
+                    for (const auto &[name, slot] : shape.methods) { f(slot); }
+                    break;
+                }
+                case NodeKind::Object: {
+                    const Object::VariantType &data = static_cast<Object *>(ptr)->data;
+                    if (const auto *fn = std::get_if<Function>(&data)) { f(fn->closureContext); }
+                    else if (const auto *st = std::get_if<StructType>(&data))
+                    {
+                        f(st->defContext);
+                        f(st->shape);
+                    }
+                    else if (const auto *si = std::get_if<StructInstance>(&data))
+                    {
+                        f(si->storage);
+                        f(si->shape);
+                    }
+                    else if (const auto *list = std::get_if<List>(&data))
+                    {
+                        // packed Int / Double / Bool storage references nothing
+                        if (const List::Elements *elements = list->boxed())
+                        {
+                            for (const Element &e : *elements) { f(e.value); }
+                        }
+                    }
+                    else if (const auto *map = std::get_if<Map>(&data))
+                    {
+                        for (const auto &[key, value] : *map)
+                        {
+                            f(key.value);
+                            f(value);
+                        }
+                    }
+                    else if (const auto *mod = std::get_if<Module>(&data)) { f(mod->ctx); }
+                    break;
+                }
+            }
+        }
+
+        // drops the references of a garbage node, which breaks every cycle it's part of
+        void clearNode(const Node &node)
+        {
+            switch (node.kind)
+            {
+                case NodeKind::Context: static_cast<Context *>(node.ptr)->dropReferences(); break;
+                case NodeKind::Slot: {
+                    VariableSlot &slot = *static_cast<VariableSlot *>(node.ptr);
+                    slot.value.reset();
+                    slot.refTarget.reset();
+                    break;
+                }
+                case NodeKind::Storage: {
+                    StructInstance::Storage &storage = *static_cast<StructInstance::Storage *>(node.ptr);
+                    for (VariableSlot &field : storage.fields)
+                    {
+                        field.value.reset();
+                        field.refTarget.reset();
+                    }
+                    storage.boundMethods.clear();
+                    break;
+                }
+                case NodeKind::Object: {
+                    Object &obj = *static_cast<Object *>(node.ptr);
+                    if (!obj.isNull() && !obj.isNumeric() && !obj.is<ValueType::StringClass>()
+                        && !obj.is<ValueType::BoolClass>())
+                    {
+                        obj.data = ValueType::NullClass{};
+                    }
+                    break;
+                }
+                case NodeKind::Shape: break; // const, shared with its type; its context and method slots are cleared
+                case NodeKind::Field: break;
+            }
+        }
+    }; // namespace
+
+    size_t Collector::collect()
+    {
+        collecting = true;
+
+        // 1. every node reachable from a live Context, with the references found inside the graph
+        Graph graph;
+        for (Context *ctx : contexts)
+        {
+            std::weak_ptr<Context> self = ctx->weak_from_this();
+            if (self.expired()) { continue; } // pooled frame, not handed out
+            graph.intern(std::weak_ptr<const void>(self), self.use_count(), NodeKind::Context, ctx);
+        }
+        while (!graph.pending.empty())
+        {
+            size_t id = graph.pending.back();
+            graph.pending.pop_back();
+            NodeKind kind = graph.nodes[id].kind; // copied: interning may grow `nodes`
+            void *ptr = graph.nodes[id].ptr;
+            forEachEdge(kind, ptr, [&graph](const auto &edge) {
+                const auto *p = edgeOf(edge);
+                if (!p) { return; }
+                Node &target = graph.nodes[graph.intern(*p, kindOf(p->get()))];
+                if constexpr (std::is_same_v<std::decay_t<decltype(edge)>, Value>) { ++target.valueEdges; }
+                else { ++target.internal; }
+            });
+        }
+
+        // the pin is one strong reference for all the Values holding an Object: internal if every one of them
+        // was found in the graph
+        for (Node &node : graph.nodes)
+        {
+            if (node.kind == NodeKind::Object && node.valueEdges > 0
+                && node.valueEdges == static_cast<long>(static_cast<Object *>(node.ptr)->valueRefCount()))
+            {
+                ++node.internal;
+            }
+        }
+
+        // 2. nodes referenced from outside are roots, keep everything they reach
+        // so is a Storage only reached through its fields: its other fields weren't visited
+        std::vector<size_t> stack;
+        for (size_t id = 0; id < graph.nodes.size(); ++id)
+        {
+            const Node &node = graph.nodes[id];
+            if ((node.strong > node.internal || node.kind == NodeKind::Field) && !node.reachable)
+            {
+                graph.nodes[id].reachable = true;
+                stack.push_back(id);
+            }
+            while (!stack.empty())
+            {
+                size_t current = stack.back();
+                stack.pop_back();
+                forEachEdge(graph.nodes[current].kind, graph.nodes[current].ptr, [&](const auto &edge) {
+                    const auto *p = edgeOf(edge);
+                    if (!p) { return; }
+                    size_t target = graph.find(*p);
+                    if (!graph.nodes[target].reachable)
+                    {
+                        graph.nodes[target].reachable = true;
+                        stack.push_back(target);
+                    }
+                });
+            }
+        }
+
+        // 3. the rest is garbage: hold it while its references are cleared, then let it go
+        std::vector<std::shared_ptr<const void>> garbage;
+        size_t freed = 0;
+        for (const Node &node : graph.nodes)
+        {
+            if (node.reachable) { continue; }
+            garbage.push_back(node.owner.lock());
+            if (node.kind == NodeKind::Context) { ++freed; }
+        }
+        for (const Node &node : graph.nodes)
+        {
+            if (!node.reachable) { clearNode(node); }
+        }
+        graph = Graph();
+        garbage.clear();
+
+        ++collections;
+        freedContexts += freed;
+        survivors = contexts.size();
+        updateTrigger();
+        collecting = false;
+        return freed;
+    }
+}; // namespace Fig
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Evaluator/Context/context_forward.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        Collector
+        backup cycle collector for what shared_ptr counting can't free: Contexts, variable slots, objects and
+        struct storage referencing each other in a loop (a local function stored in its own scope, a bound
+        method stored in a field of its instance...)
+
+        trial deletion over the graph reachable from every live Context: a node whose strong count is higher
+        than the references found inside the graph is held from outside (evaluator frames, registries, the
+        C++ stack, std::function captures) and everything reachable from it is kept. the rest is garbage,
+        its references are cleared and shared_ptr frees it. edges it can't see only keep more alive
+
+        runs when the number of live Contexts reaches the trigger (at most growth * live after the previous
+        collection, at least threshold), checked at function calls, or on std.runtime.gc()
+    */
+    class Collector
+    {
+    public:
+        static constexpr size_t DefaultThreshold = 10000;
+        static constexpr double DefaultGrowth = 2.0;
+
+    private:
+        std::vector<Context *> contexts; // every constructed Context, Context::gcIndex is its index
+
+        size_t threshold = DefaultThreshold;
+        double growth = DefaultGrowth;
+        size_t trigger = DefaultThreshold;
+        size_t survivors = 0; // live Contexts after the previous collection
+        bool enabled = true;
+        bool collecting = false;
+
+        size_t collections = 0;
+        size_t freedContexts = 0;
+
+        void updateTrigger()
+        {
+            trigger = std::max(threshold, static_cast<size_t>(static_cast<double>(survivors) * growth));
+        }
+
+    public:
+        static Collector &getInstance()
+        {
+            // never destroyed: Contexts may still be destroyed during static destruction
+            static Collector *collector = new Collector();
+            return *collector;
+        }
+
+        void track(Context *ctx);
+        void untrack(Context *ctx);
+
+        // safe point: no Context / Object may be referenced only through a raw pointer or reference
+        void maybeCollect()
+        {
+            if (contexts.size() >= trigger && enabled && !collecting) { collect(); }
+        }
+
+        // returns the number of Contexts found unreachable
+        size_t collect();
+
+        void setEnabled(bool _enabled) { enabled = _enabled; }
+        bool isEnabled() const { return enabled; }
+
+        void setThreshold(size_t _threshold)
+        {
+            threshold = _threshold;
+            updateTrigger();
+        }
+        void setGrowth(double _growth)
+        {
+            growth = std::max(_growth, 1.0);
+            updateTrigger();
+        }
+
+        size_t trackedContexts() const { return contexts.size(); }
+        size_t getCollections() const { return collections; }
+        size_t getFreedContexts() const { return freedContexts; }
+    };
+}; // namespace Fig
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Core/BlockAllocator.hpp>
+#include <Evaluator/Context/context.hpp>
+#include <Evaluator/Context/context_forward.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        FramePool
+        recycles scope Contexts (function call / loop iteration / block / try / catch)
+
+        a released frame is cleared (Context::recycle) instead of destroyed, so its map buckets and slot
+        vector are reused by the next acquire. shared_ptr control blocks come from a free list as well,
+        no heap allocation in steady state
+    */
+    class FramePool
+    {
+    private:
+        static constexpr size_t MAX_FREE_FRAMES = 256;
+
+        std::vector<Context *> freeFrames;
+
+        struct FrameDeleter
+        {
+            void operator()(Context *ctx) const { FramePool::getInstance().release(ctx); }
+        };
+
+        void release(Context *ctx)
+        {
+            ctx->recycle(); // may release other frames
+            if (freeFrames.size() < MAX_FREE_FRAMES)
+            {
+                freeFrames.push_back(ctx);
+                return;
+            }
+            delete ctx;
+        }
+
+    public:
+        static FramePool &getInstance()
+        {
+            // never destroyed: frames may still be released during static destruction
+            static FramePool *pool = new FramePool();
+            return *pool;
+        }
+
+        static ContextPtr acquire(ScopeKind kind, Ast::_AstBase *node, ContextPtr parent)
+        {
+            FramePool &pool = getInstance();
+            Context *ctx;
+            if (!pool.freeFrames.empty())
+            {
+                ctx = pool.freeFrames.back();
+                pool.freeFrames.pop_back();
+                ctx->setFrame(kind, node, std::move(parent));
+            }
+            else
+            {
+                ctx = new Context(kind, node, std::move(parent));
+            }
+            return ContextPtr(ctx, FrameDeleter{}, BlockAllocator<Context, MAX_FREE_FRAMES>{});
+        }
+    };
+}; // namespace Fig
@@ -3,9 +3,11 @@
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <Ast/astBase.hpp>
 #include <Ast/Statements/InterfaceDefSt.hpp>
@@ -13,7 +15,9 @@
 #include <Evaluator/Value/interface.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Context/context_forward.hpp>
+#include <Evaluator/Context/Collector.hpp>
 #include <Core/fig_string.hpp>
+#include <Core/Symbol.hpp>
 #include <Evaluator/Value/value.hpp>
 #include <Evaluator/Value/VariableSlot.hpp>
 #include <Evaluator/Core/ExprResult.hpp>
@@ -26,13 +30,13 @@ namespace Fig
         TypeInfo interfaceType;
         TypeInfo structType;
 
-        std::unordered_map<FString, Function> implMethods;
+        std::unordered_map<Symbol, Function> implMethods;
     };
 
     struct OperationRecord
     {
-        using UnaryOpFn = std::function<ExprResult(const ObjectPtr &)>;
-        using BinaryOpFn = std::function<ExprResult(const ObjectPtr &, const ObjectPtr &)>;
+        using UnaryOpFn = std::function<ExprResult(const Value &)>;
+        using BinaryOpFn = std::function<ExprResult(const Value &, const Value &)>;
 
         std::unordered_map<Ast::Operator, UnaryOpFn> unOpRec;
         std::unordered_map<Ast::Operator, BinaryOpFn> binOpRec;
@@ -46,11 +50,33 @@ namespace Fig
         const BinaryOpFn &getBinaryOpFn(Ast::Operator op) const { return binOpRec.at(op); }
     };
 
+    // what created the context, used instead of matching scope name prefixes
+    enum class ScopeKind : uint8_t
+    {
+        Named, // global, module, struct... (scopeName is the full name)
+        Function,
+        While,
+        For,
+        ForIteration,
+        Block,
+        Try,
+        Catch,
+        Instance, // struct instance, closure of its bound methods
+    };
+
     class Context : public std::enable_shared_from_this<Context>
     {
     private:
-        FString scopeName;
-        std::unordered_map<FString, std::shared_ptr<VariableSlot>> variables;
+        FString scopeName; // Function: function name only
+        ScopeKind kind = ScopeKind::Named;
+        Ast::_AstBase *node = nullptr; // scope owner, for lazily formatted debug names
+        size_t iteration = 0;          // ForIteration: index of the running iteration
+        std::unordered_map<Symbol, std::shared_ptr<VariableSlot>> variables; // names without a resolver slot
+
+        // flat storage indexed by resolver slot (Ast::VarExprAst::slot)
+        // slotNames[i] names slots[i], scanned by name lookups that weren't resolved (methods, modules...)
+        std::vector<std::shared_ptr<VariableSlot>> slots;
+        std::vector<Symbol> slotNames;
 
         // std::unordered_map<std::size_t, Function> functions;
         // std::unordered_map<std::size_t, FString> functionNames;
@@ -59,23 +85,191 @@ namespace Fig
         std::unordered_map<TypeInfo, std::vector<ImplRecord>, TypeInfoHash> implRegistry;
         std::unordered_map<TypeInfo, OperationRecord, TypeInfoHash> opRegistry;
 
+        // ScopeKind::Instance: names resolve to the instance's fields and the type's methods
+        std::optional<StructInstance> instance;
+
+        friend class Collector;
+        size_t gcIndex = 0; // in Collector::contexts
+
+        // index of the filled slot called `name`, -1 if none
+        int findSlot(Symbol name) const
+        {
+            for (size_t i = 0; i < slotNames.size(); ++i)
+            {
+                if (slotNames[i] == name && slots[i]) { return static_cast<int>(i); }
+            }
+            return -1;
+        }
+
+        // f(name, slot) for every variable of this scope, slotted or not
+        template <class F>
+        void forEachVariable(F &&f) const
+        {
+            for (const auto &[name, slot] : variables) { f(name, slot); }
+            for (size_t i = 0; i < slots.size(); ++i)
+            {
+                if (slots[i]) { f(slotNames[i], slots[i]); }
+            }
+        }
+
+        std::shared_ptr<VariableSlot> findInstanceMember(Symbol name) const
+        {
+            if (auto slot = instance->findField(name)) { return slot; }
+            if (const auto *method = instance->shape->findMethod(name))
+            {
+                return instanceMethod(*instance, **method);
+            }
+            return nullptr;
+        }
+
+        // bumped whenever an impl or operator registry gains, loses or copies records
+        // (see Ast::MemberCache, Ast::OperatorCache)
+        static uint64_t &registryEpochCounter()
+        {
+            static uint64_t epoch = 1;
+            return epoch;
+        }
+        void registriesChanged()
+        {
+            if (!implRegistry.empty() || !opRegistry.empty()) ++registryEpochCounter();
+        }
+
     public:
         ContextPtr parent;
 
-        Context(const Context &) = default;
-        Context(const FString &name, ContextPtr p = nullptr) : scopeName(name), parent(p) {}
+        Context(const Context &other) :
+            scopeName(other.scopeName),
+            kind(other.kind),
+            node(other.node),
+            iteration(other.iteration),
+            variables(other.variables),
+            slots(other.slots),
+            slotNames(other.slotNames),
+            implRegistry(other.implRegistry),
+            opRegistry(other.opRegistry),
+            instance(other.instance),
+            parent(other.parent)
+        {
+            Collector::getInstance().track(this);
+        }
+        Context(const FString &name, ContextPtr p = nullptr) : scopeName(name), parent(p)
+        {
+            Collector::getInstance().track(this);
+        }
+        Context(ScopeKind _kind, Ast::_AstBase *_node, ContextPtr p = nullptr) : kind(_kind), node(_node), parent(p)
+        {
+            Collector::getInstance().track(this);
+        }
+
+        ~Context()
+        {
+            registriesChanged(); // cached impl Functions / operator records may point into it
+            Collector::getInstance().untrack(this);
+        }
+
+        static uint64_t registryEpoch() { return registryEpochCounter(); }
+
+        // method slot of a struct shape as a Function closed over the instance context `self`
+        static std::shared_ptr<VariableSlot> bindMethod(ContextPtr self, const VariableSlot &method)
+        {
+            const Function &fn = method.value.as<Function>();
+            return std::make_shared<VariableSlot>(
+                method.name,
+                Value(Object(fn.boundTo(std::move(self)))),
+                ValueType::Function,
+                method.am);
+        }
+
+        // shared method closure of a struct instance, kept while a bound method or its frames are alive
+        static ContextPtr forInstance(const StructInstance &si)
+        {
+            if (ContextPtr ctx = si.storage->methodContext.lock()) { return ctx; }
+            ContextPtr ctx = std::make_shared<Context>(ScopeKind::Instance, nullptr, si.shape->defContext);
+            ctx->instance = si;
+            si.storage->methodContext = ctx;
+            return ctx;
+        }
+
+        // method slot of a shape bound to the instance, made once per instance and reused
+        static std::shared_ptr<VariableSlot> instanceMethod(const StructInstance &si, const VariableSlot &method)
+        {
+            std::shared_ptr<VariableSlot> &bound = si.storage->boundMethods[&method];
+            if (!bound) { bound = bindMethod(forInstance(si), method); }
+            return bound;
+        }
 
         void setParent(ContextPtr _parent) { parent = _parent; }
 
         void setScopeName(FString _name) { scopeName = std::move(_name); }
 
-        FString getScopeName() const { return scopeName; }
+        void setFrame(ScopeKind _kind, Ast::_AstBase *_node, ContextPtr _parent)
+        {
+            kind = _kind;
+            node = _node;
+            parent = std::move(_parent);
+        }
+
+        ScopeKind getScopeKind() const { return kind; }
+
+        void nextIteration() { ++iteration; }
+
+        FString getScopeName() const
+        {
+            if (kind == ScopeKind::Named) { return scopeName; }
+            if (kind == ScopeKind::Function) { return FString(std::format("<Function {}()>", scopeName.toBasicString())); }
+
+            if (kind == ScopeKind::Instance)
+            {
+                return FString(std::format("<StructInstance {}>", instance->parentType.toString().toBasicString()));
+            }
+
+            size_t line = 0, column = 0;
+            if (node)
+            {
+                const Ast::AstAddressInfo &aai = node->getAAI();
+                line = aai.line;
+                column = aai.column;
+            }
+            switch (kind)
+            {
+                case ScopeKind::While: return FString(std::format("<While {}:{}>", line, column));
+                case ScopeKind::For: return FString(std::format("<For {}:{}>", line, column));
+                case ScopeKind::ForIteration:
+                    return FString(std::format("<For {}:{}, Iteration {}>", line, column, iteration));
+                case ScopeKind::Block: return FString(std::format("<Block at {}:{}>", line, column));
+                case ScopeKind::Try: return FString(std::format("<Try at {}:{}>", line, column));
+                case ScopeKind::Catch: return FString(std::format("<Catch at {}:{}>", line, column));
+                default: return scopeName;
+            }
+        }
+
+        // drop everything so the frame can be handed out again by FramePool
+        // (keeps map buckets / vector capacity)
+        void recycle()
+        {
+            ContextPtr p = std::move(parent);
+            variables.clear();
+            slots.clear();
+            slotNames.clear();
+            registriesChanged();
+            implRegistry.clear();
+            opRegistry.clear();
+            instance.reset();
+            scopeName.clear();
+            kind = ScopeKind::Named;
+            node = nullptr;
+            iteration = 0;
+        }
 
         void merge(const Context &c)
         {
-            variables.insert(c.variables.begin(), c.variables.end());
+            // by name: the slot layout of `c` isn't this scope's
+            c.forEachVariable([this](Symbol name, const std::shared_ptr<VariableSlot> &slot) {
+                variables.emplace(name, slot);
+            });
             implRegistry.insert(c.implRegistry.begin(), c.implRegistry.end());
             opRegistry.insert(c.opRegistry.begin(), c.opRegistry.end());
+            registriesChanged();
             // structTypeNames.insert(c.structTypeNames.begin(),
             // c.structTypeNames.end());
         }
@@ -83,86 +277,160 @@ namespace Fig
         void clear()
         {
             variables.clear();
+            slots.clear();
+            slotNames.clear();
+            registriesChanged();
             implRegistry.clear();
             opRegistry.clear();
         }
 
+        // f(shared_ptr) for every reference the Collector can follow (operator closures are opaque)
+        template <class F>
+        void forEachReference(F &&f) const
+        {
+            f(parent);
+            for (const auto &[name, slot] : variables) { f(slot); }
+            for (const auto &slot : slots) { f(slot); }
+            if (instance)
+            {
+                f(instance->storage);
+                f(instance->shape);
+            }
+            for (const auto &[type, records] : implRegistry)
+            {
+                for (const ImplRecord &record : records)
+                {
+                    for (const auto &[name, fn] : record.implMethods) { f(fn.closureContext); }
+                }
+            }
+        }
+
+        // unreachable, found by the Collector: let go of everything so cycles through it fall apart
+        void dropReferences()
+        {
+            clear();
+            instance.reset();
+            parent.reset();
+        }
+
         std::unordered_map<size_t, Function> getFunctions() const
         {
             std::unordered_map<size_t, Function> result;
-            for (auto &[name, slot] : variables)
-            {
+            forEachVariable([&result](Symbol, const std::shared_ptr<VariableSlot> &slot) {
                 if (slot->declaredType == ValueType::Function)
                 {
-                    const Function &fn = slot->value->as<Function>();
+                    const Function &fn = slot->value.as<Function>();
                     result[fn.id] = fn;
                 }
-            }
+            });
             return result;
         }
 
-        std::shared_ptr<VariableSlot> get(const FString &name)
+        // resolved lookup: `depth` parent hops then index, nullptr if the slot isn't defined (yet)
+        std::shared_ptr<VariableSlot> getResolved(int depth, int slot) const
+        {
+            const Context *ctx = this;
+            while (depth-- > 0 && ctx) { ctx = ctx->parent.get(); }
+            if (!ctx || static_cast<size_t>(slot) >= ctx->slots.size()) { return nullptr; }
+            return ctx->slots[slot];
+        }
+
+        // single walk, nullptr if not found
+        std::shared_ptr<VariableSlot> find(Symbol name) const
+        {
+            const Context *ctx = this;
+            while (ctx)
+            {
+                if (auto slot = ctx->findLocal(name)) return slot;
+                ctx = ctx->parent.get();
+            }
+            return nullptr;
+        }
+
+        // this scope only, nullptr if not found
+        std::shared_ptr<VariableSlot> findLocal(Symbol name) const
         {
             auto it = variables.find(name);
             if (it != variables.end()) return it->second;
+            if (int slot = findSlot(name); slot >= 0) return slots[slot];
+            if (instance) return findInstanceMember(name);
+            return nullptr;
+        }
+
+        std::shared_ptr<VariableSlot> get(Symbol name)
+        {
+            if (auto slot = findLocal(name)) return slot;
             if (parent) return parent->get(name);
-            throw RuntimeError(FString(std::format("Variable '{}' not defined", name.toBasicString())));
+            throw RuntimeError(FString(std::format("Variable '{}' not defined", name.str().toBasicString())));
         }
-        AccessModifier getAccessModifier(const FString &name)
+        AccessModifier getAccessModifier(Symbol name)
         {
-            if (variables.contains(name)) { return variables[name]->am; }
+            if (auto slot = findLocal(name)) { return slot->am; }
             else if (parent != nullptr) { return parent->getAccessModifier(name); }
             else
             {
-                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.toBasicString())));
+                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.str().toBasicString())));
             }
         }
-        bool isVariableMutable(const FString &name)
+        bool isVariableMutable(Symbol name)
         {
             AccessModifier am = getAccessModifier(name); // may throw
             return !isAccessConst(am);
         }
-        bool isVariablePublic(const FString &name)
+        bool isVariablePublic(Symbol name)
         {
             AccessModifier am = getAccessModifier(name); // may throw
             return isAccessPublic(am);
         }
-        void set(const FString &name, ObjectPtr value)
+        void set(Symbol name, const Value &value)
         {
-            if (variables.contains(name))
+            if (auto slot = findLocal(name))
             {
-                if (!isVariableMutable(name))
+                if (isAccessConst(slot->am))
                 {
-                    throw RuntimeError(FString(std::format("Variable '{}' is immutable", name.toBasicString())));
+                    throw RuntimeError(FString(std::format("Variable '{}' is immutable", name.str().toBasicString())));
                 }
-                variables[name]->value = value;
+                slot->value = value;
             }
             else if (parent != nullptr) { parent->set(name, value); }
             else
             {
-                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.toBasicString())));
+                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.str().toBasicString())));
             }
         }
-        void _update(const FString &name, ObjectPtr value)
+        void _update(Symbol name, const Value &value)
         {
-            if (variables.contains(name)) { variables[name]->value = value; }
+            if (auto slot = findLocal(name)) { slot->value = value; }
             else if (parent != nullptr) { parent->_update(name, value); }
             else
             {
-                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.toBasicString())));
+                throw RuntimeError(FString(std::format("Variable '{}' not defined", name.str().toBasicString())));
             }
         }
-        void def(const FString &name,
+        void def(Symbol name,
                  const TypeInfo &ti,
                  AccessModifier am,
-                 const ObjectPtr &value = Object::getNullInstance())
+                 const Value &value = Value(),
+                 int slot = -1)
         {
             if (containsInThisScope(name))
             {
                 throw RuntimeError(
-                    FString(std::format("Variable '{}' already defined in this scope", name.toBasicString())));
+                    FString(std::format("Variable '{}' already defined in this scope", name.str().toBasicString())));
             }
-            variables[name] = std::make_shared<VariableSlot>(name, value, ti, am);
+            auto varSlot = std::make_shared<VariableSlot>(name.str(), value, ti, am);
+            if (slot < 0)
+            {
+                variables.emplace(name, std::move(varSlot));
+                return;
+            }
+            if (static_cast<size_t>(slot) >= slots.size())
+            {
+                slots.resize(slot + 1);
+                slotNames.resize(slot + 1);
+            }
+            slots[slot] = std::move(varSlot);
+            slotNames[slot] = name;
             // if (ti == ValueType::StructType)
             // {
             //     auto &st = value->as<StructType>();
@@ -170,27 +438,26 @@ namespace Fig
             // }
         }
         void
-        defReference(const FString &name, const TypeInfo &ti, AccessModifier am, std::shared_ptr<VariableSlot> target)
+        defReference(Symbol name, const TypeInfo &ti, AccessModifier am, std::shared_ptr<VariableSlot> target)
         {
             if (containsInThisScope(name))
             {
                 throw RuntimeError(
-                    FString(std::format("Variable '{}' already defined in this scope", name.toBasicString())));
+                    FString(std::format("Variable '{}' already defined in this scope", name.str().toBasicString())));
             }
-            variables[name] = std::make_shared<VariableSlot>(name, target->value, ti, am, true, target);
+            variables[name] = std::make_shared<VariableSlot>(name.str(), target->value, ti, am, true, target);
         }
 
         std::optional<FString> getFunctionName(std::size_t id)
         {
-            for (auto &[name, slot] : variables)
-            {
-                if (slot->declaredType == ValueType::Function)
+            std::optional<FString> result;
+            forEachVariable([&](Symbol name, const std::shared_ptr<VariableSlot> &slot) {
+                if (!result && slot->declaredType == ValueType::Function && slot->value.as<Function>().id == id)
                 {
-                    const Function &fn = slot->value->as<Function>();
-                    if (fn.id == id) { return name; }
+                    result = name.str();
                 }
-            }
-            return std::nullopt;
+            });
+            return result;
         }
         // std::optional<FString> getStructName(std::size_t id)
         // {
@@ -208,35 +475,40 @@ namespace Fig
         //         return std::nullopt;
         //     }
         // }
-        bool contains(const FString &name)
+        bool contains(Symbol name)
         {
-            if (variables.contains(name)) { return true; }
+            if (containsInThisScope(name)) { return true; }
             else if (parent != nullptr) { return parent->contains(name); }
             return false;
         }
-        bool containsInThisScope(const FString &name) const { return variables.contains(name); }
+        bool containsInThisScope(Symbol name) const
+        {
+            if (variables.contains(name) || findSlot(name) >= 0) { return true; }
+            return instance && (instance->shape->findField(name) >= 0 || instance->shape->findMethod(name));
+        }
 
-        TypeInfo getTypeInfo(const FString &name) { return get(name)->declaredType; }
+        TypeInfo getTypeInfo(Symbol name) { return get(name)->declaredType; }
         bool isInFunctionContext()
         {
-            ContextPtr ctx = shared_from_this();
+            const Context *ctx = this;
             while (ctx)
             {
-                if (ctx->getScopeName().find(u8"<Function ") == 0) { return true; }
-                ctx = ctx->parent;
+                if (ctx->kind == ScopeKind::Function) { return true; }
+                ctx = ctx->parent.get();
             }
             return false;
         }
         bool isInLoopContext()
         {
-            ContextPtr ctx = shared_from_this();
+            const Context *ctx = this;
             while (ctx)
             {
-                if (ctx->getScopeName().find(u8"<While ") == 0 or ctx->getScopeName().find(u8"<For ") == 0)
+                if (ctx->kind == ScopeKind::While || ctx->kind == ScopeKind::For
+                    || ctx->kind == ScopeKind::ForIteration)
                 {
                     return true;
                 }
-                ctx = ctx->parent;
+                ctx = ctx->parent.get();
             }
             return false;
         }
@@ -259,7 +531,12 @@ namespace Fig
             return implRegistry;
         }
 
-        std::unordered_map<TypeInfo, std::vector<ImplRecord>, TypeInfoHash> &getImplRegistry() { return implRegistry; }
+        // records of `c` this scope doesn't have yet, e.g. the impls of an imported module
+        void importImpls(const Context &c)
+        {
+            implRegistry.insert(c.implRegistry.begin(), c.implRegistry.end());
+            registriesChanged();
+        }
 
         std::optional<ImplRecord> getImplRecord(const TypeInfo &structType, const TypeInfo &interfaceType) const
         {
@@ -287,9 +564,10 @@ namespace Fig
             }
 
             list.push_back(record); // order is the level
+            ++registryEpochCounter();
         }
 
-        bool hasMethodImplemented(const TypeInfo &structType, const FString &functionName) const
+        bool hasMethodImplemented(const TypeInfo &structType, Symbol functionName) const
         {
             auto it = implRegistry.find(structType);
             if (it != implRegistry.end())
@@ -303,7 +581,7 @@ namespace Fig
             return parent && parent->hasMethodImplemented(structType, functionName);
         }
 
-        bool hasDefaultImplementedMethod(const TypeInfo &structType, const FString &functionName) const
+        bool hasDefaultImplementedMethod(const TypeInfo &structType, Symbol functionName) const
         {
             auto it = implRegistry.find(structType);
             if (it == implRegistry.end()) return false;
@@ -311,28 +589,28 @@ namespace Fig
             std::vector<TypeInfo> implementedInterfaces;
             for (auto &record : it->second) implementedInterfaces.push_back(record.interfaceType);
 
-            for (auto &[_, slot] : variables)
-            {
-                if (!slot->value->is<InterfaceType>()) continue;
+            bool found = false;
+            forEachVariable([&](Symbol, const std::shared_ptr<VariableSlot> &slot) {
+                if (found || !slot->value.is<InterfaceType>()) return;
 
-                InterfaceType &interface = slot->value->as<InterfaceType>();
+                InterfaceType &interface = slot->value.as<InterfaceType>();
 
                 bool implemented = std::any_of(implementedInterfaces.begin(),
                                                implementedInterfaces.end(),
                                                [&](const TypeInfo &ti) { return ti == interface.type; });
 
-                if (!implemented) continue;
+                if (!implemented) return;
 
                 for (auto &method : interface.methods)
                 {
-                    if (method.name == functionName && method.hasDefaultBody()) return true;
+                    if (method.name == functionName.str() && method.hasDefaultBody()) found = true;
                 }
-            }
+            });
 
-            return false;
+            return found;
         }
 
-        Ast::InterfaceMethod getDefaultImplementedMethod(const TypeInfo &structType, const FString &functionName)
+        Ast::InterfaceMethod getDefaultImplementedMethod(const TypeInfo &structType, Symbol functionName)
         {
             // O(N²)
             // SLOW
@@ -348,32 +626,34 @@ namespace Fig
             std::vector<TypeInfo> implementedInterfaces;
             for (auto &record : it->second) implementedInterfaces.push_back(record.interfaceType);
 
-            for (auto &[_, slot] : variables)
-            {
-                if (!slot->value->is<InterfaceType>()) continue;
+            const Ast::InterfaceMethod *found = nullptr;
+            forEachVariable([&](Symbol, const std::shared_ptr<VariableSlot> &slot) {
+                if (found || !slot->value.is<InterfaceType>()) return;
 
-                InterfaceType &interface = slot->value->as<InterfaceType>();
+                InterfaceType &interface = slot->value.as<InterfaceType>();
 
                 bool implemented = std::any_of(implementedInterfaces.begin(),
                                                implementedInterfaces.end(),
                                                [&](const TypeInfo &ti) { return ti == interface.type; });
 
-                if (!implemented) continue;
+                if (!implemented) return;
 
                 for (auto &method : interface.methods)
                 {
-                    if (method.name == functionName)
+                    if (method.name == functionName.str())
                     {
                         if (!method.hasDefaultBody()) assert(false);
-                        return method;
+                        found = &method;
+                        return;
                     }
                 }
-            }
+            });
+            if (found) return *found;
 
             assert(false);
         }
 
-        const Function &getImplementedMethod(const TypeInfo &structType, const FString &functionName) const
+        const Function &getImplementedMethod(const TypeInfo &structType, Symbol functionName) const
         {
             auto it = implRegistry.find(structType);
             if (it != implRegistry.end())
@@ -391,7 +671,13 @@ namespace Fig
             throw "";      // ignore warning
         }
 
-        std::unordered_map<TypeInfo, OperationRecord, TypeInfoHash> &getOpRegistry() { return opRegistry; }
+        const std::unordered_map<TypeInfo, OperationRecord, TypeInfoHash> &getOpRegistry() const { return opRegistry; }
+
+        void setOpRecord(const TypeInfo &type, const OperationRecord &record)
+        {
+            opRegistry[type] = record;
+            ++registryEpochCounter();
+        }
 
         bool hasOperatorImplemented(const TypeInfo &type, Ast::Operator op, bool isUnary = false) const
         {
@@ -435,18 +721,32 @@ namespace Fig
             return std::nullopt;
         }
 
+        // record holding the binary `op` for `type` in the nearest scope, nullptr if none
+        const OperationRecord *findBinaryOperator(const TypeInfo &type, Ast::Operator op) const
+        {
+            for (const Context *ctx = this; ctx; ctx = ctx->parent.get())
+            {
+                auto it = ctx->opRegistry.find(type);
+                if (it != ctx->opRegistry.end() && it->second.hasBinaryOp(op)) return &it->second;
+            }
+            return nullptr;
+        }
+
         void registerUnaryOperator(const TypeInfo &type, Ast::Operator op, OperationRecord::UnaryOpFn fn)
         {
             opRegistry[type].unOpRec[op] = std::move(fn);
+            ++registryEpochCounter();
         }
 
         void registerBinaryOperator(const TypeInfo &type, Ast::Operator op, OperationRecord::BinaryOpFn fn)
         {
             opRegistry[type].binOpRec[op] = std::move(fn);
+            ++registryEpochCounter();
         }
 
         bool removeUnaryOperator(const TypeInfo &type, Ast::Operator op)
         {
+            ++registryEpochCounter();
             auto it = opRegistry.find(type);
             if (it != opRegistry.end()) return it->second.unOpRec.erase(op) > 0;
             return false;
@@ -454,6 +754,7 @@ namespace Fig
 
         bool removeBinaryOperator(const TypeInfo &type, Ast::Operator op)
         {
+            ++registryEpochCounter();
             auto it = opRegistry.find(type);
             if (it != opRegistry.end()) return it->second.binOpRec.erase(op) > 0;
             return false;
@@ -473,7 +774,7 @@ namespace Fig
             os << "[STACK TRACE]\n";
             for (int i = static_cast<int>(chain.size()) - 1; i >= 0; --i)
             {
-                os << "  #" << (chain.size() - 1 - i) << " " << chain[i]->scopeName.toBasicString() << "\n";
+                os << "  #" << (chain.size() - 1 - i) << " " << chain[i]->getScopeName().toBasicString() << "\n";
             }
         }
     };
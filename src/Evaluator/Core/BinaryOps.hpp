@@ -0,0 +1,285 @@
+#pragma once
+
+#include <Ast/astBase.hpp>
+#include <Ast/Expressions/BinaryExpr.hpp>
+#include <Evaluator/Context/context.hpp>
+#include <Evaluator/Core/ExprResult.hpp>
+#include <Evaluator/Value/value.hpp>
+
+#include <Utils/magic_enum/magic_enum.hpp>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+
+namespace Fig::BinaryOps
+{
+    /*
+        BinaryOps
+        kernels for binary operators on builtin operands, looked up by (operator, lhs tag, rhs tag)
+        without touching any Context. numbers and bools stay inline Values, nothing is boxed. a missing kernel
+        sends the evaluator down the general path: overloads, then Object's operators, which raise the errors
+    */
+
+    enum Tag : uint8_t
+    {
+        Int,
+        Double,
+        String,
+        Bool,
+        Other, // null, containers, functions, structs...
+        TagCount,
+    };
+
+    using Kernel = Value (*)(const Value &, const Value &);
+
+    inline Tag tagOf(const Value &value)
+    {
+        switch (value.getKind())
+        {
+            case Value::Kind::Int: return Int;
+            case Value::Kind::Double: return Double;
+            case Value::Kind::Bool: return Bool;
+            case Value::Kind::Boxed: return (value.boxed()->is<ValueType::StringClass>() ? String : Other);
+            case Value::Kind::Null: break;
+        }
+        return Other;
+    }
+
+    namespace Kernels
+    {
+        using IntClass = ValueType::IntClass;
+        using DoubleClass = ValueType::DoubleClass;
+        using StringClass = ValueType::StringClass;
+
+        inline IntClass i(const Value &v) { return v.as<IntClass>(); }
+        inline DoubleClass d(const Value &v) { return v.getNumericValue(); } // Int or Double
+        inline const StringClass &s(const Value &v) { return v.as<StringClass>(); }
+        inline bool b(const Value &v) { return v.as<ValueType::BoolClass>(); }
+
+        inline Value boxInt(IntClass v) { return Value::Int(v); }
+        inline Value boxDouble(DoubleClass v) { return Value::Double(v); }
+        inline Value boxBool(bool v) { return Value::Bool(v); }
+
+        // Object's message for a zero divisor
+        [[noreturn]] inline void byZero(const char *what, const char *op, const Value &l, const Value &r)
+        {
+            throw ValueError(FString(std::format("{}: {} '{}' {}",
+                                                 what,
+                                                 l.getTypeInfo().name.toBasicString(),
+                                                 op,
+                                                 r.getTypeInfo().name.toBasicString())));
+        }
+
+        // Int op Int
+        inline Value addII(const Value &l, const Value &r) { return boxInt(i(l) + i(r)); }
+        inline Value subII(const Value &l, const Value &r) { return boxInt(i(l) - i(r)); }
+        inline Value mulII(const Value &l, const Value &r) { return boxInt(i(l) * i(r)); }
+        inline Value modII(const Value &l, const Value &r)
+        {
+            IntClass lv = i(l), rv = i(r);
+            if (rv == 0) { throw ValueError(FString(std::format("Modulo by zero: {} % {}", lv, rv))); }
+            // floor modulo, the result has the sign of rv
+            IntClass rem = lv % rv;
+            if (rem != 0 && ((rem < 0) != (rv < 0))) { rem += rv; }
+            return boxInt(rem);
+        }
+        inline Value andII(const Value &l, const Value &r) { return boxInt(i(l) & i(r)); }
+        inline Value orII(const Value &l, const Value &r) { return boxInt(i(l) | i(r)); }
+        inline Value xorII(const Value &l, const Value &r) { return boxInt(i(l) ^ i(r)); }
+        inline Value shlII(const Value &l, const Value &r) { return boxInt(i(l) << i(r)); }
+        inline Value shrII(const Value &l, const Value &r) { return boxInt(i(l) >> i(r)); }
+
+        // any numeric pair, in double like Object's operators
+        inline Value addNN(const Value &l, const Value &r) { return boxDouble(d(l) + d(r)); }
+        inline Value subNN(const Value &l, const Value &r) { return boxDouble(d(l) - d(r)); }
+        inline Value mulNN(const Value &l, const Value &r) { return boxDouble(d(l) * d(r)); }
+        inline Value divNN(const Value &l, const Value &r)
+        {
+            DoubleClass rv = d(r);
+            if (rv == 0) { byZero("Division by zero", "/", l, r); }
+            return boxDouble(d(l) / rv);
+        }
+        inline Value modNN(const Value &l, const Value &r)
+        {
+            DoubleClass rv = d(r);
+            if (rv == 0) { byZero("Modulo by zero", "%", l, r); }
+            return boxDouble(std::fmod(d(l), rv));
+        }
+        inline Value eqNN(const Value &l, const Value &r) { return boxBool(nearlyEqual(d(l), d(r))); }
+        inline Value neNN(const Value &l, const Value &r) { return boxBool(!nearlyEqual(d(l), d(r))); }
+        inline Value ltNN(const Value &l, const Value &r) { return boxBool(d(l) < d(r)); }
+        inline Value gtNN(const Value &l, const Value &r) { return boxBool(d(l) > d(r)); }
+        inline Value leNN(const Value &l, const Value &r)
+        {
+            return boxBool(nearlyEqual(d(l), d(r)) || d(l) < d(r));
+        }
+        inline Value geNN(const Value &l, const Value &r)
+        {
+            return boxBool(nearlyEqual(d(l), d(r)) || d(l) > d(r));
+        }
+
+        // String op String
+        inline Value addSS(const Value &l, const Value &r) { return Value(Object(s(l) + s(r))); }
+        inline Value eqSS(const Value &l, const Value &r) { return boxBool(s(l) == s(r)); }
+        inline Value neSS(const Value &l, const Value &r) { return boxBool(!(s(l) == s(r))); }
+        inline Value ltSS(const Value &l, const Value &r) { return boxBool(s(l) < s(r)); }
+        inline Value gtSS(const Value &l, const Value &r) { return boxBool(s(l) > s(r)); }
+        inline Value leSS(const Value &l, const Value &r) { return boxBool(s(l) == s(r) || s(l) < s(r)); }
+        inline Value geSS(const Value &l, const Value &r) { return boxBool(s(l) == s(r) || s(l) > s(r)); }
+
+        // Bool op Bool
+        inline Value eqBB(const Value &l, const Value &r) { return boxBool(b(l) == b(r)); }
+        inline Value neBB(const Value &l, const Value &r) { return boxBool(b(l) != b(r)); }
+    }; // namespace Kernels
+
+    class Table
+    {
+    private:
+        static constexpr size_t OpCount = magic_enum::enum_count<Ast::Operator>();
+
+        std::array<std::array<std::array<Kernel, TagCount>, TagCount>, OpCount> kernels{};
+
+        void set(Ast::Operator op, Tag l, Tag r, Kernel k) { kernels[static_cast<size_t>(op)][l][r] = k; }
+
+        // Int/Double in every combination
+        void setNumeric(Ast::Operator op, Kernel k)
+        {
+            set(op, Int, Int, k);
+            set(op, Int, Double, k);
+            set(op, Double, Int, k);
+            set(op, Double, Double, k);
+        }
+
+        Table()
+        {
+            using Ast::Operator;
+            using namespace Kernels;
+
+            setNumeric(Operator::Add, addNN);
+            setNumeric(Operator::Subtract, subNN);
+            setNumeric(Operator::Multiply, mulNN);
+            setNumeric(Operator::Divide, divNN); // Int / Int is a Double
+            setNumeric(Operator::Modulo, modNN);
+            setNumeric(Operator::Equal, eqNN);
+            setNumeric(Operator::NotEqual, neNN);
+            setNumeric(Operator::Less, ltNN);
+            setNumeric(Operator::LessEqual, leNN);
+            setNumeric(Operator::Greater, gtNN);
+            setNumeric(Operator::GreaterEqual, geNN);
+
+            set(Operator::Add, Int, Int, addII);
+            set(Operator::Subtract, Int, Int, subII);
+            set(Operator::Multiply, Int, Int, mulII);
+            set(Operator::Modulo, Int, Int, modII);
+            set(Operator::BitAnd, Int, Int, andII);
+            set(Operator::BitOr, Int, Int, orII);
+            set(Operator::BitXor, Int, Int, xorII);
+            set(Operator::ShiftLeft, Int, Int, shlII);
+            set(Operator::ShiftRight, Int, Int, shrII);
+
+            set(Operator::Add, String, String, addSS);
+            set(Operator::Equal, String, String, eqSS);
+            set(Operator::NotEqual, String, String, neSS);
+            set(Operator::Less, String, String, ltSS);
+            set(Operator::LessEqual, String, String, leSS);
+            set(Operator::Greater, String, String, gtSS);
+            set(Operator::GreaterEqual, String, String, geSS);
+
+            set(Operator::Equal, Bool, Bool, eqBB);
+            set(Operator::NotEqual, Bool, Bool, neBB);
+        }
+
+    public:
+        static const Table &getInstance()
+        {
+            static const Table table;
+            return table;
+        }
+
+        Kernel find(Ast::Operator op, const Value &lhs, const Value &rhs) const
+        {
+            return kernels[static_cast<size_t>(op)][tagOf(lhs)][tagOf(rhs)];
+        }
+    };
+
+    // the arithmetic operator behind a compound assignment, `op` itself otherwise
+    inline Ast::Operator underlying(Ast::Operator op)
+    {
+        switch (op)
+        {
+            case Ast::Operator::PlusAssign: return Ast::Operator::Add;
+            case Ast::Operator::MinusAssign: return Ast::Operator::Subtract;
+            case Ast::Operator::AsteriskAssign: return Ast::Operator::Multiply;
+            case Ast::Operator::SlashAssign: return Ast::Operator::Divide;
+            case Ast::Operator::PercentAssign: return Ast::Operator::Modulo;
+            default: return op;
+        }
+    }
+
+    // Object's own operators, for operands without a kernel (they raise the type errors)
+    inline Value applyGeneric(Ast::Operator op, const Value &lhsValue, const Value &rhsValue)
+    {
+        ObjectPtr lhsObject = lhsValue.toObject(), rhsObject = rhsValue.toObject();
+        const Object &lhs = *lhsObject, &rhs = *rhsObject;
+        switch (op)
+        {
+            case Ast::Operator::Add: return Value(lhs + rhs);
+            case Ast::Operator::Subtract: return Value(lhs - rhs);
+            case Ast::Operator::Multiply: return Value(lhs * rhs);
+            case Ast::Operator::Divide: return Value(lhs / rhs);
+            case Ast::Operator::Modulo: return Value(lhs % rhs);
+            case Ast::Operator::BitAnd: return Value(bit_and(lhs, rhs));
+            case Ast::Operator::BitOr: return Value(bit_or(lhs, rhs));
+            case Ast::Operator::BitXor: return Value(bit_xor(lhs, rhs));
+            case Ast::Operator::ShiftLeft: return Value(shift_left(lhs, rhs));
+            case Ast::Operator::ShiftRight: return Value(shift_right(lhs, rhs));
+            case Ast::Operator::Equal: return Value::Bool(lhs == rhs);
+            case Ast::Operator::NotEqual: return Value::Bool(lhs != rhs);
+            case Ast::Operator::Less: return Value::Bool(lhs < rhs);
+            case Ast::Operator::LessEqual: return Value::Bool(lhs <= rhs);
+            case Ast::Operator::Greater: return Value::Bool(lhs > rhs);
+            case Ast::Operator::GreaterEqual: return Value::Bool(lhs >= rhs);
+            default: assert(false && "not an arithmetic / comparison operator"); return Value();
+        }
+    }
+
+    // overload of `op` for two instances of the same struct, looked up once per struct type until a registry
+    // changes. nullptr for anything else
+    inline const OperationRecord *
+    findOverload(Ast::Operator op, const Value &lhs, const Value &rhs, const Context &ctx, Ast::OperatorCache &cache)
+    {
+        if (!lhs.is<StructInstance>() || !rhs.is<StructInstance>()) { return nullptr; }
+        const TypeInfo &type = lhs.as<StructInstance>().parentType;
+        if (type != rhs.as<StructInstance>().parentType) { return nullptr; }
+        if (cache.typeId != type.getInstanceID() || cache.epoch != Context::registryEpoch())
+        {
+            cache.typeId = type.getInstanceID();
+            cache.record = ctx.findBinaryOperator(type, op);
+            cache.epoch = Context::registryEpoch();
+        }
+        return cache.record;
+    }
+
+    /*
+        arithmetic, comparison, bitwise and compound assignment operators as evalBinary runs them:
+        the kernel when there is one, then an overload, then Object's operators.
+        overloads are found by `op` itself (`x += y` uses the `+=` overload), everything else by its arithmetic
+        operator
+    */
+    inline ExprResult
+    apply(Ast::Operator op, const Value &lhs, const Value &rhs, const Context &ctx, Ast::OperatorCache &cache)
+    {
+        Ast::Operator arith = underlying(op);
+        if (Kernel kernel = Table::getInstance().find(arith, lhs, rhs)) { return kernel(lhs, rhs); }
+        if (const OperationRecord *record = findOverload(op, lhs, rhs, ctx, cache))
+        {
+            return record->getBinaryOpFn(op)(lhs, rhs);
+        }
+        return applyGeneric(arith, lhs, rhs);
+    }
+}; // namespace Fig::BinaryOps
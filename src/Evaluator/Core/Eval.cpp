@@ -11,27 +11,27 @@ namespace Fig
         switch (type)
         {
             case AstType::ValueExpr: {
-                auto val = std::static_pointer_cast<Ast::ValueExprAst>(exp);
+                auto val = static_cast<Ast::ValueExprAst *>(exp);
                
-                return val->val;
+                return val->value;
             }
             case AstType::VarExpr: {
-                auto varExpr = std::static_pointer_cast<Ast::VarExprAst>(exp);
+                auto varExpr = static_cast<Ast::VarExprAst *>(exp);
 
                 return check_unwrap_lv(evalVarExpr(varExpr, ctx)).get(); // LvObject -> RvObject
             }
             case AstType::BinaryExpr: {
-                auto bin = std::static_pointer_cast<Ast::BinaryExprAst>(exp);
+                auto bin = static_cast<Ast::BinaryExprAst *>(exp);
                
                 return evalBinary(bin, ctx);
             }
             case AstType::UnaryExpr: {
-                auto un = std::static_pointer_cast<Ast::UnaryExprAst>(exp);
+                auto un = static_cast<Ast::UnaryExprAst *>(exp);
                
                 return evalUnary(un, ctx);
             }
             case AstType::TernaryExpr: {
-                auto te = std::static_pointer_cast<Ast::TernaryExprAst>(exp);
+                auto te = static_cast<Ast::TernaryExprAst *>(exp);
                
                 return evalTernary(te, ctx);
             }
@@ -39,69 +39,53 @@ namespace Fig
             case AstType::IndexExpr: return check_unwrap_lv(evalLv(exp, ctx)).get();
 
             case AstType::FunctionCall: {
-                auto fnCall = std::static_pointer_cast<Ast::FunctionCallExpr>(exp);
+                auto fnCall = static_cast<Ast::FunctionCallExpr *>(exp);
                 return evalFunctionCall(fnCall, ctx);
             }
             case AstType::FunctionLiteralExpr: {
-                auto fnLiteral = std::static_pointer_cast<Ast::FunctionLiteralExprAst>(exp);
+                auto fnLiteral = static_cast<Ast::FunctionLiteralExprAst *>(exp);
                
 
-                Ast::BlockStatement body = nullptr;
-                if (fnLiteral->isExprMode())
-                {
-                    Ast::Expression exprBody = fnLiteral->getExprBody();
-                   
-
-                    const Ast::AstAddressInfo &aai = exprBody->getAAI();
-                    Ast::Return st = std::make_shared<Ast::ReturnSt>(exprBody);
-                    st->setAAI(aai);
-
-                    body = std::make_shared<Ast::BlockStatementAst>();
-                    body->stmts.push_back(st); // convert to Ast::Statement
-                    body->setAAI(aai);
-                }
-                else
-                {
-                    body = fnLiteral->getBlockBody();
-                   
-                }
+                Ast::BlockStatement body = fnLiteral->getCallBody();
                 Function fn(FString(std::format("<LambdaFn>")),fnLiteral->paras, ValueType::Any, body, ctx
                             /*
                                 pass the ctx(fnLiteral eval context) as closure context
                             */
                 );
-                return std::make_shared<Object>(std::move(fn));
+                return Value(Object(std::move(fn)));
             }
             case AstType::InitExpr: {
-                auto initExpr = std::static_pointer_cast<Ast::InitExprAst>(exp);
+                auto initExpr = static_cast<Ast::InitExprAst *>(exp);
                
                 return evalInitExpr(initExpr, ctx);
             }
 
             case AstType::ListExpr: {
-                auto lstExpr = std::static_pointer_cast<Ast::ListExprAst>(exp);
+                auto lstExpr = static_cast<Ast::ListExprAst *>(exp);
                
 
-                List list;
-                for (auto &exp : lstExpr->val) { list.push_back(check_unwrap(eval(exp, ctx))); }
-                return std::make_shared<Object>(std::move(list));
+                std::vector<Value> elements;
+                elements.reserve(lstExpr->val.size());
+                for (auto &exp : lstExpr->val) { elements.push_back(check_unwrap(eval(exp, ctx))); }
+                return Value(Object(List(elements))); // packed when homogeneous
             }
 
             case AstType::MapExpr: {
-                auto mapExpr = std::static_pointer_cast<Ast::MapExprAst>(exp);
+                auto mapExpr = static_cast<Ast::MapExprAst *>(exp);
                
 
                 Map map;
+                map.reserve(mapExpr->val.size());
                 for (auto &[key, value] : mapExpr->val) {
                     map[check_unwrap(eval(key, ctx))] = check_unwrap(eval(value, ctx));
                 }
-                return std::make_shared<Object>(std::move(map));
+                return Value(Object(std::move(map)));
             }
 
             default: {
                 throw RuntimeError(FString(std::format("err type of expr: {}", magic_enum::enum_name(type))));
             }
         }
-        return Object::getNullInstance(); // ignore warning
+        return Value(); // ignore warning
     }
 };
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/LvObject.hpp>
-#include <Evaluator/Value/IntPool.hpp>
+#include <Evaluator/Core/BinaryOps.hpp>
 #include <Evaluator/evaluator.hpp>
 #include <Evaluator/evaluator_error.hpp>
 #include <Evaluator/Core/ExprResult.hpp>
@@ -21,105 +21,63 @@ namespace Fig
         Ast::Expression lexp = bin->lexp, rexp = bin->rexp;
 
         const auto &tryInvokeOverloadFn =
-            [ctx, op](const ObjectPtr &lhs, const ObjectPtr &rhs, const std::function<ExprResult()> &rollback) {
-                if (lhs->is<StructInstance>() && lhs->getTypeInfo() == rhs->getTypeInfo())
+            [&ctx, bin, op](const Value &lhs, const Value &rhs, auto &&rollback) -> ExprResult {
+                // rollback is taken as-is: wrapping it in std::function would heap allocate on every operator
+                if (const OperationRecord *record = BinaryOps::findOverload(op, lhs, rhs, *ctx, bin->overload))
                 {
-                    // 运算符重载
-                    const TypeInfo &type = actualType(lhs);
-                    if (ctx->hasOperatorImplemented(type, op))
-                    {
-                        const auto &fnOpt = ctx->getBinaryOperatorFn(type, op);
-                        return (*fnOpt)(lhs, rhs);
-                    }
+                    return record->getBinaryOpFn(op)(lhs, rhs); // 运算符重载
                 }
                 return rollback();
             };
 
         switch (op)
         {
-            case Operator::Add: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() + rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(*lhs + *rhs);
-                });
-            }
-            case Operator::Subtract: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() - rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(*lhs - *rhs);
-                });
-            }
-            case Operator::Multiply: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() * rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(*lhs * *rhs);
-                });
-            }
-            case Operator::Divide: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs / *rhs); });
-            }
-            case Operator::Modulo: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass lv = lhs->as<ValueType::IntClass>();
-                        ValueType::IntClass rv = rhs->as<ValueType::IntClass>();
-                        if (rv == 0) { throw ValueError(FString(std::format("Modulo by zero: {} % {}", lv, rv))); }
-                        ValueType::IntClass result = lv / rv;
-                        ValueType::IntClass r = lv % rv;
-                        if (r != 0 && ((lv < 0) != (rv < 0))) { result -= 1; }
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(*lhs % *rhs);
-                });
+            case Operator::Add:
+            case Operator::Subtract:
+            case Operator::Multiply:
+            case Operator::Divide:
+            case Operator::Modulo:
+            case Operator::BitAnd:
+            case Operator::BitOr:
+            case Operator::BitXor:
+            case Operator::ShiftLeft:
+            case Operator::ShiftRight:
+            case Operator::Equal:
+            case Operator::NotEqual:
+            case Operator::Less:
+            case Operator::LessEqual:
+            case Operator::Greater:
+            case Operator::GreaterEqual: {
+                // builtin operands go straight to their kernel, without overload lookup or a Context walk
+                Value lhs = check_unwrap(eval(lexp, ctx));
+                Value rhs = check_unwrap(eval(rexp, ctx));
+                return BinaryOps::apply(op, lhs, rhs, *ctx, bin->overload);
             }
 
             case Operator::Is: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
+                Value lhs = check_unwrap(eval(lexp, ctx));
+                Value rhs = check_unwrap(eval(rexp, ctx));
 
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs, ctx, bin]() {
-                    const TypeInfo &lhsType = lhs->getTypeInfo();
-                    const TypeInfo &rhsType = rhs->getTypeInfo();
+                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs, ctx, bin]() -> Value {
+                    const TypeInfo &lhsType = lhs.getTypeInfo();
+                    const TypeInfo &rhsType = rhs.getTypeInfo();
 
-                    if (lhs->is<StructInstance>() && rhs->is<StructType>())
+                    if (lhs.is<StructInstance>() && rhs.is<StructType>())
                     {
-                        const StructInstance &si = lhs->as<StructInstance>();
-                        const StructType &st = rhs->as<StructType>();
-                        return std::make_shared<Object>(si.parentType == st.type);
+                        const StructInstance &si = lhs.as<StructInstance>();
+                        const StructType &st = rhs.as<StructType>();
+                        return Value::Bool(si.parentType == st.type);
                     }
-                    if (lhs->is<StructInstance>() && rhs->is<InterfaceType>())
+                    if (lhs.is<StructInstance>() && rhs.is<InterfaceType>())
                     {
-                        const StructInstance &si = lhs->as<StructInstance>();
-                        const InterfaceType &it = rhs->as<InterfaceType>();
-                        return std::make_shared<Object>(implements(si.parentType, it.type, ctx));
+                        const StructInstance &si = lhs.as<StructInstance>();
+                        const InterfaceType &it = rhs.as<InterfaceType>();
+                        return Value::Bool(implements(si.parentType, it.type, ctx));
                     }
 
                     if (ValueType::isTypeBuiltin(lhsType) && rhsType == ValueType::StructType)
                     {
-                        const StructType &st = rhs->as<StructType>();
+                        const StructType &st = rhs.as<StructType>();
                         const TypeInfo &type = st.type;
                         /*
                             如果是内置类型(e.g. Int, String)
@@ -135,8 +93,8 @@ namespace Fig
                             而 R 类型为 StructType (builtins.hpp) 中注册
                             拿到 R 的 StructType, 其中的 type 为 String
                         */
-                        if (lhs->getTypeInfo() == type) { return Object::getTrueInstance(); }
-                        return Object::getFalseInstance();
+                        if (lhs.getTypeInfo() == type) { return Value::Bool(true); }
+                        return Value::Bool(false);
                     }
 
                     throw EvaluatorError(u8"TypeError",
@@ -148,11 +106,11 @@ namespace Fig
             }
 
             case Operator::As: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
+                Value lhs = check_unwrap(eval(lexp, ctx));
+                Value rhs = check_unwrap(eval(rexp, ctx));
 
                 return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs, ctx, bin, this]() -> ExprResult {
-                    if (!rhs->is<StructType>())
+                    if (!rhs.is<StructType>())
                     {
                         throw EvaluatorError(
                             u8"OperatorError",
@@ -160,36 +118,33 @@ namespace Fig
                                         prettyType(rhs).toBasicString()),
                             bin->rexp);
                     }
-                    const StructType &targetStructType = rhs->as<StructType>();
+                    const StructType &targetStructType = rhs.as<StructType>();
                     const TypeInfo &targetType = targetStructType.type;
-                    const TypeInfo &sourceType = lhs->getTypeInfo();
+                    const TypeInfo &sourceType = lhs.getTypeInfo();
                     if (targetType == sourceType) { return lhs; }
-                    if (targetType == ValueType::String) { return std::make_shared<Object>(lhs->toStringIO()); }
+                    if (targetType == ValueType::String) { return Value(Object(lhs.toStringIO())); }
                     if (sourceType == ValueType::Int)
                     {
                         if (targetType == ValueType::Double)
                         {
-                            return std::make_shared<Object>(
-                                static_cast<ValueType::DoubleClass>(lhs->as<ValueType::IntClass>()));
+                            return Value::Double(static_cast<ValueType::DoubleClass>(lhs.as<ValueType::IntClass>()));
                         }
                     }
                     else if (sourceType == ValueType::Double)
                     {
                         if (targetType == ValueType::Int)
                         {
-                            return IntPool::getInstance().createInt(
-                                static_cast<ValueType::IntClass>(lhs->as<ValueType::DoubleClass>()));
+                            return Value::Int(static_cast<ValueType::IntClass>(lhs.as<ValueType::DoubleClass>()));
                         }
                     }
                     else if (sourceType == ValueType::String)
                     {
-                        const FString &str = lhs->as<ValueType::StringClass>();
+                        const ValueType::StringClass &str = lhs.as<ValueType::StringClass>();
                         if (targetType == ValueType::Int)
                         {
                             try
                             {
-                                return IntPool::getInstance().createInt(
-                                    static_cast<ValueType::IntClass>(std::stoll(str.toBasicString())));
+                                return Value::Int(static_cast<ValueType::IntClass>(std::stoll(str.toBasicString())));
                             }
                             catch (std::exception &e)
                             {
@@ -206,7 +161,7 @@ namespace Fig
                         {
                             try
                             {
-                                return std::make_shared<Object>(std::stod(str.toBasicString()));
+                                return Value::Double(std::stod(str.toBasicString()));
                             }
                             catch (std::exception &e)
                             {
@@ -221,8 +176,8 @@ namespace Fig
                         }
                         if (targetType == ValueType::Bool)
                         {
-                            if (str == u8"true") { return Object::getTrueInstance(); }
-                            else if (str == u8"false") { return Object::getFalseInstance(); }
+                            if (str.asciiView() == "true") { return Value::Bool(true); }
+                            else if (str.asciiView() == "false") { return Value::Bool(false); }
                             return ExprResult::error(
                                 genTypeError(FString(std::format("Cannot cast type `{}` to `{}`, bad bool string {}",
                                                                  prettyType(lhs).toBasicString(),
@@ -236,11 +191,11 @@ namespace Fig
                     {
                         if (targetType == ValueType::Int)
                         {
-                            return IntPool::getInstance().createInt(static_cast<ValueType::IntClass>(lhs->as<ValueType::BoolClass>()));
+                            return Value::Int(static_cast<ValueType::IntClass>(lhs.as<ValueType::BoolClass>()));
                         }
                         if (targetType == ValueType::Double)
                         {
-                            return std::make_shared<Object>(static_cast<ValueType::DoubleClass>(lhs->as<ValueType::BoolClass>()));
+                            return Value::Double(static_cast<ValueType::DoubleClass>(lhs.as<ValueType::BoolClass>()));
                         }
                     }
 
@@ -252,178 +207,36 @@ namespace Fig
                 });
             }
 
-            case Operator::BitAnd: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() & rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(bit_and(*lhs, *rhs));
-                });
-            }
-
-            case Operator::BitOr: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() | rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(bit_or(*lhs, *rhs));
-                });
-            }
-
-            case Operator::BitXor: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() ^ rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(bit_xor(*lhs, *rhs));
-                });
-            }
-
-            case Operator::ShiftLeft: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() << rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(shift_left(*lhs, *rhs));
-                });
-            }
-            case Operator::ShiftRight: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() {
-                    if (lhs->is<ValueType::IntClass>() && rhs->is<ValueType::IntClass>())
-                    {
-                        ValueType::IntClass result = lhs->as<ValueType::IntClass>() >> rhs->as<ValueType::IntClass>();
-                        return IntPool::getInstance().createInt(result);
-                    }
-                    return std::make_shared<Object>(shift_right(*lhs, *rhs));
-                });
-            }
-
             case Operator::Assign: {
                 LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
+                Value rhs = check_unwrap(eval(rexp, ctx));
                 lv.set(rhs);
                 return rhs;
             }
 
             case Operator::And: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                if (lhs->is<bool>() && !isBoolObjectTruthy(lhs)) { return Object::getFalseInstance(); }
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs && *rhs); });
+                Value lhs = check_unwrap(eval(lexp, ctx));
+                if (lhs.is<bool>() && !isBoolObjectTruthy(lhs)) { return Value::Bool(false); }
+                Value rhs = check_unwrap(eval(rexp, ctx));
+                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return Value(*lhs.toObject() && *rhs.toObject()); });
             }
 
             case Operator::Or: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                if (lhs->is<bool>() && isBoolObjectTruthy(lhs)) { return Object::getTrueInstance(); }
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs || *rhs); });
-            }
-
-            case Operator::Equal: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs == *rhs); });
-            }
-
-            case Operator::NotEqual: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs != *rhs); });
-            }
-
-            case Operator::Less: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs < *rhs); });
-            }
-
-            case Operator::LessEqual: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs <= *rhs); });
-            }
-
-            case Operator::Greater: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs > *rhs); });
-            }
-
-            case Operator::GreaterEqual: {
-                ObjectPtr lhs = check_unwrap(eval(lexp, ctx));
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs >= *rhs); });
-            }
-
-            case Operator::PlusAssign: {
-                LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                const ObjectPtr &lhs = lv.get();
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                const ObjectPtr &result = check_unwrap(
-                    tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs + *rhs); }));
-                lv.set(result);
-                return rhs;
-            }
-
-            case Operator::MinusAssign: {
-                LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                const ObjectPtr &lhs = lv.get();
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                const ObjectPtr &result = check_unwrap(
-                    tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs - *rhs); }));
-                lv.set(result);
-                return rhs;
-            }
-
-            case Operator::AsteriskAssign: {
-                LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                const ObjectPtr &lhs = lv.get();
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                const ObjectPtr &result = check_unwrap(
-                    tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs * *rhs); }));
-                lv.set(result);
-                return rhs;
-            }
-
-            case Operator::SlashAssign: {
-                LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                const ObjectPtr &lhs = lv.get();
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                const ObjectPtr &result = check_unwrap(
-                    tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs / *rhs); }));
-                lv.set(result);
-                return rhs;
+                Value lhs = check_unwrap(eval(lexp, ctx));
+                if (lhs.is<bool>() && isBoolObjectTruthy(lhs)) { return Value::Bool(true); }
+                Value rhs = check_unwrap(eval(rexp, ctx));
+                return tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return Value(*lhs.toObject() || *rhs.toObject()); });
             }
 
+            case Operator::PlusAssign:
+            case Operator::MinusAssign:
+            case Operator::AsteriskAssign:
+            case Operator::SlashAssign:
             case Operator::PercentAssign: {
                 LvObject lv = check_unwrap_lv(evalLv(lexp, ctx));
-                const ObjectPtr &lhs = lv.get();
-                ObjectPtr rhs = check_unwrap(eval(rexp, ctx));
-                const ObjectPtr &result = check_unwrap(
-                    tryInvokeOverloadFn(lhs, rhs, [lhs, rhs]() { return std::make_shared<Object>(*lhs % *rhs); }));
+                Value lhs = lv.get();
+                Value rhs = check_unwrap(eval(rexp, ctx));
+                const Value &result = check_unwrap(BinaryOps::apply(op, lhs, rhs, *ctx, bin->overload));
                 lv.set(result);
                 return rhs;
             }
@@ -3,6 +3,8 @@
 #include <Ast/Expressions/FunctionCall.hpp>
 #include <Evaluator/Value/function.hpp>
 #include <Evaluator/Value/LvObject.hpp>
+#include <Evaluator/Context/Collector.hpp>
+#include <Evaluator/Context/FramePool.hpp>
 #include <Evaluator/evaluator.hpp>
 #include <Evaluator/evaluator_error.hpp>
 #include <Evaluator/Core/ExprResult.hpp>
@@ -19,7 +21,7 @@ namespace Fig
             if (fn.type == Function::Builtin) { return fn.builtin(args.argv); }
             else
             {
-                return fn.mtFn(nullptr,
+                return fn.mtFn(Value(),
                                args.argv); // wrapped member type function (`this` provided by evalMemberExpr)
             }
         }
@@ -36,19 +38,103 @@ namespace Fig
                 return sr.result;
             }
         }
-        return Object::getNullInstance();
+        return Value();
+    }
+    void Evaluator::checkDefaultType(const Function &fn,
+                                     const FString &paraName,
+                                     const TypeInfo &expectedType,
+                                     const Value &defaultVal,
+                                     Ast::AstBase where)
+    {
+        if (isTypeMatch(expectedType, defaultVal, fn.closureContext)) { return; }
+        throw EvaluatorError(
+            u8"DefaultParameterTypeError",
+            std::format("In function '{}', default parameter '{}' has type '{}', which does not match the expected type '{}'",
+                        fn.name.toBasicString(),
+                        paraName.toBasicString(),
+                        prettyType(defaultVal).toBasicString(),
+                        expectedType.toString().toBasicString()),
+            where);
+    }
+    ExprResult Evaluator::resolveSignature(const Function &fn)
+    {
+        CompiledSignature &sig = *fn.signature;
+        if (sig.resolved) { return Value(); }
+
+        const Ast::FunctionParameters &paras = fn.paras;
+        sig.minArgs = paras.posParas.size();
+        sig.maxArgs = paras.size();
+        sig.paraTypes.clear();
+        sig.paraTypes.reserve(sig.maxArgs);
+        sig.paraNames.clear();
+        sig.paraNames.reserve(sig.maxArgs);
+        sig.defaults.clear();
+        sig.defaults.reserve(paras.defParas.size());
+
+        for (const auto &para : paras.posParas)
+        {
+            sig.paraTypes.push_back(actualType(check_unwrap(eval(para.second, fn.closureContext))));
+            sig.paraNames.push_back(para.first);
+        }
+        for (const auto &para : paras.defParas)
+        {
+            const auto &def = para.second; // type exp, default value
+            const TypeInfo &expectedType =
+                sig.paraTypes.emplace_back(actualType(check_unwrap(eval(def.first, fn.closureContext))));
+            sig.paraNames.push_back(para.first);
+
+            // a literal is the same object on every eval anyway, checked here once
+            ObjectPtr literal = (def.second->getType() == Ast::AstType::ValueExpr ?
+                                     static_cast<Ast::ValueExprAst *>(def.second)->val :
+                                     nullptr);
+            if (literal) { checkDefaultType(fn, para.first, expectedType, literal, def.second); }
+            sig.defaults.push_back(std::move(literal));
+        }
+        sig.resolved = true; // only once every type resolved, a failed lookup is retried next call
+        return Value();
     }
     ExprResult Evaluator::evalFunctionCall(const Ast::FunctionCall &call, ContextPtr ctx)
     {
-        RvObject fnObj = check_unwrap(eval(call->callee, ctx));
-        if (fnObj->getTypeInfo() != ValueType::Function)
+        RvObject fnObj;
+        if (call->callee->getType() == Ast::AstType::MemberExpr)
+        {
+            // obj.method(args): call builtin type method directly, no bound Function object
+            Ast::MemberExpr me = static_cast<Ast::MemberExprAst *>(call->callee);
+            RvObject baseVal = check_unwrap(eval(me->base, ctx));
+
+            if (me->methodId == -2) { me->methodId = Object::getMemberMethodId(me->member); }
+            if (const BuiltinMemberMethod *method = baseVal.findMemberMethod(me->methodId))
+            {
+                const Ast::FunctionArguments &fnArgs = call->arg;
+                std::vector<Value> args;
+                args.reserve(fnArgs.getLength());
+                for (const auto &argExpr : fnArgs.argv) { args.push_back(check_unwrap(eval(argExpr, ctx))); }
+                if (method->paraCount != -1 && method->paraCount != args.size())
+                {
+                    throw EvaluatorError(u8"BuiltinArgumentMismatchError",
+                                         std::format("Builtin function '{}' expects {} arguments, but {} were provided",
+                                                     me->member.toBasicString(),
+                                                     method->paraCount,
+                                                     args.size()),
+                                         (fnArgs.getLength() > 0 ? fnArgs.argv.back() : call));
+                }
+                ProfileScope profileScope(profiler, method, baseVal, me->member);
+                return (*method->fn)(baseVal, args);
+            }
+            fnObj = check_unwrap_lv(evalMemberOf(baseVal, me, ctx)).get(); // base evaluated only once
+        }
+        else
+        {
+            fnObj = check_unwrap(eval(call->callee, ctx));
+        }
+        if (fnObj.getTypeInfo() != ValueType::Function)
         {
             throw EvaluatorError(u8"ObjectNotCallable",
-                                 std::format("Object `{}` isn't callable", fnObj->toString().toBasicString()),
+                                 std::format("Object `{}` isn't callable", fnObj.toString().toBasicString()),
                                  call->callee);
         }
 
-        const Function &fn = fnObj->as<Function>();
+        const Function &fn = fnObj.as<Function>();
 
         const FString &fnName = fn.name;
         const Ast::FunctionArguments &fnArgs = call->arg;
@@ -66,15 +152,25 @@ namespace Fig
                                                  evaluatedArgs.getLength()),
                                      (fnArgs.getLength() > 0 ? fnArgs.argv.back() : call));
             }
+            ProfileScope profileScope(profiler, fn);
             return executeFunction(fn, evaluatedArgs, nullptr);
         }
+        if (fn.type == Function::Compiled)
+        {
+            throw EvaluatorError(u8"ObjectNotCallable",
+                                 std::format("Function '{}' is compiled bytecode, run it with --vm", fnName.toBasicString()),
+                                 call->callee);
+        }
 
         // check argument, all types of parameters
-        Ast::FunctionParameters fnParas = fn.paras;
+        const Ast::FunctionParameters &fnParas = fn.paras; // fnObj keeps fn alive
+
+        // safe point: everything in use is held by the frames below
+        Collector::getInstance().maybeCollect();
 
         // create new context for function call
-        auto newContext = std::make_shared<Context>(FString(std::format("<Function {}()>", fnName.toBasicString())),
-                                                    fn.closureContext);
+        ContextPtr newContext = FramePool::acquire(ScopeKind::Function, fn.body, fn.closureContext);
+        newContext->setScopeName(fnName); // formatted lazily
 
         if (fnParas.variadic)
             goto VariadicFilling;
@@ -82,23 +178,24 @@ namespace Fig
             goto NormalFilling;
 
     NormalFilling: {
-        if (fnArgs.getLength() < fnParas.posParas.size() || fnArgs.getLength() > fnParas.size())
+        check_unwrap(resolveSignature(fn)); // types evaluated once, not twice per call
+        const CompiledSignature &sig = *fn.signature;
+        if (fnArgs.getLength() < sig.minArgs || fnArgs.getLength() > sig.maxArgs)
         {
             throw RuntimeError(FString(std::format("Function '{}' expects {} to {} arguments, but {} were provided",
                                                    fnName.toBasicString(),
-                                                   fnParas.posParas.size(),
-                                                   fnParas.size(),
+                                                   sig.minArgs,
+                                                   sig.maxArgs,
                                                    fnArgs.getLength())));
         }
+        evaluatedArgs.argv.reserve(sig.maxArgs);
 
         // positional parameters type check
         size_t i;
-        for (i = 0; i < fnParas.posParas.size(); i++)
+        for (i = 0; i < sig.minArgs; i++)
         {
-            const TypeInfo &expectedType = actualType(check_unwrap(eval(fnParas.posParas[i].second, fn.closureContext))); // look up type info, if exists a type
-                                                                                  // with the name, use it, else throw
-            ObjectPtr argVal = check_unwrap(eval(fnArgs.argv[i], ctx));
-            TypeInfo actualType = argVal->getTypeInfo();
+            const TypeInfo &expectedType = sig.paraTypes[i];
+            Value argVal = check_unwrap(eval(fnArgs.argv[i], ctx));
             if (!isTypeMatch(expectedType, argVal, fn.closureContext))
             {
                 throw EvaluatorError(u8"ArgumentTypeMismatchError",
@@ -106,34 +203,19 @@ namespace Fig
                                                  fnName.toBasicString(),
                                                  fnParas.posParas[i].first.toBasicString(),
                                                  expectedType.toString().toBasicString(),
-                                                 actualType.toString().toBasicString()),
+                                                 argVal.getTypeInfo().toString().toBasicString()),
                                      fnArgs.argv[i]);
             }
-            evaluatedArgs.argv.push_back(argVal);
+            evaluatedArgs.argv.push_back(std::move(argVal));
         }
-        // default parameters type check
+
+        // supplied default parameters: only the argument is checked, the default is not evaluated
         for (; i < fnArgs.getLength(); i++)
         {
-            size_t defParamIndex = i - fnParas.posParas.size();
-            const TypeInfo &expectedType =
-                actualType(check_unwrap(eval(fnParas.defParas[defParamIndex].second.first, fn.closureContext)));
-
-            ObjectPtr defaultVal = check_unwrap(eval(fnParas.defParas[defParamIndex].second.second, fn.closureContext));
-            if (!isTypeMatch(expectedType, defaultVal, fn.closureContext))
-            {
-                throw EvaluatorError(
-                    u8"DefaultParameterTypeError",
-                    std::format(
-                        "In function '{}', default parameter '{}' has type '{}', which does not match the expected type '{}'",
-                        fnName.toBasicString(),
-                        fnParas.defParas[defParamIndex].first.toBasicString(),
-                        prettyType(defaultVal).toBasicString(),
-                        expectedType.toString().toBasicString()),
-                    fnArgs.argv[i]);
-            }
+            size_t defParamIndex = i - sig.minArgs;
+            const TypeInfo &expectedType = sig.paraTypes[i];
 
-            ObjectPtr argVal = check_unwrap(eval(fnArgs.argv[i], ctx));
-            TypeInfo actualType = argVal->getTypeInfo();
+            Value argVal = check_unwrap(eval(fnArgs.argv[i], ctx));
             if (!isTypeMatch(expectedType, argVal, fn.closureContext))
             {
                 throw EvaluatorError(u8"ArgumentTypeMismatchError",
@@ -141,55 +223,54 @@ namespace Fig
                                                  fnName.toBasicString(),
                                                  fnParas.defParas[defParamIndex].first.toBasicString(),
                                                  expectedType.toString().toBasicString(),
-                                                 actualType.toString().toBasicString()),
+                                                 argVal.getTypeInfo().toString().toBasicString()),
                                      fnArgs.argv[i]);
             }
-            evaluatedArgs.argv.push_back(argVal);
+            evaluatedArgs.argv.push_back(std::move(argVal));
         }
-        // default parameters filling
-        for (; i < fnParas.size(); i++)
+        // missing default parameters: a literal was checked by resolveSignature, anything else is evaluated
+        // in the closure and checked here
+        for (; i < sig.maxArgs; i++)
         {
-            size_t defParamIndex = i - fnParas.posParas.size();
-            ObjectPtr defaultVal = check_unwrap(eval(fnParas.defParas[defParamIndex].second.second, fn.closureContext));
-            evaluatedArgs.argv.push_back(defaultVal);
+            size_t defParamIndex = i - sig.minArgs;
+            Value defaultVal = sig.defaults[defParamIndex];
+            if (!sig.defaults[defParamIndex])
+            {
+                const auto &[paraName, para] = fnParas.defParas[defParamIndex];
+                defaultVal = check_unwrap(eval(para.second, fn.closureContext));
+                checkDefaultType(fn, paraName, sig.paraTypes[i], defaultVal, para.second);
+            }
+            evaluatedArgs.argv.push_back(std::move(defaultVal));
         }
 
         // define parameters in new context
-        for (size_t j = 0; j < fnParas.size(); j++)
+        for (size_t j = 0; j < sig.maxArgs; j++)
         {
-            FString paramName;
-            TypeInfo paramType;
-            if (j < fnParas.posParas.size())
-            {
-                paramName = fnParas.posParas[j].first;
-                paramType = actualType(check_unwrap(eval(fnParas.posParas[j].second, fn.closureContext)));
-            }
-            else
-            {
-                size_t defParamIndex = j - fnParas.posParas.size();
-                paramName = fnParas.defParas[defParamIndex].first;
-                paramType =
-                    actualType(check_unwrap(eval(fnParas.defParas[defParamIndex].second.first, fn.closureContext)));
-            }
             AccessModifier argAm = AccessModifier::Normal;
-            newContext->def(paramName, paramType, argAm, evaluatedArgs.argv[j]);
+            newContext->def(sig.paraNames[j], sig.paraTypes[j], argAm, evaluatedArgs.argv[j], static_cast<int>(j)); // slot j, see Resolver
         }
         goto ExecuteBody;
     }
 
     VariadicFilling: {
-        List list;
+        std::vector<Value> elements;
+        elements.reserve(fnArgs.argv.size());
         for (auto &exp : fnArgs.argv)
         {
-            list.push_back(check_unwrap(eval(exp, ctx))); // eval arguments in current scope
+            elements.push_back(check_unwrap(eval(exp, ctx))); // eval arguments in current scope
         }
-        newContext->def(fnParas.variadicPara, ValueType::List, AccessModifier::Normal, std::make_shared<Object>(list));
+        newContext->def(fnParas.variadicPara,
+                        ValueType::List,
+                        AccessModifier::Normal,
+                        Value(Object(List(elements))),
+                        0);
         goto ExecuteBody;
     }
 
     ExecuteBody: {
         // execute function body
-        ObjectPtr retVal = check_unwrap(executeFunction(fn, evaluatedArgs, newContext));
+        ProfileScope profileScope(profiler, fn);
+        Value retVal = check_unwrap(executeFunction(fn, evaluatedArgs, newContext));
 
         if (!isTypeMatch(fn.retType, retVal, ctx))
         {
@@ -9,15 +9,15 @@ namespace Fig
     ExprResult Evaluator::evalInitExpr(Ast::InitExpr initExpr, ContextPtr ctx)
     {
         LvObject structeLv = check_unwrap_lv(evalLv(initExpr->structe, ctx));
-        ObjectPtr structTypeVal = structeLv.get();
+        Value structTypeVal = structeLv.get();
         const FString &structName = structeLv.name();
-        if (!structTypeVal->is<StructType>())
+        if (!structTypeVal.is<StructType>())
         {
             throw EvaluatorError(u8"NotAStructTypeError",
                                  std::format("'{}' is not a structure type", structName.toBasicString()),
                                  initExpr);
         }
-        const StructType &structT = structTypeVal->as<StructType>();
+        const StructType &structT = structTypeVal.as<StructType>();
 
         if (structT.builtin)
         {
@@ -44,10 +44,10 @@ namespace Fig
                         std::format("Builtin type `{}` cannot be constructed", type.toString().toBasicString()),
                         initExpr);
                 }
-                return std::make_shared<Object>(Object::defaultValue(type));
+                return Value(Object::defaultValue(type));
             }
 
-            ObjectPtr val = check_unwrap(eval(args[0].second, ctx));
+            Value val = check_unwrap(eval(args[0].second, ctx));
 
             auto err = [&](const char *msg) {
                 throw EvaluatorError(u8"BuiltinInitTypeMismatchError",
@@ -58,66 +58,55 @@ namespace Fig
             // ===================== Int =====================
             if (type == ValueType::Int)
             {
-                if (!val->is<ValueType::IntClass>()) err("expects Int");
-                return std::make_shared<Object>(val->as<ValueType::IntClass>());
+                if (!val.is<ValueType::IntClass>()) err("expects Int");
+                return Value::Int(val.as<ValueType::IntClass>());
             }
 
             // ===================== Double =====================
             if (type == ValueType::Double)
             {
-                if (!val->is<ValueType::DoubleClass>()) err("expects Double");
-                return std::make_shared<Object>(val->as<ValueType::DoubleClass>());
+                if (!val.is<ValueType::DoubleClass>()) err("expects Double");
+                return Value::Double(val.as<ValueType::DoubleClass>());
             }
 
             // ===================== Bool =====================
             if (type == ValueType::Bool)
             {
-                if (!val->is<ValueType::BoolClass>()) err("expects Bool");
-                return std::make_shared<Object>(val->as<ValueType::BoolClass>());
+                if (!val.is<ValueType::BoolClass>()) err("expects Bool");
+                return Value::Bool(val.as<ValueType::BoolClass>());
             }
 
             // ===================== String =====================
             if (type == ValueType::String)
             {
-                if (!val->is<ValueType::StringClass>()) err("expects String");
-                return std::make_shared<Object>(val->as<ValueType::StringClass>());
+                if (!val.is<ValueType::StringClass>()) err("expects String");
+                return Value(Object(val.as<ValueType::StringClass>()));
             }
 
             // ===================== Null =====================
             if (type == ValueType::Null)
             {
                 // Null basically ignores input but keep invariant strict:
-                if (!val->is<ValueType::NullClass>()) err("expects Null");
-                return Object::getNullInstance();
+                if (!val.is<ValueType::NullClass>()) err("expects Null");
+                return Value();
             }
 
             // ===================== List =====================
             if (type == ValueType::List)
             {
-                if (!val->is<List>()) err("expects List");
+                if (!val.is<List>()) err("expects List");
 
-                const auto &src = val->as<List>();
-                auto copied = std::make_shared<Object>(List{});
-
-                auto &dst = copied->as<List>();
-                dst.reserve(src.size());
-                for (auto &e : src) dst.push_back(e); // shallow element copy, but new container
-
-                return copied;
+                // shallow element copy, but new container (packed storage is copied as it is)
+                return Value(Object(val.as<List>()));
             }
 
             // ===================== Map =====================
             if (type == ValueType::Map)
             {
-                if (!val->is<Map>()) err("expects Map");
-
-                const auto &src = val->as<Map>();
-                auto copied = std::make_shared<Object>(Map{});
-
-                auto &dst = copied->as<Map>();
-                for (auto &[k, v] : src) dst.emplace(k, v);
+                if (!val.is<Map>()) err("expects Map");
 
-                return copied;
+                // keys, order and cached hashes are copied as they are
+                return Value(Object(val.as<Map>()));
             }
 
             throw EvaluatorError(
@@ -149,18 +138,54 @@ namespace Fig
                                  initExpr);
         }
 
-        std::vector<std::pair<FString, ObjectPtr>> evaluatedArgs;
+        // fields are laid out by the shape, slot i is structT.fields[i]
+        std::vector<VariableSlot> slots(maxArgs);
+        std::vector<bool> initialized(maxArgs, false);
+
+        auto initField = [&](size_t i, const Value &value) {
+            const Field &field = structT.fields[i];
+            if (initialized[i])
+            {
+                throw EvaluatorError(u8"StructFieldRedeclarationError",
+                                     std::format("Field '{}' already initialized in structure '{}'",
+                                                 field.name.toBasicString(),
+                                                 structName.toBasicString()),
+                                     initExpr);
+            }
+            if (!isTypeMatch(field.type, value, ctx))
+            {
+                throw EvaluatorError(
+                    u8"StructFieldTypeMismatchError",
+                    std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
+                                structName.toBasicString(),
+                                field.name.toBasicString(),
+                                field.type.toString().toBasicString(),
+                                prettyType(value).toBasicString()),
+                    initExpr);
+            }
+            slots[i] = VariableSlot{field.name, value, field.type, field.am};
+            initialized[i] = true;
+        };
 
-        auto evalArguments = [&evaluatedArgs, initExpr, ctx, this](){
-            for (const auto &[argName, argExpr] : initExpr->args)
+        auto fillDefaults = [&]() {
+            for (size_t i = 0; i < maxArgs; ++i)
             {
-                evaluatedArgs.push_back({argName, check_unwrap(eval(argExpr, ctx))});
+                if (initialized[i]) continue;
+                const Field &field = structT.fields[i];
+                if (field.defaultValue == nullptr)
+                {
+                    throw EvaluatorError(u8"StructInitArgumentMismatchError",
+                                         std::format("Field '{}' of structure '{}' has no default value",
+                                                     field.name.toBasicString(),
+                                                     structName.toBasicString()),
+                                         initExpr);
+                }
+                // evaluate default value in definition context!
+                initField(i, check_unwrap(eval(field.defaultValue, defContext)));
             }
-            return ExprResult::normal(Object::getNullInstance());
+            return ExprResult::normal(Value());
         };
 
-        ContextPtr instanceCtx =
-            std::make_shared<Context>(FString(std::format("<StructInstance {}>", structName.toBasicString())), defContext);
         /*
             3 ways of calling constructor
             .1 Person {"Fig", 1, "IDK"};
@@ -171,193 +196,36 @@ namespace Fig
             using enum Ast::InitExprAst::InitMode;
             if (initExpr->initMode == Positional)
             {
-                evalArguments();
-
-                for (size_t i = 0; i < maxArgs; ++i)
-                {
-                    const Field &field = structT.fields[i];
-                    const FString &fieldName = field.name;
-                    const TypeInfo &expectedType = field.type;
-                    if (i >= evaluatedArgs.size())
-                    {
-                        // we've checked argument count before, so here
-                        // must be a default value
-
-                        // evaluate default value in definition context!
-                        ObjectPtr defaultVal = check_unwrap(eval(field.defaultValue,
-                                                                 defContext)); // it can't be null here
-
-                        // type check
-                        if (!isTypeMatch(expectedType, defaultVal, ctx))
-                        {
-                            throw EvaluatorError(
-                                u8"StructFieldTypeMismatchError",
-                                std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                            structName.toBasicString(),
-                                            fieldName.toBasicString(),
-                                            expectedType.toString().toBasicString(),
-                                            prettyType(defaultVal).toBasicString()),
-                                initExpr);
-                        }
-
-                        instanceCtx->def(fieldName, expectedType, field.am, defaultVal);
-                        continue;
-                    }
-
-                    const ObjectPtr &argVal = evaluatedArgs[i].second;
-                    if (!isTypeMatch(expectedType, argVal, ctx))
-                    {
-                        throw EvaluatorError(
-                            u8"StructFieldTypeMismatchError",
-                            std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                        structName.toBasicString(),
-                                        fieldName.toBasicString(),
-                                        expectedType.toString().toBasicString(),
-                                        prettyType(argVal).toBasicString()),
-                            initExpr);
-                    }
-                    instanceCtx->def(fieldName, expectedType, field.am, argVal);
-                }
+                for (size_t i = 0; i < got; ++i) { initField(i, check_unwrap(eval(initExpr->args[i].second, ctx))); }
             }
-            else if (initExpr->initMode == Named)
+            else
             {
-                evalArguments();
-
-                // named
-                for (size_t i = 0; i < maxArgs; ++i)
+                // named / shorthand, can be unordered
+                // in shorthand mode initExpr args are all VarExpr, the field name is the variable name
+                for (size_t i = 0; i < initExpr->args.size(); ++i)
                 {
-                    const Field &field = structT.fields[i];
-                    const FString &fieldName = (field.name.empty() ? evaluatedArgs[i].first : field.name);
-                    if (instanceCtx->containsInThisScope(fieldName))
-                    {
-                        throw EvaluatorError(u8"StructFieldRedeclarationError",
-                                             std::format("Field '{}' already initialized in structure '{}'",
-                                                         fieldName.toBasicString(),
-                                                         structName.toBasicString()),
-                                             initExpr);
-                    }
-                    if (i + 1 > got)
+                    const auto &[argName, argExpr] = initExpr->args[i];
+                    int index = structT.shape->findField(initExpr->argSymbols[i]);
+                    if (index < 0)
                     {
-                        // use default value                  //
-                        // evaluate default value in definition context
-                        ObjectPtr defaultVal = check_unwrap(eval(field.defaultValue,
-                                                                 defContext)); // it can't be null here
-
-                        // type check
-                        const TypeInfo &expectedType = field.type;
-                        if (!isTypeMatch(expectedType, defaultVal, ctx))
+                        if (initExpr->initMode == Named)
                         {
-                            throw EvaluatorError(
-                                u8"StructFieldTypeMismatchError",
-                                std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                            structName.toBasicString(),
-                                            fieldName.toBasicString(),
-                                            expectedType.toString().toBasicString(),
-                                            prettyType(defaultVal).toBasicString()),
-                                initExpr);
+                            throw EvaluatorError(u8"StructFieldNotFoundError",
+                                                 std::format("Field '{}' not found in structure '{}'",
+                                                             argName.toBasicString(),
+                                                             structName.toBasicString()),
+                                                 initExpr);
                         }
-
-                        instanceCtx->def(fieldName, field.type, field.am, defaultVal);
-                        continue;
-                    }
-                    const ObjectPtr &argVal = evaluatedArgs[i].second;
-                    if (!isTypeMatch(field.type, argVal, ctx))
-                    {
-                        throw EvaluatorError(
-                            u8"StructFieldTypeMismatchError",
-                            std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                        structName.toBasicString(),
-                                        fieldName.toBasicString(),
-                                        field.type.toString().toBasicString(),
-                                        prettyType(argVal).toBasicString()),
-                            initExpr);
-                    }
-                    instanceCtx->def(fieldName, field.type, field.am, argVal);
-                }
-            }
-            else
-            {
-                // shorthand, can be unordered
-                // in this mode, initExpr args are all VarExpr
-                // field name is the variable name
-                for (const auto &[argName, argExpr] : initExpr->args)
-                {
-                    // assert(argExpr->getType() == Ast::AstType::VarExpr);
-                    // argName is var name
-                    const ObjectPtr &argVal = check_unwrap(eval(argExpr, ctx)); // get the value
-                    // find field
-                    auto fieldIt = std::find_if(structT.fields.begin(),
-                                                structT.fields.end(),
-                                                [&argName](const Field &f) { return f.name == argName; });
-                    if (fieldIt == structT.fields.end())
-                    {
-                        // throw EvaluatorError(u8"StructFieldNotFoundError",
-                        //                      std::format("Field '{}' not found in structure '{}'",
-                        //                                  argName.toBasicString(),
-                        //                                  structName.toBasicString()),
-                        //                      initExpr);
+                        // Point{a, b} with a, b not fields: positional
                         initExpr->initMode = Positional;
                         return evalInitExpr(initExpr, ctx);
                     }
-                    const Field &field = *fieldIt;
-                    if (!isTypeMatch(field.type, argVal, ctx))
-                    {
-                        throw EvaluatorError(
-                            u8"StructFieldTypeMismatchError",
-                            std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                        structName.toBasicString(),
-                                        field.name.toBasicString(),
-                                        field.type.toString().toBasicString(),
-                                        prettyType(argVal).toBasicString()),
-                            initExpr);
-                    }
-                    // field.name is argName (var name)
-                    // Point{x=x, y=y} --> Point{x, y}
-
-                    instanceCtx->def(field.name, field.type, field.am, argVal);
-                }
-                // fill default values
-                size_t currentFieldCount =
-                    initExpr->args.size(); // we have already check argument count, min <= got <= max
-                // so remain fields start from currentFieldCount to maxArgs
-                for (size_t i = currentFieldCount; i < maxArgs; ++i)
-                {
-                    const Field &field = structT.fields[i];
-
-                    // evaluate default value in definition context
-                    ObjectPtr defaultVal = check_unwrap(eval(field.defaultValue,
-                                                             defContext)); // it can't be null here
-
-                    // type check
-                    if (!isTypeMatch(field.type, defaultVal, ctx))
-                    {
-                        throw EvaluatorError(
-                            u8"StructFieldTypeMismatchError",
-                            std::format("In structure '{}', field '{}' expects type '{}', but got type '{}'",
-                                        structName.toBasicString(),
-                                        field.name.toBasicString(),
-                                        field.type.toString().toBasicString(),
-                                        prettyType(defaultVal).toBasicString()),
-                            initExpr);
-                    }
-
-                    instanceCtx->def(field.name, field.type, field.am, defaultVal);
+                    initField(static_cast<size_t>(index), check_unwrap(eval(argExpr, ctx)));
                 }
             }
+            check_unwrap(fillDefaults());
         }
 
-        // load struct method
-        for (auto &[id, fn] : defContext->getFunctions())
-        {
-            const FString &funcName = fn.name;
-            const auto &funcSlot = defContext->get(funcName);
-            
-            instanceCtx->def(funcName,
-                             ValueType::Function,
-                             funcSlot->am,
-                             std::make_shared<Object>(Function(funcName, fn.paras, fn.retType, fn.body, instanceCtx)));
-        }
-
-        return std::make_shared<Object>(StructInstance(structT.type, instanceCtx));
+        return Value(Object(StructInstance(structT.type, structT.shape, std::move(slots))));
     }
 };
\ No newline at end of file
@@ -38,20 +38,69 @@ namespace Fig
         // }
         // end
 
-        if (!ctx->contains(name)) { throw EvaluatorError(u8"UndeclaredIdentifierError", name, var); }
-        return LvObject(ctx->get(name), ctx);
+        if (var->isResolved())
+        {
+            // resolved by Resolver: two array indexes
+            if (auto slot = ctx->getResolved(var->depth, var->slot)) { return LvObject(slot, ctx); }
+        }
+
+        // fallback: unresolved name or slot not defined yet
+        auto slot = ctx->find(var->symbol);
+        if (!slot) { throw EvaluatorError(u8"UndeclaredIdentifierError", name, var); }
+        return LvObject(slot, ctx);
     }
     ExprResult Evaluator::evalMemberExpr(Ast::MemberExpr me, ContextPtr ctx)
     {
         // LvObject base = evalLv(me->base, ctx);
         RvObject baseVal = check_unwrap(eval(me->base, ctx));
-        const FString &member = me->member;
-        if (baseVal->getTypeInfo() == ValueType::Module)
+        return evalMemberOf(baseVal, me, ctx);
+    }
+    // a.b straight from an inline cache entry, nullptr if the entry no longer holds
+    static std::shared_ptr<VariableSlot> memberFromCache(const Ast::MemberCache::Entry &entry,
+                                                         const FString &member,
+                                                         const StructInstance *si,
+                                                         const ContextPtr &ctx)
+    {
+        using Kind = Ast::MemberCache::Kind;
+        if (entry.epoch != Context::registryEpoch()) { return nullptr; } // an impl may now shadow the member
+
+        switch (entry.kind)
+        {
+            case Kind::Field: {
+                if (si->shape.get() != entry.shape || !isAccessPublic(si->storage->fields[entry.fieldIndex].am))
+                {
+                    return nullptr;
+                }
+                return si->field(entry.fieldIndex);
+            }
+            case Kind::ShapeMethod: {
+                if (si->shape.get() != entry.shape) { return nullptr; }
+                return Context::instanceMethod(*si, **entry.method);
+            }
+            case Kind::ImplMethod:
+            case Kind::InstanceImpl: {
+                const Function &fn = *entry.implFn;
+                ContextPtr closure = (entry.kind == Kind::InstanceImpl ? Context::forInstance(*si) : ctx);
+                return std::make_shared<VariableSlot>(
+                    member,
+                    Value(Object(fn.boundTo(std::move(closure)))),
+                    ValueType::Function,
+                    AccessModifier::PublicConst);
+            }
+            default: return nullptr;
+        }
+    }
+
+    ExprResult Evaluator::evalMemberOf(RvObject baseVal, Ast::MemberExpr me, ContextPtr ctx)
+    {
+        const FString &member = me->member; // names the result and errors
+        Symbol symbol = me->memberSymbol;   // lookups
+        if (baseVal.is<Module>())
         {
             // std::cerr << "=== DEBUG evalMemberExpr (Module) ===" << std::endl;
-            // std::cerr << "Module object: " << baseVal->toString().toBasicString() << std::endl;
+            // std::cerr << "Module object: " << baseVal.toString().toBasicString() << std::endl;
 
-            const Module &mod = baseVal->as<Module>();
+            const Module &mod = baseVal.as<Module>();
             // std::cerr << "Module context: " << mod.ctx->getScopeName().toBasicString() << std::endl;
             // std::cerr << "Looking for member: " << member.toBasicString() << std::endl;
 
@@ -68,121 +117,131 @@ namespace Fig
             // {
             //     std::cerr << "NOT found in module context!" << std::endl;
             // }
-            if (mod.ctx->contains(member) && mod.ctx->isVariablePublic(member))
+            if (mod.ctx->contains(symbol) && mod.ctx->isVariablePublic(symbol))
             {
-                return LvObject(mod.ctx->get(member), ctx);
+                return LvObject(mod.ctx->get(symbol), ctx);
             }
             else
             {
                 throw EvaluatorError(u8"VariableNotFoundError",
                                      std::format("`{}` has not variable '{}', check if it is public",
-                                                 baseVal->toString().toBasicString(),
+                                                 baseVal.toString().toBasicString(),
                                                  member.toBasicString()),
                                      me->base);
             }
         }
-        if (baseVal->hasMemberFunction(member))
+        // inline cache first: the receiver's type decides, an instance by its struct type
+        const StructInstance *si = (baseVal.is<StructInstance>() ? &baseVal.as<StructInstance>() : nullptr);
+        const TypeInfo &receiverType = (si ? si->parentType : baseVal.getTypeInfo());
+        if (const Ast::MemberCache::Entry *entry = me->cache.find(receiverType.getInstanceID()))
+        {
+            if (auto slot = memberFromCache(*entry, member, si, ctx)) { return LvObject(slot, ctx); }
+        }
+
+        Ast::MemberCache::Entry fill;
+        fill.typeId = receiverType.getInstanceID();
+        fill.epoch = Context::registryEpoch();
+
+        if (me->methodId == -2) { me->methodId = Object::getMemberMethodId(member); }
+        if (const BuiltinMemberMethod *method = baseVal.findMemberMethod(me->methodId))
         {
+            // bound method as value, e.g. `var f := list.push;`
+            // calls `obj.method(args)` don't come here, see evalFunctionCall
+            const BuiltinTypeMemberFn *fn = method->fn; // points into the static table
             return LvObject(std::make_shared<VariableSlot>(
                                 member,
-                                std::make_shared<Object>(Function(
+                                Value(Object(Function(
                                     member,
-                                    [baseVal, member](ObjectPtr self, std::vector<ObjectPtr> args) -> ObjectPtr {
-                                        if (self) { return baseVal->getMemberFunction(member)(self, args); }
-                                        return baseVal->getMemberFunction(member)(baseVal, args);
+                                    [baseVal, fn](const Value &self, const std::vector<Value> &args) -> Value {
+                                        return (*fn)(self.isNull() ? baseVal : self, args);
                                     },
-                                    baseVal->getMemberFunctionParaCount(member))),
+                                    method->paraCount))),
                                 ValueType::Function,
                                 AccessModifier::PublicConst),
                             ctx); // fake l-value
         }
 
-        if (ctx->hasMethodImplemented(baseVal->getTypeInfo(), member))
+        if (ctx->hasMethodImplemented(baseVal.getTypeInfo(), symbol))
         {
             // builtin type implementation!
             // e.g. impl xxx for Int
 
-            auto &fn = ctx->getImplementedMethod(baseVal->getTypeInfo(), member);
-            Function boundFn(member,
-                             fn.paras,
-                             fn.retType,
-                             fn.body,
-                             ctx // current context
-            );
-            return LvObject(
-                std::make_shared<VariableSlot>(
-                    member, std::make_shared<Object>(boundFn), ValueType::Function, AccessModifier::PublicConst),
-                ctx);
+            fill.kind = Ast::MemberCache::Kind::ImplMethod;
+            fill.implFn = &ctx->getImplementedMethod(baseVal.getTypeInfo(), symbol);
+            me->cache.fill(fill);
+            return LvObject(memberFromCache(fill, member, si, ctx), ctx); // bound to the current context
         }
 
-        if (baseVal->getTypeInfo() != ValueType::StructInstance) // and not member function found
+        if (!si) // and not member function found
         {
             throw EvaluatorError(
                 u8"NoAttributeError",
-                std::format("`{}` has not attribute '{}'", baseVal->toString().toBasicString(), member.toBasicString()),
+                std::format("`{}` has not attribute '{}'", baseVal.toString().toBasicString(), member.toBasicString()),
                 me->base);
         }
-        const StructInstance &si = baseVal->as<StructInstance>();
-        if (ctx->hasMethodImplemented(si.parentType, member))
+        if (ctx->hasMethodImplemented(si->parentType, symbol))
         {
-            auto &fn = ctx->getImplementedMethod(si.parentType, member);
-            Function boundFn(member,
-                             fn.paras,
-                             fn.retType,
-                             fn.body,
-                             si.localContext // create a new function and set closure context
-                                             // to struct instance context
-            );
-            return LvObject(
-                std::make_shared<VariableSlot>(
-                    member, std::make_shared<Object>(boundFn), ValueType::Function, AccessModifier::PublicConst),
-                ctx);
+            // closure set to the struct instance context
+            fill.kind = Ast::MemberCache::Kind::InstanceImpl;
+            fill.implFn = &ctx->getImplementedMethod(si->parentType, symbol);
         }
-        else if (si.localContext->containsInThisScope(member) && si.localContext->isVariablePublic(member))
+        else if (int index = si->shape->findField(symbol); index >= 0 && isAccessPublic(si->storage->fields[index].am))
         {
-            return LvObject(si.localContext->get(member), ctx);
+            fill.kind = Ast::MemberCache::Kind::Field;
+            fill.shape = si->shape.get();
+            fill.fieldIndex = static_cast<size_t>(index);
         }
-        else if (ctx->hasDefaultImplementedMethod(si.parentType, member))
+        else if (const auto *method = si->shape->findMethod(symbol); method && isAccessPublic((*method)->am))
         {
-            const auto &ifm = ctx->getDefaultImplementedMethod(si.parentType, member);
+            fill.kind = Ast::MemberCache::Kind::ShapeMethod; // bound on lookup
+            fill.shape = si->shape.get();
+            fill.method = method;
+        }
+        else if (ctx->hasDefaultImplementedMethod(si->parentType, symbol))
+        {
+            // not cached, the return type is evaluated in the calling context
+            const auto &ifm = ctx->getDefaultImplementedMethod(si->parentType, symbol);
             Function fn(member, ifm.paras, actualType(check_unwrap(eval(ifm.returnType, ctx))), ifm.defaultBody, ctx);
 
             return LvObject(std::make_shared<VariableSlot>(
-                                member, std::make_shared<Object>(fn), ValueType::Function, AccessModifier::PublicConst),
+                                member, Value(Object(fn)), ValueType::Function, AccessModifier::PublicConst),
                             ctx);
         }
         else
         {
             throw EvaluatorError(u8"NoAttributeError",
                                  std::format("`{}` has not attribute '{}' and no interfaces have been implemented it",
-                                             baseVal->toString().toBasicString(),
+                                             baseVal.toString().toBasicString(),
                                              member.toBasicString()),
                                  me->base);
         }
+
+        me->cache.fill(fill);
+        return LvObject(memberFromCache(fill, member, si, ctx), ctx);
     }
     ExprResult Evaluator::evalIndexExpr(Ast::IndexExpr ie, ContextPtr ctx)
     {
         RvObject base = check_unwrap(eval(ie->base, ctx));
         RvObject index = check_unwrap(eval(ie->index, ctx));
 
-        const TypeInfo &type = base.get()->getTypeInfo();
+        const TypeInfo &type = base.getTypeInfo();
 
         if (type == ValueType::List)
         {
-            if (index->getTypeInfo() != ValueType::Int)
+            if (index.getTypeInfo() != ValueType::Int)
             {
                 throw EvaluatorError(
                     u8"TypeError",
                     std::format("Type `List` indices must be `Int`, got '{}'", prettyType(index).toBasicString()),
                     ie->index);
             }
-            List &list = base.get()->as<List>();
-            ValueType::IntClass indexVal = index->as<ValueType::IntClass>();
+            List &list = base.as<List>();
+            ValueType::IntClass indexVal = index.as<ValueType::IntClass>();
             if (indexVal >= list.size())
             {
                 throw EvaluatorError(
                     u8"IndexOutOfRangeError",
-                    std::format("Index {} out of list `{}` range", indexVal, base->toString().toBasicString()),
+                    std::format("Index {} out of list `{}` range", indexVal, base.toString().toBasicString()),
                     ie->index);
             }
             return LvObject(base, indexVal, LvObject::Kind::ListElement, ctx);
@@ -190,20 +249,20 @@ namespace Fig
         else if (type == ValueType::Map) { return LvObject(base, index, LvObject::Kind::MapElement, ctx); }
         else if (type == ValueType::String)
         {
-            if (index->getTypeInfo() != ValueType::Int)
+            if (index.getTypeInfo() != ValueType::Int)
             {
                 throw EvaluatorError(
                     u8"TypeError",
                     std::format("Type `String` indices must be `Int`, got '{}'", prettyType(index).toBasicString()),
                     ie->index);
             }
-            FString &string = base->as<ValueType::StringClass>();
-            ValueType::IntClass indexVal = index->as<ValueType::IntClass>();
+            const ValueType::StringClass &string = base.as<ValueType::StringClass>();
+            ValueType::IntClass indexVal = index.as<ValueType::IntClass>();
             if (indexVal >= string.length())
             {
                 throw EvaluatorError(
                     u8"IndexOutOfRangeError",
-                    std::format("Index {} out of string `{}` range", indexVal, base->toString().toBasicString()),
+                    std::format("Index {} out of string `{}` range", indexVal, base.toString().toBasicString()),
                     ie->index);
             }
             return LvObject(base, indexVal, LvObject::Kind::StringElement, ctx);
@@ -212,7 +271,7 @@ namespace Fig
         {
             throw EvaluatorError(
                 u8"NoSubscriptableError",
-                std::format("`{}` object is not subscriptable", base->getTypeInfo().toString().toBasicString()),
+                std::format("`{}` object is not subscriptable", base.getTypeInfo().toString().toBasicString()),
                 ie->base);
         }
     }
@@ -223,17 +282,17 @@ namespace Fig
         switch (exp->getType())
         {
             case AstType::VarExpr: {
-                Ast::VarExpr var = std::static_pointer_cast<Ast::VarExprAst>(exp);
+                Ast::VarExpr var = static_cast<Ast::VarExprAst *>(exp);
 
                 return evalVarExpr(var, ctx);
             }
             case AstType::MemberExpr: {
-                Ast::MemberExpr me = std::static_pointer_cast<Ast::MemberExprAst>(exp);
+                Ast::MemberExpr me = static_cast<Ast::MemberExprAst *>(exp);
 
                 return evalMemberExpr(me, ctx);
             }
             case AstType::IndexExpr: {
-                Ast::IndexExpr ie = std::static_pointer_cast<Ast::IndexExprAst>(exp);
+                Ast::IndexExpr ie = static_cast<Ast::IndexExprAst *>(exp);
 
                 return evalIndexExpr(ie, ctx);
             }
@@ -10,6 +10,7 @@
 #include <Evaluator/Value/structType.hpp>
 #include <Evaluator/Value/value.hpp>
 #include <Evaluator/Value/LvObject.hpp>
+#include <Evaluator/Context/FramePool.hpp>
 #include <Evaluator/evaluator.hpp>
 #include <Evaluator/evaluator_error.hpp>
 
@@ -21,17 +22,19 @@ namespace Fig
 {
     StatementResult Evaluator::evalStatement(Ast::Statement stmt, ContextPtr ctx)
     {
+        if (profiler) { profiler->atStatement(stmt); }
+
         using enum Ast::AstType;
         switch (stmt->getType())
         {
             case ImportSt: {
-                auto i = std::static_pointer_cast<Ast::ImportSt>(stmt);
+                auto i = static_cast<Ast::ImportSt *>(stmt);
                 return evalImportSt(i, ctx);
             }
             case VarDefSt: {
-                auto varDef = std::static_pointer_cast<Ast::VarDefAst>(stmt);
+                auto varDef = static_cast<Ast::VarDefAst *>(stmt);
 
-                if (ctx->containsInThisScope(varDef->name))
+                if (ctx->containsInThisScope(varDef->symbol))
                 {
                     throw EvaluatorError(
                         u8"RedeclarationError",
@@ -39,7 +42,7 @@ namespace Fig
                         varDef);
                 }
 
-                RvObject value = nullptr;
+                Value value;
                 if (varDef->expr) { value = check_unwrap_stres(eval(varDef->expr, ctx)); }
 
                 TypeInfo declaredType; // default is Any
@@ -48,10 +51,10 @@ namespace Fig
                 if (varDef->followupType) { declaredType = actualType(value); }
                 else if (declaredTypeExp)
                 {
-                    ObjectPtr declaredTypeValue = check_unwrap_stres(eval(declaredTypeExp, ctx));
+                    Value declaredTypeValue = check_unwrap_stres(eval(declaredTypeExp, ctx));
                     declaredType = actualType(declaredTypeValue);
 
-                    if (value != nullptr && !isTypeMatch(declaredType, value, ctx))
+                    if (varDef->expr && !isTypeMatch(declaredType, value, ctx))
                     {
                         throw EvaluatorError(u8"TypeError",
                                              std::format("Variable `{}` expects init-value type `{}`, but got '{}'",
@@ -60,27 +63,27 @@ namespace Fig
                                                          prettyType(value).toBasicString()),
                                              varDef->expr);
                     }
-                    else if (value == nullptr)
+                    else if (!varDef->expr)
                     {
-                        value = std::make_shared<Object>(Object::defaultValue(declaredType));
+                        value = Value(Object::defaultValue(declaredType));
                     } // else -> Ok
                 } // else -> type is Any (default)
                 else 
                 {
-                    value = Object::getNullInstance();
+                    value = Value();
                 }
                 AccessModifier am =
                     (varDef->isConst ? (varDef->isPublic ? AccessModifier::PublicConst : AccessModifier::Const) :
                                        (varDef->isPublic ? AccessModifier::Public : AccessModifier::Normal));
-                ctx->def(varDef->name, declaredType, am, value);
+                ctx->def(varDef->symbol, declaredType, am, value, varDef->slot);
                 return StatementResult::normal();
             }
 
             case FunctionDefSt: {
-                auto fnDef = std::static_pointer_cast<Ast::FunctionDefSt>(stmt);
+                auto fnDef = static_cast<Ast::FunctionDefSt *>(stmt);
 
                 const FString &fnName = fnDef->name;
-                if (ctx->containsInThisScope(fnName))
+                if (ctx->containsInThisScope(fnDef->symbol))
                 {
                     throw EvaluatorError(
                         u8"RedeclarationError",
@@ -90,22 +93,23 @@ namespace Fig
                 TypeInfo returnType = ValueType::Any;
                 if (fnDef->retType)
                 {
-                    ObjectPtr returnTypeValue = check_unwrap_stres(eval(fnDef->retType, ctx));
+                    Value returnTypeValue = check_unwrap_stres(eval(fnDef->retType, ctx));
                     returnType = actualType(returnTypeValue);
                 }
 
                 Function fn(fnName, fnDef->paras, returnType, fnDef->body, ctx);
-                ctx->def(fnName,
+                ctx->def(fnDef->symbol,
                          ValueType::Function,
                          (fnDef->isPublic ? AccessModifier::PublicConst : AccessModifier::Const),
-                         std::make_shared<Object>(fn));
+                         Value(Object(fn)),
+                         fnDef->slot);
                 return StatementResult::normal();
             }
 
             case StructSt: {
-                auto stDef = std::static_pointer_cast<Ast::StructDefSt>(stmt);
+                auto stDef = static_cast<Ast::StructDefSt *>(stmt);
 
-                if (ctx->containsInThisScope(stDef->name))
+                if (ctx->containsInThisScope(stDef->symbol))
                 {
                     throw EvaluatorError(
                         u8"RedeclarationError",
@@ -119,12 +123,12 @@ namespace Fig
                                                                                       stDef->getAAI().line,
                                                                                       stDef->getAAI().column)),
                                                                   ctx);
-                ObjectPtr structTypeObj = std::make_shared<Object>(StructType(type, defContext, {}));
+                Value structTypeObj = Value(Object(StructType(type, defContext, {})));
 
                 AccessModifier am = (stDef->isPublic ? AccessModifier::PublicConst : AccessModifier::Const);
 
-                ctx->def(stDef->name, ValueType::StructType, am, structTypeObj); // predef
-                defContext->def(stDef->name,
+                ctx->def(stDef->symbol, ValueType::StructType, am, structTypeObj, stDef->slot); // predef
+                defContext->def(stDef->symbol,
                                 ValueType::StructType,
                                 AccessModifier::Const,
                                 structTypeObj); // predef to itself, always const
@@ -144,13 +148,13 @@ namespace Fig
                     TypeInfo fieldType = ValueType::Any;
                     if (field.declaredType)
                     {
-                        ObjectPtr declaredTypeValue = check_unwrap_stres(eval(field.declaredType, ctx));
+                        Value declaredTypeValue = check_unwrap_stres(eval(field.declaredType, ctx));
                         fieldType = actualType(declaredTypeValue);
                     }
 
                     fields.push_back(Field(field.am, field.fieldName, fieldType, field.defaultValueExpr));
                 }
-                structTypeObj->as<StructType>().fields = fields;
+                structTypeObj.as<StructType>().setFields(std::move(fields));
 
                 const Ast::BlockStatement &body = stDef->body;
                 for (auto &st : body->stmts)
@@ -163,17 +167,21 @@ namespace Fig
                                              st);
                     }
                     evalStatement(st, defContext); // function def st
+
+                    // shared method table, bound to an instance on lookup
+                    Symbol methodName = static_cast<Ast::FunctionDefSt *>(st)->symbol;
+                    structTypeObj.as<StructType>().addMethod(methodName, defContext->get(methodName));
                 }
                 return StatementResult::normal();
             }
 
             case InterfaceDefSt: {
-                auto ifd = std::static_pointer_cast<Ast::InterfaceDefAst>(stmt);
+                auto ifd = static_cast<Ast::InterfaceDefAst *>(stmt);
 
                 const FString &interfaceName = ifd->name;
                 const std::vector<Ast::Expression> &bundle_exprs = ifd->bundles;
 
-                if (ctx->containsInThisScope(interfaceName))
+                if (ctx->containsInThisScope(ifd->symbol))
                 {
                     throw EvaluatorError(
                         u8"RedeclarationError",
@@ -186,15 +194,15 @@ namespace Fig
                 //   K: interface method name    V: method owner (interface)
                 for (const auto &exp : bundle_exprs)
                 {
-                    ObjectPtr itf_val = check_unwrap_stres(eval(exp, ctx));
-                    if (!itf_val->is<InterfaceType>())
+                    Value itf_val = check_unwrap_stres(eval(exp, ctx));
+                    if (!itf_val.is<InterfaceType>())
                     {
                         throw EvaluatorError(u8"TypeError",
                                              std::format("Cannot bundle type '{}' that is not interface",
                                                          prettyType(itf_val).toBasicString()),
                                              exp);
                     }
-                    const InterfaceType &itfType = itf_val->as<InterfaceType>();
+                    const InterfaceType &itfType = itf_val.as<InterfaceType>();
                     for (const auto &method : itfType.methods)
                     {
                         if (cache_methods.contains(method.name))
@@ -216,15 +224,16 @@ namespace Fig
                 methods.insert(methods.end(), bundle_methods.begin(), bundle_methods.end());
 
                 TypeInfo type(interfaceName, true); // register interface
-                ctx->def(interfaceName,
+                ctx->def(ifd->symbol,
                          type,
                          (ifd->isPublic ? AccessModifier::PublicConst : AccessModifier::Const),
-                         std::make_shared<Object>(InterfaceType(type, methods)));
+                         Value(Object(InterfaceType(type, methods))),
+                         ifd->slot);
                 return StatementResult::normal();
             }
 
             case ImplementSt: {
-                auto ip = std::static_pointer_cast<Ast::ImplementAst>(stmt);
+                auto ip = static_cast<Ast::ImplementAst *>(stmt);
 
                 TypeInfo structType(ip->structName);
                 TypeInfo interfaceType(ip->interfaceName);
@@ -254,17 +263,17 @@ namespace Fig
                 LvObject interfaceLv(interfaceSlot, ctx);
                 LvObject structLv(structSlot, ctx);
 
-                ObjectPtr interfaceObj = interfaceLv.get();
-                ObjectPtr structTypeObj = structLv.get();
+                Value interfaceObj = interfaceLv.get();
+                Value structTypeObj = structLv.get();
 
-                if (!interfaceObj->is<InterfaceType>())
+                if (!interfaceObj.is<InterfaceType>())
                 {
                     throw EvaluatorError(
                         u8"NotAInterfaceError",
                         std::format("Variable `{}` is not a interface", ip->interfaceName.toBasicString()),
                         ip);
                 }
-                if (!structTypeObj->is<StructType>())
+                if (!structTypeObj.is<StructType>())
                 {
                     throw EvaluatorError(
                         u8"NotAStructType",
@@ -365,11 +374,11 @@ namespace Fig
 
                         FString opFnName(u8"Operation." + prettyType(structTypeObj) + u8"." + opName);
 
-                        ContextPtr fnCtx = std::make_shared<Context>(
-                            FString(std::format("<Function {}>", opFnName.toBasicString())), ctx);
+                        ContextPtr fnCtx = FramePool::acquire(ScopeKind::Function, implMethod.body, ctx);
+                        fnCtx->setScopeName(opFnName);
 
                         const auto &fillOpFnParas = [this, structType, implMethod, opFnName, fnCtx, ctx, paraCnt](
-                                                        const std::vector<ObjectPtr> &args) -> StatementResult {
+                                                        const std::vector<Value> &args) -> StatementResult {
                             const Ast::FunctionParameters &paras = implMethod.paras;
                             for (size_t i = 0; i < paraCnt; ++i)
                             {
@@ -392,7 +401,7 @@ namespace Fig
 
                         if (paraCnt == 1)
                         {
-                            ctx->registerUnaryOperator(structType, op, [=, this](const ObjectPtr &value) -> ExprResult {
+                            ctx->registerUnaryOperator(structType, op, [=, this](const Value &value) -> ExprResult {
                                 fillOpFnParas({value});
                                 return executeFunction(Function(opFnName,
                                                                 implMethod.paras, // parameters
@@ -407,7 +416,7 @@ namespace Fig
                         else
                         {
                             ctx->registerBinaryOperator(
-                                structType, op, [=, this](const ObjectPtr &lhs, const ObjectPtr &rhs) {
+                                structType, op, [=, this](const Value &lhs, const Value &rhs) {
                                     fillOpFnParas({lhs, rhs});
                                     return executeFunction(Function(opFnName,
                                                                     implMethod.paras, // parameters
@@ -423,7 +432,7 @@ namespace Fig
                     return StatementResult::normal();
                 }
 
-                InterfaceType &interface = interfaceObj->as<InterfaceType>();
+                InterfaceType &interface = interfaceObj.as<InterfaceType>();
 
                 // ===== interface implementation validation =====
                 ImplRecord record{interfaceType, structType, {}};
@@ -494,7 +503,7 @@ namespace Fig
 
                     implemented.insert(name);
 
-                    ObjectPtr returnTypeValue = check_unwrap_stres(eval(ifMethod.returnType, ctx));
+                    Value returnTypeValue = check_unwrap_stres(eval(ifMethod.returnType, ctx));
 
                     record.implMethods[name] =
                         Function(implMethod.name, implMethod.paras, actualType(returnTypeValue), implMethod.body, ctx);
@@ -520,90 +529,83 @@ namespace Fig
             }
 
             case IfSt: {
-                auto ifSt = std::static_pointer_cast<Ast::IfSt>(stmt);
-                ObjectPtr condVal = check_unwrap_stres(eval(ifSt->condition, ctx));
-                if (condVal->getTypeInfo() != ValueType::Bool)
+                auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                Value condVal = check_unwrap_stres(eval(ifSt->condition, ctx));
+                if (condVal.getTypeInfo() != ValueType::Bool)
                 {
                     throw EvaluatorError(
                         u8"TypeError",
                         std::format("Condition must be boolean, but got '{}'", prettyType(condVal).toBasicString()),
                         ifSt->condition);
                 }
-                if (condVal->as<ValueType::BoolClass>()) { return evalBlockStatement(ifSt->body, ctx); }
+                if (condVal.as<ValueType::BoolClass>()) { return evalBlockStatement(ifSt->body, ctx); }
                 // else
                 for (const auto &elif : ifSt->elifs)
                 {
-                    ObjectPtr elifCondVal = check_unwrap_stres(eval(elif->condition, ctx));
-                    if (elifCondVal->getTypeInfo() != ValueType::Bool)
+                    Value elifCondVal = check_unwrap_stres(eval(elif->condition, ctx));
+                    if (elifCondVal.getTypeInfo() != ValueType::Bool)
                     {
                         throw EvaluatorError(
                             u8"TypeError",
                             std::format("Condition must be boolean, but got '{}'", prettyType(condVal).toBasicString()),
                             ifSt->condition);
                     }
-                    if (elifCondVal->as<ValueType::BoolClass>()) { return evalBlockStatement(elif->body, ctx); }
+                    if (elifCondVal.as<ValueType::BoolClass>()) { return evalBlockStatement(elif->body, ctx); }
                 }
                 if (ifSt->els) { return evalBlockStatement(ifSt->els->body, ctx); }
                 return StatementResult::normal();
             };
             case WhileSt: {
-                auto whileSt = std::static_pointer_cast<Ast::WhileSt>(stmt);
+                auto whileSt = static_cast<Ast::WhileSt *>(stmt);
                 while (true)
                 {
-                    ObjectPtr condVal = check_unwrap_stres(eval(whileSt->condition, ctx));
-                    if (condVal->getTypeInfo() != ValueType::Bool)
+                    Value condVal = check_unwrap_stres(eval(whileSt->condition, ctx));
+                    if (condVal.getTypeInfo() != ValueType::Bool)
                     {
                         throw EvaluatorError(
                             u8"TypeError",
                             std::format("Condition must be boolean, but got '{}'", prettyType(condVal).toBasicString()),
                             whileSt->condition);
                     }
-                    if (!condVal->as<ValueType::BoolClass>()) { break; }
-                    ContextPtr loopContext = std::make_shared<Context>(
-                        FString(std::format("<While {}:{}>", whileSt->getAAI().line, whileSt->getAAI().column)),
-                        ctx); // every loop has its own context
+                    if (!condVal.as<ValueType::BoolClass>()) { break; }
+                    ContextPtr loopContext =
+                        FramePool::acquire(ScopeKind::While, whileSt, ctx); // every loop has its own context
                     StatementResult sr = evalBlockStatement(whileSt->body, loopContext);
-                    if (sr.shouldReturn()) { return sr; }
+                    if (sr.shouldReturn() || sr.isError()) { return sr; }
                     if (sr.shouldBreak()) { break; }
                     if (sr.shouldContinue()) { continue; }
                 }
                 return StatementResult::normal();
             };
             case ForSt: {
-                auto forSt = std::static_pointer_cast<Ast::ForSt>(stmt);
-                ContextPtr loopContext = std::make_shared<Context>(
-                    FString(std::format("<For {}:{}>", forSt->getAAI().line, forSt->getAAI().column)),
-                    ctx); // for loop has its own context
+                auto forSt = static_cast<Ast::ForSt *>(stmt);
+                ContextPtr loopContext =
+                    FramePool::acquire(ScopeKind::For, forSt, ctx); // for loop has its own context
 
                 evalStatement(forSt->initSt,
                               loopContext); // ignore init statement result
-                size_t iteration = 0;
 
-                ContextPtr iterationContext = std::make_shared<Context>(
-                    FString(std::format(
-                        "<For {}:{}, Iteration {}>", forSt->getAAI().line, forSt->getAAI().column, iteration)),
-                    loopContext); // every loop has its own context
+                ContextPtr iterationContext = FramePool::acquire(
+                    ScopeKind::ForIteration, forSt, loopContext); // every loop has its own context
 
                 while (true) // use while loop to simulate for loop, cause we
                              // need to check condition type every iteration
                 {
-                    ObjectPtr condVal = check_unwrap_stres(eval(forSt->condition, loopContext));
-                    if (condVal->getTypeInfo() != ValueType::Bool)
+                    Value condVal = check_unwrap_stres(eval(forSt->condition, loopContext));
+                    if (condVal.getTypeInfo() != ValueType::Bool)
                     {
                         throw EvaluatorError(
                             u8"TypeError",
                             std::format("Condition must be boolean, but got '{}'", prettyType(condVal).toBasicString()),
                             forSt->condition);
                     }
-                    if (!condVal->as<ValueType::BoolClass>()) { break; }
-                    iteration++;
+                    if (!condVal.as<ValueType::BoolClass>()) { break; }
 
                     StatementResult sr = evalBlockStatement(forSt->body, iterationContext);
                     iterationContext->clear();
-                    iterationContext->setScopeName(FString(std::format(
-                        "<For {}:{}, Iteration {}>", forSt->getAAI().line, forSt->getAAI().column, iteration)));
+                    iterationContext->nextIteration();
 
-                    if (sr.shouldReturn()) { return sr; }
+                    if (sr.shouldReturn() || sr.isError()) { return sr; }
                     if (sr.shouldBreak()) { break; }
                     if (sr.shouldContinue())
                     {
@@ -617,10 +619,9 @@ namespace Fig
             }
 
             case TrySt: {
-                auto tryst = std::static_pointer_cast<Ast::TrySt>(stmt);
+                auto tryst = static_cast<Ast::TrySt *>(stmt);
 
-                ContextPtr tryCtx = std::make_shared<Context>(
-                    FString(std::format("<Try at {}:{}>", tryst->getAAI().line, tryst->getAAI().column)), ctx);
+                ContextPtr tryCtx = FramePool::acquire(ScopeKind::Try, tryst, ctx);
                 StatementResult sr = StatementResult::normal();
                 bool crashed = false;
                 for (auto &stmt : tryst->body->stmts)
@@ -635,15 +636,11 @@ namespace Fig
                 bool catched = false;
                 for (auto &cat : tryst->catches)
                 {
-                    const FString &errVarName = cat.errVarName;
                     TypeInfo errVarType = (cat.hasType ? TypeInfo(cat.errVarType) : ValueType::Any);
                     if (isTypeMatch(errVarType, sr.result, ctx))
                     {
-                        ContextPtr catchCtx = std::make_shared<Context>(
-                            FString(
-                                std::format("<Catch at {}:{}>", cat.body->getAAI().line, cat.body->getAAI().column)),
-                            ctx);
-                        catchCtx->def(errVarName, errVarType, AccessModifier::Normal, sr.result);
+                        ContextPtr catchCtx = FramePool::acquire(ScopeKind::Catch, cat.body, ctx);
+                        catchCtx->def(cat.errVarSymbol, errVarType, AccessModifier::Normal, sr.result);
                         sr = evalBlockStatement(cat.body, catchCtx);
                         catched = true;
                         break;
@@ -652,7 +649,7 @@ namespace Fig
                 if (!catched && crashed)
                 {
                     throw EvaluatorError(u8"UncaughtExceptionError",
-                                         std::format("Uncaught exception: {}", sr.result->toString().toBasicString()),
+                                         std::format("Uncaught exception: {}", sr.result.toString().toBasicString()),
                                          tryst);
                 }
                 if (tryst->finallyBlock) { sr = evalBlockStatement(tryst->finallyBlock, ctx); }
@@ -660,10 +657,10 @@ namespace Fig
             }
 
             case ThrowSt: {
-                auto ts = std::static_pointer_cast<Ast::ThrowSt>(stmt);
+                auto ts = static_cast<Ast::ThrowSt *>(stmt);
 
-                ObjectPtr value = check_unwrap_stres(eval(ts->value, ctx));
-                if (value->is<ValueType::NullClass>())
+                Value value = check_unwrap_stres(eval(ts->value, ctx));
+                if (value.is<ValueType::NullClass>())
                 {
                     throw EvaluatorError(u8"TypeError", u8"Why did you throw a null?", ts);
                 }
@@ -671,9 +668,9 @@ namespace Fig
             }
 
             case ReturnSt: {
-                auto returnSt = std::static_pointer_cast<Ast::ReturnSt>(stmt);
+                auto returnSt = static_cast<Ast::ReturnSt *>(stmt);
 
-                ObjectPtr returnValue = Object::getNullInstance(); // default is null
+                Value returnValue; // default is null
                 if (returnSt->retValue) returnValue = check_unwrap_stres(eval(returnSt->retValue, ctx));
                 return StatementResult::returnFlow(returnValue);
             }
@@ -703,15 +700,14 @@ namespace Fig
             }
 
             case ExpressionStmt: {
-                auto exprStmt = std::static_pointer_cast<Ast::ExpressionStmtAst>(stmt);
+                auto exprStmt = static_cast<Ast::ExpressionStmtAst *>(stmt);
                 return check_unwrap_stres(eval(exprStmt->exp, ctx));
             }
 
             case BlockStatement: {
-                auto block = std::static_pointer_cast<Ast::BlockStatementAst>(stmt);
+                auto block = static_cast<Ast::BlockStatementAst *>(stmt);
 
-                ContextPtr blockCtx = std::make_shared<Context>(
-                    FString(std::format("<Block at {}:{}>", block->getAAI().line, block->getAAI().column)), ctx);
+                ContextPtr blockCtx = FramePool::acquire(ScopeKind::Block, block, ctx);
                 return evalBlockStatement(block, blockCtx);
             }
 
@@ -11,10 +11,10 @@ namespace Fig
         using Ast::Operator;
         Operator op = un->op;
         Ast::Expression exp = un->exp;
-        ObjectPtr value = check_unwrap(eval(exp, ctx));
+        Value value = check_unwrap(eval(exp, ctx));
 
-        const auto &tryInvokeOverloadFn = [ctx, op](const ObjectPtr &rhs, const std::function<ExprResult()> &rollback) {
-            if (rhs->is<StructInstance>())
+        const auto &tryInvokeOverloadFn = [ctx, op](const Value &rhs, auto &&rollback) -> ExprResult {
+            if (rhs.is<StructInstance>())
             {
                 // 运算符重载
                 const TypeInfo &type = actualType(rhs);
@@ -29,14 +29,19 @@ namespace Fig
 
         switch (op)
         {
+            // scalars are never overloaded and stay inline, the rest goes through Object's operators
             case Operator::Not: {
-                return tryInvokeOverloadFn(value, [value]() { return std::make_shared<Object>(!(*value)); });
+                if (value.is<ValueType::BoolClass>()) { return Value::Bool(!value.as<ValueType::BoolClass>()); }
+                return tryInvokeOverloadFn(value, [value]() { return Value(!*value.toObject()); });
             }
             case Operator::Subtract: {
-                return tryInvokeOverloadFn(value, [value]() { return std::make_shared<Object>(-(*value)); });
+                if (value.is<ValueType::IntClass>()) { return Value::Int(-value.as<ValueType::IntClass>()); }
+                if (value.is<ValueType::DoubleClass>()) { return Value::Double(-value.as<ValueType::DoubleClass>()); }
+                return tryInvokeOverloadFn(value, [value]() { return Value(-*value.toObject()); });
             }
             case Operator::BitNot: {
-                return tryInvokeOverloadFn(value, [value]() { return std::make_shared<Object>(bit_not(*value)); });
+                if (value.is<ValueType::IntClass>()) { return Value::Int(~value.as<ValueType::IntClass>()); }
+                return tryInvokeOverloadFn(value, [value]() { return Value(bit_not(*value.toObject())); });
             }
             default: {
                 throw EvaluatorError(u8"UnsupportedOpError",
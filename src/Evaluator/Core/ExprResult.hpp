@@ -19,13 +19,13 @@ namespace Fig
             Error,
         } flow;
 
-        ExprResult(ObjectPtr _result, Flow _flow = Flow::Normal) : result(_result), flow(_flow) {}
+        ExprResult(Value _result, Flow _flow = Flow::Normal) : result(std::move(_result)), flow(_flow) {}
         ExprResult(const LvObject &_result, Flow _flow = Flow::Normal) : result(_result), flow(_flow) {}
 
-        static ExprResult normal(ObjectPtr _result) { return ExprResult(_result); }
+        static ExprResult normal(Value _result) { return ExprResult(std::move(_result)); }
         static ExprResult normal(const LvObject &_result) { return ExprResult(_result); }
 
-        static ExprResult error(ObjectPtr _result) { return ExprResult(_result, Flow::Error); }
+        static ExprResult error(Value _result) { return ExprResult(std::move(_result), Flow::Error); }
         static ExprResult error(const LvObject &_result) { return ExprResult(_result, Flow::Error); }
 
         bool isNormal() const { return flow == Flow::Normal; }
@@ -34,13 +34,13 @@ namespace Fig
 
         bool isResultLv() const { return std::holds_alternative<LvObject>(result); }
 
-        ObjectPtr &unwrap()
+        Value &unwrap()
         {
             if (!isNormal()) { assert(false && "unwrap abnormal ExprResult!"); }
             return std::get<RvObject>(result);
         }
 
-        const ObjectPtr &unwrap() const
+        const Value &unwrap() const
         {
             if (!isNormal()) { assert(false && "unwrap abnormal ExprResult!"); }
             return std::get<RvObject>(result);
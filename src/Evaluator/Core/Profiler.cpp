@@ -0,0 +1,228 @@
+#include <Evaluator/Core/Profiler.hpp>
+#include <Evaluator/Value/function.hpp>
+#include <Evaluator/Value/value.hpp>
+#include <Core/Output.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <csignal>
+    #include <sys/time.h>
+    #define FIG_PROFILER_SIGPROF
+#endif
+
+namespace Fig
+{
+    std::atomic<uint32_t> Profiler::pendingTicks{0};
+    Profiler *Profiler::activeProfiler = nullptr;
+
+    // SIGPROF handler: only touches a lock-free atomic, the evaluator does the rest at its next poll()
+    void onProfilerTick(int)
+    {
+        Profiler::pendingTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool Profiler::start(const std::string &_outputPath, unsigned _intervalUs)
+    {
+#ifdef FIG_PROFILER_SIGPROF
+        outputPath = _outputPath;
+        intervalUs = std::max(_intervalUs, 1u);
+
+        struct sigaction action{};
+        action.sa_handler = onProfilerTick;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART; // a tick during a read from stdin mustn't fail it
+        if (sigaction(SIGPROF, &action, nullptr) != 0) { return false; }
+
+        itimerval timer{};
+        timer.it_interval.tv_sec = intervalUs / 1000000;
+        timer.it_interval.tv_usec = intervalUs % 1000000;
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) { return false; }
+
+        running = true;
+        activeProfiler = this;
+        // atexit handlers and statics are torn down in reverse order: constructing Output first keeps it
+        // alive for report()
+        Output::stdOut();
+        std::atexit([]() { Profiler::getInstance().report(); });
+        return true;
+#else
+        (void)_outputPath;
+        (void)_intervalUs;
+        return false;
+#endif
+    }
+
+    void Profiler::stop()
+    {
+        if (!running) { return; }
+#ifdef FIG_PROFILER_SIGPROF
+        itimerval timer{};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        std::signal(SIGPROF, SIG_IGN); // the default action terminates, a tick may still be on its way
+#endif
+        running = false;
+    }
+
+    uint32_t Profiler::addFunction(FString name, const Ast::_AstBase *definition)
+    {
+        FunctionInfo info{std::move(name)};
+        if (definition)
+        {
+            const Ast::AstAddressInfo &aai = definition->getAAI();
+            info.sourcePath = aai.sourcePath;
+            info.line = aai.line;
+        }
+        functions.push_back(std::move(info));
+        return static_cast<uint32_t>(functions.size() - 1);
+    }
+
+    uint32_t Profiler::functionId(const Function &fn)
+    {
+        if (fn.type == Function::Normal)
+        {
+            auto it = definitionIds.find(fn.body);
+            if (it != definitionIds.end()) { return it->second; }
+            uint32_t id = addFunction(fn.name.empty() ? FString(u8"<anonymous>") : fn.name, fn.body);
+            definitionIds.emplace(fn.body, id);
+            return id;
+        }
+        auto it = nativeIds.find(fn.name);
+        if (it != nativeIds.end()) { return it->second; }
+        uint32_t id = addFunction(fn.name, nullptr);
+        nativeIds.emplace(fn.name, id);
+        return id;
+    }
+
+    uint32_t Profiler::functionId(const BuiltinMemberMethod *method, const Value &self, const FString &member)
+    {
+        auto it = methodIds.find(method);
+        if (it != methodIds.end()) { return it->second; }
+        uint32_t id = addFunction(self.getTypeInfo().toString() + FString(u8".") + member, nullptr);
+        methodIds.emplace(method, id);
+        return id;
+    }
+
+    uint32_t Profiler::functionId(const FString &scopeName, const Ast::_AstBase *node)
+    {
+        auto it = nativeIds.find(scopeName);
+        if (it != nativeIds.end()) { return it->second; }
+        uint32_t id = addFunction(scopeName, node);
+        nativeIds.emplace(scopeName, id);
+        return id;
+    }
+
+    void Profiler::record(uint32_t ticks)
+    {
+        if (stack.empty()) { return; } // before the script starts / after it ends
+
+        std::vector<uint32_t> ids;
+        ids.reserve(stack.size());
+        for (const Frame &frame : stack) { ids.push_back(frame.function); }
+        samples[std::move(ids)] += ticks;
+
+        const Frame &top = stack.back();
+        lineTicks[{top.function, (top.node ? top.node->getAAI().line : 0)}] += ticks;
+        totalTicks += ticks;
+    }
+
+    void Profiler::report()
+    {
+        if (!running) { return; }
+        stop();
+        Output::stdOut().flush(); // the table comes after the script's own output
+
+        auto frameName = [this](uint32_t id) {
+            std::string name = functions[id].name.toBasicString();
+            std::replace(name.begin(), name.end(), ';', ':'); // ';' separates frames
+            return name;
+        };
+
+        std::ofstream folded(outputPath);
+        for (const auto &[ids, ticks] : samples)
+        {
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                if (i != 0) folded << ';';
+                folded << frameName(ids[i]);
+            }
+            folded << ' ' << ticks << '\n';
+        }
+        folded.close();
+
+        // self: ticks on top of the stack. total: ticks anywhere in it, a recursive function counted once
+        std::vector<uint64_t> self(functions.size(), 0), total(functions.size(), 0);
+        std::vector<size_t> seen(functions.size(), 0);
+        size_t stamp = 0;
+        for (const auto &[ids, ticks] : samples)
+        {
+            self[ids.back()] += ticks;
+            ++stamp;
+            for (uint32_t id : ids)
+            {
+                if (seen[id] == stamp) { continue; }
+                seen[id] = stamp;
+                total[id] += ticks;
+            }
+        }
+
+        std::vector<size_t> hotLine(functions.size(), 0);
+        std::vector<uint64_t> hotLineTicks(functions.size(), 0);
+        for (const auto &[key, ticks] : lineTicks)
+        {
+            if (ticks > hotLineTicks[key.first])
+            {
+                hotLineTicks[key.first] = ticks;
+                hotLine[key.first] = key.second;
+            }
+        }
+
+        std::vector<uint32_t> order;
+        for (uint32_t id = 0; id < functions.size(); ++id)
+        {
+            if (total[id] != 0) order.push_back(id);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) {
+            return (self[l] != self[r] ? self[l] > self[r] : total[l] > total[r]);
+        });
+
+        double msPerTick = static_cast<double>(intervalUs) / 1000.0;
+        auto percent = [this](uint64_t ticks) {
+            return (totalTicks == 0 ? 0.0 : 100.0 * static_cast<double>(ticks) / static_cast<double>(totalTicks));
+        };
+
+        std::cerr << std::format("\nFig profile: {} samples every {} us of CPU time, folded stacks in {}\n",
+                                 totalTicks,
+                                 intervalUs,
+                                 outputPath);
+        std::cerr << std::format(
+            "{:>7} {:>10} {:>7} {:>10}  {}\n", "self%", "self ms", "total%", "total ms", "function");
+        for (uint32_t id : order)
+        {
+            const FunctionInfo &info = functions[id];
+            std::string location = "<native>";
+            if (info.sourcePath)
+            {
+                location = std::format("{}:{}",
+                                       std::filesystem::path(info.sourcePath->toBasicString()).filename().string(),
+                                       info.line);
+            }
+            std::string hot = (hotLineTicks[id] != 0 && hotLine[id] != 0 ? std::format("  hot line {}", hotLine[id])
+                                                                          : std::string());
+            std::cerr << std::format("{:>6.1f}% {:>10.2f} {:>6.1f}% {:>10.2f}  {}  {}{}\n",
+                                     percent(self[id]),
+                                     static_cast<double>(self[id]) * msPerTick,
+                                     percent(total[id]),
+                                     static_cast<double>(total[id]) * msPerTick,
+                                     frameName(id),
+                                     location,
+                                     hot);
+        }
+    }
+}; // namespace Fig
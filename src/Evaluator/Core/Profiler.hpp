@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Ast/astBase.hpp>
+#include <Core/fig_string.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Fig
+{
+    class Function;
+    class Value;
+    struct BuiltinMemberMethod;
+
+    /*
+        Profiler
+        sampling profiler for `--profile`. every Evaluator pushes a (function, AST node) frame per call onto
+        the shadow stack kept here and points the top frame's node at the statement it runs
+
+        a SIGPROF interval timer (process CPU time) only counts ticks in the signal handler; the evaluator
+        polls the count at its next statement, call or return and files the shadow stack under it. the stack
+        can't have changed in between, so attribution is exact to the statement
+
+        report() writes the samples as folded stacks (`main;fib;fib 42`, input of flamegraph.pl) and prints
+        a self / total table per function, with the file:line of its definition and its hottest line
+    */
+    class Profiler
+    {
+    public:
+        static constexpr unsigned DefaultIntervalUs = 1000;
+
+        struct Frame
+        {
+            uint32_t function;         // index into `functions`
+            const Ast::_AstBase *node; // statement running in this frame, nullptr before the first one
+        };
+
+    private:
+        struct FunctionInfo
+        {
+            FString name;
+            std::shared_ptr<FString> sourcePath; // nullptr: native
+            size_t line = 0;
+        };
+
+        static std::atomic<uint32_t> pendingTicks; // written by the signal handler
+
+        static Profiler *activeProfiler;
+
+        std::vector<FunctionInfo> functions;
+        std::unordered_map<const Ast::_AstBase *, uint32_t> definitionIds; // Normal functions, by body
+        std::unordered_map<const BuiltinMemberMethod *, uint32_t> methodIds;
+        std::unordered_map<FString, uint32_t> nativeIds; // builtin functions and scopes, by name
+
+        std::vector<Frame> stack;
+
+        std::map<std::vector<uint32_t>, uint64_t> samples; // stack of function ids -> ticks
+        std::map<std::pair<uint32_t, size_t>, uint64_t> lineTicks; // (function, line) -> self ticks
+        uint64_t totalTicks = 0;
+
+        unsigned intervalUs = DefaultIntervalUs;
+        std::string outputPath;
+        bool running = false;
+
+        Profiler() = default;
+
+        uint32_t addFunction(FString name, const Ast::_AstBase *definition);
+        void record(uint32_t ticks);
+
+    public:
+        static Profiler &getInstance()
+        {
+            // never destroyed: report() runs from atexit
+            static Profiler *profiler = new Profiler();
+            return *profiler;
+        }
+
+        // nullptr unless start() was called, Evaluators skip every hook then
+        static Profiler *active() { return activeProfiler; }
+
+        // installs the SIGPROF handler and timer, report() is registered with atexit
+        // false where there is no setitimer (Windows)
+        bool start(const std::string &_outputPath, unsigned _intervalUs = DefaultIntervalUs);
+        void stop();
+
+        // folded stacks to outputPath, table to stderr
+        void report();
+
+        // a Normal function by its definition: every closure a lambda expression makes shares one row
+        uint32_t functionId(const Function &fn);
+        uint32_t functionId(const BuiltinMemberMethod *method, const Value &self, const FString &member); // List.sum
+        uint32_t functionId(const FString &scopeName, const Ast::_AstBase *node);  // main script, module bodies
+
+        void poll()
+        {
+            uint32_t ticks = pendingTicks.load(std::memory_order_relaxed);
+            if (ticks != 0) { record(pendingTicks.exchange(0, std::memory_order_relaxed)); }
+        }
+
+        void push(uint32_t function)
+        {
+            poll();
+            stack.push_back(Frame{function, nullptr});
+        }
+
+        void pop()
+        {
+            poll();
+            stack.pop_back();
+        }
+
+        void atStatement(const Ast::_AstBase *node)
+        {
+            poll();
+            if (!stack.empty()) { stack.back().node = node; }
+        }
+
+        friend void onProfilerTick(int);
+    };
+
+    // pushes a frame for its lifetime (a call unwound by an exception pops too), no-op without a profiler
+    class ProfileScope
+    {
+    private:
+        Profiler *profiler;
+
+    public:
+        template <class... Args>
+        explicit ProfileScope(Profiler *_profiler, const Args &...args) : profiler(_profiler)
+        {
+            if (profiler) { profiler->push(profiler->functionId(args...)); }
+        }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+
+        ~ProfileScope()
+        {
+            if (profiler) { profiler->pop(); }
+        }
+    };
+}; // namespace Fig
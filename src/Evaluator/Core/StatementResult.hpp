@@ -7,7 +7,7 @@ namespace Fig
 {
     struct StatementResult
     {
-        ObjectPtr result;
+        Value result;
         enum class Flow
         {
             Normal,
@@ -17,16 +17,16 @@ namespace Fig
             Error
         } flow;
 
-        StatementResult(ObjectPtr val, Flow f = Flow::Normal) : result(val), flow(f) {}
+        StatementResult(Value val, Flow f = Flow::Normal) : result(std::move(val)), flow(f) {}
 
-        static StatementResult normal(ObjectPtr val = Object::getNullInstance())
+        static StatementResult normal(Value val = Value())
         {
-            return StatementResult(val, Flow::Normal);
+            return StatementResult(std::move(val), Flow::Normal);
         }
-        static StatementResult returnFlow(ObjectPtr val) { return StatementResult(val, Flow::Return); }
-        static StatementResult breakFlow() { return StatementResult(Object::getNullInstance(), Flow::Break); }
-        static StatementResult continueFlow() { return StatementResult(Object::getNullInstance(), Flow::Continue); }
-        static StatementResult errorFlow(ObjectPtr val) { return StatementResult(val, Flow::Error); }
+        static StatementResult returnFlow(Value val) { return StatementResult(std::move(val), Flow::Return); }
+        static StatementResult breakFlow() { return StatementResult(Value(), Flow::Break); }
+        static StatementResult continueFlow() { return StatementResult(Value(), Flow::Continue); }
+        static StatementResult errorFlow(Value val) { return StatementResult(std::move(val), Flow::Error); }
 
         bool isNormal() const { return flow == Flow::Normal; }
         bool shouldReturn() const { return flow == Flow::Return; }
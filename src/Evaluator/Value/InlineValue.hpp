@@ -0,0 +1,177 @@
+#pragma once
+
+#include <Core/fig_string.hpp>
+#include <Evaluator/Value/Type.hpp>
+#include <Evaluator/Value/value_forward.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Fig
+{
+    struct BuiltinMemberMethod;
+
+    /*
+        Value
+        a script value as the evaluator passes it around: Null, Bool, Int and Double are stored inline, every
+        other type is boxed in an Object. 16 bytes; copying or dropping a scalar touches no heap and no
+        reference count
+
+        all the Values holding one Object share a single ObjectPtr to it (Object::pin), counted by a plain
+        integer (Object::valueRefs): only the first Value to take the Object and the last one to let it go touch
+        the shared_ptr. built from an ObjectPtr to an Int (Double, Bool, null), a Value holds the number itself,
+        never the box
+
+        member functions mirror Object's. templates and whatever needs Object complete live in value.hpp
+    */
+    class Value
+    {
+    public:
+        enum class Kind : uint8_t
+        {
+            Null,
+            Bool,
+            Int,
+            Double,
+            Boxed, // String, List, Map, Function, struct..., in `payload.object`
+        };
+
+    private:
+        union Payload
+        {
+            ValueType::BoolClass b;
+            ValueType::IntClass i;
+            ValueType::DoubleClass d;
+            Object *object;
+        } payload;
+        Kind kind;
+
+        static void retain(Object *);
+        static void release(Object *);
+
+        bool unbox(const Object &); // holds it inline if it's a scalar or null
+
+    public:
+        Value() : payload{.i = 0}, kind(Kind::Null) {}
+        Value(const ObjectPtr &);
+        Value(ObjectPtr &&);
+        explicit Value(const Object &); // boxes a copy unless it's a scalar
+        explicit Value(Object &&);
+
+        static Value Bool(ValueType::BoolClass v)
+        {
+            Value r;
+            r.kind = Kind::Bool;
+            r.payload.b = v;
+            return r;
+        }
+        static Value Int(ValueType::IntClass v)
+        {
+            Value r;
+            r.kind = Kind::Int;
+            r.payload.i = v;
+            return r;
+        }
+        static Value Double(ValueType::DoubleClass v)
+        {
+            Value r;
+            r.kind = Kind::Double;
+            r.payload.d = v;
+            return r;
+        }
+
+        Value(const Value &other) : payload(other.payload), kind(other.kind)
+        {
+            if (kind == Kind::Boxed) retain(payload.object);
+        }
+        Value(Value &&other) noexcept : payload(other.payload), kind(other.kind) { other.kind = Kind::Null; }
+
+        // `other` may live inside the Object this Value lets go of: read it first, release last
+        Value &operator=(const Value &other)
+        {
+            Payload p = other.payload;
+            Kind k = other.kind;
+            if (k == Kind::Boxed) retain(p.object);
+            Payload old = payload;
+            Kind oldKind = kind;
+            payload = p;
+            kind = k;
+            if (oldKind == Kind::Boxed) release(old.object);
+            return *this;
+        }
+        Value &operator=(Value &&other) noexcept
+        {
+            Payload p = other.payload;
+            Kind k = other.kind;
+            other.kind = Kind::Null;
+            Payload old = payload;
+            Kind oldKind = kind;
+            payload = p;
+            kind = k;
+            if (oldKind == Kind::Boxed) release(old.object);
+            return *this;
+        }
+
+        ~Value()
+        {
+            if (kind == Kind::Boxed) release(payload.object);
+        }
+
+        void reset() { *this = Value(); }
+
+        Kind getKind() const { return kind; }
+        bool isBoxed() const { return kind == Kind::Boxed; }
+        bool isNull() const { return kind == Kind::Null; }
+        bool isNumeric() const { return kind == Kind::Int || kind == Kind::Double; }
+
+        // the boxed Object, nullptr for a scalar
+        Object *boxed() const { return (kind == Kind::Boxed ? payload.object : nullptr); }
+
+        // the ObjectPtr the boxed Object is held by, no copy. boxed Values only
+        const ObjectPtr &object() const;
+
+        template <typename T>
+        bool is() const;
+
+        template <typename T>
+        static constexpr bool isInline =
+            std::is_same_v<T, ValueType::NullClass> || std::is_same_v<T, ValueType::BoolClass>
+            || std::is_same_v<T, ValueType::IntClass> || std::is_same_v<T, ValueType::DoubleClass>;
+
+        template <typename T>
+        using AsResult = std::conditional_t<isInline<T>, const T &, T &>;
+
+        // scalars by const reference into the Value, boxed types by reference into the Object
+        template <typename T>
+        AsResult<T> as() const;
+
+        const TypeInfo &getTypeInfo() const;
+        const BuiltinMemberMethod *findMemberMethod(int methodId) const; // see Object
+        ValueType::DoubleClass getNumericValue() const;
+
+        FString toString() const;
+        FString toStringIO() const;
+
+        // the Value as an ObjectPtr, a scalar is boxed (small Ints come from IntPool), value.cpp
+        ObjectPtr toObject() const;
+
+        // same Object, or equal scalars of one kind (`is`-like identity, not ==)
+        bool isSame(const Value &other) const
+        {
+            if (kind != other.kind) return false;
+            switch (kind)
+            {
+                case Kind::Null: return true;
+                case Kind::Bool: return payload.b == other.payload.b;
+                case Kind::Int: return payload.i == other.payload.i;
+                case Kind::Double: return payload.d == other.payload.d;
+                case Kind::Boxed: return payload.object == other.payload.object;
+            }
+            return false;
+        }
+    };
+    static_assert(sizeof(Value) == 16, "Value is a payload word and a kind");
+
+    using RvObject = Value;
+}; // namespace Fig
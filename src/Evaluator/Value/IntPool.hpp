@@ -28,7 +28,7 @@ namespace Fig
         ObjectPtr createInt(ValueType::IntClass val) const
         {
             if (val >= CACHE_MIN && val <= CACHE_MAX) { return cache[val - CACHE_MIN]; }
-            return std::make_shared<Object>(val);
+            return Object::box(val);
         }
         Object createIntCopy(ValueType::IntClass val) const
         {
@@ -17,10 +17,10 @@ namespace Fig
         } kind;
         std::shared_ptr<VariableSlot> slot;
 
-        ObjectPtr value = nullptr;
+        Value value; // the container
         size_t numIndex;
 
-        ObjectPtr mapIndex;
+        Value mapIndex;
 
         ContextPtr ctx;
 
@@ -29,18 +29,18 @@ namespace Fig
         {
             kind = Kind::Variable;
         }
-        LvObject(ObjectPtr _v, size_t _index, Kind _kind, ContextPtr _ctx) :
-            value(_v), numIndex(_index), ctx(_ctx)
+        LvObject(Value _v, size_t _index, Kind _kind, ContextPtr _ctx) :
+            value(std::move(_v)), numIndex(_index), ctx(_ctx)
         {
             kind = _kind;
         }
-        LvObject(ObjectPtr _v, ObjectPtr _index, Kind _kind, ContextPtr _ctx) :
-            value(_v), mapIndex(_index), ctx(_ctx)
+        LvObject(Value _v, Value _index, Kind _kind, ContextPtr _ctx) :
+            value(std::move(_v)), mapIndex(std::move(_index)), ctx(_ctx)
         {
             kind = _kind;
         }
 
-        ObjectPtr get() const
+        Value get() const
         {
             if (kind == Kind::Variable)
             {
@@ -49,33 +49,34 @@ namespace Fig
             }
             else if (kind == Kind::ListElement)
             {
-                List &list = value->as<List>();
+                List &list = value.as<List>();
                 if (numIndex >= list.size())
                     throw RuntimeError(FString(
-                        std::format("Index {} out of range {}", numIndex, value->toString().toBasicString())));
-                return list.at(numIndex).value;
+                        std::format("Index {} out of range {}", numIndex, value.toString().toBasicString())));
+                return list.get(numIndex);
             }
             else if (kind == Kind::MapElement) // map
             {
-                Map &map = value->as<Map>();
-                if (!map.contains(mapIndex))
+                Map &map = value.as<Map>();
+                Value *found = map.find(mapIndex);
+                if (!found)
                     throw RuntimeError(FString(
-                        std::format("Key {} not found", mapIndex->toString().toBasicString())));
-                return map.at(mapIndex);
+                        std::format("Key {} not found", mapIndex.toString().toBasicString())));
+                return *found;
             }
             else
             {
                 // string
-                FString &string = value->as<ValueType::StringClass>();
+                const ValueType::StringClass &string = value.as<ValueType::StringClass>();
                 if (numIndex >= string.length())
                     throw RuntimeError(FString(
-                        std::format("Index {} out of range {}", numIndex, value->toString().toBasicString())));
+                        std::format("Index {} out of range {}", numIndex, value.toString().toBasicString())));
 
-                return std::make_shared<Object>(string.getRealChar(numIndex));
+                return Value(Object(ValueType::StringClass(string[numIndex])));
             }
         }
 
-        void set(const ObjectPtr &v)
+        void set(const Value &v)
         {
             if (kind == Kind::Variable)
             {
@@ -97,34 +98,34 @@ namespace Fig
             }
             else if (kind == Kind::ListElement)
             {
-                List &list = value->as<List>();
+                List &list = value.as<List>();
                 if (numIndex >= list.size())
                     throw RuntimeError(FString(
                         std::format("Index {} out of range", numIndex)));
-                list[numIndex] = v;
+                list.set(numIndex, v);
             }
             else if (kind == Kind::MapElement) // map
             {
-                Map &map = value->as<Map>();
+                Map &map = value.as<Map>();
                 map[mapIndex] = v;
             }
             else if (kind == Kind::StringElement)
             {
-                FString &string = value->as<ValueType::StringClass>();
+                ValueType::StringClass &string = value.as<ValueType::StringClass>();
                 if (numIndex >= string.length())
                     throw RuntimeError(FString(
-                        std::format("Index {} out of range {}", numIndex, value->toString().toBasicString())));
+                        std::format("Index {} out of range {}", numIndex, value.toString().toBasicString())));
                 
-                if (v->getTypeInfo() != ValueType::String)
+                if (v.getTypeInfo() != ValueType::String)
                     throw RuntimeError(FString(
-                        std::format("Could not assign {} to sub string", v->toString().toBasicString())
+                        std::format("Could not assign {} to sub string", v.toString().toBasicString())
                     ));
-                const FString &strReplace = v->as<ValueType::StringClass>();
+                const ValueType::StringClass &strReplace = v.as<ValueType::StringClass>();
                 if (strReplace.length() > 1)
                     throw RuntimeError(FString(
-                        std::format("Could not assign {} to sub string, expects length 1", v->toString().toBasicString())
+                        std::format("Could not assign {} to sub string, expects length 1", v.toString().toBasicString())
                 ));
-                string.realReplace(numIndex, strReplace);
+                string.replace(numIndex, 1, strReplace);
             }
         }
 
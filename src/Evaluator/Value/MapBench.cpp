@@ -0,0 +1,129 @@
+#include <Evaluator/Value/value.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace Fig;
+
+/*
+    Map throughput: insert, lookup (hit), contains then get of the same key (fib_memo), miss and iteration over
+    `count` Int keys and `count` String keys,
+    for the Map value (ValueMap) and a std::unordered_map keyed the same way (what Map was before it)
+    usage: MapBench [count] [rounds]
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct KeyHash
+{
+    size_t operator()(const Value &key) const { return hashValue(key); }
+};
+struct KeyEqual
+{
+    bool operator()(const Value &l, const Value &r) const { return valueEquals(l, r); }
+};
+using BaselineMap = std::unordered_map<Value, Value, KeyHash, KeyEqual>;
+
+struct Timings
+{
+    double insert = 0, lookup = 0, containsGet = 0, miss = 0, iterate = 0;
+};
+
+static double seconds(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// keys[i] are inserted, missing[i] are not
+template <class M>
+static Timings run(const std::vector<Value> &keys, const std::vector<Value> &missing, size_t rounds, size_t &sink)
+{
+    Timings t;
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        M map;
+        auto start = Clock::now();
+        for (const Value &key : keys) { map[key] = key; }
+        t.insert += seconds(start, Clock::now());
+
+        start = Clock::now();
+        for (const Value &key : keys)
+        {
+            if constexpr (std::is_same_v<M, Map>)
+                sink += (map.find(key) != nullptr);
+            else
+                sink += (map.find(key) != map.end());
+        }
+        t.lookup += seconds(start, Clock::now());
+
+        start = Clock::now();
+        for (const Value &key : keys)
+        {
+            if (!map.contains(key)) continue;
+            if constexpr (std::is_same_v<M, Map>)
+                sink += static_cast<size_t>(map.find(key)->getKind());
+            else
+                sink += static_cast<size_t>(map.find(key)->second.getKind());
+        }
+        t.containsGet += seconds(start, Clock::now());
+
+        start = Clock::now();
+        for (const Value &key : missing) { sink += map.contains(key); }
+        t.miss += seconds(start, Clock::now());
+
+        start = Clock::now();
+        for (const auto &[key, value] : map) { sink += static_cast<size_t>(value.getKind()); }
+        t.iterate += seconds(start, Clock::now());
+    }
+    return t;
+}
+
+static void report(std::string_view name, const Timings &map, const Timings &baseline, size_t ops)
+{
+    auto row = [ops](std::string_view what, double mapTime, double baselineTime) {
+        double mapNs = mapTime * 1e9 / static_cast<double>(ops);
+        double baselineNs = baselineTime * 1e9 / static_cast<double>(ops);
+        std::string label(what);
+        label.resize(12, ' ');
+        std::cout << "    " << label << "  " << mapNs << "  " << baselineNs << "  " << baselineNs / mapNs << "x\n";
+    };
+    std::cout << "  " << name << "\n";
+    row("insert", map.insert, baseline.insert);
+    row("lookup", map.lookup, baseline.lookup);
+    row("contains+get", map.containsGet, baseline.containsGet);
+    row("miss", map.miss, baseline.miss);
+    row("iterate", map.iterate, baseline.iterate);
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000);
+    size_t rounds = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20);
+
+    std::vector<Value> ints, missingInts, strings, missingStrings;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ints.push_back(Value::Int(static_cast<ValueType::IntClass>(i * 7)));
+        missingInts.push_back(Value::Int(static_cast<ValueType::IntClass>(i * 7 + 3)));
+        strings.push_back(Value(Object(FString(std::format("key_{}", i)))));
+        missingStrings.push_back(Value(Object(FString(std::format("absent_{}", i)))));
+    }
+
+    size_t sink = 0; // keeps the results alive to the optimizer
+    size_t ops = count * rounds;
+
+    std::cout << count << " keys, " << rounds << " rounds, ns/op\n";
+    std::cout << "    op            Map  unordered_map  speedup\n";
+    report("Int keys", run<Map>(ints, missingInts, rounds, sink), run<BaselineMap>(ints, missingInts, rounds, sink), ops);
+    report("String keys",
+           run<Map>(strings, missingStrings, rounds, sink),
+           run<BaselineMap>(strings, missingStrings, rounds, sink),
+           ops);
+    if (sink == 0) std::cout << "(no results)\n";
+    return 0;
+}
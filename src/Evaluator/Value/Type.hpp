@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/fig_string.hpp>
+#include <Core/String.hpp>
 
 #include <unordered_set>
 #include <variant>
@@ -63,7 +64,21 @@ namespace Fig
         using DoubleClass = double;
         using BoolClass = bool;
         using NullClass = std::monostate;
-        using StringClass = FString;
+        using StringClass = Fig::String; // code point indexed, see Core/String.hpp
+
+        // source text, identifiers and I/O stay UTF-8 (FString), conversions happen at these boundaries
+        inline StringClass toStringClass(const FString &s)
+        {
+            return StringClass(std::u8string_view(s));
+        }
+
+        inline FString toFString(const StringClass &s)
+        {
+            FString res;
+            res.reserve(s.length());
+            s.appendUTF8(res);
+            return res;
+        }
 
         inline bool isTypeBuiltin(const TypeInfo &type)
         {
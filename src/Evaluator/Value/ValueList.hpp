@@ -0,0 +1,234 @@
+#pragma once
+
+#include <Evaluator/Value/InlineValue.hpp>
+#include <Evaluator/Value/Type.hpp>
+#include <Evaluator/Value/value_forward.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace Fig
+{
+    bool valueEquals(const Value &, const Value &);
+
+    struct Element
+    {
+        Value value;
+        Element(Value _value) : value(std::move(_value)) {}
+
+        bool operator==(const Element &other) const { return valueEquals(value, other.value); }
+
+        void deepCopy(const Element &e);
+    };
+
+    /*
+        ListKernels
+        loops over packed List storage. four independent accumulators / compares per step: no dependency
+        between iterations, so the compiler keeps them in vector registers (no intrinsics, any target)
+    */
+    namespace ListKernels
+    {
+        inline ValueType::IntClass sum(const ValueType::IntClass *p, size_t n)
+        {
+            uint64_t a0 = 0, a1 = 0, a2 = 0, a3 = 0; // unsigned: overflow wraps like Int +
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                a0 += static_cast<uint64_t>(p[i]);
+                a1 += static_cast<uint64_t>(p[i + 1]);
+                a2 += static_cast<uint64_t>(p[i + 2]);
+                a3 += static_cast<uint64_t>(p[i + 3]);
+            }
+            for (; i < n; ++i) a0 += static_cast<uint64_t>(p[i]);
+            return static_cast<ValueType::IntClass>(a0 + a1 + a2 + a3);
+        }
+
+        inline ValueType::DoubleClass sum(const ValueType::DoubleClass *p, size_t n)
+        {
+            ValueType::DoubleClass a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                a0 += p[i];
+                a1 += p[i + 1];
+                a2 += p[i + 2];
+                a3 += p[i + 3];
+            }
+            for (; i < n; ++i) a0 += p[i];
+            return (a0 + a1) + (a2 + a3);
+        }
+
+        inline ValueType::IntClass dot(const ValueType::IntClass *x, const ValueType::IntClass *y, size_t n)
+        {
+            uint64_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                a0 += static_cast<uint64_t>(x[i]) * static_cast<uint64_t>(y[i]);
+                a1 += static_cast<uint64_t>(x[i + 1]) * static_cast<uint64_t>(y[i + 1]);
+                a2 += static_cast<uint64_t>(x[i + 2]) * static_cast<uint64_t>(y[i + 2]);
+                a3 += static_cast<uint64_t>(x[i + 3]) * static_cast<uint64_t>(y[i + 3]);
+            }
+            for (; i < n; ++i) a0 += static_cast<uint64_t>(x[i]) * static_cast<uint64_t>(y[i]);
+            return static_cast<ValueType::IntClass>(a0 + a1 + a2 + a3);
+        }
+
+        inline ValueType::DoubleClass dot(const ValueType::DoubleClass *x, const ValueType::DoubleClass *y, size_t n)
+        {
+            ValueType::DoubleClass a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                a0 += x[i] * y[i];
+                a1 += x[i + 1] * y[i + 1];
+                a2 += x[i + 2] * y[i + 2];
+                a3 += x[i + 3] * y[i + 3];
+            }
+            for (; i < n; ++i) a0 += x[i] * y[i];
+            return (a0 + a1) + (a2 + a3);
+        }
+
+        // n > 0
+        template <class T>
+        T min(const T *p, size_t n)
+        {
+            T m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                m0 = std::min(m0, p[i]);
+                m1 = std::min(m1, p[i + 1]);
+                m2 = std::min(m2, p[i + 2]);
+                m3 = std::min(m3, p[i + 3]);
+            }
+            for (; i < n; ++i) m0 = std::min(m0, p[i]);
+            return std::min(std::min(m0, m1), std::min(m2, m3));
+        }
+
+        // n > 0
+        template <class T>
+        T max(const T *p, size_t n)
+        {
+            T m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                m0 = std::max(m0, p[i]);
+                m1 = std::max(m1, p[i + 1]);
+                m2 = std::max(m2, p[i + 2]);
+                m3 = std::max(m3, p[i + 3]);
+            }
+            for (; i < n; ++i) m0 = std::max(m0, p[i]);
+            return std::max(std::max(m0, m1), std::max(m2, m3));
+        }
+
+        // first i with p[i] == x, or n. a block of 8 is tested branch free before it's searched
+        inline size_t indexOf(const ValueType::IntClass *p, size_t n, ValueType::IntClass x)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                bool any = (p[i] == x) | (p[i + 1] == x) | (p[i + 2] == x) | (p[i + 3] == x) | (p[i + 4] == x)
+                           | (p[i + 5] == x) | (p[i + 6] == x) | (p[i + 7] == x);
+                if (any) break;
+            }
+            for (; i < n; ++i)
+            {
+                if (p[i] == x) return i;
+            }
+            return n;
+        }
+    }; // namespace ListKernels
+
+    /*
+        ValueList
+        the List value. while every element is an Int, a Double or a Bool the elements are stored unboxed in
+        a vector<int64_t> / vector<double> / vector<bool>; the first store of another kind (an Int into a
+        Double list, a String, a struct...) boxes them all and the list stays boxed
+
+        elements come and go as Values: a packed element is read back as an inline Value, and Boxed storage
+        holds Values too, so a scalar in a mixed list isn't boxed either
+
+        sum / min / max / dot / indexOf run ListKernels over packed storage and compare Objects otherwise
+    */
+    class ValueList
+    {
+    public:
+        enum class Kind : uint8_t
+        {
+            Empty, // no element stored yet, the first one decides
+            Int,
+            Double,
+            Bool,
+            Boxed,
+        };
+
+        using Ints = std::vector<ValueType::IntClass>;
+        using Doubles = std::vector<ValueType::DoubleClass>;
+        using Bools = std::vector<bool>; // bitset
+        using Elements = std::vector<Element>;
+
+    private:
+        using Storage = std::variant<std::monostate, Ints, Doubles, Bools, Elements>; // alternatives in Kind order
+        Storage storage;
+
+        static Kind kindOf(const Value &value);
+        void box(); // to Kind::Boxed
+
+    public:
+        ValueList() = default;
+        ValueList(std::initializer_list<Value> values);
+        explicit ValueList(const std::vector<Value> &values);
+
+        Kind kind() const { return static_cast<Kind>(storage.index()); }
+        bool isPacked() const { return kind() != Kind::Empty && kind() != Kind::Boxed; }
+
+        size_t size() const
+        {
+            return std::visit(
+                [](const auto &v) -> size_t {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+                        return 0;
+                    else
+                        return v.size();
+                },
+                storage);
+        }
+        bool empty() const { return size() == 0; }
+
+        void reserve(size_t count)
+        {
+            std::visit(
+                [count](auto &v) {
+                    if constexpr (!std::is_same_v<std::decay_t<decltype(v)>, std::monostate>) v.reserve(count);
+                },
+                storage);
+        }
+
+        Value get(size_t index) const;
+        void set(size_t index, const Value &value);
+        void push_back(const Value &value);
+
+        // the boxed elements, nullptr while packed (packed elements reference nothing)
+        const Elements *boxed() const { return std::get_if<Elements>(&storage); }
+
+        const Ints *ints() const { return std::get_if<Ints>(&storage); }
+        const Doubles *doubles() const { return std::get_if<Doubles>(&storage); }
+        const Bools *bools() const { return std::get_if<Bools>(&storage); }
+
+        // element-wise Object ==, whatever the storage of either side
+        bool operator==(const ValueList &other) const;
+
+        // reductions behind the List member functions, value.cpp
+        Value sum() const;
+        Value min() const;
+        Value max() const;
+        Value dot(const ValueList &other) const;
+        ValueType::IntClass indexOf(const Value &value) const;
+    };
+}; // namespace Fig
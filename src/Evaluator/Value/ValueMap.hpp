@@ -0,0 +1,277 @@
+#pragma once
+
+#include <Evaluator/Value/InlineValue.hpp>
+#include <Evaluator/Value/value_forward.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Fig
+{
+    bool valueEquals(const Value &, const Value &);
+
+    // hash consistent with Object ==, any value kind (containers structurally, functions / instances by identity)
+    size_t hashValue(const Object &);
+    size_t hashValue(const Value &);
+
+    struct ValueKey
+    {
+        Value value;
+        ValueKey(Value _value) : value(std::move(_value)) {}
+
+        void deepCopy(const ValueKey &vk);
+    };
+
+    /*
+        ValueMap
+        the Map value: open addressing over a control byte array (Swiss table style), entries kept in
+        insertion order so iteration and printing are deterministic
+
+        `entries` holds (key, value) pairs in insertion order with their hash in `hashes`. the index is
+        `ctrl` (one byte per slot: Empty, or the low 7 bits of the hash) plus `slots` (entry index per slot).
+        a probe reads a group of 8 control bytes at once and compares keys only where the 7 bits match;
+        growing re-places the cached hashes, keys are never hashed again
+
+        List / Map keys are copied on insertion, mutating the original afterwards doesn't move the entry
+        there's no removal: the language has none
+    */
+    class ValueMap
+    {
+    public:
+        using Entry = std::pair<ValueKey, Value>;
+        using const_iterator = std::vector<Entry>::const_iterator;
+
+    private:
+        static constexpr uint8_t Empty = 0x80;
+        static constexpr size_t GroupWidth = 8;
+        static constexpr uint64_t LowBits = 0x0101010101010101ull;
+        static constexpr uint64_t HighBits = 0x8080808080808080ull;
+
+        std::vector<Entry> entries;
+        std::vector<uint64_t> hashes;  // parallel to entries
+        std::vector<uint8_t> ctrl;     // capacity bytes, capacity is 0 or a power of two >= GroupWidth
+        std::vector<uint32_t> slots;   // entry index of each full slot
+
+        // last key found and its entry: `m.contains(k)` then `m.get(k)` passes the same key twice, the second
+        // lookup only compares it to the entry's key. a boxed key has to be the same Object (nullptr: the key
+        // was a scalar, comparing one is as cheap). hits only, entries are never removed
+        mutable const Object *lastKey = nullptr;
+        mutable size_t lastEntry = SIZE_MAX;
+
+        static uint64_t mix(uint64_t h)
+        {
+            // Int keys hash to themselves, spread them over the whole word
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        static uint8_t tagOf(uint64_t hash) { return static_cast<uint8_t>(hash & 0x7F); }
+
+        size_t groupMask() const { return ctrl.size() / GroupWidth - 1; }
+
+        uint64_t loadGroup(size_t group) const
+        {
+            uint64_t word;
+            std::memcpy(&word, ctrl.data() + group * GroupWidth, GroupWidth);
+            return word;
+        }
+
+        // high bit set in every byte equal to `tag`
+        // (may report a false positive next to a real match, keys are compared anyway)
+        static uint64_t matchTag(uint64_t group, uint8_t tag)
+        {
+            uint64_t x = group ^ (LowBits * tag);
+            return (x - LowBits) & ~x & HighBits;
+        }
+
+        static uint64_t matchEmpty(uint64_t group) { return group & HighBits; }
+
+        static size_t byteIndex(uint64_t bits)
+        {
+            // control bytes are loaded in memory order
+            if constexpr (std::endian::native == std::endian::little)
+                return static_cast<size_t>(std::countr_zero(bits)) / 8;
+            else
+                return static_cast<size_t>(std::countl_zero(bits)) / 8;
+        }
+
+        static uint64_t clearLowest(uint64_t bits, size_t byte)
+        {
+            if constexpr (std::endian::native == std::endian::little)
+                return bits & (bits - 1);
+            else
+                return bits & ~(uint64_t(0x80) << (8 * (GroupWidth - 1 - byte)));
+        }
+
+        // entry index of `key`, or entries.size()
+        size_t findIndex(const Value &key, uint64_t hash) const
+        {
+            if (ctrl.empty()) { return entries.size(); }
+            uint8_t tag = tagOf(hash);
+            size_t mask = groupMask();
+            size_t group = (hash >> 7) & mask;
+            for (size_t step = 1;; ++step)
+            {
+                uint64_t word = loadGroup(group);
+                for (uint64_t bits = matchTag(word, tag); bits != 0;)
+                {
+                    size_t byte = byteIndex(bits);
+                    size_t entry = slots[group * GroupWidth + byte];
+                    if (hashes[entry] == hash && valueEquals(entries[entry].first.value, key)) { return entry; }
+                    bits = clearLowest(bits, byte);
+                }
+                if (matchEmpty(word) != 0) { return entries.size(); }
+                group = (group + step) & mask; // triangular probing visits every group
+            }
+        }
+
+        // puts entry `entry` in the first empty slot of its probe sequence
+        void place(size_t entry)
+        {
+            uint64_t hash = hashes[entry];
+            size_t mask = groupMask();
+            size_t group = (hash >> 7) & mask;
+            for (size_t step = 1;; ++step)
+            {
+                uint64_t empty = matchEmpty(loadGroup(group));
+                if (empty != 0)
+                {
+                    size_t slot = group * GroupWidth + byteIndex(empty);
+                    ctrl[slot] = tagOf(hash);
+                    slots[slot] = static_cast<uint32_t>(entry);
+                    return;
+                }
+                group = (group + step) & mask;
+            }
+        }
+
+        void rehash(size_t capacity)
+        {
+            ctrl.assign(capacity, Empty);
+            slots.assign(capacity, 0);
+            for (size_t i = 0; i < entries.size(); ++i) { place(i); }
+        }
+
+        // load factor at most 7/8
+        void growFor(size_t count)
+        {
+            size_t capacity = (ctrl.empty() ? GroupWidth : ctrl.size());
+            while (count > capacity - capacity / 8) { capacity *= 2; }
+            if (capacity != ctrl.size()) { rehash(capacity); }
+        }
+
+        // entry index of `key`, or entries.size()
+        size_t lookup(const Value &key) const
+        {
+            if (key.boxed() == lastKey && lastEntry < entries.size() && valueEquals(entries[lastEntry].first.value, key))
+            {
+                return lastEntry; // keys are unique, an equal one is the entry
+            }
+            size_t entry = findIndex(key, mix(hashValue(key)));
+            if (entry != entries.size())
+            {
+                lastKey = key.boxed();
+                lastEntry = entry;
+            }
+            return entry;
+        }
+
+        static Value ownKey(const Value &key); // value.cpp
+
+        size_t insertNew(const Value &key, uint64_t hash, Value value)
+        {
+            growFor(entries.size() + 1);
+            entries.emplace_back(ValueKey(ownKey(key)), std::move(value));
+            hashes.push_back(hash);
+            place(entries.size() - 1);
+            return entries.size() - 1;
+        }
+
+    public:
+        ValueMap() = default;
+
+        size_t size() const { return entries.size(); }
+        bool empty() const { return entries.empty(); }
+
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const { return entries.end(); }
+
+        void reserve(size_t count)
+        {
+            entries.reserve(count);
+            hashes.reserve(count);
+            if (count != 0) { growFor(count); }
+        }
+
+        void clear()
+        {
+            entries.clear();
+            hashes.clear();
+            ctrl.clear();
+            slots.clear();
+            lastKey = nullptr;
+            lastEntry = SIZE_MAX;
+        }
+
+        // nullptr when absent: a single probe for `get`, where contains() + at() would hash twice
+        const Value *find(const Value &key) const
+        {
+            size_t entry = lookup(key);
+            return (entry == entries.size() ? nullptr : &entries[entry].second);
+        }
+        Value *find(const Value &key)
+        {
+            size_t entry = lookup(key);
+            return (entry == entries.size() ? nullptr : &entries[entry].second);
+        }
+
+        bool contains(const Value &key) const { return find(key) != nullptr; }
+
+        // value of `key`, inserted as null when absent
+        Value &operator[](const Value &key)
+        {
+            uint64_t hash = mix(hashValue(key));
+            size_t entry = findIndex(key, hash);
+            if (entry == entries.size()) { entry = insertNew(key, hash, Value()); }
+            return entries[entry].second;
+        }
+
+        // inserts unless present, returns whether it did
+        bool emplace(const Value &key, Value value)
+        {
+            uint64_t hash = mix(hashValue(key));
+            if (findIndex(key, hash) != entries.size()) { return false; }
+            insertNew(key, hash, std::move(value));
+            return true;
+        }
+
+        // same keys mapping to equal values, whatever the insertion order
+        bool operator==(const ValueMap &other) const
+        {
+            if (entries.size() != other.entries.size()) { return false; }
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                size_t j = other.findIndex(entries[i].first.value, hashes[i]);
+                if (j == other.entries.size() || !valueEquals(entries[i].second, other.entries[j].second))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // order independent, consistent with ==
+        uint64_t hashKeys() const
+        {
+            uint64_t h = entries.size();
+            for (uint64_t keyHash : hashes) { h += keyHash; }
+            return h;
+        }
+    };
+}; // namespace Fig
@@ -3,6 +3,7 @@
 
 #include <Ast/AccessModifier.hpp>
 #include <Core/fig_string.hpp>
+#include <Evaluator/Value/InlineValue.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/value_forward.hpp>
 
@@ -13,11 +14,13 @@ namespace Fig
     struct VariableSlot
     {
         FString name;
-        ObjectPtr value;
+        Value value;
         TypeInfo declaredType;
         AccessModifier am;
 
         bool isRef = false;
         std::shared_ptr<VariableSlot> refTarget;
+
+        bool isField = false; // lives in StructInstance::Storage, a shared_ptr to it shares the Storage's control block
     };
 }
\ No newline at end of file
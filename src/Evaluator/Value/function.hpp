@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Ast/functionParameters.hpp>
+#include <Core/Symbol.hpp>
 #include <Evaluator/Context/context_forward.hpp>
+#include <Evaluator/Value/InlineValue.hpp>
 
 #include <atomic>
 #include <functional>
@@ -11,6 +13,24 @@
 namespace Fig
 {
     class Object;
+    struct CompiledFunction;
+
+    /*
+        CompiledSignature
+        parameter types and literal defaults of a Normal function, resolved on its first call (a type may
+        name a struct declared after the function) by Evaluator::resolveSignature.
+        made when the function is defined and shared by every copy and bound copy of it
+    */
+    struct CompiledSignature
+    {
+        bool resolved = false;
+        size_t minArgs = 0; // posParas
+        size_t maxArgs = 0; // posParas + defParas
+
+        std::vector<TypeInfo> paraTypes;               // posParas then defParas
+        std::vector<Symbol> paraNames;                 // same order, interned for Context::def
+        std::vector<std::shared_ptr<Object>> defaults; // per defPara, nullptr: not a literal, evaluated per call
+    };
 
     class Function
     {
@@ -22,7 +42,8 @@ namespace Fig
         {
             Normal,
             Builtin,
-            MemberType
+            MemberType,
+            Compiled // bytecode, only callable by VirtualMachine
         } type;
 
         union
@@ -34,16 +55,18 @@ namespace Fig
 
                 Ast::BlockStatement body;
             };
-            std::function<std::shared_ptr<Object>(const std::vector<std::shared_ptr<Object>> &)> builtin;
-            std::function<std::shared_ptr<Object>(std::shared_ptr<Object>,
-                                                  const std::vector<std::shared_ptr<Object>> &)>
-                mtFn;
+            std::function<Value(const std::vector<Value> &)> builtin;
+            std::function<Value(const Value &, const std::vector<Value> &)> mtFn;
         };
 
         int builtinParamCount = -1;
 
         std::shared_ptr<Context> closureContext;
 
+        std::shared_ptr<const CompiledFunction> compiled; // type == Compiled
+
+        std::shared_ptr<CompiledSignature> signature; // type == Normal
+
         // ===== Constructors =====
         Function() : id(nextId()), type(Normal)
         {
@@ -51,6 +74,7 @@ namespace Fig
             new (&paras) Ast::FunctionParameters();
             new (&retType) TypeInfo();
             new (&body) Ast::BlockStatement();
+            signature = std::make_shared<CompiledSignature>();
         }
 
         Function(const FString &_name,
@@ -63,25 +87,29 @@ namespace Fig
             paras(std::move(_paras)),
             retType(std::move(_retType)),
             body(std::move(_body)),
-            closureContext(std::move(_closureContext))
+            closureContext(std::move(_closureContext)),
+            signature(std::make_shared<CompiledSignature>())
         {
             type = Normal;
         }
 
-        Function(const FString &_name, std::function<std::shared_ptr<Object>(const std::vector<std::shared_ptr<Object>> &)> fn, int argc) :
+        Function(const FString &_name, std::function<Value(const std::vector<Value> &)> fn, int argc) :
             id(nextId()), name(_name), type(Builtin), builtin(fn), builtinParamCount(argc)
         {
             type = Builtin;
         }
 
-        Function(const FString &_name, std::function<std::shared_ptr<Object>(std::shared_ptr<Object>,
-                                                       const std::vector<std::shared_ptr<Object>> &)> fn,
-                 int argc) :
+        Function(const FString &_name, std::function<Value(const Value &, const std::vector<Value> &)> fn, int argc) :
             id(nextId()), name(_name), type(MemberType), mtFn(fn), builtinParamCount(argc)
         {
             type = MemberType;
         }
 
+        Function(const FString &_name, std::shared_ptr<const CompiledFunction> _compiled) :
+            id(nextId()), name(_name), type(Compiled), compiled(std::move(_compiled))
+        {
+        }
+
         // ===== Copy / Move =====
         Function(const Function &other) { copyFrom(other); }
         Function &operator=(const Function &other)
@@ -96,6 +124,14 @@ namespace Fig
 
         ~Function() { destroy(); }
 
+        // the same definition closed over another context (a method bound to an instance), shares the signature
+        Function boundTo(ContextPtr _closureContext) const
+        {
+            Function bound(*this);
+            bound.closureContext = std::move(_closureContext);
+            return bound;
+        }
+
         // ===== Comparison =====
         bool operator==(const Function &other) const noexcept { return id == other.id; }
         bool operator!=(const Function &other) const noexcept { return !(*this == other); }
@@ -113,10 +149,10 @@ namespace Fig
                 case Normal:
                     paras.~FunctionParameters();
                     retType.~TypeInfo();
-                    body.~shared_ptr();
-                    break;
+                    break; // body: arena node, not owned
                 case Builtin: builtin.~function(); break;
                 case MemberType: mtFn.~function(); break;
+                case Compiled: break;
             }
         }
 
@@ -127,6 +163,8 @@ namespace Fig
             id = nextId(); // 每个复制都生成新的ID
             builtinParamCount = other.builtinParamCount;
             closureContext = other.closureContext;
+            compiled = other.compiled;
+            signature = other.signature;
 
             switch (type)
             {
@@ -136,13 +174,12 @@ namespace Fig
                     new (&body) Ast::BlockStatement(other.body);
                     break;
                 case Builtin:
-                    new (&builtin) std::function<std::shared_ptr<Object>(const std::vector<std::shared_ptr<Object>> &)>(
-                        other.builtin);
+                    new (&builtin) std::function<Value(const std::vector<Value> &)>(other.builtin);
                     break;
                 case MemberType:
-                    new (&mtFn) std::function<std::shared_ptr<Object>(
-                        std::shared_ptr<Object>, const std::vector<std::shared_ptr<Object>> &)>(other.mtFn);
+                    new (&mtFn) std::function<Value(const Value &, const std::vector<Value> &)>(other.mtFn);
                     break;
+                case Compiled: break;
             }
         }
     };
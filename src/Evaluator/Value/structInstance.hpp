@@ -1,28 +1,64 @@
 #pragma once
 
 #include <Evaluator/Context/context_forward.hpp>
+#include <Evaluator/Value/structType.hpp>
 #include <Evaluator/Value/Type.hpp>
+#include <Evaluator/Value/VariableSlot.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace Fig
 {
     struct StructInstance
     {
+        struct Storage
+        {
+            std::vector<VariableSlot> fields; // StructShape::fieldIndex order, never resized
+
+            // closure of bound methods, rebuilt on demand
+            // weak: the context points back to this storage
+            std::weak_ptr<Context> methodContext;
+
+            // methods bound to methodContext, keyed by the shape's unbound slot (fixed once the struct is defined)
+            // filled on first lookup; holds methodContext, so the cycle is left to the Collector
+            std::unordered_map<const VariableSlot *, std::shared_ptr<VariableSlot>> boundMethods;
+        };
+
         TypeInfo parentType;
-        ContextPtr localContext;
+        std::shared_ptr<const StructShape> shape;
+        std::shared_ptr<Storage> storage; // shared by copies, like the object itself
 
         // ===== Constructors =====
-        StructInstance(TypeInfo _parentType, ContextPtr _localContext) :
-            parentType(_parentType), localContext(std::move(_localContext)) {}
+        StructInstance(TypeInfo _parentType, std::shared_ptr<const StructShape> _shape, std::vector<VariableSlot> _fields) :
+            parentType(std::move(_parentType)), shape(std::move(_shape)), storage(std::make_shared<Storage>())
+        {
+            storage->fields = std::move(_fields);
+            for (VariableSlot &field : storage->fields) { field.isField = true; }
+        }
 
         StructInstance(const StructInstance &other) = default;
         StructInstance(StructInstance &&) noexcept = default;
         StructInstance &operator=(const StructInstance &) = default;
         StructInstance &operator=(StructInstance &&) noexcept = default;
 
+        // slot pointing into storage, no allocation
+        std::shared_ptr<VariableSlot> field(size_t index) const
+        {
+            return std::shared_ptr<VariableSlot>(storage, &storage->fields[index]);
+        }
+
+        std::shared_ptr<VariableSlot> findField(Symbol name) const
+        {
+            int index = shape->findField(name);
+            return (index < 0 ? nullptr : field(static_cast<size_t>(index)));
+        }
+
         // ===== Comparison =====
         bool operator==(const StructInstance &other) const noexcept
         {
-            return parentType == other.parentType && localContext == other.localContext;
+            return parentType == other.parentType && storage == other.storage;
         }
         bool operator!=(const StructInstance &other) const noexcept
         {
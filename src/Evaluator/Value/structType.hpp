@@ -1,12 +1,16 @@
 #pragma once
 
 #include <Core/fig_string.hpp>
+#include <Core/Symbol.hpp>
 #include <Ast/Statements/StructDefSt.hpp>
 
 #include <Evaluator/Value/Type.hpp>
+#include <Evaluator/Value/VariableSlot.hpp>
 
 #include <Evaluator/Context/context_forward.hpp>
 #include <atomic>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace Fig
@@ -31,23 +35,70 @@ namespace Fig
         }
     };
 
+    /*
+        layout shared by a struct type and all of its instances
+        fields live in StructInstance::Storage at the index given here, methods stay in the definition
+        context and are bound to an instance when looked up
+    */
+    struct StructShape
+    {
+        ContextPtr defContext;
+        std::vector<Field> fields;
+        std::unordered_map<Symbol, size_t> fieldIndex;
+        std::unordered_map<Symbol, std::shared_ptr<VariableSlot>> methods; // unbound, slot in defContext
+
+        int findField(Symbol name) const
+        {
+            auto it = fieldIndex.find(name);
+            return (it == fieldIndex.end() ? -1 : static_cast<int>(it->second));
+        }
+
+        const std::shared_ptr<VariableSlot> *findMethod(Symbol name) const
+        {
+            auto it = methods.find(name);
+            return (it == methods.end() ? nullptr : &it->second);
+        }
+    };
+
     struct StructType
     {
         TypeInfo type;
         ContextPtr defContext; // 定义时的上下文
         std::vector<Field> fields;
+        std::shared_ptr<StructShape> shape;
 
         bool builtin = false;
 
         // ===== Constructors =====
         StructType(TypeInfo _type, ContextPtr _defContext, std::vector<Field> _fields, bool _builtin = false) :
-            type(std::move(_type)), defContext(std::move(_defContext)), fields(std::move(_fields)), builtin(_builtin) {}
+            type(std::move(_type)),
+            defContext(std::move(_defContext)),
+            fields(std::move(_fields)),
+            shape(std::make_shared<StructShape>()),
+            builtin(_builtin)
+        {
+            shape->defContext = defContext;
+            setFields(fields);
+        }
 
         StructType(const StructType &other) = default;
         StructType(StructType &&) noexcept = default;
         StructType &operator=(const StructType &) = default;
         StructType &operator=(StructType &&) noexcept = default;
 
+        void setFields(std::vector<Field> _fields)
+        {
+            fields = std::move(_fields);
+            shape->fields = fields;
+            shape->fieldIndex.clear();
+            for (size_t i = 0; i < fields.size(); ++i) { shape->fieldIndex[fields[i].name] = i; }
+        }
+
+        void addMethod(Symbol name, std::shared_ptr<VariableSlot> slot)
+        {
+            shape->methods[name] = std::move(slot);
+        }
+
         // ===== Comparison =====
         bool operator==(const StructType &other) const noexcept
         {
@@ -3,8 +3,11 @@
 #include <Evaluator/Value/value_forward.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/value.hpp>
+#include <Evaluator/Value/IntPool.hpp>
 #include <Evaluator/Context/context.hpp>
 
+#include <algorithm>
+
 // #include <iostream>
 
 namespace Fig
@@ -35,65 +38,434 @@ namespace Fig
         }
     }
 
-    size_t ValueKeyHash::operator()(const ValueKey &key) const
+    size_t hashValue(const Object &value)
+    {
+        return std::visit(
+            [](const auto &v) -> size_t {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, ValueType::NullClass>) { return 0; }
+                else if constexpr (std::is_same_v<T, ValueType::IntClass>)
+                {
+                    return std::hash<ValueType::IntClass>{}(v);
+                }
+                else if constexpr (std::is_same_v<T, ValueType::DoubleClass>)
+                {
+                    // 2.0 == 2, so an integral Double hashes as the Int
+                    if (isDoubleInteger(v) && !isNumberExceededIntLimit(v))
+                    {
+                        return std::hash<ValueType::IntClass>{}(static_cast<ValueType::IntClass>(v));
+                    }
+                    return std::hash<ValueType::DoubleClass>{}(v);
+                }
+                else if constexpr (std::is_same_v<T, ValueType::StringClass>) { return v.hash(); } // cached
+                else if constexpr (std::is_same_v<T, ValueType::BoolClass>) { return (v ? 1 : 2); }
+                else if constexpr (std::is_same_v<T, Function>) { return std::hash<size_t>{}(v.id); }
+                else if constexpr (std::is_same_v<T, StructType>) { return std::hash<TypeInfo>{}(v.type); }
+                else if constexpr (std::is_same_v<T, StructInstance>)
+                {
+                    return std::hash<TypeInfo>{}(v.parentType)
+                           + std::hash<uint64_t>{}(reinterpret_cast<uint64_t>(v.storage.get()));
+                }
+                else if constexpr (std::is_same_v<T, List>)
+                {
+                    size_t h = v.size();
+                    if (const auto *ints = v.ints())
+                    {
+                        for (ValueType::IntClass i : *ints) { h = h * 31 + std::hash<ValueType::IntClass>{}(i); }
+                        return h;
+                    }
+                    for (size_t i = 0; i < v.size(); ++i) { h = h * 31 + hashValue(v.get(i)); }
+                    return h;
+                }
+                else if constexpr (std::is_same_v<T, Map>) { return v.hashKeys(); }
+                else if constexpr (std::is_same_v<T, Module>) { return std::hash<FString>{}(v.name); }
+                else if constexpr (std::is_same_v<T, InterfaceType>) { return std::hash<TypeInfo>{}(v.type); }
+            },
+            value.data);
+    }
+
+    size_t hashValue(const Value &value)
+    {
+        switch (value.getKind())
+        {
+            case Value::Kind::Null: return 0;
+            case Value::Kind::Bool: return (value.as<ValueType::BoolClass>() ? 1 : 2);
+            case Value::Kind::Int: return std::hash<ValueType::IntClass>{}(value.as<ValueType::IntClass>());
+            case Value::Kind::Double: {
+                ValueType::DoubleClass v = value.as<ValueType::DoubleClass>();
+                if (isDoubleInteger(v) && !isNumberExceededIntLimit(v))
+                {
+                    return std::hash<ValueType::IntClass>{}(static_cast<ValueType::IntClass>(v));
+                }
+                return std::hash<ValueType::DoubleClass>{}(v);
+            }
+            case Value::Kind::Boxed: break;
+        }
+        return hashValue(*value.boxed());
+    }
+
+    ObjectPtr Value::toObject() const
+    {
+        switch (kind)
+        {
+            case Kind::Null: return Object::getNullInstance();
+            case Kind::Bool: return Object::boxBool(payload.b);
+            case Kind::Int: return IntPool::getInstance().createInt(payload.i);
+            case Kind::Double: return Object::box(payload.d);
+            case Kind::Boxed: break;
+        }
+        return object();
+    }
+
+    bool valueEquals(const Object &lhs, const Value &rhs)
+    {
+        switch (rhs.getKind())
+        {
+            case Value::Kind::Null: return lhs.isNull();
+            case Value::Kind::Bool:
+                return lhs.is<ValueType::BoolClass>()
+                       && lhs.as<ValueType::BoolClass>() == rhs.as<ValueType::BoolClass>();
+            case Value::Kind::Int:
+            case Value::Kind::Double:
+                return lhs.isNumeric() && nearlyEqual(lhs.getNumericValue(), rhs.getNumericValue());
+            case Value::Kind::Boxed: break;
+        }
+        return lhs == *rhs.boxed();
+    }
+
+    bool valueEquals(const Value &lhs, const Value &rhs)
+    {
+        if (lhs.isBoxed()) { return valueEquals(*lhs.boxed(), rhs); }
+        if (rhs.isBoxed()) { return valueEquals(*rhs.boxed(), lhs); }
+        if (lhs.isNumeric() && rhs.isNumeric()) { return nearlyEqual(lhs.getNumericValue(), rhs.getNumericValue()); }
+        return lhs.isSame(rhs);
+    }
+
+    // scalars are immutable, only a boxed value needs its own Object
+    void ValueKey::deepCopy(const ValueKey &vk)
+    {
+        value = (vk.value.isBoxed() ? Value(*vk.value.boxed()) : vk.value);
+    }
+    void Element::deepCopy(const Element &e) { value = (e.value.isBoxed() ? Value(*e.value.boxed()) : e.value); }
+
+    Value ValueMap::ownKey(const Value &key)
+    {
+        // a container key is a snapshot: the script may keep mutating the one it passed
+        if (key.is<List>() || key.is<Map>()) { return Value(*key.boxed()); }
+        return key;
+    }
+
+    // ===== ValueList =====
+
+    ValueList::Kind ValueList::kindOf(const Value &value)
+    {
+        switch (value.getKind())
+        {
+            case Value::Kind::Int: return Kind::Int;
+            case Value::Kind::Double: return Kind::Double;
+            case Value::Kind::Bool: return Kind::Bool;
+            default: return Kind::Boxed;
+        }
+    }
+
+    void ValueList::box()
+    {
+        Elements elements;
+        elements.reserve(size());
+        for (size_t i = 0; i < size(); ++i) { elements.emplace_back(get(i)); }
+        storage = std::move(elements);
+    }
+
+    ValueList::ValueList(std::initializer_list<Value> values) : ValueList(std::vector<Value>(values)) {}
+
+    ValueList::ValueList(const std::vector<Value> &values)
+    {
+        if (values.empty()) return;
+        Kind kind = kindOf(values[0]);
+        for (const Value &value : values)
+        {
+            if (kindOf(value) != kind)
+            {
+                kind = Kind::Boxed;
+                break;
+            }
+        }
+        auto unboxed = [&values]<class T>(std::vector<T> &packed) {
+            packed.reserve(values.size());
+            for (const Value &value : values) { packed.push_back(value.as<T>()); }
+        };
+        switch (kind)
+        {
+            case Kind::Int: unboxed(storage.emplace<Ints>()); break;
+            case Kind::Double: unboxed(storage.emplace<Doubles>()); break;
+            case Kind::Bool: unboxed(storage.emplace<Bools>()); break;
+            default: storage.emplace<Elements>(values.begin(), values.end()); break;
+        }
+    }
+
+    Value ValueList::get(size_t index) const
+    {
+        switch (kind())
+        {
+            case Kind::Int: return Value::Int(std::get<Ints>(storage)[index]);
+            case Kind::Double: return Value::Double(std::get<Doubles>(storage)[index]);
+            case Kind::Bool: return Value::Bool(std::get<Bools>(storage)[index]);
+            case Kind::Boxed: return std::get<Elements>(storage)[index].value;
+            case Kind::Empty: break;
+        }
+        throw RuntimeError(FString(std::format("List index {} out of range", index)));
+    }
+
+    void ValueList::set(size_t index, const Value &value)
+    {
+        if (kind() != Kind::Boxed && kindOf(value) != kind()) { box(); }
+        switch (kind())
+        {
+            case Kind::Int: std::get<Ints>(storage)[index] = value.as<ValueType::IntClass>(); break;
+            case Kind::Double: std::get<Doubles>(storage)[index] = value.as<ValueType::DoubleClass>(); break;
+            case Kind::Bool: std::get<Bools>(storage)[index] = value.as<ValueType::BoolClass>(); break;
+            case Kind::Boxed: std::get<Elements>(storage)[index] = value; break;
+            case Kind::Empty: break;
+        }
+    }
+
+    void ValueList::push_back(const Value &value)
+    {
+        Kind valueKind = kindOf(value);
+        if (kind() == Kind::Empty)
+        {
+            switch (valueKind)
+            {
+                case Kind::Int: storage.emplace<Ints>(); break;
+                case Kind::Double: storage.emplace<Doubles>(); break;
+                case Kind::Bool: storage.emplace<Bools>(); break;
+                default: storage.emplace<Elements>(); break;
+            }
+        }
+        else if (kind() != Kind::Boxed && valueKind != kind()) { box(); }
+
+        switch (kind())
+        {
+            case Kind::Int: std::get<Ints>(storage).push_back(value.as<ValueType::IntClass>()); break;
+            case Kind::Double: std::get<Doubles>(storage).push_back(value.as<ValueType::DoubleClass>()); break;
+            case Kind::Bool: std::get<Bools>(storage).push_back(value.as<ValueType::BoolClass>()); break;
+            case Kind::Boxed: std::get<Elements>(storage).emplace_back(value); break;
+            case Kind::Empty: break;
+        }
+    }
+
+    bool ValueList::operator==(const ValueList &other) const
+    {
+        size_t n = size();
+        if (n != other.size()) return false;
+        if (kind() == other.kind())
+        {
+            switch (kind())
+            {
+                case Kind::Empty: return true;
+                case Kind::Int: return *ints() == *other.ints();
+                case Kind::Bool: return *bools() == *other.bools();
+                case Kind::Double: {
+                    const auto &l = *doubles(), &r = *other.doubles();
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        if (!nearlyEqual(l[i], r[i])) return false;
+                    }
+                    return true;
+                }
+                case Kind::Boxed: break;
+            }
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (!valueEquals(get(i), other.get(i))) return false;
+        }
+        return true;
+    }
+
+    namespace
     {
+        // Int while both sides of every step are Int, Double from the first Double on (like +)
+        struct NumericAccumulator
         {
-            ObjectPtr value = key.value;
-            const TypeInfo &type = value->getTypeInfo();
+            uint64_t intSum = 0;
+            ValueType::DoubleClass doubleSum = 0;
+            bool isInt = true;
 
-            if (type == ValueType::Int) { return std::hash<ValueType::IntClass>{}(value->as<ValueType::IntClass>()); }
-            if (type == ValueType::Double)
+            void addInt(ValueType::IntClass v)
             {
-                return std::hash<ValueType::DoubleClass>{}(value->as<ValueType::DoubleClass>());
+                if (isInt)
+                    intSum += static_cast<uint64_t>(v);
+                else
+                    doubleSum += static_cast<ValueType::DoubleClass>(v);
             }
-            if (type == ValueType::String)
+            void addDouble(ValueType::DoubleClass v)
             {
-                return std::hash<ValueType::StringClass>{}(value->as<ValueType::StringClass>());
+                if (isInt)
+                {
+                    doubleSum = static_cast<ValueType::DoubleClass>(static_cast<ValueType::IntClass>(intSum));
+                    isInt = false;
+                }
+                doubleSum += v;
             }
-            if (type == ValueType::Bool)
+            Value result() const
             {
-                return std::hash<ValueType::BoolClass>{}(value->as<ValueType::BoolClass>());
+                if (isInt) return Value::Int(static_cast<ValueType::IntClass>(intSum));
+                return Value::Double(doubleSum);
             }
-            if (type == ValueType::StructType)
+        };
+
+        // Object < / > without boxing numbers
+        bool lessThan(const Value &l, const Value &r)
+        {
+            if (l.isNumeric() && r.isNumeric()) return l.getNumericValue() < r.getNumericValue();
+            return *l.toObject() < *r.toObject();
+        }
+        bool greaterThan(const Value &l, const Value &r)
+        {
+            if (l.isNumeric() && r.isNumeric()) return l.getNumericValue() > r.getNumericValue();
+            return *l.toObject() > *r.toObject();
+        }
+
+        void expectNumeric(const char *method, const Value &value)
+        {
+            if (!value.isNumeric())
+                throw RuntimeError(FString(std::format(
+                    "`{}` expects numeric elements, {} got", method, prettyType(value).toBasicString())));
+        }
+    }; // namespace
+
+    Value ValueList::sum() const
+    {
+        if (const auto *v = ints()) return Value::Int(ListKernels::sum(v->data(), v->size()));
+        if (const auto *v = doubles()) return Value::Double(ListKernels::sum(v->data(), v->size()));
+
+        NumericAccumulator acc;
+        for (size_t i = 0; i < size(); ++i)
+        {
+            Value value = get(i);
+            expectNumeric("sum", value);
+            if (value.is<ValueType::IntClass>())
+                acc.addInt(value.as<ValueType::IntClass>());
+            else
+                acc.addDouble(value.as<ValueType::DoubleClass>());
+        }
+        return acc.result();
+    }
+
+    Value ValueList::min() const
+    {
+        if (empty()) return Value();
+        if (const auto *v = ints()) return Value::Int(ListKernels::min(v->data(), v->size()));
+        if (const auto *v = doubles()) return Value::Double(ListKernels::min(v->data(), v->size()));
+
+        Value best = get(0);
+        for (size_t i = 1; i < size(); ++i)
+        {
+            Value value = get(i);
+            if (lessThan(value, best)) best = value;
+        }
+        return best;
+    }
+
+    Value ValueList::max() const
+    {
+        if (empty()) return Value();
+        if (const auto *v = ints()) return Value::Int(ListKernels::max(v->data(), v->size()));
+        if (const auto *v = doubles()) return Value::Double(ListKernels::max(v->data(), v->size()));
+
+        Value best = get(0);
+        for (size_t i = 1; i < size(); ++i)
+        {
+            Value value = get(i);
+            if (greaterThan(value, best)) best = value;
+        }
+        return best;
+    }
+
+    Value ValueList::dot(const ValueList &other) const
+    {
+        if (size() != other.size())
+            throw RuntimeError(
+                FString(std::format("`dot` expects Lists of the same length, {} and {} got", size(), other.size())));
+        if (ints() && other.ints())
+            return Value::Int(ListKernels::dot(ints()->data(), other.ints()->data(), size()));
+        if (doubles() && other.doubles())
+            return Value::Double(ListKernels::dot(doubles()->data(), other.doubles()->data(), size()));
+
+        NumericAccumulator acc;
+        for (size_t i = 0; i < size(); ++i)
+        {
+            Value l = get(i), r = other.get(i);
+            expectNumeric("dot", l);
+            expectNumeric("dot", r);
+            if (l.is<ValueType::IntClass>() && r.is<ValueType::IntClass>())
+                acc.addInt(static_cast<ValueType::IntClass>(static_cast<uint64_t>(l.as<ValueType::IntClass>())
+                                                            * static_cast<uint64_t>(r.as<ValueType::IntClass>())));
+            else
+                acc.addDouble(l.getNumericValue() * r.getNumericValue());
+        }
+        return acc.result();
+    }
+
+    ValueType::IntClass ValueList::indexOf(const Value &value) const
+    {
+        size_t n = size();
+        size_t found = n;
+        if (const auto *v = ints())
+        {
+            if (value.is<ValueType::IntClass>())
+                found = ListKernels::indexOf(v->data(), n, value.as<ValueType::IntClass>());
+            else if (value.is<ValueType::DoubleClass>())
             {
-                auto HashFields = [](std::vector<Field> fields) {
-                    size_t r = 0;
-                    for (auto &f : fields) { r += std::hash<Field>{}(f); }
-                    return r;
-                };
-                const StructType &st = value->as<StructType>();
-                return std::hash<TypeInfo>{}(st.type) + HashFields(st.fields);
+                ValueType::DoubleClass d = value.as<ValueType::DoubleClass>();
+                auto it = std::find_if(v->begin(), v->end(), [d](ValueType::IntClass i) {
+                    return nearlyEqual(static_cast<ValueType::DoubleClass>(i), d);
+                });
+                found = it - v->begin();
             }
-            if (type == ValueType::StructInstance)
+        }
+        else if (const auto *v = doubles())
+        {
+            if (value.isNumeric())
             {
-                const StructInstance &si = value->as<StructInstance>();
-                return std::hash<TypeInfo>{}(si.parentType)
-                       + std::hash<uint64_t>{}(reinterpret_cast<uint64_t>(std::addressof(*si.localContext)));
+                ValueType::DoubleClass d = value.getNumericValue();
+                auto it = std::find_if(v->begin(), v->end(), [d](ValueType::DoubleClass e) { return nearlyEqual(e, d); });
+                found = it - v->begin();
             }
-            assert(false);
-            throw ""; // ignore warning
         }
+        else if (const auto *v = bools())
+        {
+            if (value.is<ValueType::BoolClass>())
+                found = std::find(v->begin(), v->end(), value.as<ValueType::BoolClass>()) - v->begin();
+        }
+        else if (const auto *v = boxed())
+        {
+            auto it = std::find_if(v->begin(), v->end(), [&value](const Element &e) { return valueEquals(e.value, value); });
+            found = it - v->begin();
+        }
+        return (found == n ? -1 : static_cast<ValueType::IntClass>(found));
     }
 
-    TypeInfo actualType(std::shared_ptr<const Object> obj)
+    TypeInfo actualType(const Value &obj)
     {
-        auto t = obj->getTypeInfo();
+        auto t = obj.getTypeInfo();
         
         // dispatch builtin struct types (like Int{}, List{} e.g...)
         if (t == ValueType::StructType)
         {
-            return obj->as<StructType>().type;
+            return obj.as<StructType>().type;
         }
 
         if (t == ValueType::InterfaceType)
         {
-            return obj->as<InterfaceType>().type;
+            return obj.as<InterfaceType>().type;
         }
 
-        if (t == ValueType::StructInstance) return obj->as<StructInstance>().parentType;
+        if (t == ValueType::StructInstance) return obj.as<StructInstance>().parentType;
         return t;
     }
-    FString prettyType(std::shared_ptr<const Object> obj)
+    FString prettyType(const Value &obj)
     {
         return actualType(obj).toString();
     }
@@ -112,28 +484,71 @@ namespace Fig
     const TypeInfo ValueType::Module(FString(u8"Module"), true);                 // id: 12
     const TypeInfo ValueType::InterfaceType(FString(u8"InterfaceType"), true);   // id: 13
 
+    const Object::MemberMethodTable &Object::getMemberMethodTable()
+    {
+        static const MemberMethodTable table = []() {
+            // same order as Object::VariantType
+            static const TypeInfo *variantTypes[] = {&ValueType::Null,
+                                                     &ValueType::Int,
+                                                     &ValueType::Double,
+                                                     &ValueType::String,
+                                                     &ValueType::Bool,
+                                                     &ValueType::Function,
+                                                     &ValueType::StructType,
+                                                     &ValueType::StructInstance,
+                                                     &ValueType::List,
+                                                     &ValueType::Map,
+                                                     &ValueType::Module,
+                                                     &ValueType::InterfaceType};
+            static_assert(std::size(variantTypes) == std::variant_size_v<VariantType>);
+
+            MemberMethodTable t;
+            const auto &fns = getMemberTypeFunctions();
+            const auto &paras = getMemberTypeFunctionsParas();
+            for (const auto &[type, methods] : fns)
+            {
+                for (const auto &[name, fn] : methods)
+                {
+                    if (!t.ids.contains(name)) { t.ids[name] = static_cast<int>(t.ids.size()); }
+                }
+            }
+            t.methods.assign(std::size(variantTypes), std::vector<BuiltinMemberMethod>(t.ids.size()));
+            for (size_t i = 0; i < std::size(variantTypes); ++i)
+            {
+                auto it = fns.find(*variantTypes[i]);
+                if (it == fns.end()) continue;
+                for (const auto &[name, fn] : it->second)
+                {
+                    t.methods[i][t.ids.at(name)] = BuiltinMemberMethod{&fn, paras.at(*variantTypes[i]).at(name)};
+                }
+            }
+            return t;
+        }();
+        return table;
+    }
+
     bool implements(const TypeInfo &structType, const TypeInfo &interfaceType, ContextPtr ctx)
     {
         return ctx->hasImplRegisted(structType, interfaceType);
     }
 
-    bool isTypeMatch(const TypeInfo &expected, ObjectPtr obj, ContextPtr ctx)
+    bool isTypeMatch(const TypeInfo &expected, const Value &obj, const ContextPtr &ctx)
     {
         if (expected == ValueType::Any) return true;
 
-        TypeInfo actual = obj->getTypeInfo();
+        const TypeInfo &actual = obj.getTypeInfo();
 
-        if (obj->is<StructType>())
+        if (obj.is<StructType>())
         {
-            const StructType &t = obj->as<StructType>();
+            const StructType &t = obj.as<StructType>();
             if (expected == t.type) // the StructType typeinfo
             {
                 return true;
             }
         }
-        else if (obj->is<StructInstance>())
+        else if (obj.is<StructInstance>())
         {
-            const StructInstance &si = obj->as<StructInstance>();
+            const StructInstance &si = obj.as<StructInstance>();
             if (si.parentType == expected) { return true; }
             if (implements(si.parentType, expected, ctx)) { return true; }
         }
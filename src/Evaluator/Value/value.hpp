@@ -1,11 +1,15 @@
 #pragma once
+#include <Core/BlockAllocator.hpp>
 #include <Core/fig_string.hpp>
 #include <Evaluator/Value/function.hpp>
+#include <Evaluator/Value/InlineValue.hpp>
 #include <Evaluator/Value/interface.hpp>
 #include <Evaluator/Value/structType.hpp>
 #include <Evaluator/Value/structInstance.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/valueError.hpp>
+#include <Evaluator/Value/ValueList.hpp>
+#include <Evaluator/Value/ValueMap.hpp>
 #include <Evaluator/Value/module.hpp>
 #include <Evaluator/Value/value_forward.hpp>
 
@@ -42,43 +46,33 @@ namespace Fig
         return std::abs(l - r) < epsilon;
     }
 
-    TypeInfo actualType(std::shared_ptr<const Object> obj);
-    FString prettyType(std::shared_ptr<const Object> obj);
+    TypeInfo actualType(const Value &value);
+    FString prettyType(const Value &value);
 
     bool operator==(const Object &, const Object &);
 
-    struct Element
-    {
-        ObjectPtr value;
-        Element(ObjectPtr _value) : value(_value) {}
-
-        bool operator==(const Element &other) const { return *value == *other.value; }
+    using List = ValueList;
 
-        void deepCopy(const Element &e) { value = std::make_shared<Object>(*e.value); }
-    };
-    using List = std::vector<Element>;
+    using Map = ValueMap;
 
-    struct ValueKey
-    {
-        ObjectPtr value;
-        ValueKey(ObjectPtr _value) : value(_value) {}
+    bool isTypeMatch(const TypeInfo &, const Value &, const ContextPtr &);
+    bool implements(const TypeInfo &, const TypeInfo &, ContextPtr);
 
-        void deepCopy(const ValueKey &vk) { value = std::make_shared<Object>(*vk.value); }
-    };
+    using BuiltinTypeMemberFn = std::function<Value(const Value &, const std::vector<Value> &)>;
 
-    struct ValueKeyHash
+    struct BuiltinMemberMethod
     {
-        size_t operator()(const ValueKey &key) const;
+        const BuiltinTypeMemberFn *fn = nullptr; // nullptr: type has no such method
+        int paraCount = -1;
     };
-    using Map = std::unordered_map<ValueKey, ObjectPtr, ValueKeyHash>;
-
-    bool isTypeMatch(const TypeInfo &, ObjectPtr, ContextPtr);
-    bool implements(const TypeInfo &, const TypeInfo &, ContextPtr);
 
-    using BuiltinTypeMemberFn = std::function<ObjectPtr(ObjectPtr, std::vector<ObjectPtr>)>;
-
-    class Object : public std::enable_shared_from_this<Object>
+    class Object
     {
+        // Values holding this Object share `pin`, kept while valueRefs > 0 (see Value)
+        friend class Value;
+        uint32_t valueRefs = 0;
+        ObjectPtr pin;
+
     public:
         using VariantType = std::variant<ValueType::NullClass,
                                          ValueType::IntClass,
@@ -93,7 +87,7 @@ namespace Fig
                                          Module,
                                          InterfaceType>;
 
-        static std::unordered_map<TypeInfo, std::unordered_map<FString, BuiltinTypeMemberFn>, TypeInfoHash>
+        static const std::unordered_map<TypeInfo, std::unordered_map<FString, BuiltinTypeMemberFn>, TypeInfoHash> &
         getMemberTypeFunctions()
         {
             static const std::unordered_map<TypeInfo, std::unordered_map<FString, BuiltinTypeMemberFn>, TypeInfoHash>
@@ -104,50 +98,50 @@ namespace Fig
                     {ValueType::String,
                      {
                          {u8"length",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 0)
                                   throw RuntimeError(
                                       FString(std::format("`length` expects 0 arguments, {} got", args.size())));
-                              const FString &str = object->as<ValueType::StringClass>();
-                              return std::make_shared<Object>(static_cast<ValueType::IntClass>(str.length()));
+                              const ValueType::StringClass &str = object.as<ValueType::StringClass>();
+                              return Value::Int(static_cast<ValueType::IntClass>(str.length()));
                           }},
                          {u8"replace",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 2)
                                   throw RuntimeError(
                                       FString(std::format("`replace` expects 2 arguments, {} got", args.size())));
-                              FString &str = object->as<ValueType::StringClass>();
-                              ObjectPtr arg1 = args[0];
-                              ObjectPtr arg2 = args[1];
-                              if (!arg1->is<ValueType::IntClass>())
+                              ValueType::StringClass &str = object.as<ValueType::StringClass>();
+                              const Value &arg1 = args[0];
+                              const Value &arg2 = args[1];
+                              if (!arg1.is<ValueType::IntClass>())
                               {
                                   throw RuntimeError(FString("`replace` arg 1 expects type Int"));
                               }
-                              if (!arg2->is<ValueType::StringClass>())
+                              if (!arg2.is<ValueType::StringClass>())
                               {
                                   throw RuntimeError(FString("`replace` arg 2 expects type String"));
                               }
-                              str.realReplace(arg1->as<ValueType::IntClass>(), arg2->as<ValueType::StringClass>());
-                              return Object::getNullInstance();
+                              str.replace(arg1.as<ValueType::IntClass>(), 1, arg2.as<ValueType::StringClass>());
+                              return Value();
                           }},
                          {u8"erase",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 2)
                                   throw RuntimeError(
                                       FString(std::format("`erase` expects 2 arguments, {} got", args.size())));
-                              FString &str = object->as<ValueType::StringClass>();
-                              ObjectPtr arg1 = args[0];
-                              ObjectPtr arg2 = args[1];
-                              if (!arg1->is<ValueType::IntClass>())
+                              ValueType::StringClass &str = object.as<ValueType::StringClass>();
+                              const Value &arg1 = args[0];
+                              const Value &arg2 = args[1];
+                              if (!arg1.is<ValueType::IntClass>())
                               {
                                   throw RuntimeError(FString("`erase` arg 1 expects type Int"));
                               }
-                              if (!arg2->is<ValueType::IntClass>())
+                              if (!arg2.is<ValueType::IntClass>())
                               {
                                   throw RuntimeError(FString("`erase` arg 2 expects type Int"));
                               }
-                              ValueType::IntClass index = arg1->as<ValueType::IntClass>();
-                              ValueType::IntClass n = arg2->as<ValueType::IntClass>();
+                              ValueType::IntClass index = arg1.as<ValueType::IntClass>();
+                              ValueType::IntClass n = arg2.as<ValueType::IntClass>();
                               if (index < 0 || n < 0)
                               {
                                   throw RuntimeError(FString("`erase`: index and n must greater or equal to 0"));
@@ -156,27 +150,27 @@ namespace Fig
                               {
                                   throw RuntimeError(FString("`erase`: length is not long enough to erase"));
                               }
-                              str.realErase(arg1->as<ValueType::IntClass>(), arg2->as<ValueType::IntClass>());
-                              return Object::getNullInstance();
+                              str.erase(index, n);
+                              return Value();
                           }},
                          {u8"insert",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 2)
                                   throw RuntimeError(
                                       FString(std::format("`insert` expects 2 arguments, {} got", args.size())));
-                              FString &str = object->as<ValueType::StringClass>();
-                              ObjectPtr arg1 = args[0];
-                              ObjectPtr arg2 = args[1];
-                              if (!arg1->is<ValueType::IntClass>())
+                              ValueType::StringClass &str = object.as<ValueType::StringClass>();
+                              const Value &arg1 = args[0];
+                              const Value &arg2 = args[1];
+                              if (!arg1.is<ValueType::IntClass>())
                               {
                                   throw RuntimeError(FString("`insert` arg 1 expects type Int"));
                               }
-                              if (!arg2->is<ValueType::StringClass>())
+                              if (!arg2.is<ValueType::StringClass>())
                               {
                                   throw RuntimeError(FString("`insert` arg 2 expects type String"));
                               }
-                              str.realInsert(arg1->as<ValueType::IntClass>(), arg2->as<ValueType::StringClass>());
-                              return Object::getNullInstance();
+                              str.insert(arg1.as<ValueType::IntClass>(), arg2.as<ValueType::StringClass>());
+                              return Value();
                           }},
                      }},
                     {ValueType::Function, {}},
@@ -185,59 +179,99 @@ namespace Fig
                     {ValueType::List,
                      {
                          {u8"length",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 0)
                                   throw RuntimeError(
                                       FString(std::format("`length` expects 0 arguments, {} got", args.size())));
-                              const List &list = object->as<List>();
-                              return std::make_shared<Object>(static_cast<ValueType::IntClass>(list.size()));
+                              const List &list = object.as<List>();
+                              return Value::Int(static_cast<ValueType::IntClass>(list.size()));
                           }},
                          {u8"get",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 1)
                                   throw RuntimeError(
                                       FString(std::format("`get` expects 1 arguments, {} got", args.size())));
-                              ObjectPtr arg = args[0];
-                              if (arg->getTypeInfo() != ValueType::Int)
+                              const Value &arg = args[0];
+                              if (arg.getTypeInfo() != ValueType::Int)
                                   throw RuntimeError(
                                       FString(std::format("`get` argument 1 expects Int, {} got",
-                                                          arg->getTypeInfo().toString().toBasicString())));
-                              ValueType::IntClass i = arg->as<ValueType::IntClass>();
-                              const List &list = object->as<List>();
-                              if (i >= list.size()) return Object::getNullInstance();
-                              return list[i].value;
+                                                          arg.getTypeInfo().toString().toBasicString())));
+                              ValueType::IntClass i = arg.as<ValueType::IntClass>();
+                              const List &list = object.as<List>();
+                              if (i >= list.size()) return Value();
+                              return list.get(i);
                           }},
                          {u8"push",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 1)
                                   throw RuntimeError(
                                       FString(std::format("`push` expects 1 arguments, {} got", args.size())));
-                              ObjectPtr arg = args[0];
-                              List &list = object->as<List>();
+                              const Value &arg = args[0];
+                              List &list = object.as<List>();
                               list.push_back(arg);
-                              return Object::getNullInstance();
+                              return Value();
+                          }},
+                         {u8"sum",
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
+                              if (args.size() != 0)
+                                  throw RuntimeError(
+                                      FString(std::format("`sum` expects 0 arguments, {} got", args.size())));
+                              return object.as<List>().sum();
+                          }},
+                         {u8"min",
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
+                              if (args.size() != 0)
+                                  throw RuntimeError(
+                                      FString(std::format("`min` expects 0 arguments, {} got", args.size())));
+                              return object.as<List>().min();
+                          }},
+                         {u8"max",
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
+                              if (args.size() != 0)
+                                  throw RuntimeError(
+                                      FString(std::format("`max` expects 0 arguments, {} got", args.size())));
+                              return object.as<List>().max();
+                          }},
+                         {u8"dot",
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
+                              if (args.size() != 1)
+                                  throw RuntimeError(
+                                      FString(std::format("`dot` expects 1 arguments, {} got", args.size())));
+                              const Value &arg = args[0];
+                              if (!arg.is<List>())
+                                  throw RuntimeError(
+                                      FString(std::format("`dot` argument 1 expects List, {} got",
+                                                          arg.getTypeInfo().toString().toBasicString())));
+                              return object.as<List>().dot(arg.as<List>());
+                          }},
+                         {u8"indexOf",
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
+                              if (args.size() != 1)
+                                  throw RuntimeError(
+                                      FString(std::format("`indexOf` expects 1 arguments, {} got", args.size())));
+                              return Value::Int(object.as<List>().indexOf(args[0]));
                           }},
                      }},
                     {ValueType::Map,
                      {
                          {u8"get",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 1)
                                   throw RuntimeError(
                                       FString(std::format("`get` expects 1 arguments, {} got", args.size())));
-                              ObjectPtr index = args[0];
-                              const Map &map = object->as<Map>();
-                              if (!map.contains(index)) return Object::getNullInstance();
-                              return map.at(index);
+                              const Value &index = args[0];
+                              const Map &map = object.as<Map>();
+                              const Value *value = map.find(index);
+                              return (value ? *value : Value());
                           }},
                          {u8"contains",
-                          [](ObjectPtr object, std::vector<ObjectPtr> args) -> ObjectPtr {
+                          [](const Value &object, const std::vector<Value> &args) -> Value {
                               if (args.size() != 1)
                                   throw RuntimeError(
                                       FString(std::format("`contains` expects 1 arguments, {} got", args.size())));
-                              ObjectPtr index = args[0];
-                              const Map &map = object->as<Map>();
-                              return std::make_shared<Object>(map.contains(index));
+                              const Value &index = args[0];
+                              const Map &map = object.as<Map>();
+                              return Value::Bool(map.contains(index));
                           }},
                      }},
                     {ValueType::Module, {}},
@@ -246,7 +280,7 @@ namespace Fig
             return memberTypeFunctions;
         }
 
-        static std::unordered_map<TypeInfo, std::unordered_map<FString, int>, TypeInfoHash>
+        static const std::unordered_map<TypeInfo, std::unordered_map<FString, int>, TypeInfoHash> &
         getMemberTypeFunctionsParas()
         {
             static const std::unordered_map<TypeInfo, std::unordered_map<FString, int>, TypeInfoHash>
@@ -264,7 +298,17 @@ namespace Fig
                     {ValueType::Function, {}},
                     {ValueType::StructType, {}},
                     {ValueType::StructInstance, {}},
-                    {ValueType::List, {{u8"length", 0}, {u8"get", 1}, {u8"push", 1}}},
+                    {ValueType::List,
+                     {
+                         {u8"length", 0},
+                         {u8"get", 1},
+                         {u8"push", 1},
+                         {u8"sum", 0},
+                         {u8"min", 0},
+                         {u8"max", 0},
+                         {u8"dot", 1},
+                         {u8"indexOf", 1},
+                     }},
                     {ValueType::Map,
                      {
                          {u8"get", 1},
@@ -276,17 +320,47 @@ namespace Fig
             return memberTypeFunctionsParas;
         }
 
-        bool hasMemberFunction(const FString &name) const
+        /*
+            dispatch table built from the two maps above
+            methods[type index][method id], type index is the index of `data` (VariantType alternative)
+        */
+        struct MemberMethodTable
+        {
+            std::unordered_map<FString, int> ids; // interned method name -> method id
+            std::vector<std::vector<BuiltinMemberMethod>> methods;
+        };
+        static const MemberMethodTable &getMemberMethodTable();
+
+        // -1: no builtin type has a method named so
+        static int getMemberMethodId(const FString &name)
+        {
+            const auto &ids = getMemberMethodTable().ids;
+            auto it = ids.find(name);
+            return (it == ids.end() ? -1 : it->second);
+        }
+
+        // nullptr if the type at `typeIndex` of VariantType has no such method
+        static const BuiltinMemberMethod *findMemberMethod(size_t typeIndex, int methodId)
         {
-            return getMemberTypeFunctions().at(getTypeInfo()).contains(name);
+            if (methodId < 0) return nullptr;
+            const BuiltinMemberMethod &method = getMemberMethodTable().methods[typeIndex][methodId];
+            return (method.fn ? &method : nullptr);
         }
-        BuiltinTypeMemberFn getMemberFunction(const FString &name) const
+
+        // nullptr if this type has no such method
+        const BuiltinMemberMethod *findMemberMethod(int methodId) const
         {
-            return getMemberTypeFunctions().at(getTypeInfo()).at(name);
+            return findMemberMethod(data.index(), methodId);
+        }
+
+        bool hasMemberFunction(const FString &name) const { return findMemberMethod(getMemberMethodId(name)); }
+        const BuiltinTypeMemberFn &getMemberFunction(const FString &name) const
+        {
+            return *findMemberMethod(getMemberMethodId(name))->fn;
         }
         int getMemberFunctionParaCount(const FString &name) const
         {
-            return getMemberTypeFunctionsParas().at(getTypeInfo()).at(name);
+            return findMemberMethod(getMemberMethodId(name))->paraCount;
         }
 
         VariantType data;
@@ -296,19 +370,34 @@ namespace Fig
         Object(const ValueType::IntClass &i) : data(i) {}
         explicit Object(const ValueType::DoubleClass &d) : data(d) {}
         Object(const ValueType::StringClass &s) : data(s) {}
+        Object(ValueType::StringClass &&s) : data(std::move(s)) {}
+        Object(const FString &s) : data(ValueType::toStringClass(s)) {}
         Object(const ValueType::BoolClass &b) : data(b) {}
         Object(const Function &f) : data(f) {}
         Object(const StructType &s) : data(s) {}
         Object(const StructInstance &s) : data(s) {}
         Object(const List &l) : data(l) {}
+        Object(List &&l) : data(std::move(l)) {}
         Object(const Map &m) : data(m) {}
+        Object(Map &&m) : data(std::move(m)) {}
         Object(const Module &m) : data(m) {}
         Object(const InterfaceType &i) : data(i) {}
 
-        Object(const Object &) = default;
-        Object(Object &&) noexcept = default;
-        Object &operator=(const Object &) = default;
-        Object &operator=(Object &&) noexcept = default;
+        // copies the value only: the Values holding `other` don't hold the copy
+        Object(const Object &other) : data(other.data) {}
+        Object(Object &&other) noexcept : data(std::move(other.data)) {}
+        Object &operator=(const Object &other)
+        {
+            data = other.data;
+            return *this;
+        }
+        Object &operator=(Object &&other) noexcept
+        {
+            data = std::move(other.data);
+            return *this;
+        }
+
+        uint32_t valueRefCount() const { return valueRefs; }
 
         static Object defaultValue(TypeInfo ti)
         {
@@ -317,7 +406,7 @@ namespace Fig
             else if (ti == ValueType::Double)
                 return Object(ValueType::DoubleClass(0.0));
             else if (ti == ValueType::String)
-                return Object(ValueType::StringClass(u8""));
+                return Object(ValueType::StringClass());
             else if (ti == ValueType::Bool)
                 return Object(ValueType::BoolClass(false));
             else if (ti == ValueType::List)
@@ -346,6 +435,16 @@ namespace Fig
             return std::get<T>(data);
         }
 
+        // boxed values come from a free list: Object and control block in one recycled block
+        static constexpr size_t MAX_FREE_BOXES = 4096;
+
+        template <typename... Args>
+        static ObjectPtr box(Args &&...args)
+        {
+            return std::allocate_shared<Object>(BlockAllocator<Object, MAX_FREE_BOXES>{}, std::forward<Args>(args)...);
+        }
+        static ObjectPtr boxBool(bool b) { return (b ? getTrueInstance() : getFalseInstance()); }
+
         static std::shared_ptr<Object> getNullInstance()
         {
             static std::shared_ptr<Object> n = std::make_shared<Object>(ValueType::NullClass{});
@@ -362,10 +461,13 @@ namespace Fig
             return f;
         }
 
-        TypeInfo getTypeInfo() const
+        TypeInfo getTypeInfo() const { return getTypeInfoRef(); }
+
+        // the static ValueType::X of the held value, no copy
+        const TypeInfo &getTypeInfoRef() const
         {
             return std::visit(
-                [](auto &&val) -> TypeInfo {
+                [](auto &&val) -> const TypeInfo & {
                     using T = std::decay_t<decltype(val)>;
 
                     if constexpr (std::is_same_v<T, ValueType::NullClass>)
@@ -425,7 +527,7 @@ namespace Fig
 
         FString toStringIO() const
         {
-            if (is<ValueType::StringClass>()) return as<ValueType::StringClass>();
+            if (is<ValueType::StringClass>()) return ValueType::toFString(as<ValueType::StringClass>());
             return toString();
         }
 
@@ -434,7 +536,8 @@ namespace Fig
             if (is<ValueType::NullClass>()) return FString(u8"null");
             if (is<ValueType::IntClass>()) return FString(std::to_string(as<ValueType::IntClass>()));
             if (is<ValueType::DoubleClass>()) return FString(std::format("{}", as<ValueType::DoubleClass>()));
-            if (is<ValueType::StringClass>()) return FString(u8"\"" + as<ValueType::StringClass>() + u8"\"");
+            if (is<ValueType::StringClass>())
+                return FString(u8"\"" + ValueType::toFString(as<ValueType::StringClass>()) + u8"\"");
             if (is<ValueType::BoolClass>()) return as<ValueType::BoolClass>() ? FString(u8"true") : FString(u8"false");
             if (is<Function>())
                 return FString(std::format("<Function '{}'({}) at {:p}>",
@@ -456,12 +559,10 @@ namespace Fig
 
                 FString output(u8"[");
                 const List &list = as<List>();
-                bool first_flag = true;
-                for (auto &ele : list)
+                for (size_t i = 0; i < list.size(); ++i)
                 {
-                    if (!first_flag) output += u8", ";
-                    output += ele.value->toString(visited);
-                    first_flag = false;
+                    if (i != 0) output += u8", ";
+                    output += valueString(list.get(i), visited);
                 }
                 output += u8"]";
                 return output;
@@ -477,7 +578,7 @@ namespace Fig
                 for (auto &[key, value] : map)
                 {
                     if (!first_flag) output += u8", ";
-                    output += key.value->toString(visited) + FString(u8" : ") + value->toString(visited);
+                    output += valueString(key.value, visited) + FString(u8" : ") + valueString(value, visited);
                     first_flag = false;
                 }
                 output += u8"}";
@@ -505,6 +606,12 @@ namespace Fig
         }
 
     private:
+        // an element of a container, only a boxed one can lead back into it
+        static FString valueString(const Value &value, std::unordered_set<const Object *> &visited)
+        {
+            return (value.isBoxed() ? value.boxed()->toString(visited) : value.toString());
+        }
+
         static std::string
         makeTypeErrorMessage(const char *prefix, const char *op, const Object &lhs, const Object &rhs)
         {
@@ -527,7 +634,7 @@ namespace Fig
                 return Object(result);
             }
             if (lhs.is<ValueType::StringClass>() && rhs.is<ValueType::StringClass>())
-                return Object(FString(lhs.as<ValueType::StringClass>() + rhs.as<ValueType::StringClass>()));
+                return Object(lhs.as<ValueType::StringClass>() + rhs.as<ValueType::StringClass>());
             throw ValueError(FString(makeTypeErrorMessage("Unsupported operation", "+", lhs, rhs)));
         }
 
@@ -558,10 +665,12 @@ namespace Fig
             }
             if (lhs.is<ValueType::StringClass>() && rhs.is<ValueType::IntClass>())
             {
-                FString result;
-                const FString &l = lhs.as<ValueType::StringClass>();
-                for (size_t i = 0; i < rhs.getNumericValue(); ++i) { result += l; }
-                return Object(result);
+                ValueType::StringClass result;
+                const ValueType::StringClass &l = lhs.as<ValueType::StringClass>();
+                ValueType::IntClass times = rhs.as<ValueType::IntClass>();
+                if (times > 0) result.reserve(l.length() * times);
+                for (ValueType::IntClass i = 0; i < times; ++i) { result += l; }
+                return Object(std::move(result));
             }
             throw ValueError(FString(makeTypeErrorMessage("Unsupported operation", "*", lhs, rhs)));
         }
@@ -593,19 +702,19 @@ namespace Fig
             if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>())
             {
                 ValueType::IntClass lv = lhs.as<ValueType::IntClass>();
-                ValueType::IntClass rv = lhs.as<ValueType::IntClass>();
-                if (rv == 0) throw ValueError(FString(makeTypeErrorMessage("Modulo by zero", "/", lhs, rhs)));
+                ValueType::IntClass rv = rhs.as<ValueType::IntClass>();
+                if (rv == 0) throw ValueError(FString(makeTypeErrorMessage("Modulo by zero", "%", lhs, rhs)));
 
-                ValueType::IntClass q = lv / rv;
+                // floor modulo, the result has the sign of rv
                 ValueType::IntClass r = lv % rv;
-                if (r != 0 && ((lv < 0) != (rv < 0))) { q -= 1; }
-                return q;
+                if (r != 0 && ((r < 0) != (rv < 0))) { r += rv; }
+                return r;
             }
 
             if (lhs.isNumeric() && rhs.isNumeric())
             {
                 auto rnv = rhs.getNumericValue();
-                if (rnv == 0) throw ValueError(FString(makeTypeErrorMessage("Modulo by zero", "/", lhs, rhs)));
+                if (rnv == 0) throw ValueError(FString(makeTypeErrorMessage("Modulo by zero", "%", lhs, rhs)));
                 auto result = std::fmod(lhs.getNumericValue(), rnv);
                 return Object(result);
             }
@@ -738,17 +847,163 @@ namespace Fig
         }
     };
 
-    inline bool isBoolObjectTruthy(ObjectPtr obj)
+    // ===== Value, see InlineValue.hpp =====
+
+    inline void Value::retain(Object *obj)
+    {
+        ++obj->valueRefs;
+    }
+
+    inline void Value::release(Object *obj)
+    {
+        if (--obj->valueRefs == 0)
+        {
+            ObjectPtr last = std::move(obj->pin); // may be the last reference, obj goes with it
+        }
+    }
+
+    inline bool Value::unbox(const Object &obj)
+    {
+        const Object::VariantType &data = obj.data;
+        if (const auto *i = std::get_if<ValueType::IntClass>(&data)) { *this = Int(*i); }
+        else if (const auto *d = std::get_if<ValueType::DoubleClass>(&data)) { *this = Double(*d); }
+        else if (const auto *b = std::get_if<ValueType::BoolClass>(&data)) { *this = Bool(*b); }
+        else if (!std::holds_alternative<ValueType::NullClass>(data)) { return false; }
+        return true;
+    }
+
+    inline Value::Value(const ObjectPtr &obj) : payload{.i = 0}, kind(Kind::Null)
+    {
+        if (!obj || unbox(*obj)) { return; }
+        if (obj->valueRefs++ == 0) { obj->pin = obj; }
+        payload.object = obj.get();
+        kind = Kind::Boxed;
+    }
+
+    inline Value::Value(ObjectPtr &&obj) : payload{.i = 0}, kind(Kind::Null)
+    {
+        if (!obj || unbox(*obj)) { return; }
+        Object *raw = obj.get();
+        if (raw->valueRefs++ == 0) { raw->pin = std::move(obj); }
+        payload.object = raw;
+        kind = Kind::Boxed;
+    }
+
+    inline Value::Value(const Object &obj) : payload{.i = 0}, kind(Kind::Null)
+    {
+        if (!unbox(obj)) { *this = Value(Object::box(obj)); }
+    }
+
+    inline Value::Value(Object &&obj) : payload{.i = 0}, kind(Kind::Null)
+    {
+        if (!unbox(obj)) { *this = Value(Object::box(std::move(obj))); }
+    }
+
+    inline const ObjectPtr &Value::object() const
+    {
+        assert(kind == Kind::Boxed);
+        return payload.object->pin;
+    }
+
+    template <typename T>
+    bool Value::is() const
+    {
+        if constexpr (std::is_same_v<T, ValueType::NullClass>) { return kind == Kind::Null; }
+        else if constexpr (std::is_same_v<T, ValueType::BoolClass>) { return kind == Kind::Bool; }
+        else if constexpr (std::is_same_v<T, ValueType::IntClass>) { return kind == Kind::Int; }
+        else if constexpr (std::is_same_v<T, ValueType::DoubleClass>) { return kind == Kind::Double; }
+        else { return kind == Kind::Boxed && payload.object->is<T>(); }
+    }
+
+    template <typename T>
+    Value::AsResult<T> Value::as() const
+    {
+        if constexpr (std::is_same_v<T, ValueType::NullClass>)
+        {
+            assert(kind == Kind::Null);
+            static const ValueType::NullClass null{};
+            return (null);
+        }
+        else if constexpr (std::is_same_v<T, ValueType::BoolClass>)
+        {
+            assert(kind == Kind::Bool);
+            return static_cast<const ValueType::BoolClass &>(payload.b);
+        }
+        else if constexpr (std::is_same_v<T, ValueType::IntClass>)
+        {
+            assert(kind == Kind::Int);
+            return static_cast<const ValueType::IntClass &>(payload.i);
+        }
+        else if constexpr (std::is_same_v<T, ValueType::DoubleClass>)
+        {
+            assert(kind == Kind::Double);
+            return static_cast<const ValueType::DoubleClass &>(payload.d);
+        }
+        else
+        {
+            assert(kind == Kind::Boxed);
+            return static_cast<T &>(payload.object->as<T>());
+        }
+    }
+
+    inline const BuiltinMemberMethod *Value::findMemberMethod(int methodId) const
+    {
+        // Kind::Null, Bool, Int, Double in Object::VariantType
+        static constexpr size_t scalarTypeIndex[] = {0, 4, 1, 2};
+        static_assert(std::is_same_v<std::variant_alternative_t<1, Object::VariantType>, ValueType::IntClass>);
+        static_assert(std::is_same_v<std::variant_alternative_t<2, Object::VariantType>, ValueType::DoubleClass>);
+        static_assert(std::is_same_v<std::variant_alternative_t<4, Object::VariantType>, ValueType::BoolClass>);
+
+        if (kind == Kind::Boxed) return payload.object->findMemberMethod(methodId);
+        return Object::findMemberMethod(scalarTypeIndex[static_cast<size_t>(kind)], methodId);
+    }
+
+    inline const TypeInfo &Value::getTypeInfo() const
+    {
+        switch (kind)
+        {
+            case Kind::Null: return ValueType::Null;
+            case Kind::Bool: return ValueType::Bool;
+            case Kind::Int: return ValueType::Int;
+            case Kind::Double: return ValueType::Double;
+            case Kind::Boxed: break;
+        }
+        return payload.object->getTypeInfoRef();
+    }
+
+    inline ValueType::DoubleClass Value::getNumericValue() const
+    {
+        if (kind == Kind::Int) return static_cast<ValueType::DoubleClass>(payload.i);
+        if (kind == Kind::Double) return payload.d;
+        throw RuntimeError(u8"getNumericValue: Not a numeric value");
+    }
+
+    inline FString Value::toString() const
+    {
+        switch (kind)
+        {
+            case Kind::Null: return FString(u8"null");
+            case Kind::Bool: return (payload.b ? FString(u8"true") : FString(u8"false"));
+            case Kind::Int: return FString(std::to_string(payload.i));
+            case Kind::Double: return FString(std::format("{}", payload.d));
+            case Kind::Boxed: break;
+        }
+        return payload.object->toString();
+    }
+
+    inline FString Value::toStringIO() const
     {
-        assert(obj->is<bool>());
-        return obj->as<bool>();
+        return (kind == Kind::Boxed ? payload.object->toStringIO() : toString());
     }
 
-    using RvObject = ObjectPtr;
+    // Object == with a Value on either side, scalars aren't boxed (value.cpp)
+    bool valueEquals(const Value &, const Value &);
+    bool valueEquals(const Object &, const Value &);
 
-    inline bool operator==(const ValueKey &l, const ValueKey &r)
+    inline bool isBoolObjectTruthy(const Value &value)
     {
-        return *l.value == *r.value;
+        assert(value.is<bool>());
+        return value.as<bool>();
     }
 
 } // namespace Fig
@@ -5,6 +5,7 @@
 namespace Fig
 {
     class Object;
+    class Value; // InlineValue.hpp
 
     using ObjectPtr = std::shared_ptr<Object>;
 }; // namespace Fig
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <Evaluator/Core/ExprResult.hpp>
 #include <Evaluator/Value/value.hpp>
 #include <Module/builtins.hpp>
+#include <Module/ModuleRegistry.hpp>
 #include <Evaluator/Value/LvObject.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Value/structInstance.hpp>
@@ -22,7 +23,9 @@
 #include <unordered_map>
 
 #include <Utils/utils.hpp>
+#include <Ast/AstCache.hpp>
 #include <Parser/parser.hpp>
+#include <Resolver/resolver.hpp>
 
 #ifndef SourceInfo
     #define SourceInfo(ptr) (ptr->sourcePath), (ptr->sourceLines)
@@ -48,38 +51,20 @@ namespace Fig
         return sr;
     }
 
-    ContextPtr Evaluator::loadModule(const std::filesystem::path &path)
+    ContextPtr Evaluator::loadModule(const std::filesystem::path &path, const FString &modKey)
     {
-        static std::unordered_map<FString, std::pair<std::vector<FString>, std::vector<Ast::AstBase>>> mod_ast_cache{};
+        ModuleRegistry &registry = ModuleRegistry::getInstance();
+        if (ContextPtr modCtx = registry.find(modKey)) { return modCtx; } // already evaluated
 
         FString modSourcePath(path.string());
 
-        std::ifstream file(path);
-        assert(file.is_open());
+        AstCache::Unit unit = AstCache::loadOrParse(path, modSourcePath); // .figc when fresh
+        std::vector<FString> &modSourceLines = unit.sourceLines;
+        std::vector<Ast::AstBase> &asts = unit.asts;
+        registry.keepTree(std::move(unit.arena)); // nodes stay where they are, only the owner moves
 
-        std::vector<Ast::AstBase> asts;
-
-        std::vector<FString> modSourceLines;
-
-        if (mod_ast_cache.contains(modSourcePath))
-        {
-            auto &[_sl, _asts] = mod_ast_cache[modSourcePath];
-            modSourceLines = _sl;
-            asts = _asts;
-        }
-        else
-        {
-            std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-
-            modSourceLines = Utils::splitSource(FString(source));
-
-            Lexer lexer((FString(source)), modSourcePath, modSourceLines);
-            Parser parser(lexer, modSourcePath, modSourceLines);
-
-            asts = parser.parseAll();
-            mod_ast_cache[modSourcePath] = {modSourceLines, asts};
-        }
+        Resolver resolver;
+        resolver.resolve(asts);
 
         Evaluator evaluator;
         evaluator.SetSourcePath(modSourcePath);
@@ -89,7 +74,18 @@ namespace Fig
 
         evaluator.SetGlobalContext(modctx);
         evaluator.RegisterBuiltinsValue();
-        evaluator.Run(asts); // error upward pass-by, log outside, we have already keep info in evaluator error
+
+        registry.beginLoading(modKey);
+        try
+        {
+            evaluator.Run(asts); // error upward pass-by, log outside, we have already keep info in evaluator error
+        }
+        catch (...)
+        {
+            registry.abortLoading(modKey);
+            throw;
+        }
+        registry.finishLoading(modKey, evaluator.global);
 
         return evaluator.global;
     }
@@ -114,10 +110,18 @@ namespace Fig
         }
 
         auto path = resolveModulePath(pathVec);
-        ContextPtr modCtx = loadModule(path);
+        FString modKey = ModuleRegistry::key(path);
+        if (ModuleRegistry::getInstance().isLoading(modKey))
+        {
+            throw EvaluatorError(u8"CircularImportError",
+                                 std::format("Circular import: {}",
+                                             ModuleRegistry::getInstance().importChain(modKey).toBasicString()),
+                                 i);
+        }
+        ContextPtr modCtx = loadModule(path, modKey);
 
         // 冲突问题等impl存储改成 2xMap之后解决吧（咕咕咕
-        ctx->getImplRegistry().insert(modCtx->getImplRegistry().begin(), modCtx->getImplRegistry().end()); // load impl
+        ctx->importImpls(*modCtx); // load impl
 
         for (auto &[type, opRecord] : modCtx->getOpRegistry())
         {
@@ -131,14 +135,14 @@ namespace Fig
                                 type.toString().toBasicString()),
                     i);
             }
-            ctx->getOpRegistry()[type] = opRecord;
+            ctx->setOpRecord(type, opRecord);
         }
         if (!i->names.empty())
         {
             for (const FString &symName : i->names)
             {
                 LvObject tmp(modCtx->get(symName), modCtx);
-                const ObjectPtr &value = tmp.get();
+                Value value = tmp.get();
 
                 ctx->def(symName, tmp.declaredType(), AccessModifier::Const, value);
             }
@@ -146,7 +150,7 @@ namespace Fig
         }
         if (!i->rename.empty()) { modName = i->rename; }
         ctx->def(
-            modName, ValueType::Module, AccessModifier::PublicConst, std::make_shared<Object>(Module(modName, modCtx)));
+            modName, ValueType::Module, AccessModifier::PublicConst, Value(Object(Module(modName, modCtx))));
 
         return StatementResult::normal();
     }
@@ -154,11 +158,17 @@ namespace Fig
     StatementResult Evaluator::Run(std::vector<Ast::AstBase> asts)
     {
         using Ast::AstType;
+        // the script / module body is the root frame of everything it runs
+        ProfileScope profileScope(
+            profiler,
+            FString(std::format("<{}>", std::filesystem::path(sourcePath.toBasicString()).filename().string())),
+            (asts.empty() ? nullptr : asts.front()));
+
         StatementResult sr = StatementResult::normal();
         for (auto &ast : asts)
         {
             // statement, all stmt!
-            Ast::Statement stmt = std::static_pointer_cast<Ast::StatementAst>(ast);
+            Ast::Statement stmt = static_cast<Ast::StatementAst *>(ast);
             assert(stmt != nullptr);
             sr = evalStatement(stmt, global);
             if (sr.isError()) { handle_error(sr, stmt, global); }
@@ -171,35 +181,36 @@ namespace Fig
     void Evaluator::handle_error(const StatementResult &sr, const Ast::Statement &stmt, const ContextPtr &ctx)
     {
         assert(sr.isError());
-        const ObjectPtr &result = sr.result;
+        const Value &result = sr.result;
         const TypeInfo &resultType = actualType(result);
 
-        if (result->is<StructInstance>() && implements(resultType, Builtins::getErrorInterfaceTypeInfo(), ctx))
+        if (result.is<StructInstance>() && implements(resultType, Builtins::getErrorInterfaceTypeInfo(), ctx))
         {
             /*
                 toString() -> String
                 getErrorClass() -> String
                 getErrorMessage() -> String
             */
-            const StructInstance &resInst = result->as<StructInstance>();
+            const StructInstance &resInst = result.as<StructInstance>();
+            ContextPtr instanceCtx = Context::forInstance(resInst);
 
             Function getErrorClassFn = ctx->getImplementedMethod(resultType, u8"getErrorClass");
             getErrorClassFn = Function(getErrorClassFn.name,
                                        getErrorClassFn.paras,
                                        getErrorClassFn.retType,
                                        getErrorClassFn.body,
-                                       resInst.localContext);
+                                       instanceCtx);
             Function getErrorMessageFn = ctx->getImplementedMethod(resultType, u8"getErrorMessage");
             getErrorMessageFn = Function(getErrorMessageFn.name,
                                          getErrorMessageFn.paras,
                                          getErrorMessageFn.retType,
                                          getErrorMessageFn.body,
-                                         resInst.localContext);
+                                         instanceCtx);
 
             const ExprResult &errorClassRes =
-                executeFunction(getErrorClassFn, Ast::FunctionCallArgs{}, resInst.localContext);
+                executeFunction(getErrorClassFn, Ast::FunctionCallArgs{}, instanceCtx);
             const ExprResult &errorMessageRes =
-                executeFunction(getErrorMessageFn, Ast::FunctionCallArgs{}, resInst.localContext);
+                executeFunction(getErrorMessageFn, Ast::FunctionCallArgs{}, instanceCtx);
 
             if (errorClassRes.isError()) { handle_error(errorClassRes.toStatementResult(), getErrorClassFn.body, ctx); }
             if (errorMessageRes.isError())
@@ -207,11 +218,11 @@ namespace Fig
                 handle_error(errorMessageRes.toStatementResult(), getErrorMessageFn.body, ctx);
             }
 
-            // std::cerr << errorClassRes.unwrap()->toString().toBasicString() << "\n";
-            // std::cerr << errorMessageRes.unwrap()->toString().toBasicString() << "\n";
+            // std::cerr << errorClassRes.unwrap().toString().toBasicString() << "\n";
+            // std::cerr << errorMessageRes.unwrap().toString().toBasicString() << "\n";
 
-            const FString &errorClass = errorClassRes.unwrap()->as<ValueType::StringClass>();
-            const FString &errorMessage = errorMessageRes.unwrap()->as<ValueType::StringClass>();
+            FString errorClass = ValueType::toFString(errorClassRes.unwrap().as<ValueType::StringClass>());
+            FString errorMessage = ValueType::toFString(errorMessageRes.unwrap().as<ValueType::StringClass>());
 
             ErrorLog::logFigErrorInterface(errorClass, errorMessage);
             std::exit(1);
@@ -219,7 +230,7 @@ namespace Fig
         else
         {
             throw EvaluatorError(u8"UncaughtExceptionError",
-                                 std::format("Uncaught exception: {}", sr.result->toString().toBasicString()),
+                                 std::format("Uncaught exception: {}", sr.result.toString().toBasicString()),
                                  stmt);
         }
     }
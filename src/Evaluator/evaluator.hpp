@@ -13,6 +13,7 @@
 #include <Ast/Statements/InterfaceDefSt.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Ast/ast.hpp>
+#include <Ast/AstArena.hpp>
 
 #include <Evaluator/Context/context.hpp>
 #include <Error/error.hpp>
@@ -23,6 +24,7 @@
 
 #include <Evaluator/Core/StatementResult.hpp>
 #include <Evaluator/Core/ExprResult.hpp>
+#include <Evaluator/Core/Profiler.hpp>
 #include <memory>
 #include <source_location>
 
@@ -33,6 +35,8 @@ namespace Fig
     private:
         ContextPtr global;
 
+        Profiler *profiler = Profiler::active(); // --profile, nullptr otherwise
+
     public:
         FString sourcePath;
         std::vector<FString> sourceLines;
@@ -57,9 +61,23 @@ namespace Fig
             {
                 int argc = Builtins::getBuiltinFunctionParamCount(name);
                 Function f(name, fn, argc);
-                global->def(name, ValueType::Function, AccessModifier::Const, std::make_shared<Object>(f));
+                global->def(name, ValueType::Function, AccessModifier::Const, Value(Object(f)));
             }
 
+            // method bodies are built once into the builtins arena, every global shares them
+            static Ast::Arena &arena = Ast::Arena::builtins();
+            static const Ast::BlockStatement toStringBody = arena.make<Ast::BlockStatementAst>(std::vector<Ast::Statement>(
+                {arena.make<Ast::ReturnSt>(arena.make<Ast::BinaryExprAst>(
+                    arena.make<Ast::ValueExprAst>(std::make_shared<Object>(u8"TypeError: ")),
+                    Ast::Operator::Add,
+                    arena.make<Ast::FunctionCallExpr>(arena.make<Ast::VarExprAst>(u8"getErrorMessage"),
+                                                      Ast::FunctionArguments{})))}));
+            static const Ast::BlockStatement getErrorClassBody =
+                arena.make<Ast::BlockStatementAst>(std::vector<Ast::Statement>({arena.make<Ast::ReturnSt>(
+                    arena.make<Ast::ValueExprAst>(std::make_shared<Object>(FString(u8"TypeError"))))}));
+            static const Ast::BlockStatement getErrorMessageBody = arena.make<Ast::BlockStatementAst>(
+                std::vector<Ast::Statement>({arena.make<Ast::ReturnSt>(arena.make<Ast::VarExprAst>(u8"msg"))}));
+
             global->setImplRecord(
                 Builtins::getTypeErrorStructTypeInfo(),
                 Builtins::getErrorInterfaceTypeInfo(),
@@ -68,32 +86,18 @@ namespace Fig
                     .structType = Builtins::getTypeErrorStructTypeInfo(),
                     .implMethods = {
                         {u8"toString",
-                         Function(
-                             u8"toString",
-                             Ast::FunctionParameters{},
-                             ValueType::String,
-                             std::make_shared<Ast::BlockStatementAst>(std::vector<Ast::Statement>(
-                                 {std::make_shared<Ast::ReturnSt>(std::make_shared<Ast::BinaryExprAst>(
-                                     std::make_shared<Ast::ValueExprAst>(std::make_shared<Object>(u8"TypeError: ")),
-                                     Ast::Operator::Add,
-                                     std::make_shared<Ast::FunctionCallExpr>(
-                                         std::make_shared<Ast::VarExprAst>(u8"getErrorMessage"),
-                                         Ast::FunctionArguments{})))})),
-                             nullptr)},
+                         Function(u8"toString", Ast::FunctionParameters{}, ValueType::String, toStringBody, nullptr)},
                         {u8"getErrorClass",
                          Function(u8"getErrorClass",
                                   Ast::FunctionParameters{},
                                   ValueType::String,
-                                  std::make_shared<Ast::BlockStatementAst>(std::vector<Ast::Statement>(
-                                      {std::make_shared<Ast::ReturnSt>(std::make_shared<Ast::ValueExprAst>(
-                                          std::make_shared<Object>(FString(u8"TypeError"))))})),
+                                  getErrorClassBody,
                                   nullptr)},
                         {u8"getErrorMessage",
                          Function(u8"getErrorMessage",
                                   Ast::FunctionParameters{},
                                   ValueType::String,
-                                  std::make_shared<Ast::BlockStatementAst>(std::vector<Ast::Statement>(
-                                      {std::make_shared<Ast::ReturnSt>(std::make_shared<Ast::VarExprAst>(u8"msg"))})),
+                                  getErrorMessageBody,
                                   nullptr)},
                     }});
         }
@@ -110,19 +114,23 @@ namespace Fig
 
         bool isInterfaceSignatureMatch(const Ast::ImplementMethod &, const Ast::InterfaceMethod &);
 
-        ObjectPtr genTypeError(const FString &_msg,
+        Value genTypeError(const FString &_msg,
                                const Ast::AstBase &_ast,
                                ContextPtr ctx,
                                std::source_location loc = std::source_location::current())
         {
-            ContextPtr stCtx = std::make_shared<Context>(u8"<TypeError Instance>");
-            stCtx->def(u8"msg", ValueType::String, AccessModifier::Const, std::make_shared<Object>(_msg));
-            return std::make_shared<Object>(StructInstance(Builtins::getTypeErrorStructTypeInfo(), stCtx));
+            static const std::shared_ptr<StructShape> shape =
+                Builtins::getBuiltinValues().at(u8"TypeError")->as<StructType>().shape;
+            return Value(Object(StructInstance(
+                Builtins::getTypeErrorStructTypeInfo(),
+                shape,
+                {VariableSlot{u8"msg", Value(Object(_msg)), ValueType::String, AccessModifier::Const}})));
         }
 
         /* Left-value eval*/
         ExprResult evalVarExpr(Ast::VarExpr, ContextPtr);       // identifier: a, b, c
         ExprResult evalMemberExpr(Ast::MemberExpr, ContextPtr); // a.b
+        ExprResult evalMemberOf(RvObject, Ast::MemberExpr, ContextPtr); // a.b, a already evaluated
         ExprResult evalIndexExpr(Ast::IndexExpr, ContextPtr);   // a[b]
 
         ExprResult evalLv(Ast::Expression, ContextPtr); // for access: a.b / index a[b]
@@ -134,6 +142,12 @@ namespace Fig
         ExprResult evalTernary(Ast::TernaryExpr, ContextPtr); // ternary expr
 
         ExprResult executeFunction(const Function &fn, const Ast::FunctionCallArgs &, ContextPtr); // fn, fn context
+        ExprResult resolveSignature(const Function &); // fills fn.signature once per definition
+        void checkDefaultType(const Function &fn,
+                              const FString &paraName,
+                              const TypeInfo &expectedType,
+                              const Value &defaultVal,
+                              Ast::AstBase where); // throws DefaultParameterTypeError
 
         ExprResult evalFunctionCall(const Ast::FunctionCall &,
                                     ContextPtr); // function call
@@ -144,7 +158,7 @@ namespace Fig
         StatementResult evalStatement(Ast::Statement, ContextPtr);           // statement
 
         std::filesystem::path resolveModulePath(const std::vector<FString> &);
-        ContextPtr loadModule(const std::filesystem::path &);
+        ContextPtr loadModule(const std::filesystem::path &, const FString &modKey); // see ModuleRegistry
 
         StatementResult evalImportSt(Ast::Import, ContextPtr);
 
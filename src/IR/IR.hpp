@@ -1,9 +1,16 @@
 #pragma once
 
 #include <Core/fig_string.hpp>
+#include <Error/error.hpp>
+#include <Utils/magic_enum/magic_enum.hpp>
 
-#include <vector>
+#include <cmath>
 #include <cstdint>
+#include <format>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace Fig::IR
 {
     using Reg = uint16_t;
@@ -15,16 +22,19 @@ namespace Fig::IR
     {
         // ---- control ----
         Nop,
-        Jmp,
-        Br, // conditional branch
-        Ret,
-        Call,
+        Jmp, // ip += imm
+        Br,  // conditional branch, ip += imm if a is false
+        Ret, // return a, null if a == INVALID_REG
+        Call, // dst = functions[imm](a, a + 1, ..., a + b - 1)
 
         // ---- arithmetic ----
         Add,
         Sub,
         Mul,
         Div,
+        Mod,
+        Neg,
+        Not,
 
         // ---- compare ----
         Lt,
@@ -32,21 +42,99 @@ namespace Fig::IR
         Gt,
         Ge,
         Eq,
+        Ne,
 
         // ---- data ----
-        LoadImm, // immediate -> reg
+        LoadImm,   // Int immediate -> reg
+        LoadConst, // constants[imm] -> reg
         Mov,
     };
 
+    // 寄存器里的值: 只有数值 tier 需要的类型
+    struct Value
+    {
+        enum class Kind : uint8_t
+        {
+            Null,
+            Int,
+            Double,
+            Bool,
+        };
+
+        Kind kind = Kind::Null;
+        union
+        {
+            int64_t i;
+            double d;
+            bool b;
+        };
+
+        Value() : i(0) {}
+
+        static Value Int(int64_t v)
+        {
+            Value r;
+            r.kind = Kind::Int;
+            r.i = v;
+            return r;
+        }
+        static Value Double(double v)
+        {
+            Value r;
+            r.kind = Kind::Double;
+            r.d = v;
+            return r;
+        }
+        static Value Bool(bool v)
+        {
+            Value r;
+            r.kind = Kind::Bool;
+            r.b = v;
+            return r;
+        }
+
+        bool isInt() const { return kind == Kind::Int; }
+        bool isDouble() const { return kind == Kind::Double; }
+        bool isBool() const { return kind == Kind::Bool; }
+        bool isNull() const { return kind == Kind::Null; }
+        bool isNumeric() const { return kind == Kind::Int || kind == Kind::Double; }
+
+        double getNumericValue() const { return (kind == Kind::Int ? static_cast<double>(i) : d); }
+
+        std::string toString() const
+        {
+            switch (kind)
+            {
+                case Kind::Null: return "null";
+                case Kind::Int: return std::to_string(i);
+                case Kind::Double: return std::format("{}", d);
+                case Kind::Bool: return (b ? "true" : "false");
+            }
+            return "?";
+        }
+
+        bool operator==(const Value &other) const
+        {
+            if (isNumeric() && other.isNumeric())
+            {
+                if (isInt() && other.isInt()) return i == other.i;
+                return getNumericValue() == other.getNumericValue();
+            }
+            if (kind != other.kind) return false;
+            if (kind == Kind::Bool) return b == other.b;
+            return true; // null == null
+        }
+    };
+
     struct Inst
     {
         Op op;
 
         Reg dst; // 结果寄存器
         Reg a;   // operand a
-        Reg b;   // operand b
+        Reg b;   // operand b, argument count of Call
 
-        int64_t imm; // immediate / jump offset
+        int64_t imm; // immediate / jump offset / constant index / function index
     };
 
     struct Function
@@ -55,8 +143,173 @@ namespace Fig::IR
 
         uint16_t paramCount;
         uint16_t localCount; // 不含参数
-        uint16_t regCount; // param + locals + temps
+        uint16_t regCount;   // param + locals + temps
 
         std::vector<Inst> code;
+        std::vector<Value> constants;
     };
-};
\ No newline at end of file
+
+    // functions of one script, Call imm indexes `functions`
+    struct Module
+    {
+        std::vector<Function> functions;
+        std::unordered_map<FString, uint32_t> index;
+
+        Function *get(const FString &name)
+        {
+            auto it = index.find(name);
+            return (it == index.end() ? nullptr : &functions[it->second]);
+        }
+    };
+
+    inline bool isJump(Op op)
+    {
+        return op == Op::Jmp || op == Op::Br;
+    }
+
+    inline bool writesDst(Op op)
+    {
+        switch (op)
+        {
+            case Op::Nop:
+            case Op::Jmp:
+            case Op::Br:
+            case Op::Ret: return false;
+            default: return true;
+        }
+    }
+
+    // no side effect besides writing dst (may still throw at runtime, see Passes.cpp mayThrow)
+    inline bool isPure(Op op)
+    {
+        return writesDst(op) && op != Op::Call;
+    }
+
+    inline bool isBinary(Op op)
+    {
+        return (op >= Op::Add && op <= Op::Mod) || (op >= Op::Lt && op <= Op::Ne);
+    }
+
+    inline bool isUnary(Op op)
+    {
+        return op == Op::Neg || op == Op::Not;
+    }
+
+    // registers read by an instruction
+    template <class Fn>
+    void forEachUse(const Inst &ins, Fn &&fn)
+    {
+        if (isBinary(ins.op))
+        {
+            fn(ins.a);
+            fn(ins.b);
+        }
+        else if (isUnary(ins.op) || ins.op == Op::Mov || ins.op == Op::Br)
+        {
+            fn(ins.a);
+        }
+        else if (ins.op == Op::Ret)
+        {
+            if (ins.a != INVALID_REG) fn(ins.a);
+        }
+        else if (ins.op == Op::Call)
+        {
+            for (Reg r = 0; r < ins.b; ++r) fn(static_cast<Reg>(ins.a + r));
+        }
+    }
+
+    // slow paths shared by IRInterpreter and constant folding, same rules as Object operators
+    inline Value binaryOp(Op op, const Value &lhs, const Value &rhs)
+    {
+        auto error = [&](const char *what) -> RuntimeError {
+            return RuntimeError(FString(std::format(
+                "{}: '{}' {} '{}'", what, lhs.toString(), magic_enum::enum_name(op), rhs.toString())));
+        };
+
+        if (op == Op::Eq) return Value::Bool(lhs == rhs);
+        if (op == Op::Ne) return Value::Bool(!(lhs == rhs));
+
+        if (!lhs.isNumeric() || !rhs.isNumeric()) throw error("Unsupported operation");
+
+        bool bothInt = lhs.isInt() && rhs.isInt();
+        switch (op)
+        {
+            case Op::Add:
+                if (bothInt) return Value::Int(lhs.i + rhs.i);
+                return Value::Double(lhs.getNumericValue() + rhs.getNumericValue());
+            case Op::Sub:
+                if (bothInt) return Value::Int(lhs.i - rhs.i);
+                return Value::Double(lhs.getNumericValue() - rhs.getNumericValue());
+            case Op::Mul:
+                if (bothInt) return Value::Int(lhs.i * rhs.i);
+                return Value::Double(lhs.getNumericValue() * rhs.getNumericValue());
+            case Op::Div: {
+                // int / int maybe decimals
+                if (rhs.getNumericValue() == 0) throw error("Division by zero");
+                return Value::Double(lhs.getNumericValue() / rhs.getNumericValue());
+            }
+            case Op::Mod: {
+                if (rhs.getNumericValue() == 0) throw error("Modulo by zero");
+                if (bothInt)
+                {
+                    // floor modulo, result has the sign of rhs
+                    int64_t r = lhs.i % rhs.i;
+                    if (r != 0 && ((r < 0) != (rhs.i < 0))) r += rhs.i;
+                    return Value::Int(r);
+                }
+                return Value::Double(std::fmod(lhs.getNumericValue(), rhs.getNumericValue()));
+            }
+            case Op::Lt: return Value::Bool(lhs.getNumericValue() < rhs.getNumericValue());
+            case Op::Le: return Value::Bool(lhs.getNumericValue() <= rhs.getNumericValue());
+            case Op::Gt: return Value::Bool(lhs.getNumericValue() > rhs.getNumericValue());
+            case Op::Ge: return Value::Bool(lhs.getNumericValue() >= rhs.getNumericValue());
+            default: throw error("Not a binary operator");
+        }
+    }
+
+    inline Value unaryOp(Op op, const Value &v)
+    {
+        if (op == Op::Not)
+        {
+            if (!v.isBool()) throw RuntimeError(FString(std::format("Logical NOT requires bool: '{}'", v.toString())));
+            return Value::Bool(!v.b);
+        }
+        if (v.isInt()) return Value::Int(-v.i);
+        if (v.isDouble()) return Value::Double(-v.d);
+        throw RuntimeError(FString(std::format("Unary minus requires int or double: '{}'", v.toString())));
+    }
+
+    inline std::string dump(const Function &fn)
+    {
+        std::string out = std::format("func {} (params {}, regs {})\n", fn.name.toBasicString(), fn.paramCount, fn.regCount);
+        for (size_t i = 0; i < fn.code.size(); ++i)
+        {
+            const Inst &ins = fn.code[i];
+            std::string_view name = magic_enum::enum_name(ins.op);
+            switch (ins.op)
+            {
+                case Op::Nop: out += std::format("{:4}  {}\n", i, name); break;
+                case Op::Jmp: out += std::format("{:4}  {} -> {}\n", i, name, static_cast<int64_t>(i) + 1 + ins.imm); break;
+                case Op::Br:
+                    out += std::format("{:4}  {} r{} else -> {}\n", i, name, ins.a, static_cast<int64_t>(i) + 1 + ins.imm);
+                    break;
+                case Op::Ret:
+                    out += (ins.a == INVALID_REG ? std::format("{:4}  {}\n", i, name)
+                                                 : std::format("{:4}  {} r{}\n", i, name, ins.a));
+                    break;
+                case Op::Call:
+                    out += std::format("{:4}  r{} = {} #{} (r{}, {} args)\n", i, ins.dst, name, ins.imm, ins.a, ins.b);
+                    break;
+                case Op::LoadImm: out += std::format("{:4}  r{} = {}\n", i, ins.dst, ins.imm); break;
+                case Op::LoadConst:
+                    out += std::format("{:4}  r{} = {}\n", i, ins.dst, fn.constants[ins.imm].toString());
+                    break;
+                case Op::Mov: out += std::format("{:4}  r{} = r{}\n", i, ins.dst, ins.a); break;
+                case Op::Neg:
+                case Op::Not: out += std::format("{:4}  r{} = {} r{}\n", i, ins.dst, name, ins.a); break;
+                default: out += std::format("{:4}  r{} = {} r{}, r{}\n", i, ins.dst, name, ins.a, ins.b); break;
+            }
+        }
+        return out;
+    }
+}; // namespace Fig::IR
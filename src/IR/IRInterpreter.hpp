@@ -3,72 +3,189 @@
 #include <IR/IR.hpp>
 
 #include <cassert>
+#include <initializer_list>
 
 namespace Fig::IR
 {
+    /*
+        IR interpreter
+        every frame is a window of one preallocated register stack: a call puts the callee window right
+        above the caller's and copies the arguments into its first registers, nothing is allocated per call
+    */
     struct VirtualMachine
     {
-        std::vector<Function *> functions;
+        static constexpr size_t REGISTER_STACK_SIZE = 1 << 20; // values, preallocated
+        static constexpr size_t MAX_FRAMES = 1 << 16;
 
-        int64_t execute(Function *fn, const int64_t *args) 
+        struct Frame
         {
-            assert(fn != nullptr);
-            std::vector<int64_t> regs(fn->regCount);
-            // load params
+            const Function *fn;
+            const Inst *ip;
+            Value *regs; // window of fn->regCount registers
+            Reg retDst;  // caller register receiving the result
+        };
 
-            size_t ip = 0;
+        std::vector<Function *> functions;
 
-            while (ip < fn->code.size())
-            {
-                const Inst &ins = fn->code[ip++];
+        std::vector<Value> registers;
+        std::vector<Frame> frames;
 
-                switch (ins.op)
-                {
-                    case Op::Nop: break;
+        VirtualMachine() : registers(REGISTER_STACK_SIZE) { frames.reserve(MAX_FRAMES); }
 
-                    case Op::LoadImm: regs[ins.dst] = ins.imm; break;
+        void load(Module &module)
+        {
+            functions.clear();
+            for (Function &fn : module.functions) { functions.push_back(&fn); }
+        }
 
-                    case Op::Mov: regs[ins.dst] = regs[ins.a]; break;
+        Value execute(Function *fn, const Value *args, size_t argc)
+        {
+            assert(fn != nullptr);
+            if (argc != fn->paramCount)
+            {
+                throw RuntimeError(FString(std::format("Function '{}' expects {} arguments, but {} were provided",
+                                                       fn->name.toBasicString(),
+                                                       fn->paramCount,
+                                                       argc)));
+            }
 
-                    case Op::Add: regs[ins.dst] = regs[ins.a] + regs[ins.b]; break;
+            // re-entrant: nested execute() calls stack above the running frames
+            Value *base = (frames.empty() ? registers.data() : frames.back().regs + frames.back().fn->regCount);
+            if (base + fn->regCount > registers.data() + registers.size())
+            {
+                throw RuntimeError(FString(u8"IR register stack overflow"));
+            }
+            for (size_t i = 0; i < argc; ++i) { base[i] = args[i]; }
 
-                    case Op::Sub: regs[ins.dst] = regs[ins.a] - regs[ins.b]; break;
+            size_t entryDepth = frames.size();
+            frames.push_back(Frame{fn, fn->code.data(), base, INVALID_REG});
+            try
+            {
+                return run(entryDepth);
+            }
+            catch (...)
+            {
+                frames.resize(entryDepth);
+                throw;
+            }
+        }
 
-                    case Op::Mul: regs[ins.dst] = regs[ins.a] * regs[ins.b]; break;
+        Value execute(Function *fn, std::initializer_list<Value> args)
+        {
+            return execute(fn, args.begin(), args.size());
+        }
 
-                    case Op::Div: regs[ins.dst] = regs[ins.a] / regs[ins.b]; break;
+    private:
+        Value run(size_t entryDepth)
+        {
+            Frame *frame = &frames.back();
+            const Inst *ip = frame->ip;
+            Value *regs = frame->regs;
+            const Value *constants = frame->fn->constants.data();
 
-                    case Op::Lt: regs[ins.dst] = regs[ins.a] < regs[ins.b]; break;
+            for (;;)
+            {
+                const Inst &ins = *ip++;
 
-                    case Op::Le: regs[ins.dst] = regs[ins.a] <= regs[ins.b]; break;
+                switch (ins.op)
+                {
+                    case Op::Nop: break;
 
-                    case Op::Gt: regs[ins.dst] = regs[ins.a] > regs[ins.b]; break;
+                    case Op::LoadImm: regs[ins.dst] = Value::Int(ins.imm); break;
+
+                    case Op::LoadConst: regs[ins.dst] = constants[ins.imm]; break;
+
+                    case Op::Mov: regs[ins.dst] = regs[ins.a]; break;
 
-                    case Op::Ge: regs[ins.dst] = regs[ins.a] >= regs[ins.b]; break;
+                    // int fast paths, everything else through binaryOp
+                    case Op::Add: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Int(l.i + r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Sub: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Int(l.i - r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Mul: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Int(l.i * r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Lt: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Bool(l.i < r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Le: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Bool(l.i <= r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Gt: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Bool(l.i > r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Ge: {
+                        const Value &l = regs[ins.a], &r = regs[ins.b];
+                        regs[ins.dst] = (l.isInt() && r.isInt() ? Value::Bool(l.i >= r.i) : binaryOp(ins.op, l, r));
+                        break;
+                    }
+                    case Op::Div:
+                    case Op::Mod:
+                    case Op::Eq:
+                    case Op::Ne: regs[ins.dst] = binaryOp(ins.op, regs[ins.a], regs[ins.b]); break;
 
-                    case Op::Eq: regs[ins.dst] = regs[ins.a] == regs[ins.b]; break;
+                    case Op::Neg:
+                    case Op::Not: regs[ins.dst] = unaryOp(ins.op, regs[ins.a]); break;
 
-                    case Op::Jmp: ip = static_cast<size_t>(static_cast<int64_t>(ip) + ins.imm); break;
+                    case Op::Jmp: ip += ins.imm; break;
 
-                    case Op::Br:
-                        if (regs[ins.a] == 0) { ip = static_cast<size_t>(static_cast<int64_t>(ip) + ins.imm); }
+                    case Op::Br: {
+                        const Value &cond = regs[ins.a];
+                        if (!cond.isBool()) { throw RuntimeError(FString(u8"Condition must be boolean!")); }
+                        if (!cond.b) { ip += ins.imm; }
                         break;
+                    }
 
                     case Op::Call: {
-                        // currently supports 1-arg call via reg a
-                        Function *callee = functions.at(static_cast<size_t>(ins.imm));
-                        int64_t arg0 = regs[ins.a];
-                        int64_t ret = execute(callee, &arg0);
-                        regs[ins.dst] = ret;
+                        Function *callee = functions[static_cast<size_t>(ins.imm)];
+                        Value *calleeRegs = regs + frame->fn->regCount;
+                        if (frames.size() >= MAX_FRAMES
+                            || calleeRegs + callee->regCount > registers.data() + registers.size())
+                        {
+                            throw RuntimeError(
+                                FString(std::format("Stack overflow calling '{}'", callee->name.toBasicString())));
+                        }
+                        for (Reg i = 0; i < ins.b; ++i) { calleeRegs[i] = regs[ins.a + i]; }
+
+                        frame->ip = ip; // save caller
+                        frames.push_back(Frame{callee, callee->code.data(), calleeRegs, ins.dst});
+
+                        frame = &frames.back();
+                        ip = frame->ip;
+                        regs = calleeRegs;
+                        constants = callee->constants.data();
                         break;
                     }
 
-                    case Op::Ret: return regs[ins.a];
+                    case Op::Ret: {
+                        Value ret = (ins.a == INVALID_REG ? Value() : regs[ins.a]);
+                        Reg retDst = frame->retDst;
+                        frames.pop_back();
+                        if (frames.size() == entryDepth) { return ret; }
+
+                        frame = &frames.back();
+                        ip = frame->ip;
+                        regs = frame->regs;
+                        constants = frame->fn->constants.data();
+                        regs[retDst] = ret;
+                        break;
+                    }
                 }
             }
-
-            // unreachable normally
-            return 0;
         }
     };
-}; // namespace Fig::IR
\ No newline at end of file
+}; // namespace Fig::IR
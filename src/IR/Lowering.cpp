@@ -0,0 +1,471 @@
+#include <IR/Lowering.hpp>
+
+namespace Fig::IR
+{
+    void Lowering::error(const FString &msg, Ast::AstBase ast)
+    {
+        Ast::AstAddressInfo aai = (ast ? ast->getAAI() : currentAAI);
+        throw CompileError(msg, aai.line, aai.column, sourcePath, sourceLines);
+    }
+
+    size_t Lowering::emit(Op op, Reg dst, Reg a, Reg b, int64_t imm)
+    {
+        fn->code.push_back(Inst{op, dst, a, b, imm});
+        return fn->code.size() - 1;
+    }
+
+    size_t Lowering::emitJump(Op op, Reg cond)
+    {
+        return emit(op, 0, cond, 0, 0); // offset patched later
+    }
+
+    void Lowering::patchJump(size_t at)
+    {
+        patchJumpTo(at, fn->code.size());
+    }
+
+    void Lowering::patchJumpTo(size_t at, size_t target)
+    {
+        // offset is relative to the instruction after the jump
+        fn->code[at].imm = static_cast<int64_t>(target) - static_cast<int64_t>(at) - 1;
+    }
+
+    int64_t Lowering::addConstant(const Value &value)
+    {
+        std::vector<Value> &constants = fn->constants;
+        for (size_t i = 0; i < constants.size(); ++i)
+        {
+            if (constants[i].kind == value.kind && constants[i] == value) { return static_cast<int64_t>(i); }
+        }
+        constants.push_back(value);
+        return static_cast<int64_t>(constants.size() - 1);
+    }
+
+    Reg Lowering::newReg(Ast::AstBase ast)
+    {
+        if (nextReg == INVALID_REG - 1)
+        {
+            error(FString(std::format("Function `{}` needs too many registers", fn->name.toBasicString())), ast);
+        }
+        Reg r = nextReg++;
+        if (nextReg > maxReg) { maxReg = nextReg; }
+        return r;
+    }
+
+    Reg Lowering::declareLocal(const FString &name, Ast::AstBase ast)
+    {
+        auto &scope = scopes.back();
+        auto it = scope.find(name);
+        if (it != scope.end()) { return it->second; } // if/else branches may define the same name
+        Reg r = newReg(ast);
+        scope[name] = r;
+        return r;
+    }
+
+    Reg Lowering::findLocal(const FString &name, Ast::AstBase ast)
+    {
+        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it)
+        {
+            auto nit = it->find(name);
+            if (nit != it->end()) { return nit->second; }
+        }
+        error(FString(std::format("`{}` is not a local of `{}`, IR only lowers self-contained functions",
+                                  name.toBasicString(),
+                                  fn->name.toBasicString())),
+              ast);
+    }
+
+    void Lowering::lowerFunction(const Ast::FunctionDef &def)
+    {
+        fn = module->get(def->name);
+        scopes.assign(1, {});
+        loops.clear();
+        nextReg = 0;
+        maxReg = 0;
+
+        for (const auto &[paraName, _] : def->paras.posParas) { declareLocal(paraName, def); } // r0..rN-1
+        for (const auto &stmt : def->body->stmts) { lowerStatement(stmt); }
+        emit(Op::Ret, 0, INVALID_REG); // falls off the end: null
+
+        fn->regCount = static_cast<uint16_t>(maxReg);
+        fn->localCount = static_cast<uint16_t>(maxReg - fn->paramCount);
+        fn = nullptr;
+    }
+
+    void Lowering::lowerBlock(const std::vector<Ast::Statement> &stmts)
+    {
+        Reg mark = nextReg;
+        scopes.emplace_back();
+        for (const auto &stmt : stmts) { lowerStatement(stmt); }
+        scopes.pop_back();
+        nextReg = mark; // block locals are dead
+    }
+
+    void Lowering::lowerStatement(const Ast::Statement &stmt)
+    {
+        if (!stmt) return;
+        currentAAI = stmt->getAAI();
+
+        using enum Ast::AstType;
+        switch (stmt->getType())
+        {
+            case VarDefSt: {
+                auto varDef = static_cast<Ast::VarDefAst *>(stmt);
+                Reg mark = nextReg;
+                Reg t = newReg(stmt);
+                if (varDef->expr) { lowerExpression(varDef->expr, t); }
+                else
+                {
+                    // `var a: Int;` -> type default value, same as Evaluator
+                    FString typeName;
+                    if (varDef->declaredType && varDef->declaredType->getType() == VarExpr)
+                    {
+                        typeName = static_cast<Ast::VarExprAst *>(varDef->declaredType)->name;
+                    }
+                    if (typeName == u8"Int") { emit(Op::LoadImm, t, 0, 0, 0); }
+                    else if (typeName == u8"Double") { emit(Op::LoadConst, t, 0, 0, addConstant(Value::Double(0))); }
+                    else if (typeName == u8"Bool") { emit(Op::LoadConst, t, 0, 0, addConstant(Value::Bool(false))); }
+                    else
+                    {
+                        emit(Op::LoadConst, t, 0, 0, addConstant(Value()));
+                    }
+                }
+                // after init: `var x := x` reads the outer one. a new local takes over the temp register
+                nextReg = mark;
+                Reg r = declareLocal(varDef->name, stmt);
+                if (r != t) { emit(Op::Mov, r, t); }
+                break;
+            }
+            case IfSt: {
+                // if bodies share the enclosing scope, same as Evaluator
+                auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                std::vector<size_t> exits;
+
+                auto branch = [&](const Ast::Expression &cond, const std::vector<Ast::Statement> &body) {
+                    Reg t = newReg(cond);
+                    lowerExpression(cond, t);
+                    nextReg = t;
+                    size_t next = emitJump(Op::Br, t);
+                    for (const auto &st : body) { lowerStatement(st); }
+                    exits.push_back(emitJump(Op::Jmp));
+                    patchJump(next);
+                };
+
+                branch(ifSt->condition, ifSt->body->stmts);
+                for (const auto &elif : ifSt->elifs)
+                {
+                    currentAAI = elif->getAAI();
+                    branch(elif->condition, elif->body->stmts);
+                }
+                if (ifSt->els)
+                {
+                    for (const auto &st : ifSt->els->body->stmts) { lowerStatement(st); }
+                }
+                for (size_t at : exits) { patchJump(at); }
+                break;
+            }
+            case WhileSt: {
+                auto whileSt = static_cast<Ast::WhileSt *>(stmt);
+
+                size_t loopStart = fn->code.size();
+                Reg t = newReg(stmt);
+                lowerExpression(whileSt->condition, t);
+                nextReg = t;
+                size_t exit = emitJump(Op::Br, t);
+
+                loops.emplace_back();
+                lowerBlock(whileSt->body->stmts);
+                Loop loop = std::move(loops.back());
+                loops.pop_back();
+
+                for (size_t at : loop.continues) { patchJumpTo(at, loopStart); } // -> condition
+                patchJumpTo(emitJump(Op::Jmp), loopStart);
+                patchJump(exit);
+                for (size_t at : loop.breaks) { patchJump(at); }
+                break;
+            }
+            case ForSt: {
+                auto forSt = static_cast<Ast::ForSt *>(stmt);
+
+                Reg mark = nextReg;
+                scopes.emplace_back(); // loop scope: init, condition, increment
+                if (forSt->initSt) { lowerStatement(forSt->initSt); }
+
+                size_t loopStart = fn->code.size();
+                size_t exit = 0;
+                bool hasCondition = static_cast<bool>(forSt->condition);
+                if (hasCondition)
+                {
+                    Reg t = newReg(stmt);
+                    lowerExpression(forSt->condition, t);
+                    nextReg = t;
+                    exit = emitJump(Op::Br, t);
+                }
+
+                loops.emplace_back();
+                lowerBlock(forSt->body->stmts);
+                Loop loop = std::move(loops.back());
+                loops.pop_back();
+
+                for (size_t at : loop.continues) { patchJump(at); } // -> increment
+                lowerStatement(forSt->incrementSt);
+                patchJumpTo(emitJump(Op::Jmp), loopStart);
+
+                if (hasCondition) { patchJump(exit); }
+                for (size_t at : loop.breaks) { patchJump(at); }
+                scopes.pop_back();
+                nextReg = mark;
+                break;
+            }
+            case BreakSt: {
+                if (loops.empty()) { error(u8"`break` outside of loop", stmt); }
+                loops.back().breaks.push_back(emitJump(Op::Jmp));
+                break;
+            }
+            case ContinueSt: {
+                if (loops.empty()) { error(u8"`continue` outside of loop", stmt); }
+                loops.back().continues.push_back(emitJump(Op::Jmp));
+                break;
+            }
+            case ReturnSt: {
+                auto ret = static_cast<Ast::ReturnSt *>(stmt);
+                if (!ret->retValue)
+                {
+                    emit(Op::Ret, 0, INVALID_REG);
+                    break;
+                }
+                Reg t = newReg(stmt);
+                lowerExpression(ret->retValue, t);
+                emit(Op::Ret, 0, t);
+                nextReg = t;
+                break;
+            }
+            case BlockStatement: {
+                lowerBlock(static_cast<Ast::BlockStatementAst *>(stmt)->stmts);
+                break;
+            }
+            case ExpressionStmt: {
+                Reg t = newReg(stmt); // result is dead, DCE drops what only feeds it
+                lowerExpression(static_cast<Ast::ExpressionStmtAst *>(stmt)->exp, t);
+                nextReg = t;
+                break;
+            }
+            default:
+                error(FString(std::format("Statement `{}` cannot be lowered to IR", stmt->typeName().toBasicString())),
+                      stmt);
+        }
+    }
+
+    void Lowering::lowerBinary(const Ast::BinaryExpr &bin, Reg dst)
+    {
+        using Ast::Operator;
+
+        static const std::unordered_map<Operator, Op> arithmetic{
+            {Operator::Add, Op::Add},
+            {Operator::Subtract, Op::Sub},
+            {Operator::Multiply, Op::Mul},
+            {Operator::Divide, Op::Div},
+            {Operator::Modulo, Op::Mod},
+            {Operator::Less, Op::Lt},
+            {Operator::LessEqual, Op::Le},
+            {Operator::Greater, Op::Gt},
+            {Operator::GreaterEqual, Op::Ge},
+            {Operator::Equal, Op::Eq},
+            {Operator::NotEqual, Op::Ne},
+        };
+        static const std::unordered_map<Operator, Op> compound{
+            {Operator::PlusAssign, Op::Add},
+            {Operator::MinusAssign, Op::Sub},
+            {Operator::AsteriskAssign, Op::Mul},
+            {Operator::SlashAssign, Op::Div},
+            {Operator::PercentAssign, Op::Mod},
+        };
+
+        Operator op = bin->op;
+        if (auto it = arithmetic.find(op); it != arithmetic.end())
+        {
+            // operands go to temporaries: dst may be a local read by the other operand
+            Reg a = newReg(bin);
+            lowerExpression(bin->lexp, a);
+            Reg b = newReg(bin);
+            lowerExpression(bin->rexp, b);
+            emit(it->second, dst, a, b);
+            return;
+        }
+
+        if (op == Operator::And || op == Operator::Or)
+        {
+            // short circuit
+            Reg t = newReg(bin);
+            lowerExpression(bin->lexp, t);
+            Reg cond = t;
+            if (op == Operator::Or)
+            {
+                cond = newReg(bin);
+                emit(Op::Not, cond, t);
+            }
+            size_t shortCircuit = emitJump(Op::Br, cond);
+            lowerExpression(bin->rexp, t);
+            patchJump(shortCircuit);
+            emit(Op::Mov, dst, t);
+            return;
+        }
+
+        if (op == Operator::Assign || compound.contains(op))
+        {
+            if (bin->lexp->getType() != Ast::AstType::VarExpr)
+            {
+                error(u8"Only local variables can be assigned in IR", bin->lexp);
+            }
+            Reg r = findLocal(static_cast<Ast::VarExprAst *>(bin->lexp)->name, bin->lexp);
+            if (op == Operator::Assign) { lowerExpression(bin->rexp, r); }
+            else
+            {
+                Reg a = newReg(bin);
+                emit(Op::Mov, a, r);
+                Reg b = newReg(bin);
+                lowerExpression(bin->rexp, b);
+                emit(compound.at(op), r, a, b);
+            }
+            emit(Op::Mov, dst, r); // assignment is an expression
+            return;
+        }
+
+        error(FString(std::format("Operator `{}` cannot be lowered to IR", magic_enum::enum_name(op))), bin);
+    }
+
+    void Lowering::lowerExpression(const Ast::Expression &exp, Reg dst)
+    {
+        currentAAI = exp->getAAI();
+        Reg mark = nextReg; // temporaries are freed on return
+
+        using enum Ast::AstType;
+        switch (exp->getType())
+        {
+            case ValueExpr: {
+                const Object &val = *static_cast<Ast::ValueExprAst *>(exp)->val;
+                if (val.is<ValueType::IntClass>()) { emit(Op::LoadImm, dst, 0, 0, val.as<ValueType::IntClass>()); }
+                else if (val.is<ValueType::DoubleClass>())
+                {
+                    emit(Op::LoadConst, dst, 0, 0, addConstant(Value::Double(val.as<ValueType::DoubleClass>())));
+                }
+                else if (val.is<ValueType::BoolClass>())
+                {
+                    emit(Op::LoadConst, dst, 0, 0, addConstant(Value::Bool(val.as<ValueType::BoolClass>())));
+                }
+                else if (val.isNull()) { emit(Op::LoadConst, dst, 0, 0, addConstant(Value())); }
+                else
+                {
+                    error(FString(std::format("Literal of type `{}` cannot be lowered to IR",
+                                              val.getTypeInfo().name.toBasicString())),
+                          exp);
+                }
+                break;
+            }
+            case VarExpr: {
+                Reg r = findLocal(static_cast<Ast::VarExprAst *>(exp)->name, exp);
+                if (r != dst) { emit(Op::Mov, dst, r); }
+                break;
+            }
+            case BinaryExpr: lowerBinary(static_cast<Ast::BinaryExprAst *>(exp), dst); break;
+            case UnaryExpr: {
+                auto un = static_cast<Ast::UnaryExprAst *>(exp);
+                Op op;
+                if (un->op == Ast::Operator::Not) { op = Op::Not; }
+                else if (un->op == Ast::Operator::Subtract) { op = Op::Neg; }
+                else
+                {
+                    error(FString(std::format("Unary operator `{}` cannot be lowered to IR",
+                                              magic_enum::enum_name(un->op))),
+                          exp);
+                }
+                lowerExpression(un->exp, dst);
+                emit(op, dst, dst);
+                break;
+            }
+            case TernaryExpr: {
+                auto te = static_cast<Ast::TernaryExprAst *>(exp);
+                Reg cond = newReg(exp);
+                lowerExpression(te->condition, cond);
+                size_t elseJump = emitJump(Op::Br, cond);
+                lowerExpression(te->valueT, dst);
+                size_t end = emitJump(Op::Jmp);
+                patchJump(elseJump);
+                lowerExpression(te->valueF, dst);
+                patchJump(end);
+                break;
+            }
+            case FunctionCall: {
+                // arguments in consecutive temporaries: Call dst, a = first, b = count
+                auto call = static_cast<Ast::FunctionCallExpr *>(exp);
+                if (call->callee->getType() != VarExpr)
+                {
+                    error(u8"Only calls to top level functions can be lowered to IR", call->callee);
+                }
+                const FString &name = static_cast<Ast::VarExprAst *>(call->callee)->name;
+                auto it = module->index.find(name);
+                if (it == module->index.end())
+                {
+                    error(FString(std::format("`{}` is not a function of this script", name.toBasicString())),
+                          call->callee);
+                }
+                const Function &callee = module->functions[it->second];
+                size_t argc = call->arg.getLength();
+                if (argc != callee.paramCount)
+                {
+                    error(FString(std::format("Function '{}' expects {} arguments, but {} were provided",
+                                              name.toBasicString(),
+                                              callee.paramCount,
+                                              argc)),
+                          exp);
+                }
+
+                Reg first = nextReg;
+                for (const auto &arg : call->arg.argv)
+                {
+                    Reg t = newReg(arg);
+                    lowerExpression(arg, t);
+                }
+                currentAAI = exp->getAAI();
+                emit(Op::Call, dst, first, static_cast<Reg>(argc), it->second);
+                break;
+            }
+            default:
+                error(FString(std::format("Expression `{}` cannot be lowered to IR", exp->typeName().toBasicString())),
+                      exp);
+        }
+        nextReg = mark;
+    }
+
+    Module Lowering::lower(const std::vector<Ast::AstBase> &asts)
+    {
+        Module m;
+        module = &m;
+
+        // every function gets its index first, so calls may go to functions defined later
+        std::vector<Ast::FunctionDef> defs;
+        for (const auto &ast : asts)
+        {
+            if (ast->getType() != Ast::AstType::FunctionDefSt) continue;
+            auto def = static_cast<Ast::FunctionDefSt *>(ast);
+            if (def->paras.variadic || !def->paras.defParas.empty())
+            {
+                error(FString(std::format("Function `{}`: default and variadic parameters cannot be lowered to IR",
+                                          def->name.toBasicString())),
+                      ast);
+            }
+            if (m.index.contains(def->name)) continue;
+            m.index[def->name] = static_cast<uint32_t>(m.functions.size());
+
+            Function f{};
+            f.name = def->name;
+            f.paramCount = static_cast<uint16_t>(def->paras.posParas.size());
+            m.functions.push_back(std::move(f));
+            defs.push_back(def);
+        }
+        for (const auto &def : defs) { lowerFunction(def); }
+
+        module = nullptr;
+        return m;
+    }
+}; // namespace Fig::IR
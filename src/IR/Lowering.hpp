@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Ast/ast.hpp>
+#include <Bytecode/CompileError.hpp>
+#include <Core/fig_string.hpp>
+#include <IR/IR.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Fig::IR
+{
+    /*
+        Lowering
+        lowers top level numeric functions of a script to register IR
+
+        parameters   -> r0 .. rN-1
+        locals       -> next free register when declared, freed with their block
+        temporaries  -> stack allocated above the locals, freed after each expression
+
+        supported: var / const, if / while / for, return / break / continue, assignment (also compound),
+        Int / Double / Bool literals, arithmetic, comparison, logical and unary operators, ternary,
+        calls to other top level functions of the script
+        anything else (strings, globals, builtins, structs, closures...) is a CompileError
+    */
+    class Lowering
+    {
+    private:
+        struct Loop
+        {
+            std::vector<size_t> breaks;    // Jmps patched to loop end
+            std::vector<size_t> continues; // Jmps patched to condition / increment
+        };
+
+        FString sourcePath;
+        std::vector<FString> sourceLines;
+
+        Module *module = nullptr;
+        Function *fn = nullptr;
+
+        std::vector<std::unordered_map<FString, Reg>> scopes; // name -> register
+        std::vector<Loop> loops;
+        Reg nextReg = 0;
+        uint32_t maxReg = 0;
+
+        Ast::AstAddressInfo currentAAI;
+
+        [[noreturn]] void error(const FString &msg, Ast::AstBase ast);
+
+        size_t emit(Op op, Reg dst = 0, Reg a = 0, Reg b = 0, int64_t imm = 0);
+        size_t emitJump(Op op, Reg cond = 0);
+        void patchJump(size_t at);
+        void patchJumpTo(size_t at, size_t target);
+        int64_t addConstant(const Value &value);
+
+        Reg newReg(Ast::AstBase ast);
+        Reg declareLocal(const FString &name, Ast::AstBase ast);
+        Reg findLocal(const FString &name, Ast::AstBase ast);
+
+        void lowerFunction(const Ast::FunctionDef &def);
+        void lowerBlock(const std::vector<Ast::Statement> &stmts);
+        void lowerStatement(const Ast::Statement &stmt);
+        void lowerExpression(const Ast::Expression &exp, Reg dst); // result -> dst
+        void lowerBinary(const Ast::BinaryExpr &bin, Reg dst);
+
+    public:
+        Lowering(FString _sourcePath, std::vector<FString> _sourceLines) :
+            sourcePath(std::move(_sourcePath)), sourceLines(std::move(_sourceLines))
+        {
+        }
+
+        // every top level `func` of the script, other statements are ignored
+        Module lower(const std::vector<Ast::AstBase> &asts);
+    };
+}; // namespace Fig::IR
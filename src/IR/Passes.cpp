@@ -0,0 +1,369 @@
+#include <IR/Passes.hpp>
+
+#include <optional>
+
+namespace Fig::IR
+{
+    namespace
+    {
+        size_t jumpTarget(const std::vector<Inst> &code, size_t at)
+        {
+            return static_cast<size_t>(static_cast<int64_t>(at) + 1 + code[at].imm);
+        }
+
+        // first instruction of every basic block
+        std::vector<bool> findLeaders(const std::vector<Inst> &code)
+        {
+            std::vector<bool> leaders(code.size() + 1, false);
+            leaders[0] = true;
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                Op op = code[i].op;
+                if (isJump(op)) { leaders[jumpTarget(code, i)] = true; }
+                if (isJump(op) || op == Op::Ret) { leaders[i + 1] = true; }
+            }
+            return leaders;
+        }
+
+        // possible next instructions, code.size() means falling off the end
+        template <class Fn>
+        void forEachSuccessor(const std::vector<Inst> &code, size_t at, Fn &&fn)
+        {
+            Op op = code[at].op;
+            if (op == Op::Ret) return;
+            if (isJump(op)) fn(jumpTarget(code, at));
+            if (op != Op::Jmp) fn(at + 1);
+        }
+
+        struct RegSet
+        {
+            std::vector<uint64_t> words;
+
+            explicit RegSet(size_t regCount) : words((regCount + 63) / 64, 0) {}
+
+            bool test(Reg r) const { return (words[r / 64] >> (r % 64)) & 1; }
+            void set(Reg r) { words[r / 64] |= (uint64_t(1) << (r % 64)); }
+            void reset(Reg r) { words[r / 64] &= ~(uint64_t(1) << (r % 64)); }
+
+            bool merge(const RegSet &other)
+            {
+                bool changed = false;
+                for (size_t i = 0; i < words.size(); ++i)
+                {
+                    uint64_t w = words[i] | other.words[i];
+                    changed |= (w != words[i]);
+                    words[i] = w;
+                }
+                return changed;
+            }
+
+            bool operator==(const RegSet &other) const { return words == other.words; }
+        };
+
+        using Kind = std::optional<Value::Kind>; // nullopt: unknown
+
+        bool isNumeric(Kind k)
+        {
+            return k == Value::Kind::Int || k == Value::Kind::Double;
+        }
+
+        // kind of dst after `ins`, from the kinds of its operands
+        Kind resultKind(const Function &fn, const Inst &ins, const std::vector<Kind> &kinds)
+        {
+            switch (ins.op)
+            {
+                case Op::LoadImm: return Value::Kind::Int;
+                case Op::LoadConst: return fn.constants[ins.imm].kind;
+                case Op::Mov: return kinds[ins.a];
+                case Op::Eq:
+                case Op::Ne: return Value::Kind::Bool;
+                case Op::Not: return (kinds[ins.a] == Value::Kind::Bool ? Kind(Value::Kind::Bool) : std::nullopt);
+                case Op::Neg: return (isNumeric(kinds[ins.a]) ? kinds[ins.a] : std::nullopt);
+                default: break;
+            }
+            if (!isBinary(ins.op) || !isNumeric(kinds[ins.a]) || !isNumeric(kinds[ins.b])) return std::nullopt;
+            if (ins.op >= Op::Lt) return Value::Kind::Bool;
+            if (ins.op == Op::Div) return Value::Kind::Double;
+            bool bothInt = (kinds[ins.a] == Value::Kind::Int && kinds[ins.b] == Value::Kind::Int);
+            return (bothInt ? Value::Kind::Int : Value::Kind::Double);
+        }
+
+        // whether a pure `ins` can raise at runtime: anything but loads, moves, ==, != and operations on operands
+        // whose kinds are known to be accepted. Div and Mod by zero raise, so they always may
+        bool mayThrow(const Inst &ins, const std::vector<Kind> &kinds)
+        {
+            switch (ins.op)
+            {
+                case Op::LoadImm:
+                case Op::LoadConst:
+                case Op::Mov:
+                case Op::Eq:
+                case Op::Ne: return false;
+                case Op::Div:
+                case Op::Mod: return true;
+                case Op::Not: return kinds[ins.a] != Value::Kind::Bool;
+                case Op::Neg: return !isNumeric(kinds[ins.a]);
+                default: return !(isBinary(ins.op) && isNumeric(kinds[ins.a]) && isNumeric(kinds[ins.b]));
+            }
+        }
+
+        Inst makeLoad(Function &fn, Reg dst, const Value &value)
+        {
+            if (value.isInt()) { return Inst{Op::LoadImm, dst, 0, 0, value.i}; }
+
+            std::vector<Value> &constants = fn.constants;
+            for (size_t i = 0; i < constants.size(); ++i)
+            {
+                if (constants[i].kind == value.kind && constants[i] == value)
+                {
+                    return Inst{Op::LoadConst, dst, 0, 0, static_cast<int64_t>(i)};
+                }
+            }
+            constants.push_back(value);
+            return Inst{Op::LoadConst, dst, 0, 0, static_cast<int64_t>(constants.size() - 1)};
+        }
+
+        // drop Nops, jump offsets follow their targets
+        void compact(Function &fn)
+        {
+            std::vector<Inst> &code = fn.code;
+            std::vector<size_t> newIndex(code.size() + 1);
+            size_t n = 0;
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                newIndex[i] = n; // a removed target becomes the next kept instruction
+                if (code[i].op != Op::Nop) ++n;
+            }
+            newIndex[code.size()] = n;
+
+            std::vector<Inst> out;
+            out.reserve(n);
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                if (code[i].op == Op::Nop) continue;
+                Inst ins = code[i];
+                if (isJump(ins.op))
+                {
+                    ins.imm = static_cast<int64_t>(newIndex[jumpTarget(code, i)]) - static_cast<int64_t>(out.size()) - 1;
+                }
+                out.push_back(ins);
+            }
+            code = std::move(out);
+        }
+    }; // namespace
+
+    bool foldConstants(Function &fn)
+    {
+        std::vector<Inst> &code = fn.code;
+        std::vector<bool> leaders = findLeaders(code);
+        std::vector<std::optional<Value>> known(fn.regCount);
+        bool changed = false;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (leaders[i]) { std::fill(known.begin(), known.end(), std::nullopt); }
+
+            Inst &ins = code[i];
+            if (isBinary(ins.op) && known[ins.a] && known[ins.b])
+            {
+                try
+                {
+                    Value result = binaryOp(ins.op, *known[ins.a], *known[ins.b]);
+                    ins = makeLoad(fn, ins.dst, result);
+                    changed = true;
+                }
+                catch (const RuntimeError &)
+                {
+                    // keep it, the error belongs to runtime
+                }
+            }
+            else if (isUnary(ins.op) && known[ins.a])
+            {
+                try
+                {
+                    Value result = unaryOp(ins.op, *known[ins.a]);
+                    ins = makeLoad(fn, ins.dst, result);
+                    changed = true;
+                }
+                catch (const RuntimeError &)
+                {
+                }
+            }
+            else if (ins.op == Op::Br && known[ins.a] && known[ins.a]->isBool())
+            {
+                ins = (known[ins.a]->b ? Inst{Op::Nop, 0, 0, 0, 0} : Inst{Op::Jmp, 0, 0, 0, ins.imm});
+                changed = true;
+            }
+
+            switch (ins.op)
+            {
+                case Op::LoadImm: known[ins.dst] = Value::Int(ins.imm); break;
+                case Op::LoadConst: known[ins.dst] = fn.constants[ins.imm]; break;
+                case Op::Mov: known[ins.dst] = known[ins.a]; break;
+                default:
+                    if (writesDst(ins.op)) { known[ins.dst] = std::nullopt; }
+                    break;
+            }
+        }
+        return changed;
+    }
+
+    bool propagateCopies(Function &fn)
+    {
+        std::vector<Inst> &code = fn.code;
+        std::vector<bool> leaders = findLeaders(code);
+        std::vector<Reg> copyOf(fn.regCount, INVALID_REG); // dst -> src of the last Mov
+        bool changed = false;
+
+        auto forget = [&](Reg r) {
+            copyOf[r] = INVALID_REG;
+            for (Reg &src : copyOf)
+            {
+                if (src == r) src = INVALID_REG;
+            }
+        };
+        auto redirect = [&](Reg &r) {
+            if (copyOf[r] != INVALID_REG)
+            {
+                r = copyOf[r];
+                changed = true;
+            }
+        };
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (leaders[i]) { std::fill(copyOf.begin(), copyOf.end(), INVALID_REG); }
+
+            Inst &ins = code[i];
+            if (isBinary(ins.op))
+            {
+                redirect(ins.a);
+                redirect(ins.b);
+            }
+            else if (isUnary(ins.op) || ins.op == Op::Mov || ins.op == Op::Br
+                     || (ins.op == Op::Ret && ins.a != INVALID_REG))
+            {
+                redirect(ins.a);
+            }
+            // Call arguments stay in place, they must be consecutive
+
+            if (!writesDst(ins.op)) continue;
+            if (ins.op == Op::Mov && ins.dst == ins.a)
+            {
+                ins = Inst{Op::Nop, 0, 0, 0, 0};
+                changed = true;
+                continue;
+            }
+            forget(ins.dst);
+            if (ins.op == Op::Mov) { copyOf[ins.dst] = ins.a; }
+        }
+        return changed;
+    }
+
+    bool eliminateDeadCode(Function &fn)
+    {
+        std::vector<Inst> &code = fn.code;
+        bool changed = false;
+
+        // unreachable
+        std::vector<bool> reachable(code.size() + 1, false);
+        std::vector<size_t> work{0};
+        while (!work.empty())
+        {
+            size_t at = work.back();
+            work.pop_back();
+            if (at >= code.size() || reachable[at]) continue;
+            reachable[at] = true;
+            forEachSuccessor(code, at, [&](size_t next) { work.push_back(next); });
+        }
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (!reachable[i] && code[i].op != Op::Nop)
+            {
+                code[i] = Inst{Op::Nop, 0, 0, 0, 0};
+                changed = true;
+            }
+        }
+
+        // liveness, backwards until stable
+        std::vector<RegSet> liveIn(code.size() + 1, RegSet(fn.regCount));
+        bool stable = false;
+        while (!stable)
+        {
+            stable = true;
+            for (size_t i = code.size(); i-- > 0;)
+            {
+                const Inst &ins = code[i];
+                RegSet live(fn.regCount);
+                forEachSuccessor(code, i, [&](size_t next) { live.merge(liveIn[next]); });
+                if (writesDst(ins.op)) live.reset(ins.dst);
+                forEachUse(ins, [&](Reg r) { live.set(r); });
+                if (!(live == liveIn[i]))
+                {
+                    liveIn[i] = std::move(live);
+                    stable = false;
+                }
+            }
+        }
+
+        // operand kinds per basic block, an unused result is only dropped when its op cannot raise:
+        // the error belongs to runtime, as in foldConstants
+        std::vector<bool> leaders = findLeaders(code);
+        std::vector<Kind> kinds(fn.regCount);
+        std::vector<bool> throws(code.size(), true);
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (leaders[i]) { std::fill(kinds.begin(), kinds.end(), std::nullopt); }
+            const Inst &ins = code[i];
+            if (isPure(ins.op))
+            {
+                throws[i] = mayThrow(ins, kinds);
+                kinds[ins.dst] = resultKind(fn, ins, kinds);
+            }
+            else if (writesDst(ins.op))
+            {
+                kinds[ins.dst] = std::nullopt; // Call
+            }
+        }
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            Inst &ins = code[i];
+            bool dead = false;
+            if (isPure(ins.op) && !throws[i])
+            {
+                dead = true;
+                forEachSuccessor(code, i, [&](size_t next) { dead = dead && !liveIn[next].test(ins.dst); });
+            }
+            else if (ins.op == Op::Jmp && ins.imm == 0)
+            {
+                dead = true; // jump to the next instruction
+            }
+            if (dead)
+            {
+                ins = Inst{Op::Nop, 0, 0, 0, 0};
+                changed = true;
+            }
+        }
+
+        size_t before = code.size();
+        compact(fn);
+        return changed || code.size() != before;
+    }
+
+    void optimize(Function &fn)
+    {
+        bool changed = true;
+        while (changed)
+        {
+            changed = foldConstants(fn);
+            changed |= propagateCopies(fn);
+            changed |= eliminateDeadCode(fn);
+        }
+    }
+
+    void optimize(Module &module)
+    {
+        for (Function &fn : module.functions) { optimize(fn); }
+    }
+}; // namespace Fig::IR
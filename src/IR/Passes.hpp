@@ -0,0 +1,26 @@
+#pragma once
+
+#include <IR/IR.hpp>
+
+namespace Fig::IR
+{
+    /*
+        optimizer passes over one Function, each returns whether it changed the code
+
+        foldConstants      evaluates operators whose operands are known in the same basic block,
+                           branches on known conditions become Jmp / Nop
+        propagateCopies    reads of `Mov dst, src` results are redirected to src within a basic block
+        eliminateDeadCode  drops unreachable code and pure instructions whose result is never read and that
+                           cannot throw, then removes Nops and re-targets jumps
+
+        operations that would throw at runtime (division by zero, type errors) are never folded nor dropped,
+        so -O raises wherever the tree walker and VM raise
+    */
+    bool foldConstants(Function &fn);
+    bool propagateCopies(Function &fn);
+    bool eliminateDeadCode(Function &fn);
+
+    // runs the passes until nothing changes
+    void optimize(Function &fn);
+    void optimize(Module &module);
+}; // namespace Fig::IR
@@ -1,14 +1,133 @@
 #include <IR/IRInterpreter.hpp>
 #include <IR/IR.hpp>
+#include <IR/Lowering.hpp>
+#include <IR/Passes.hpp>
 
+#include <Lexer/lexer.hpp>
+#include <Parser/parser.hpp>
+#include <Utils/utils.hpp>
 
-int main()
+#include <chrono>
+#include <iostream>
+
+using namespace Fig;
+
+static const char *source = R"(
+func fib(x: Int) -> Int
+{
+    if (x <= 1)
+    {
+        return x;
+    }
+    return fib(x - 1) + fib(x - 2);
+}
+
+func sumTo(n: Int) -> Int
+{
+    var total := 0;
+    for (var i := 1; i <= n; i += 1)
+    {
+        if (i % 2 == 0 && i % 3 != 0) { continue; }
+        total += i;
+    }
+    return total;
+}
+
+func clamp(x, lo, hi)
+{
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+func folded()
+{
+    var a := 2 * 3 + 4;
+    var b := a;
+    var unused := b * 100;
+    if (a > 5 || false) { return -b / 4; }
+    return 0;
+}
+
+func power(base: Double, exp: Int) -> Double
+{
+    var result := 1.0;
+    while (exp > 0)
+    {
+        result *= base;
+        exp -= 1;
+    }
+    return result;
+}
+)";
+
+struct Case
+{
+    const char *fn;
+    std::vector<IR::Value> args;
+    IR::Value expected;
+};
+
+static int run(IR::Module &module, const std::vector<Case> &cases)
 {
-    using namespace Fig;
     IR::VirtualMachine vm;
+    vm.load(module);
+
+    int failed = 0;
+    for (const Case &c : cases)
+    {
+        IR::Value result = vm.execute(module.get(FString(std::string(c.fn))), c.args.data(), c.args.size());
+        bool ok = (result.kind == c.expected.kind && result == c.expected);
+        if (!ok) ++failed;
+        std::cout << (ok ? "  ok   " : "  FAIL ") << c.fn << " -> " << result.toString()
+                  << (ok ? "" : " expected " + c.expected.toString()) << "\n";
+    }
+    return failed;
+}
+
+int main()
+{
+    using IR::Value;
+
+    FString sourcePath(u8"<ir_test>");
+    std::vector<FString> sourceLines = Utils::splitSource(FString(std::string(source)));
+    Lexer lexer(FString(std::string(source)), sourcePath, sourceLines);
+    Ast::Arena arena;
+    Parser parser(lexer, sourcePath, sourceLines, arena);
+
+    IR::Lowering lowering(sourcePath, sourceLines);
+    IR::Module plain = lowering.lower(parser.parseAll());
+    IR::Module optimized = plain;
+    IR::optimize(optimized);
 
-    using namespace IR;
-    IR::Inst fib_ir[] = {
-        
+    for (size_t i = 0; i < plain.functions.size(); ++i)
+    {
+        std::cout << IR::dump(plain.functions[i]) << "-- optimized --\n" << IR::dump(optimized.functions[i]) << "\n";
+    }
+
+    std::vector<Case> cases{
+        {"fib", {Value::Int(20)}, Value::Int(6765)},
+        {"sumTo", {Value::Int(12)}, Value::Int(1 + 3 + 5 + 6 + 7 + 9 + 11 + 12)},
+        {"clamp", {Value::Int(-3), Value::Int(0), Value::Int(10)}, Value::Int(0)},
+        {"clamp", {Value::Int(42), Value::Int(0), Value::Int(10)}, Value::Int(10)},
+        {"clamp", {Value::Double(2.5), Value::Int(0), Value::Int(10)}, Value::Double(2.5)},
+        {"folded", {}, Value::Double(-2.5)},
+        {"power", {Value::Double(1.5), Value::Int(3)}, Value::Double(3.375)},
     };
-}
\ No newline at end of file
+
+    std::cout << "plain:\n";
+    int failed = run(plain, cases);
+    std::cout << "optimized:\n";
+    failed += run(optimized, cases);
+
+    IR::VirtualMachine vm;
+    vm.load(optimized);
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto start = Clock::now();
+    Value result = vm.execute(optimized.get(u8"fib"), {Value::Int(30)});
+    auto end = Clock::now();
+
+    std::cout << "fib(30) = " << result.toString() << ", cost: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms\n";
+
+    return (failed == 0 ? 0 : 1);
+}
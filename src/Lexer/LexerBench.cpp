@@ -0,0 +1,85 @@
+#include <Lexer/lexer.hpp>
+#include <Utils/utils.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Fig;
+
+/*
+    lexer throughput: every .fig file under a directory (default ExampleCodes) is tokenized `rounds` times
+    usage: LexerBench [dir] [rounds]
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct SourceFile
+{
+    FString path;
+    FString source;
+    std::vector<FString> lines;
+};
+
+int main(int argc, char **argv)
+{
+    std::filesystem::path dir = (argc > 1 ? argv[1] : "ExampleCodes");
+    size_t rounds = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200);
+
+    std::vector<SourceFile> files;
+    size_t bytes = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dir))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".fig") continue;
+
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        FString fsource(source);
+        files.push_back(SourceFile{FString(entry.path().string()), fsource, Utils::splitSource(fsource)});
+        bytes += source.size();
+    }
+    if (files.empty())
+    {
+        std::cerr << "no .fig files under " << dir.string() << "\n";
+        return 1;
+    }
+
+    size_t tokens = 0;
+    size_t illegal = 0;
+
+    auto start = Clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (const SourceFile &f : files)
+        {
+            Lexer lexer(f.source, f.path, f.lines);
+            for (;;)
+            {
+                Token tok = lexer.nextToken();
+                if (tok.getType() == TokenType::EndOfFile) break;
+                if (tok.getType() == TokenType::Illegal)
+                {
+                    ++illegal;
+                    break;
+                }
+                ++tokens;
+            }
+        }
+    }
+    auto end = Clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double megabytes = static_cast<double>(bytes * rounds) / (1024.0 * 1024.0);
+
+    std::cout << files.size() << " files, " << bytes << " bytes, " << rounds << " rounds\n";
+    std::cout << "  " << tokens << " tokens in " << seconds * 1000.0 << "ms\n";
+    std::cout << "  " << megabytes / seconds << " MB/s, " << static_cast<double>(tokens) / seconds / 1e6
+              << " Mtokens/s\n";
+    if (illegal > 0) std::cout << "  (" << illegal / rounds << " files stopped at an illegal token)\n";
+    return 0;
+}
@@ -3,8 +3,8 @@
 #include <Token/token.hpp>
 #include <Lexer/lexer.hpp>
 
-#include <Core/fig_string.hpp>
-#include <Utils/utils.hpp>
+#include <array>
+#include <cwctype>
 
 #if 0
     #include <iostream> // debug
@@ -16,124 +16,243 @@
 
 namespace Fig
 {
+    namespace
+    {
+        enum CharClass : uint8_t
+        {
+            Space = 1 << 0,
+            Digit = 1 << 1,
+            Alpha = 1 << 2,
+            Punct = 1 << 3,
+        };
+
+        // same answers as the <cwctype> classifiers in the "C" locale
+        constexpr std::array<uint8_t, 128> ASCII_CLASS = [] {
+            std::array<uint8_t, 128> table{};
+            for (char c : {' ', '\t', '\n', '\v', '\f', '\r'}) { table[c] = Space; }
+            for (int c = '0'; c <= '9'; ++c) { table[c] = Digit; }
+            for (int c = 'a'; c <= 'z'; ++c) { table[c] = Alpha; }
+            for (int c = 'A'; c <= 'Z'; ++c) { table[c] = Alpha; }
+            for (int c = 33; c < 127; ++c)
+            {
+                if (table[c] == 0) { table[c] = Punct; }
+            }
+            return table;
+        }();
+
+        uint8_t classOf(char32_t cp)
+        {
+            if (cp < 0x80) return ASCII_CLASS[cp];
+
+            wint_t wc = static_cast<wint_t>(cp);
+            return (std::iswspace(wc) ? Space : 0) | (std::iswdigit(wc) ? Digit : 0) | (std::iswalpha(wc) ? Alpha : 0)
+                   | (std::iswpunct(wc) ? Punct : 0);
+        }
+
+        size_t codePointCount(FStringView text)
+        {
+            return std::count_if(text.begin(), text.end(), [](char8_t c) { return (c & 0xC0) != 0x80; });
+        }
 
-    const std::unordered_map<FString, TokenType> Lexer::symbol_map{
-        // 三字符
-        {FString(u8"..."), TokenType::TripleDot},
-        // 双字符
-        {FString(u8"=="), TokenType::Equal},
-        {FString(u8"!="), TokenType::NotEqual},
-        {FString(u8"<="), TokenType::LessEqual},
-        {FString(u8">="), TokenType::GreaterEqual},
-        {FString(u8"<<"), TokenType::ShiftLeft},
-        {FString(u8">>"), TokenType::ShiftRight},
-        {FString(u8"+="), TokenType::PlusEqual},
-        {FString(u8"-="), TokenType::MinusEqual},
-        {FString(u8"*="), TokenType::AsteriskEqual},
-        {FString(u8"/="), TokenType::SlashEqual},
-        {FString(u8"%="), TokenType::PercentEqual},
-        {FString(u8"^="), TokenType::CaretEqual},
-        {FString(u8"++"), TokenType::DoublePlus},
-        {FString(u8"--"), TokenType::DoubleMinus},
-        {FString(u8"&&"), TokenType::DoubleAmpersand},
-        {FString(u8"||"), TokenType::DoublePipe},
-        {FString(u8":="), TokenType::Walrus},
-        {FString(u8"**"), TokenType::Power},
-        {FString(u8"->"), TokenType::RightArrow},
-        {FString(u8"=>"), TokenType::DoubleArrow},
-
-        // 单字符
-        {FString(u8"+"), TokenType::Plus},
-        {FString(u8"-"), TokenType::Minus},
-        {FString(u8"*"), TokenType::Asterisk},
-        {FString(u8"/"), TokenType::Slash},
-        {FString(u8"%"), TokenType::Percent},
-        {FString(u8"^"), TokenType::Caret},
-        {FString(u8"&"), TokenType::Ampersand},
-        {FString(u8"|"), TokenType::Pipe},
-        {FString(u8"~"), TokenType::Tilde},
-        {FString(u8"="), TokenType::Assign},
-        {FString(u8"<"), TokenType::Less},
-        {FString(u8">"), TokenType::Greater},
-        {FString(u8"."), TokenType::Dot},
-        {FString(u8","), TokenType::Comma},
-        {FString(u8":"), TokenType::Colon},
-        {FString(u8";"), TokenType::Semicolon},
-        {FString(u8"'"), TokenType::SingleQuote},
-        {FString(u8"\""), TokenType::DoubleQuote},
-        {FString(u8"("), TokenType::LeftParen},
-        {FString(u8")"), TokenType::RightParen},
-        {FString(u8"["), TokenType::LeftBracket},
-        {FString(u8"]"), TokenType::RightBracket},
-        {FString(u8"{"), TokenType::LeftBrace},
-        {FString(u8"}"), TokenType::RightBrace},
-        {FString(u8"?"), TokenType::Question},
-        {FString(u8"!"), TokenType::Not},
-    };
-
-    const std::unordered_map<FString, TokenType> Lexer::keyword_map{
-        {FString(u8"and"), TokenType::And},
-        {FString(u8"or"), TokenType::Or},
-        {FString(u8"not"), TokenType::Not},
-        {FString(u8"import"), TokenType::Import},
-        {FString(u8"func"), TokenType::Function},
-        {FString(u8"var"), TokenType::Variable},
-        {FString(u8"const"), TokenType::Const},
-        // {FString(u8"final"), TokenType::Final},
-        {FString(u8"while"), TokenType::While},
-        {FString(u8"for"), TokenType::For},
-        {FString(u8"if"), TokenType::If},
-        {FString(u8"else"), TokenType::Else},
-        {FString(u8"new"), TokenType::New},
-        {FString(u8"struct"), TokenType::Struct},
-        {FString(u8"interface"), TokenType::Interface},
-        {FString(u8"impl"), TokenType::Implement},
-        {FString(u8"is"), TokenType::Is},
-        {FString(u8"public"), TokenType::Public},
-        {FString(u8"return"), TokenType::Return},
-        {FString(u8"break"), TokenType::Break},
-        {FString(u8"continue"), TokenType::Continue},
-        {FString(u8"try"), TokenType::Try},
-        {FString(u8"catch"), TokenType::Catch},
-        {FString(u8"throw"), TokenType::Throw},
-        {FString(u8"Finally"), TokenType::Finally},
-        {FString(u8"as"), TokenType::As},
-
-        // {FString(u8"Null"), TokenType::TypeNull},
-        // {FString(u8"Int"), TokenType::TypeInt},
-        // {FString(u8"String"), TokenType::TypeString},
-        // {FString(u8"Bool"), TokenType::TypeBool},
-        // {FString(u8"Double"), TokenType::TypeDouble},
-    };
-    void Lexer::skipLine()
+        // symbols plus the prefixes that are not symbols themselves
+        bool isSymbolPrefix(FStringView text)
+        {
+            return Lexer::symbolType(text) != TokenType::Illegal || text == u8"..";
+        }
+    }; // namespace
+
+    TokenType Lexer::symbolType(FStringView text)
     {
-        while (*it != U'\n' and hasNext())
+        switch (text.size())
         {
-            next();
+            case 1:
+                switch (text[0])
+                {
+                    case u8'+': return TokenType::Plus;
+                    case u8'-': return TokenType::Minus;
+                    case u8'*': return TokenType::Asterisk;
+                    case u8'/': return TokenType::Slash;
+                    case u8'%': return TokenType::Percent;
+                    case u8'^': return TokenType::Caret;
+                    case u8'&': return TokenType::Ampersand;
+                    case u8'|': return TokenType::Pipe;
+                    case u8'~': return TokenType::Tilde;
+                    case u8'=': return TokenType::Assign;
+                    case u8'<': return TokenType::Less;
+                    case u8'>': return TokenType::Greater;
+                    case u8'.': return TokenType::Dot;
+                    case u8',': return TokenType::Comma;
+                    case u8':': return TokenType::Colon;
+                    case u8';': return TokenType::Semicolon;
+                    case u8'\'': return TokenType::SingleQuote;
+                    case u8'"': return TokenType::DoubleQuote;
+                    case u8'(': return TokenType::LeftParen;
+                    case u8')': return TokenType::RightParen;
+                    case u8'[': return TokenType::LeftBracket;
+                    case u8']': return TokenType::RightBracket;
+                    case u8'{': return TokenType::LeftBrace;
+                    case u8'}': return TokenType::RightBrace;
+                    case u8'?': return TokenType::Question;
+                    case u8'!': return TokenType::Not;
+                    default: return TokenType::Illegal;
+                }
+
+            case 2: {
+                char8_t second = text[1];
+                switch (text[0])
+                {
+                    case u8'=':
+                        if (second == u8'=') return TokenType::Equal;
+                        if (second == u8'>') return TokenType::DoubleArrow;
+                        break;
+                    case u8'!':
+                        if (second == u8'=') return TokenType::NotEqual;
+                        break;
+                    case u8'<':
+                        if (second == u8'=') return TokenType::LessEqual;
+                        if (second == u8'<') return TokenType::ShiftLeft;
+                        break;
+                    case u8'>':
+                        if (second == u8'=') return TokenType::GreaterEqual;
+                        if (second == u8'>') return TokenType::ShiftRight;
+                        break;
+                    case u8'+':
+                        if (second == u8'=') return TokenType::PlusEqual;
+                        if (second == u8'+') return TokenType::DoublePlus;
+                        break;
+                    case u8'-':
+                        if (second == u8'=') return TokenType::MinusEqual;
+                        if (second == u8'-') return TokenType::DoubleMinus;
+                        if (second == u8'>') return TokenType::RightArrow;
+                        break;
+                    case u8'*':
+                        if (second == u8'=') return TokenType::AsteriskEqual;
+                        if (second == u8'*') return TokenType::Power;
+                        break;
+                    case u8'/':
+                        if (second == u8'=') return TokenType::SlashEqual;
+                        break;
+                    case u8'%':
+                        if (second == u8'=') return TokenType::PercentEqual;
+                        break;
+                    case u8'^':
+                        if (second == u8'=') return TokenType::CaretEqual;
+                        break;
+                    case u8'&':
+                        if (second == u8'&') return TokenType::DoubleAmpersand;
+                        break;
+                    case u8'|':
+                        if (second == u8'|') return TokenType::DoublePipe;
+                        break;
+                    case u8':':
+                        if (second == u8'=') return TokenType::Walrus;
+                        break;
+                }
+                return TokenType::Illegal;
+            }
+
+            case 3: return (text == u8"..." ? TokenType::TripleDot : TokenType::Illegal);
+
+            default: return TokenType::Illegal;
         }
-        next(); // skip '\n'
-        ++line;
     }
+
+    TokenType Lexer::keywordType(FStringView text)
+    {
+        // by length first, then at most a handful of compares
+        switch (text.size())
+        {
+            case 2:
+                if (text == u8"or") return TokenType::Or;
+                if (text == u8"if") return TokenType::If;
+                if (text == u8"is") return TokenType::Is;
+                if (text == u8"as") return TokenType::As;
+                break;
+            case 3:
+                if (text == u8"var") return TokenType::Variable;
+                if (text == u8"for") return TokenType::For;
+                if (text == u8"and") return TokenType::And;
+                if (text == u8"not") return TokenType::Not;
+                if (text == u8"new") return TokenType::New;
+                if (text == u8"try") return TokenType::Try;
+                break;
+            case 4:
+                if (text == u8"func") return TokenType::Function;
+                if (text == u8"else") return TokenType::Else;
+                if (text == u8"impl") return TokenType::Implement;
+                break;
+            case 5:
+                if (text == u8"const") return TokenType::Const;
+                if (text == u8"while") return TokenType::While;
+                if (text == u8"break") return TokenType::Break;
+                if (text == u8"catch") return TokenType::Catch;
+                if (text == u8"throw") return TokenType::Throw;
+                break;
+            case 6:
+                if (text == u8"return") return TokenType::Return;
+                if (text == u8"import") return TokenType::Import;
+                if (text == u8"struct") return TokenType::Struct;
+                if (text == u8"public") return TokenType::Public;
+                break;
+            case 7:
+                if (text == u8"Finally") return TokenType::Finally;
+                break;
+            case 8:
+                if (text == u8"continue") return TokenType::Continue;
+                break;
+            case 9:
+                if (text == u8"interface") return TokenType::Interface;
+                break;
+        }
+        return TokenType::Illegal;
+    }
+
+    char32_t Lexer::codePointAt(size_t at, size_t &length) const
+    {
+        char8_t first = source[at];
+        length = ((first & 0xE0) == 0xC0 ? 2 : (first & 0xF0) == 0xE0 ? 3 : (first & 0xF8) == 0xF0 ? 4 : 1);
+        if (at + length > source.size())
+        {
+            length = source.size() - at;
+            return 0;
+        }
+
+        switch (length)
+        {
+            case 2: return ((first & 0x1F) << 6) | (source[at + 1] & 0x3F);
+            case 3: return ((first & 0x0F) << 12) | ((source[at + 1] & 0x3F) << 6) | (source[at + 2] & 0x3F);
+            case 4:
+                return ((first & 0x07) << 18) | ((source[at + 1] & 0x3F) << 12) | ((source[at + 2] & 0x3F) << 6)
+                       | (source[at + 3] & 0x3F);
+            default: return first;
+        }
+    }
+
     Token Lexer::scanIdentifier()
     {
-        FString identifier;
+        size_t start = pos;
 
         while (hasNext())
         {
-            UTF8Char c = *it;
-            if (c.isAlnum() || c == U'_')
+            char8_t c = source[pos];
+            if (c < 0x80)
             {
-                identifier += c.getString();
+                if (!(ASCII_CLASS[c] & (Alpha | Digit)) && c != u8'_') break;
                 next();
+                continue;
             }
-            else
-            {
-                break;
-            }
+
+            size_t length;
+            if (!(classOf(codePointAt(pos, length)) & (Alpha | Digit))) break;
+            while (length--) { next(); }
         }
-        if (this->keyword_map.contains(identifier))
+
+        FStringView identifier = view(start);
+
+        TokenType keyword = keywordType(identifier);
+        if (keyword != TokenType::Illegal)
         {
-            return Token(identifier, this->keyword_map.at(identifier));
+            return Token(identifier, keyword);
         }
         else if (identifier == u8"true" || identifier == u8"false")
         {
@@ -144,236 +263,128 @@ namespace Fig
             // null instance
             return Token(identifier, TokenType::LiteralNull);
         }
-        if (keyword_map.contains(Utils::toLower(identifier)))
+
+        char8_t lower[16];
+        if (identifier.size() <= sizeof(lower))
         {
-            pushWarning(1, identifier); // Identifier is too similar to a keyword or a primitive type
+            std::transform(identifier.begin(), identifier.end(), lower, [](char8_t c) {
+                return (c >= u8'A' && c <= u8'Z' ? static_cast<char8_t>(c - u8'A' + u8'a') : c);
+            });
+            if (keywordType(FStringView(lower, identifier.size())) != TokenType::Illegal)
+            {
+                pushWarning(1, FString(identifier)); // Identifier is too similar to a keyword or a primitive type
+            }
         }
-        if (identifier.length() <= 1)
+        if (codePointCount(identifier) <= 1)
         {
-            pushWarning(2, identifier); // The identifier is too abstract
+            pushWarning(2, FString(identifier)); // The identifier is too abstract
         }
-        return Token(identifier, TokenType::Identifier);
+        return Token(identifier, Symbol(identifier)); // interned once here, the AST keeps the Symbol
     }
     Token Lexer::scanString()
     {
-        FString str;
-        bool unterminated = true;
-        size_t str_start_col = it.column() - 1;
+        // escape free literals stay a view of the source, the first escape moves the text into `decoded`
+        size_t start = pos;
+        size_t segment = pos; // start of the bytes not copied into `out` yet
+        FString *out = nullptr;
+
+        size_t str_start_col = column - 1;
         while (hasNext())
         {
-            UTF8Char c = *it;
-            if (c == U'"')
+            char8_t c = source[pos];
+            if (c == u8'"')
             {
+                FStringView text;
+                if (out == nullptr) { text = view(start); }
+                else
+                {
+                    out->append(source, segment, pos - segment);
+                    text = FStringView(out->data(), out->size());
+                }
                 next();
-                unterminated = false;
-                break;
+                return Token(text, TokenType::LiteralString);
             }
-            else if (c == U'\\') // c is '\'
+            else if (c == u8'\\') // c is '\'
             {
-                if (it.isEnd())
-                {
-                    error = SyntaxError(u8"Unterminated FString", this->line, it.column(), SourceInfo(this));
-                    return IllegalTok;
-                }
+                if (out == nullptr) { out = &decoded.emplace_back(); }
+                out->append(source, segment, pos - segment);
+
                 next();
-                UTF8Char ec = *it;
-                if (ec == U'n')
-                {
-                    next();
-                    str += u8"\n";
-                }
-                else if (ec == U't')
-                {
-                    next();
-                    str += u8"\t";
-                }
-                else if (ec == U'v')
-                {
-                    next();
-                    str += u8"\v";
-                }
-                else if (ec == U'b')
-                {
-                    next();
-                    str += u8"\b";
-                }
-                else if (ec == U'"')
-                {
-                    next();
-                    str += u8"\"";
-                }
-                else if (ec == U'\'')
+                if (!hasNext())
                 {
-                    next();
-                    str += u8"'";
+                    error = SyntaxError(u8"Unterminated FString", this->line, column, SourceInfo(this));
+                    return IllegalTok;
                 }
-                else
+
+                char8_t ec = source[pos];
+                switch (ec)
                 {
-                    error = SyntaxError(FString(std::format("Unsupported escape character: {}",
-                                                            FString(ec.getString()).toBasicString())),
-                                        this->line,
-                                        it.column(),
-                                        SourceInfo(this));
-                    return IllegalTok;
+                    case u8'n': out->push_back(u8'\n'); break;
+                    case u8't': out->push_back(u8'\t'); break;
+                    case u8'v': out->push_back(u8'\v'); break;
+                    case u8'b': out->push_back(u8'\b'); break;
+                    case u8'"': out->push_back(u8'"'); break;
+                    case u8'\'': out->push_back(u8'\''); break;
+                    default: {
+                        size_t length;
+                        codePointAt(pos, length);
+                        error = SyntaxError(FString(std::format("Unsupported escape character: {}",
+                                                                FStringView(source.data() + pos, length).toBasicStringView())),
+                                            this->line,
+                                            column,
+                                            SourceInfo(this));
+                        return IllegalTok;
+                    }
                 }
-            }
-            else
-            {
-                str += c.getString();
-                next();
-            }
-        }
-        if (unterminated)
-        {
-            error = SyntaxError(u8"Unterminated FString", this->line, str_start_col, SourceInfo(this));
-            return IllegalTok;
-        }
-        return Token(str, TokenType::LiteralString);
-    }
-    Token Lexer::scanRawString()
-    {
-        FString str;
-        bool unterminated = true;
-        size_t str_start_col = it.column() - 1;
-        while (hasNext())
-        {
-            UTF8Char c = *it;
-            if (c == U'"' || c == U'\n')
-            {
                 next();
-                unterminated = false;
-                break;
+                segment = pos;
             }
             else
             {
-                str += c.getString();
                 next();
             }
         }
-        if (unterminated)
-        {
-            error = SyntaxError(u8"Unterminated FString", this->line, str_start_col, SourceInfo(this));
-            return IllegalTok;
-        }
-        return Token(str, TokenType::LiteralString);
+        error = SyntaxError(u8"Unterminated FString", this->line, str_start_col, SourceInfo(this));
+        return IllegalTok;
     }
-    Token Lexer::scanMultilineString()
+    Token Lexer::scanRawString()
     {
-        FString str;
-        bool unterminated = true;
-
-        uint8_t end = 0;
-        size_t str_start_col = it.column() - 1;
+        size_t start = pos;
+        size_t str_start_col = column - 1;
         while (hasNext())
         {
-            UTF8Char c = *it;
-            if (c == U'"')
+            char8_t c = source[pos];
+            if (c == u8'"' || c == u8'\n')
             {
-                if (end == 3)
-                {
-                    next();
-                    unterminated = false;
-                    break;
-                }
-                end++;
+                FStringView text = view(start);
                 next();
-                continue;
+                return Token(text, TokenType::LiteralString);
             }
-            else if (c == U'\\') // c is '\'
-            {
-                if (it.isEnd())
-                {
-                    error = SyntaxError(u8"Unterminated FString", this->line, it.column(), SourceInfo(this));
-                    return IllegalTok;
-                }
-                next();
-                UTF8Char ec = *it;
-                if (ec == U'n')
-                {
-                    next();
-                    str += u8"\n";
-                }
-                else if (ec == U't')
-                {
-                    next();
-                    str += u8"\t";
-                }
-                else if (ec == U'v')
-                {
-                    next();
-                    str += u8"\v";
-                }
-                else if (ec == U'b')
-                {
-                    next();
-                    str += u8"\b";
-                }
-                else if (ec == U'"')
-                {
-                    next();
-                    str += u8"\"";
-                }
-                else if (ec == U'\'')
-                {
-                    next();
-                    str += u8"'";
-                }
-                else if (ec == U'\\')
-                {
-                    next();
-                    str += u8"\\";
-                }
-                else
-                {
-                    error = SyntaxError(FString(std::format("Unsupported escape character: {}",
-                                                            FString(ec.getString()).toBasicString())),
-                                        this->line,
-                                        it.column(),
-                                        SourceInfo(this));
-                    return IllegalTok;
-                }
-            }
-            else
-            {
-                str += c.getString();
-            }
-            end = 0;
-        }
-        if (unterminated)
-        {
-            error = SyntaxError(u8"Unterminated FString", this->line, str_start_col, SourceInfo(this));
-            return IllegalTok;
+            next();
         }
-        return Token(str, TokenType::LiteralString);
+        error = SyntaxError(u8"Unterminated FString", this->line, str_start_col, SourceInfo(this));
+        return IllegalTok;
     }
     Token Lexer::scanNumber()
     {
-        FString numStr;
+        size_t start = pos;
         bool hasPoint = false;
 
         while (hasNext())
         {
-            UTF8Char ch = *it;
+            char8_t ch = source[pos];
 
-            if (ch.isDigit() || ch == U'e')
-            {
-                numStr += ch.getString();
-                next();
-            }
-            else if (ch == U'-' && !numStr.empty() && (numStr.ends_with(U'e') || numStr.ends_with(U'E')))
+            if ((ch < 0x80 && (ASCII_CLASS[ch] & Digit)) || ch == u8'e')
             {
-                numStr += ch.getString();
                 next();
             }
-            else if (ch == U'+' && !numStr.empty() && (numStr.ends_with(U'e') || numStr.ends_with(U'E')))
+            else if ((ch == u8'-' || ch == u8'+') && pos > start && source[pos - 1] == u8'e')
             {
-                numStr += ch.getString();
                 next();
             }
-            else if (ch == U'.' && !hasPoint)
+            else if (ch == u8'.' && !hasPoint)
             {
                 hasPoint = true;
-                numStr += ch.getString();
                 next();
             }
             else
@@ -381,251 +392,165 @@ namespace Fig
                 break;
             }
         }
+
+        FStringView numStr = view(start);
         if (numStr.empty()) { return IllegalTok; }
 
-        if (numStr.ends_with(U'e'))
-        {
-            error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
+        auto illegalNumber = [&]() {
+            error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicStringView())),
                                 this->line,
-                                it.column(),
+                                column,
                                 SourceInfo(this));
             return IllegalTok;
-        }
+        };
 
-        bool hasDigit = false;
-        for (auto it = numStr.begin(); it != numStr.end(); ++it)
-        {
-            if (isdigit(*it))
-            {
-                hasDigit = true;
-                break;
-            }
-        }
+        auto isDigit = [](char8_t c) { return c >= u8'0' && c <= u8'9'; };
 
-        if (!hasDigit)
-        {
-            error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                this->line,
-                                it.column(),
-                                SourceInfo(this));
-            return IllegalTok;
-        }
+        if (numStr.back() == u8'e') { return illegalNumber(); }
+        if (std::none_of(numStr.begin(), numStr.end(), isDigit)) { return illegalNumber(); }
 
-        size_t ePos = numStr.find(U'e');
-        if (ePos != FString::npos)
+        size_t ePos = numStr.find(u8'e');
+        if (ePos != FStringView::npos)
         {
-            if (ePos == 0)
-            {
-                error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                    this->line,
-                                    it.column(),
-                                    SourceInfo(this));
-                return IllegalTok;
-            }
-            if (ePos + 1 >= numStr.length())
-            {
-                error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                    this->line,
-                                    it.column(),
-                                    SourceInfo(this));
-                return IllegalTok;
-            }
+            if (ePos == 0 || ePos + 1 >= numStr.size()) { return illegalNumber(); }
+
             bool hasDigitAfterE = false;
-            for (size_t i = ePos + 1; i < numStr.length(); ++i)
+            for (size_t i = ePos + 1; i < numStr.size(); ++i)
             {
-                UTF8Char c = std::u8string(1,numStr[i]);
-                if (c == U'+' || c == U'-')
+                char8_t c = numStr[i];
+                if (c == u8'+' || c == u8'-')
                 {
-                    if (i != ePos + 1)
-                    {
-                        error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                            this->line,
-                                            it.column(),
-                                            SourceInfo(this));
-                        return IllegalTok;
-                    }
+                    if (i != ePos + 1) { return illegalNumber(); }
                     continue;
                 }
 
-                if (c.isDigit()) { hasDigitAfterE = true; }
+                if (isDigit(c)) { hasDigitAfterE = true; }
                 else
                 {
-                    error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                        this->line,
-                                        it.column(),
-                                        SourceInfo(this));
-                    return IllegalTok;
+                    return illegalNumber();
                 }
             }
 
-            if (!hasDigitAfterE)
-            {
-                error = SyntaxError(FString(std::format("Illegal number literal: {}", numStr.toBasicString())),
-                                    this->line,
-                                    it.column(),
-                                    SourceInfo(this));
-                return IllegalTok;
-            }
+            if (!hasDigitAfterE) { return illegalNumber(); }
         }
 
         return Token(numStr, TokenType::LiteralNumber);
     }
     Token Lexer::scanSymbol()
     {
-        FString sym;
-        UTF8Char ch = *it;
-        sym += ch.getString();
-
-        auto startsWith = [&](const FString &prefix) -> bool {
-            for (const auto &p : symbol_map)
-            {
-                const FString &op = p.first;
-                if (op.starts_with(prefix))
-                    return true;
-            }
-            return false;
-        };
+        size_t start = pos;
 
-        if (!startsWith(sym))
+        size_t length;
+        codePointAt(pos, length);
+        if (!isSymbolPrefix(FStringView(source.data() + start, length)))
         {
-            error = SyntaxError(FString(std::format("No such operator: {}", sym.toBasicString())),
+            error = SyntaxError(FString(std::format("No such operator: {}",
+                                                    FStringView(source.data() + start, length).toBasicStringView())),
                                 this->line,
-                                it.column(),
+                                column,
                                 SourceInfo(this));
-            next();
+            while (length--) { next(); }
             return IllegalTok;
         }
+        next(); // symbols are ASCII
 
+        // longest prefix of some operator
         while (hasNext())
         {
-            UTF8Char peek = it.peek();
-            if (!peek.isPunct())
-                break;
+            char8_t peek = source[pos];
+            if (peek >= 0x80 || !(ASCII_CLASS[peek] & Punct)) break;
 
-            FString candidate = sym + FString(peek.getString());
-
-            if (startsWith(candidate))
-            {
-                next();
-                sym = candidate;
-            }
-            else
-            {
-                break;
-            }
+            if (!isSymbolPrefix(FStringView(source.data() + start, pos + 1 - start))) break;
+            next();
         }
 
-        if (!symbol_map.contains(sym))
+        FStringView sym = view(start);
+        TokenType type = symbolType(sym);
+        if (type == TokenType::Illegal)
         {
-            error = SyntaxError(FString(std::format("No such operator: {}", sym.toBasicString())),
+            error = SyntaxError(FString(std::format("No such operator: {}", sym.toBasicStringView())),
                                 this->line,
-                                it.column(),
+                                column,
                                 SourceInfo(this));
-            next();
             return IllegalTok;
         }
-        // std::cerr << Token(sym, symbol_map.at(sym)).toString().toBasicString() << '\n;
-        next();
-        return Token(sym, symbol_map.at(sym));
+        return Token(sym, type);
     }
 
-    Token Lexer::scanComments()
+    void Lexer::skipComments()
     {
-        // entry: when iterator current char is '/' and peek is '/' or '*'
-        // current char is '/'
-        FString comment;
-
-        if (it.peek() == U'/') // single-line comment
+        // entry: current char is '/' and the next one is '/' or '*'
+        if (peekByte(1) == u8'/') // single-line comment
         {
             next(); // skip first '/'
             next(); // skip second '/'
 
-            UTF8Char c = *it;
-            while (c != U'\n' and hasNext())
-            {
-                comment += c.getString();
-                next();
-                c = *it;
-            }
-
-            if (hasNext() && c == U'\n')
-            {
-                next();
-            }
+            while (hasNext() && source[pos] != u8'\n') { next(); }
+            if (hasNext()) { next(); } // skip '\n'
         }
         else // multi-line comment
         {
             next(); // skip '/'
             next(); // skip '*'
 
-            UTF8Char c = *it;
-            bool terminated = false;
-
             while (hasNext())
             {
-                if (c == U'*' and hasNext() and it.peek() == U'/')
+                if (source[pos] == u8'*' && peekByte(1) == u8'/')
                 {
                     next(); // skip '*'
                     next(); // skip '/'
-                    terminated = true;
-                    break;
+                    return;
                 }
-                else
-                {
-                    comment += c.getString();
-                    next();
-                    c = *it;
-                }
-            }
-
-            if (!terminated)
-            {
-                error =
-                    SyntaxError(FString(u8"Unterminated multiline comment"), this->line, it.column(), SourceInfo(this));
                 next();
-                return IllegalTok;
             }
-        }
 
-        return Token(comment, TokenType::Comments);
+            // reported but not raised, the token stream just ends here
+            error = SyntaxError(FString(u8"Unterminated multiline comment"), this->line, column, SourceInfo(this));
+        }
     }
     Token Lexer::nextToken()
     {
-        if (!hasNext())
+        // comments are skipped here to avoid some stupid bugs
+        for (;;)
         {
-            return EOFTok;
-        }
-        UTF8Char ch = *it;
-        while (ch.isSpace())
-        {
-            next();
-            ch = *it;
             if (!hasNext())
             {
-                return EOFTok.setPos(getCurrentLine(), getCurrentColumn());
+                return EOFTok;
             }
-        }
-        last_line = getCurrentLine();
-        last_column = getCurrentColumn();
-        if (ch == U'/')
-        {
-            UTF8Char c{u8""};
-            if (!hasNext())
+
+            for (;;)
             {
-                next();
-                return Token(u8"/", this->symbol_map.at(u8"/")).setPos(last_line, last_column);
+                char8_t c = source[pos];
+                size_t length = 1;
+                if (c < 0x80)
+                {
+                    if (!(ASCII_CLASS[c] & Space)) break;
+                }
+                else if (!(classOf(codePointAt(pos, length)) & Space))
+                {
+                    break;
+                }
+
+                while (length--) { next(); }
+                if (!hasNext())
+                {
+                    return EOFTok.setPos(getCurrentLine(), getCurrentColumn());
+                }
             }
-            c = it.peek();
-            if (c != U'/' and c != U'*')
+
+            if (source[pos] == u8'/' && (peekByte(1) == u8'/' || peekByte(1) == u8'*'))
             {
-                next();
-                return Token(u8"/", this->symbol_map.at(u8"/")).setPos(last_line, last_column);
+                skipComments();
+                continue;
             }
-            scanComments().setPos(last_line, last_column);
-            return nextToken();
-            // now we ignore comments to avoid some stupid bugs
+            break;
         }
-        if (ch == U'r' and hasNext() and it.peek() == U'"')
+
+        last_line = getCurrentLine();
+        last_column = getCurrentColumn();
+
+        char8_t ch = source[pos];
+        if (ch == u8'r' && peekByte(1) == u8'"')
         {
             // r""
             // raw FString
@@ -633,36 +558,36 @@ namespace Fig
             next();
             return scanRawString().setPos(last_line, last_column);
         }
-        if (ch.isAlpha() || ch == U'_')
-        {
-            return scanIdentifier().setPos(last_line, last_column);
-        }
-        else if (ch == U'"')
+        if (ch == u8'"')
         {
             next();
             return scanString().setPos(last_line, last_column);
         }
-        else if (ch.isDigit())
+
+        size_t length = 1;
+        uint8_t cls = (ch < 0x80 ? ASCII_CLASS[ch] : classOf(codePointAt(pos, length)));
+        if ((cls & Alpha) || ch == u8'_')
+        {
+            return scanIdentifier().setPos(last_line, last_column);
+        }
+        else if (cls & Digit)
         {
             return scanNumber().setPos(last_line, last_column);
         }
-        else if (ch.isPunct())
+        else if (cls & Punct)
         {
             return scanSymbol().setPos(last_line, last_column);
         }
         else
         {
-            error =
-                SyntaxError(FString(std::format("Cannot tokenize char: '{}'", FString(ch.getString()).toBasicString())),
-                            this->line,
-                            it.column(),
-                            SourceInfo(this));
-            if (hasNext())
-            {
-                next();
-            }
+            error = SyntaxError(FString(std::format("Cannot tokenize char: '{}'",
+                                                    FStringView(source.data() + pos, length).toBasicStringView())),
+                                this->line,
+                                column,
+                                SourceInfo(this));
+            while (length--) { next(); }
             return IllegalTok.setPos(last_line, last_column);
         }
     }
 
-} // namespace Fig
\ No newline at end of file
+} // namespace Fig
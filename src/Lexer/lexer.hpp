@@ -1,27 +1,32 @@
 #pragma once
 
 // #include <corecrt.h>
-#include <cuchar>
-#include <cwctype>
-#include <unordered_map>
+#include <deque>
 #include <vector>
 
 #include <Token/token.hpp>
 #include <Error/error.hpp>
 #include <Core/fig_string.hpp>
-#include <Core/utf8_iterator.hpp>
 #include <Core/warning.hpp>
 
 namespace Fig
 {
 
+    /*
+        byte level scanner over the source buffer
+        ASCII goes through a character class table, only non-ASCII bytes are decoded. identifiers, numbers,
+        symbols and escape free strings are views into `source`, a string literal with escapes is decoded once
+        into `decoded`. nothing is allocated per character or per token
+    */
     class Lexer final
     {
     private:
         size_t line;
         const FString source;
         SyntaxError error;
-        UTF8Iterator it;
+        size_t pos = 0; // byte offset into source, an offset so a copied Lexer stays valid
+
+        std::deque<FString> decoded; // unescaped string literals, deque: tokens keep pointing into it
 
         FString sourcePath;
         std::vector<FString> sourceLines;
@@ -30,24 +35,37 @@ namespace Fig
 
         size_t last_line, last_column, column = 1;
 
-        bool hasNext()
+        bool hasNext() const
+        {
+            return pos < source.size();
+        }
+
+        char8_t peekByte(size_t ahead = 0) const
+        {
+            return (pos + ahead < source.size() ? source[pos + ahead] : u8'\0');
+        }
+
+        // code point at pos, `length` gets its byte length
+        char32_t codePointAt(size_t at, size_t &length) const;
+
+        FStringView view(size_t start) const
         {
-            return !this->it.isEnd();
+            return FStringView(source.data() + start, pos - start);
         }
 
-        void skipLine();
+        // one byte, columns count code points
         inline void next()
         {
-            if (*it == U'\n')
+            char8_t c = source[pos++];
+            if (c == u8'\n')
             {
                 ++this->line;
                 this->column = 1;
             }
-            else
+            else if ((c & 0xC0) != 0x80)
             {
                 ++this->column;
             }
-            ++it;
         }
 
         void pushWarning(size_t id, FString msg)
@@ -60,11 +78,12 @@ namespace Fig
         }
 
     public:
-        static const std::unordered_map<FString, TokenType> symbol_map;
-        static const std::unordered_map<FString, TokenType> keyword_map;
+        // TokenType::Illegal when `text` is not an operator / keyword
+        static TokenType symbolType(FStringView text);
+        static TokenType keywordType(FStringView text);
 
         inline Lexer(const FString &_source, const FString &_sourcePath, const std::vector<FString> &_sourceLines) :
-            source(_source), it(source), sourcePath(_sourcePath), sourceLines(_sourceLines)
+            source(_source), sourcePath(_sourcePath), sourceLines(_sourceLines)
         {
             line = 1;
         }
@@ -89,9 +108,8 @@ namespace Fig
         Token scanNumber();
         Token scanString();
         Token scanRawString();
-        Token scanMultilineString();
         Token scanIdentifier();
         Token scanSymbol();
-        Token scanComments();
+        void skipComments();
     };
 } // namespace Fig
\ No newline at end of file
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "MappedFile.hpp"
+
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace Fig::CppLibrary
@@ -13,6 +20,11 @@ namespace Fig::CppLibrary
     {
         FileIDType id;
         std::fstream *fs;
+
+        MappedFile *map = nullptr; // set by MapFile, reads then come from the mapping and `fs` stays closed
+        size_t mapPos = 0;
+
+        bool isOpen() const { return map != nullptr ? map->isOpen() : fs->is_open(); }
     };
     class FileManager
     {
@@ -22,9 +34,27 @@ namespace Fig::CppLibrary
 
         FileIDType allocated = 0;
 
+        // shared read buffer, grows to the largest read and is reused after. not zero filled
+        std::unique_ptr<char[]> scratch;
+        size_t scratchSize = 0;
+        std::string line;
+
+        char *Scratch(size_t n)
+        {
+            if (scratchSize < n)
+            {
+                size_t size = std::max(n, scratchSize * 2);
+                std::unique_ptr<char[]> grown(new char[size]);
+                if (scratchSize != 0) std::memcpy(grown.get(), scratch.get(), scratchSize);
+                scratch = std::move(grown);
+                scratchSize = size;
+            }
+            return scratch.get();
+        }
+
     public:
         static constexpr FileIDType MAX_HANDLERS = std::numeric_limits<FileIDType>::max();
-        static constexpr unsigned int MAX_FILE_BUF = 961200; // bytes
+        static constexpr size_t MAX_FILE_BUF = 961200; // bytes, `read(n)` above this is still served, just in pieces of the stream
 
         FileIDType AllocFile(std::fstream *fs)
         {
@@ -41,6 +71,7 @@ namespace Fig::CppLibrary
             if (f == nullptr) { return; }
             f->fs->close();
             delete f->fs;
+            delete f->map;
             delete f;
             free_handlers.push_back(id);
             handlers[id] = nullptr;
@@ -59,6 +90,106 @@ namespace Fig::CppLibrary
             return handlers[AllocFile(new std::fstream)];
         }
 
+        File *MapFile(const std::string &path)
+        {
+            File *f = GetNextFreeFile();
+            f->map = new MappedFile;
+            f->map->open(path); // failure shows up as !isOpen()
+            f->mapPos = 0;
+            return f;
+        }
+
+        // bytes left from the current position, -1 when unknown (closed / not seekable)
+        int64_t Remaining(File *f)
+        {
+            if (f->map != nullptr) return static_cast<int64_t>(f->map->size() - f->mapPos);
+
+            std::fstream &fs = *f->fs;
+            fs.clear(); // a previous short read left eof set, tellg would fail
+            std::streampos pos = fs.tellg();
+            if (pos == std::streampos(-1)) return -1;
+            fs.seekg(0, std::ios::end);
+            std::streampos end = fs.tellg();
+            fs.seekg(pos);
+            if (end == std::streampos(-1)) return -1;
+            return static_cast<int64_t>(end - pos);
+        }
+
+        int64_t Size(File *f)
+        {
+            if (f->map != nullptr) return static_cast<int64_t>(f->map->size());
+
+            std::fstream &fs = *f->fs;
+            fs.clear();
+            std::streampos pos = fs.tellg();
+            if (pos == std::streampos(-1)) return -1;
+            fs.seekg(0, std::ios::end);
+            std::streampos end = fs.tellg();
+            fs.seekg(pos);
+            return end == std::streampos(-1) ? -1 : static_cast<int64_t>(end);
+        }
+
+        /*
+            the views below point into the mapping or into the shared scratch buffer,
+            valid until the next read on any file
+        */
+
+        // at most n bytes, fewer at end of file
+        std::string_view ReadBytes(File *f, size_t n)
+        {
+            if (f->map != nullptr)
+            {
+                std::string_view bytes = f->map->view().substr(f->mapPos, n);
+                f->mapPos += bytes.size();
+                return bytes;
+            }
+            if (n > MAX_FILE_BUF)
+            {
+                int64_t remaining = Remaining(f); // don't size the buffer for bytes that aren't there
+                if (remaining >= 0) n = std::min(n, static_cast<size_t>(remaining));
+            }
+            char *buf = Scratch(n);
+            f->fs->read(buf, static_cast<std::streamsize>(n));
+            return std::string_view(buf, static_cast<size_t>(f->fs->gcount()));
+        }
+
+        // everything from the current position, sized up front instead of grown block by block
+        std::string_view ReadAll(File *f)
+        {
+            if (f->map != nullptr) return ReadBytes(f, f->map->size() - f->mapPos);
+
+            int64_t remaining = Remaining(f);
+            if (remaining >= 0) return ReadBytes(f, static_cast<size_t>(remaining));
+
+            // not seekable: fall back to filling fixed blocks
+            size_t size = 0;
+            for (;;)
+            {
+                char *buf = Scratch(size + MAX_FILE_BUF);
+                f->fs->read(buf + size, MAX_FILE_BUF);
+                size += static_cast<size_t>(f->fs->gcount());
+                if (!*f->fs) break;
+            }
+            return std::string_view(scratch.get(), size);
+        }
+
+        // next line without its '\n', false at end of file
+        bool ReadLine(File *f, std::string_view &out)
+        {
+            if (f->map != nullptr)
+            {
+                std::string_view rest = f->map->view().substr(f->mapPos);
+                if (rest.empty()) return false;
+                size_t nl = rest.find('\n');
+                out = rest.substr(0, nl);
+                f->mapPos += (nl == std::string_view::npos ? rest.size() : nl + 1);
+                return true;
+            }
+            if (!std::getline(*f->fs, line)) return false;
+            out = line;
+            return true;
+        }
+
         File *GetFile(FileIDType id)
         {
             assert(id < allocated && "GetFile: id out of range");
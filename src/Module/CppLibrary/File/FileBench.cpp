@@ -0,0 +1,160 @@
+#include <Core/String.hpp>
+#include <Module/CppLibrary/File/File.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace Fig;
+using namespace Fig::CppLibrary;
+
+/*
+    std.file throughput on one large log file, every read produces a runtime String like the builtins do
+    usage: FileBench [file] [megabytes]
+        without a file, a log of `megabytes` (default 512) is written to the temp directory first
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+static size_t sink = 0; // keeps the reads alive
+
+static std::filesystem::path writeLog(size_t megabytes)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "fig_filebench.log";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+    size_t target = megabytes * 1024 * 1024;
+    size_t written = 0;
+    std::string line;
+    for (size_t i = 0; written < target; ++i)
+    {
+        line = "2026-01-23 01:30:46.";
+        line += std::to_string(100000 + i % 900000);
+        line += (i % 7 == 0 ? " WARN " : " INFO ");
+        line += "[worker-" + std::to_string(i % 16) + "] request ";
+        line += std::to_string(i);
+        line += " served in " + std::to_string(i % 997) + "us, status=200 path=/api/v1/items/";
+        line += std::to_string(i * 31 % 100003);
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        written += line.size();
+    }
+    return path;
+}
+
+template <class Fn>
+static void bench(const char *what, size_t bytes, Fn &&fn)
+{
+    auto start = Clock::now();
+    size_t items = fn();
+    auto end = Clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << "  " << what << ": " << seconds * 1000.0 << "ms, " << megabytes / seconds << " MB/s (" << items
+              << " strings)\n";
+}
+
+int main(int argc, char **argv)
+{
+    std::filesystem::path path = (argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path());
+    size_t megabytes = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 512);
+    bool generated = path.empty();
+    if (generated) path = writeLog(megabytes);
+
+    size_t bytes = std::filesystem::file_size(path);
+    std::cout << path.string() << ": " << bytes << " bytes\n";
+
+    FileManager &fm = FileManager::getInstance();
+    std::string p = path.string();
+
+    auto openFile = [&] {
+        File *f = fm.GetNextFreeFile();
+        f->fs->open(p, std::ios::in | std::ios::binary);
+        return f;
+    };
+
+    // what __fstdfile_read used to do: a fresh fixed block per call, string cut at the first NUL
+    bench("old fixed block", bytes, [&] {
+        File *f = openFile();
+        size_t n = 0;
+        while (*f->fs)
+        {
+            char *buf = new char[FileManager::MAX_FILE_BUF + 1]();
+            f->fs->read(buf, FileManager::MAX_FILE_BUF);
+            String s(buf);
+            sink += s.length();
+            delete[] buf;
+            ++n;
+        }
+        fm.CloseFile(f->id);
+        return n;
+    });
+
+    bench("readBytes(1MB)", bytes, [&] {
+        File *f = openFile();
+        size_t n = 0;
+        for (;;)
+        {
+            std::string_view chunk = fm.ReadBytes(f, 1024 * 1024);
+            if (chunk.empty()) break;
+            String s(chunk.data(), chunk.size());
+            sink += s.length();
+            ++n;
+        }
+        fm.CloseFile(f->id);
+        return n;
+    });
+
+    bench("read (stream)", bytes, [&] {
+        File *f = openFile();
+        std::string_view all = fm.ReadAll(f);
+        String s(all.data(), all.size());
+        sink += s.length();
+        fm.CloseFile(f->id);
+        return size_t(1);
+    });
+
+    bench("read (mapped)", bytes, [&] {
+        File *f = fm.MapFile(p);
+        std::string_view all = fm.ReadAll(f);
+        String s(all.data(), all.size());
+        sink += s.length();
+        fm.CloseFile(f->id);
+        return size_t(1);
+    });
+
+    bench("readLine (stream)", bytes, [&] {
+        File *f = openFile();
+        size_t n = 0;
+        std::string_view line;
+        while (fm.ReadLine(f, line))
+        {
+            String s(line.data(), line.size());
+            sink += s.length();
+            ++n;
+        }
+        fm.CloseFile(f->id);
+        return n;
+    });
+
+    bench("readLine (mapped)", bytes, [&] {
+        File *f = fm.MapFile(p);
+        size_t n = 0;
+        std::string_view line;
+        while (fm.ReadLine(f, line))
+        {
+            String s(line.data(), line.size());
+            sink += s.length();
+            ++n;
+        }
+        fm.CloseFile(f->id);
+        return n;
+    });
+
+    if (generated) std::filesystem::remove(path);
+    return sink == 0 ? 1 : 0;
+}
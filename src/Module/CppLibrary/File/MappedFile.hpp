@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX // std::min / std::max
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Fig::CppLibrary
+{
+    /*
+        MappedFile
+        read-only mapping of a whole file, the bytes are read straight out of the page cache.
+        an empty file maps to an empty view (mmap refuses length 0)
+    */
+    class MappedFile
+    {
+    private:
+        const char *data = nullptr;
+        size_t length = 0;
+        bool mapped = false;
+
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() { close(); }
+
+        bool open(const std::string &path)
+        {
+            close();
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                close();
+                return false;
+            }
+            length = static_cast<size_t>(size.QuadPart);
+            if (length != 0)
+            {
+                mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping == nullptr)
+                {
+                    close();
+                    return false;
+                }
+                data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                if (data == nullptr)
+                {
+                    close();
+                    return false;
+                }
+            }
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                ::close(fd);
+                return false;
+            }
+            length = static_cast<size_t>(st.st_size);
+            if (length != 0)
+            {
+                void *p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED)
+                {
+                    ::close(fd);
+                    length = 0;
+                    return false;
+                }
+                ::madvise(p, length, MADV_SEQUENTIAL); // lines are read front to back
+                data = static_cast<const char *>(p);
+            }
+            ::close(fd); // the mapping keeps the file alive
+#endif
+            mapped = true;
+            return true;
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (data != nullptr) UnmapViewOfFile(data);
+            if (mapping != nullptr) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (data != nullptr) ::munmap(const_cast<char *>(data), length);
+#endif
+            data = nullptr;
+            length = 0;
+            mapped = false;
+        }
+
+        bool isOpen() const { return mapped; }
+        size_t size() const { return length; }
+        std::string_view view() const { return std::string_view(data, length); }
+    };
+}; // namespace Fig::CppLibrary
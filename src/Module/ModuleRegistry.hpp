@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Ast/AstArena.hpp>
+#include <Core/fig_string.hpp>
+#include <Evaluator/Context/context_forward.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        ModuleRegistry
+        process wide table of evaluated modules, keyed by canonical path
+
+        a module body runs once, later imports share its Context. a module that is requested again while
+        its body is still running is a circular import. with reevaluate set (REPL) every import reads,
+        parses and runs the file again
+
+        the parsed trees (Ast::Arena) of every module ever loaded are kept until exit, not per entry:
+        Functions and StructTypes made by a module body point into its tree and may outlive the entry
+    */
+    class ModuleRegistry
+    {
+    public:
+        enum class State : uint8_t
+        {
+            Loading,
+            Loaded,
+        };
+
+    private:
+        struct Entry
+        {
+            State state;
+            ContextPtr ctx;
+        };
+
+        std::unordered_map<FString, Entry> modules;
+        std::vector<FString> loading; // import chain, for the circular import message
+
+        std::vector<std::unique_ptr<Ast::Arena>> trees;
+
+        bool reevaluate = false;
+
+    public:
+        static ModuleRegistry &getInstance()
+        {
+            static ModuleRegistry registry;
+            return registry;
+        }
+
+        static FString key(const std::filesystem::path &path)
+        {
+            std::error_code ec;
+            std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+            return FString((ec ? path : canonical).string());
+        }
+
+        void setReevaluate(bool _reevaluate) { reevaluate = _reevaluate; }
+        bool isReevaluate() const { return reevaluate; }
+
+        // nullptr when the module has to be (re)evaluated
+        ContextPtr find(const FString &key) const
+        {
+            if (reevaluate) return nullptr;
+            auto it = modules.find(key);
+            if (it == modules.end() || it->second.state != State::Loaded) return nullptr;
+            return it->second.ctx;
+        }
+
+        bool isLoading(const FString &key) const
+        {
+            auto it = modules.find(key);
+            return it != modules.end() && it->second.state == State::Loading;
+        }
+
+        // "a -> b -> a"
+        FString importChain(const FString &key) const
+        {
+            FString chain;
+            for (const FString &k : loading)
+            {
+                chain.append(k);
+                chain.append(u8" -> ");
+            }
+            chain.append(key);
+            return chain;
+        }
+
+        void beginLoading(const FString &key)
+        {
+            modules[key] = Entry{State::Loading, nullptr};
+            loading.push_back(key);
+        }
+
+        void finishLoading(const FString &key, ContextPtr ctx)
+        {
+            modules[key] = Entry{State::Loaded, std::move(ctx)};
+            std::erase(loading, key);
+        }
+
+        void keepTree(std::unique_ptr<Ast::Arena> arena) { trees.push_back(std::move(arena)); }
+
+        // body failed, the next import starts over
+        void abortLoading(const FString &key)
+        {
+            modules.erase(key);
+            std::erase(loading, key);
+        }
+
+        void clear()
+        {
+            modules.clear();
+            loading.clear();
+        }
+    };
+}; // namespace Fig
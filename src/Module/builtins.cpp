@@ -4,6 +4,7 @@
 #include <Ast/Expressions/VarExpr.hpp>
 #include <Ast/Statements/ControlSt.hpp>
 #include <Ast/astBase.hpp>
+#include <Ast/AstArena.hpp>
 #include <Ast/functionParameters.hpp>
 #include <Ast/AccessModifier.hpp>
 
@@ -11,23 +12,59 @@
 #include <Evaluator/Value/value.hpp>
 #include <Evaluator/Value/Type.hpp>
 #include <Evaluator/Context/context.hpp>
+#include <Evaluator/Context/Collector.hpp>
 
 #include <Module/CppLibrary/CppLibrary.hpp>
 
 #include <Module/builtins.hpp>
 #include <Core/fig_string.hpp>
+#include <Core/Output.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
-#include <print>
 #include <iostream>
 #include <cmath>
 #include <chrono>
 #include <numeric>
 #include <unordered_map>
+#include <cstdio>
+#include <string_view>
+
+#ifdef __linux__
+    #include <unistd.h>
+#endif
 
 namespace Fig::Builtins
 {
+    namespace
+    {
+        // UTF-8 bytes of a runtime string: ASCII strings hand out their own buffer, others are encoded into `buffer`
+        std::string_view utf8View(const ValueType::StringClass &str, std::string &buffer)
+        {
+            if (str.isAscii()) return str.asciiView();
+            buffer.clear();
+            str.appendUTF8(buffer);
+            return buffer;
+        }
+
+        // scalars and strings are written into the output buffer as they are, the rest goes through toStringIO
+        void printIO(const Value &arg)
+        {
+            Output &out = Output::stdOut();
+            if (arg.is<ValueType::StringClass>()) { out.writeString(arg.as<ValueType::StringClass>()); }
+            else if (arg.is<ValueType::IntClass>()) { out.writeInt(arg.as<ValueType::IntClass>()); }
+            else if (arg.is<ValueType::DoubleClass>()) { out.writeDouble(arg.as<ValueType::DoubleClass>()); }
+            else if (arg.is<ValueType::BoolClass>()) { out.write(arg.as<ValueType::BoolClass>() ? "true" : "false"); }
+            else if (arg.is<ValueType::NullClass>()) { out.write("null"); }
+            else
+            {
+                FString str = arg.toStringIO();
+                out.write(std::string_view(reinterpret_cast<const char *>(str.data()), str.size()));
+            }
+        }
+    }; // namespace
+
     const TypeInfo &getErrorInterfaceTypeInfo()
     {
         static const TypeInfo ErrorInterfaceTypeInfo(u8"Error", true);
@@ -53,15 +90,15 @@ namespace Fig::Builtins
              std::make_shared<Object>(InterfaceType(getErrorInterfaceTypeInfo(),
                                                     {Ast::InterfaceMethod(u8"toString",
                                                                           Ast::FunctionParameters({}, {}),
-                                                                          std::make_shared<Ast::VarExprAst>(u8"String"),
+                                                                          Ast::Arena::builtins().make<Ast::VarExprAst>(u8"String"),
                                                                           nullptr),
                                                      Ast::InterfaceMethod(u8"getErrorClass",
                                                                           Ast::FunctionParameters({}, {}),
-                                                                          std::make_shared<Ast::VarExprAst>(u8"String"),
+                                                                          Ast::Arena::builtins().make<Ast::VarExprAst>(u8"String"),
                                                                           nullptr),
                                                      Ast::InterfaceMethod(u8"getErrorMessage",
                                                                           Ast::FunctionParameters({}, {}),
-                                                                          std::make_shared<Ast::VarExprAst>(u8"String"),
+                                                                          Ast::Arena::builtins().make<Ast::VarExprAst>(u8"String"),
                                                                           nullptr)}))},
                 {u8"TypeError", std::make_shared<Object>(StructType(
                     getTypeErrorStructTypeInfo(),
@@ -84,10 +121,10 @@ namespace Fig::Builtins
 
             {u8"type", std::make_shared<Object>(Function(
                 u8"type",
-                [](const std::vector<ObjectPtr> &_args) -> ObjectPtr
+                [](const std::vector<Value> &_args) -> Value
                 {
-                    const ObjectPtr &arg = _args[0];
-                    return std::make_shared<Object>(prettyType(arg));
+                    const Value &arg = _args[0];
+                    return Value(Object(prettyType(arg)));
                 },
                 1
             ))},
@@ -99,6 +136,7 @@ namespace Fig::Builtins
         static const std::unordered_map<FString, int> builtinFunctionArgCounts = {
             {u8"__fstdout_print", -1},   // variadic
             {u8"__fstdout_println", -1}, // variadic
+            {u8"__fstdout_flush", 0},
             {u8"__fstdin_read", 0},
             {u8"__fstdin_readln", 0},
             {u8"__fvalue_type", 1},
@@ -108,6 +146,12 @@ namespace Fig::Builtins
             {u8"__fvalue_double_from", 1},
             {u8"__fvalue_string_from", 1},
             {u8"__ftime_now_ns", 0},
+            {u8"__fruntime_gc", 0},
+            {u8"__fruntime_gc_enable", 1},
+            {u8"__fruntime_gc_set_threshold", 1},
+            {u8"__fruntime_gc_set_growth", 1},
+            {u8"__fruntime_gc_contexts", 0},
+            {u8"__fruntime_rss", 0},
             /* math start */
             {u8"__fmath_acos", 1},
             {u8"__fmath_acosh", 1},
@@ -144,7 +188,12 @@ namespace Fig::Builtins
             {u8"__fstdfile_close", 1},
             {u8"__fstdfile_is_open", 1},
 
+            {u8"__fstdfile_map", 1},
+            {u8"__fstdfile_size", 1},
+
             {u8"__fstdfile_read", 1},
+            {u8"__fstdfile_read_bytes", 2},
+            {u8"__fstdfile_read_line", 1},
             {u8"__fstdfile_write", 2},
         };
         return builtinFunctionArgCounts;
@@ -154,39 +203,46 @@ namespace Fig::Builtins
     {
         static const std::unordered_map<FString, BuiltinFunction> builtinFunctions{
             {u8"__fstdout_print",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 for (auto arg : args) { std::print("{}", arg->toStringIO().toBasicString()); }
-                 return std::make_shared<Object>(ValueType::IntClass(args.size()));
+             [](const std::vector<Value> &args) -> Value {
+                 for (const Value &arg : args) { printIO(arg); }
+                 return Value::Int(ValueType::IntClass(args.size()));
              }},
             {u8"__fstdout_println",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 for (auto arg : args) { std::print("{}", arg->toStringIO().toBasicString()); }
-                 std::print("\n");
-                 return std::make_shared<Object>(ValueType::IntClass(args.size()));
+             [](const std::vector<Value> &args) -> Value {
+                 for (const Value &arg : args) { printIO(arg); }
+                 Output::stdOut().push_back('\n');
+                 return Value::Int(ValueType::IntClass(args.size()));
+             }},
+            {u8"__fstdout_flush",
+             [](const std::vector<Value> &args) -> Value {
+                 Output::stdOut().flush();
+                 return Value();
              }},
             {u8"__fstdin_read",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
+             [](const std::vector<Value> &args) -> Value {
+                 Output::stdOut().flush(); // a prompt printed before the read has to be visible
                  std::string input;
                  std::cin >> input;
-                 return std::make_shared<Object>(FString::fromBasicString(input));
+                 return Value(Object(ValueType::StringClass(input)));
              }},
             {u8"__fstdin_readln",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
+             [](const std::vector<Value> &args) -> Value {
+                 Output::stdOut().flush();
                  std::string line;
                  std::getline(std::cin, line);
-                 return std::make_shared<Object>(FString::fromBasicString(line));
+                 return Value(Object(ValueType::StringClass(line)));
              }},
             {u8"__fvalue_type",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 return std::make_shared<Object>(args[0]->getTypeInfo().toString());
+             [](const std::vector<Value> &args) -> Value {
+                 return Value(Object(args[0].getTypeInfo().toString()));
              }},
             {u8"__fvalue_int_parse",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 FString str = args[0]->as<ValueType::StringClass>();
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::StringClass &str = args[0].as<ValueType::StringClass>();
                  try
                  {
                      ValueType::IntClass val = std::stoi(str.toBasicString());
-                     return std::make_shared<Object>(val);
+                     return Value::Int(val);
                  }
                  catch (...)
                  {
@@ -194,31 +250,29 @@ namespace Fig::Builtins
                  }
              }},
             {u8"__fvalue_int_from",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 if (val->is<ValueType::DoubleClass>())
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 if (val.is<ValueType::DoubleClass>())
                  {
-                     return std::make_shared<Object>(
-                         static_cast<ValueType::IntClass>(val->as<ValueType::DoubleClass>()));
+                     return Value::Int(static_cast<ValueType::IntClass>(val.as<ValueType::DoubleClass>()));
                  }
-                 else if (val->is<ValueType::BoolClass>())
+                 else if (val.is<ValueType::BoolClass>())
                  {
-                     return std::make_shared<Object>(
-                         static_cast<ValueType::IntClass>(val->as<ValueType::BoolClass>() ? 1 : 0));
+                     return Value::Int(static_cast<ValueType::IntClass>(val.as<ValueType::BoolClass>() ? 1 : 0));
                  }
                  else
                  {
                      throw RuntimeError(FString(std::format("Type '{}' cannot be converted to int",
-                                                            val->getTypeInfo().toString().toBasicString())));
+                                                            val.getTypeInfo().toString().toBasicString())));
                  }
              }},
             {u8"__fvalue_double_parse",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 FString str = args[0]->as<ValueType::StringClass>();
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::StringClass &str = args[0].as<ValueType::StringClass>();
                  try
                  {
                      ValueType::DoubleClass val = std::stod(str.toBasicString());
-                     return std::make_shared<Object>(ValueType::DoubleClass(val));
+                     return Value::Double(ValueType::DoubleClass(val));
                  }
                  catch (...)
                  {
@@ -226,255 +280,330 @@ namespace Fig::Builtins
                  }
              }},
             {u8"__fvalue_double_from",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 if (val->is<ValueType::IntClass>())
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 if (val.is<ValueType::IntClass>())
                  {
-                     return std::make_shared<Object>(
-                         static_cast<ValueType::DoubleClass>(val->as<ValueType::IntClass>()));
+                     return Value::Double(static_cast<ValueType::DoubleClass>(val.as<ValueType::IntClass>()));
                  }
-                 else if (val->is<ValueType::BoolClass>())
+                 else if (val.is<ValueType::BoolClass>())
                  {
-                     return std::make_shared<Object>(
-                         ValueType::DoubleClass(val->as<ValueType::BoolClass>() ? 1.0 : 0.0));
+                     return Value::Double(ValueType::DoubleClass(val.as<ValueType::BoolClass>() ? 1.0 : 0.0));
                  }
                  else
                  {
                      throw RuntimeError(FString(std::format("Type '{}' cannot be converted to double",
-                                                            val->getTypeInfo().toString().toBasicString())));
+                                                            val.getTypeInfo().toString().toBasicString())));
                  }
              }},
             {u8"__fvalue_string_from",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 return std::make_shared<Object>(val->toStringIO());
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 return Value(Object(val.toStringIO()));
              }},
             {u8"__ftime_now_ns",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
+             [](const std::vector<Value> &args) -> Value {
                  // returns nanoseconds
                  using namespace Fig::Time;
                  auto now = Clock::now();
-                 return std::make_shared<Object>(static_cast<ValueType::IntClass>(
+                 return Value::Int(static_cast<ValueType::IntClass>(
                      std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_time).count()));
              }},
+            {u8"__fruntime_gc",
+             [](const std::vector<Value> &args) -> Value {
+                 // contexts found unreachable
+                 return Value::Int(static_cast<ValueType::IntClass>(Collector::getInstance().collect()));
+             }},
+            {u8"__fruntime_gc_enable",
+             [](const std::vector<Value> &args) -> Value {
+                 if (!args[0].is<ValueType::BoolClass>())
+                 {
+                     throw RuntimeError(FString(std::format("gc enable expects Bool, got '{}'",
+                                                            args[0].getTypeInfo().toString().toBasicString())));
+                 }
+                 Collector::getInstance().setEnabled(args[0].as<ValueType::BoolClass>());
+                 return Value();
+             }},
+            {u8"__fruntime_gc_set_threshold",
+             [](const std::vector<Value> &args) -> Value {
+                 if (!args[0].is<ValueType::IntClass>() || args[0].as<ValueType::IntClass>() < 0)
+                 {
+                     throw RuntimeError(FString(u8"gc threshold must be a non-negative Int"));
+                 }
+                 Collector::getInstance().setThreshold(static_cast<size_t>(args[0].as<ValueType::IntClass>()));
+                 return Value();
+             }},
+            {u8"__fruntime_gc_set_growth",
+             [](const std::vector<Value> &args) -> Value {
+                 if (!args[0].isNumeric()) { throw RuntimeError(FString(u8"gc growth must be a number")); }
+                 Collector::getInstance().setGrowth(args[0].getNumericValue()); // at least 1
+                 return Value();
+             }},
+            {u8"__fruntime_gc_contexts",
+             [](const std::vector<Value> &args) -> Value {
+                 return Value::Int(static_cast<ValueType::IntClass>(Collector::getInstance().trackedContexts()));
+             }},
+            {u8"__fruntime_rss",
+             [](const std::vector<Value> &args) -> Value {
+                 // resident set size in bytes, 0 where it can't be read
+                 ValueType::IntClass rss = 0;
+#ifdef __linux__
+                 std::ifstream statm("/proc/self/statm");
+                 ValueType::IntClass pages = 0, resident = 0;
+                 if (statm >> pages >> resident) { rss = resident * sysconf(_SC_PAGESIZE); }
+#endif
+                 return Value::Int(rss);
+             }},
 
             /* math start */
             {u8"__fmath_acos",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(acos(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(acos(d));
              }},
             {u8"__fmath_acosh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(acosh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(acosh(d));
              }},
             {u8"__fmath_asin",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(asin(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(asin(d));
              }},
             {u8"__fmath_asinh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(asinh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(asinh(d));
              }},
             {u8"__fmath_atan",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(atan(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(atan(d));
              }},
             {u8"__fmath_atan2",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ValueType::DoubleClass y = args[0]->getNumericValue();
-                 ValueType::DoubleClass x = args[1]->getNumericValue();
-                 return std::make_shared<Object>(atan2(y, x));
+             [](const std::vector<Value> &args) -> Value {
+                 ValueType::DoubleClass y = args[0].getNumericValue();
+                 ValueType::DoubleClass x = args[1].getNumericValue();
+                 return Value::Double(atan2(y, x));
              }},
             {u8"__fmath_atanh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(atanh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(atanh(d));
              }},
             {u8"__fmath_ceil",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(ceil(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(ceil(d));
              }},
             {u8"__fmath_cos",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(cos(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(cos(d));
              }},
             {u8"__fmath_cosh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(cosh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(cosh(d));
              }},
             {u8"__fmath_exp",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(exp(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(exp(d));
              }},
             {u8"__fmath_expm1",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(expm1(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(expm1(d));
              }},
             {u8"__fmath_fabs",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(fabs(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(fabs(d));
              }},
             {u8"__fmath_floor",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(floor(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(floor(d));
              }},
             {u8"__fmath_fmod",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ValueType::DoubleClass x = args[0]->getNumericValue();
-                 ValueType::DoubleClass y = args[1]->getNumericValue();
-                 return std::make_shared<Object>(fmod(x, y));
+             [](const std::vector<Value> &args) -> Value {
+                 ValueType::DoubleClass x = args[0].getNumericValue();
+                 ValueType::DoubleClass y = args[1].getNumericValue();
+                 return Value::Double(fmod(x, y));
              }},
             {u8"__fmath_frexp",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
                  int e;
-                 return std::make_shared<Object>(List({std::make_shared<Object>(frexp(d, &e)),
-                                                       std::make_shared<Object>(static_cast<ValueType::IntClass>(e))}));
+                 ValueType::DoubleClass mantissa = frexp(d, &e);
+                 return Value(Object(List({Value::Double(mantissa), Value::Int(static_cast<ValueType::IntClass>(e))})));
              }},
             {u8"__fmath_gcd",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ValueType::IntClass x = args[0]->as<ValueType::IntClass>();
-                 ValueType::IntClass y = args[1]->as<ValueType::IntClass>();
-                 return std::make_shared<Object>(std::gcd(x, y));
+             [](const std::vector<Value> &args) -> Value {
+                 ValueType::IntClass x = args[0].as<ValueType::IntClass>();
+                 ValueType::IntClass y = args[1].as<ValueType::IntClass>();
+                 return Value::Int(std::gcd(x, y));
              }},
             {u8"__fmath_hypot",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ValueType::DoubleClass x = args[0]->getNumericValue();
-                 ValueType::DoubleClass y = args[1]->getNumericValue();
-                 return std::make_shared<Object>(hypot(x, y));
+             [](const std::vector<Value> &args) -> Value {
+                 ValueType::DoubleClass x = args[0].getNumericValue();
+                 ValueType::DoubleClass y = args[1].getNumericValue();
+                 return Value::Double(hypot(x, y));
              }},
             {u8"__fmath_isequal",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ValueType::DoubleClass x = args[0]->getNumericValue();
-                 ValueType::DoubleClass y = args[1]->getNumericValue();
+             [](const std::vector<Value> &args) -> Value {
+                 ValueType::DoubleClass x = args[0].getNumericValue();
+                 ValueType::DoubleClass y = args[1].getNumericValue();
                  static const double epsilon = 1e-9;
-                 return std::make_shared<Object>(fabs(x - y) < epsilon);
+                 return Value::Bool(fabs(x - y) < epsilon);
              }},
             {u8"__fmath_log",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(log(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(log(d));
              }},
             {u8"__fmath_log10",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(log10(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(log10(d));
              }},
             {u8"__fmath_log1p",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(log1p(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(log1p(d));
              }},
             {u8"__fmath_log2",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(log2(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(log2(d));
              }},
             {u8"__fmath_sin",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(sin(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(sin(d));
              }},
             {u8"__fmath_sinh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(sinh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(sinh(d));
              }},
             {u8"__fmath_sqrt",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(sqrt(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(sqrt(d));
              }},
             {u8"__fmath_tan",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(tan(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(tan(d));
              }},
             {u8"__fmath_tanh",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(tanh(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(tanh(d));
              }},
             {u8"__fmath_trunc",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 ObjectPtr val = args[0];
-                 ValueType::DoubleClass d = val->getNumericValue();
-                 return std::make_shared<Object>(trunc(d));
+             [](const std::vector<Value> &args) -> Value {
+                 const Value &val = args[0];
+                 ValueType::DoubleClass d = val.getNumericValue();
+                 return Value::Double(trunc(d));
              }},
             /* file start */
             {u8"__fstdfile_open",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 const FString &path = args[0]->as<ValueType::StringClass>();
-                 const ValueType::IntClass &mode = args[1]->as<ValueType::IntClass>();
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::StringClass &path = args[0].as<ValueType::StringClass>();
+                 const ValueType::IntClass &mode = args[1].as<ValueType::IntClass>();
 
                  CppLibrary::File *f = CppLibrary::FileManager::getInstance().GetNextFreeFile();
                  f->fs->open(path.toBasicString(), static_cast<unsigned int>(mode));
-                 return std::make_shared<Object>(static_cast<ValueType::IntClass>(f->id));
+                 return Value::Int(static_cast<ValueType::IntClass>(f->id));
              }},
             {u8"__fstdfile_close",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 const ValueType::IntClass &id = args[0]->as<ValueType::IntClass>();
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
                  CppLibrary::FileManager::getInstance().CloseFile(id);
-                 return Object::getNullInstance();
+                 return Value();
              }},
             {u8"__fstdfile_is_open",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 const ValueType::IntClass &id = args[0]->as<ValueType::IntClass>();
-                 return std::make_shared<Object>(CppLibrary::FileManager::getInstance().GetFile(id)->fs->is_open());
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 return Value::Bool(CppLibrary::FileManager::getInstance().GetFile(id)->isOpen());
+             }},
+            {u8"__fstdfile_map",
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::StringClass &path = args[0].as<ValueType::StringClass>();
+
+                 CppLibrary::File *f = CppLibrary::FileManager::getInstance().MapFile(path.toBasicString());
+                 return Value::Int(static_cast<ValueType::IntClass>(f->id));
+             }},
+            {u8"__fstdfile_size",
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 CppLibrary::FileManager &fm = CppLibrary::FileManager::getInstance();
+                 return Value::Int(static_cast<ValueType::IntClass>(fm.Size(fm.GetFile(id))));
              }},
             {u8"__fstdfile_read",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 const ValueType::IntClass &id = args[0]->as<ValueType::IntClass>();
-                 CppLibrary::File *f = CppLibrary::FileManager::getInstance().GetFile(id);
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 CppLibrary::FileManager &fm = CppLibrary::FileManager::getInstance();
+
+                 std::string_view bytes = fm.ReadAll(fm.GetFile(id));
+                 return Value(Object(ValueType::StringClass(bytes.data(), bytes.size())));
+             }},
+            {u8"__fstdfile_read_bytes",
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 const ValueType::IntClass &n = args[1].as<ValueType::IntClass>();
+                 CppLibrary::FileManager &fm = CppLibrary::FileManager::getInstance();
+
+                 size_t count = static_cast<size_t>(std::max<ValueType::IntClass>(n, 0));
+                 std::string_view bytes = fm.ReadBytes(fm.GetFile(id), count);
+                 return Value(Object(ValueType::StringClass(bytes.data(), bytes.size())));
+             }},
+            {u8"__fstdfile_read_line",
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 CppLibrary::FileManager &fm = CppLibrary::FileManager::getInstance();
 
-                 char *buf = new char[CppLibrary::FileManager::MAX_FILE_BUF];
-                 f->fs->read(buf, CppLibrary::FileManager::MAX_FILE_BUF);
-                 return std::make_shared<Object>(ValueType::StringClass(reinterpret_cast<const char8_t *>(buf)));
+                 std::string_view line;
+                 if (!fm.ReadLine(fm.GetFile(id), line)) { return Value(); } // end of file
+                 return Value(Object(ValueType::StringClass(line.data(), line.size())));
              }},
             {u8"__fstdfile_write",
-             [](const std::vector<ObjectPtr> &args) -> ObjectPtr {
-                 const ValueType::IntClass &id = args[0]->as<ValueType::IntClass>();
-                 const ValueType::StringClass &str = args[1]->as<ValueType::StringClass>();
+             [](const std::vector<Value> &args) -> Value {
+                 const ValueType::IntClass &id = args[0].as<ValueType::IntClass>();
+                 const ValueType::StringClass &str = args[1].as<ValueType::StringClass>();
 
                  CppLibrary::File *f = CppLibrary::FileManager::getInstance().GetFile(id);
-                 const char *data = reinterpret_cast<const char *>(str.c_str());
-                 f->fs->write(data, str.size());
-                 return std::make_shared<Object>(static_cast<ValueType::IntClass>(str.length()));
+                 std::string buffer;
+                 std::string_view bytes = utf8View(str, buffer);
+                 f->fs->write(bytes.data(), bytes.size());
+                 return Value::Int(static_cast<ValueType::IntClass>(bytes.size()));
                  // bytes wrote
              }},
         };
@@ -42,7 +42,7 @@ namespace Fig
 
         const std::unordered_map<FString, ObjectPtr> &getBuiltinValues();
 
-        using BuiltinFunction = std::function<ObjectPtr(const std::vector<ObjectPtr> &)>;
+        using BuiltinFunction = std::function<Value(const std::vector<Value> &)>;
 
         const std::unordered_map<FString, int> &getBuiltinFunctionArgCounts();
 
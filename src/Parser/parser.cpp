@@ -248,7 +248,7 @@ namespace Fig
         expect(TokenType::LeftParen);
         Ast::FunctionParameters params = __parseFunctionParameters();
 
-        Ast::Expression returnType;
+        Ast::Expression returnType = nullptr;
 
         if (isThis(TokenType::RightArrow)) // ->
         {
@@ -582,7 +582,7 @@ namespace Fig
 
     Ast::Statement Parser::__parseStatement(bool allowExp)
     {
-        Ast::Statement stmt;
+        Ast::Statement stmt = nullptr;
         if (isThis(TokenType::EndOfFile)) { return makeAst<Ast::EofStmt>(); }
         else if (isThis(TokenType::Import)) { stmt = __parseImport(); }
         else if (isThis(TokenType::Public))
@@ -671,7 +671,7 @@ namespace Fig
     {
         // entry: current is `if`
         next(); // consume `if`
-        Ast::Expression condition;
+        Ast::Expression condition = nullptr;
         if (isThis(TokenType::LeftParen))
         {
             next(); // consume `(`
@@ -695,7 +695,7 @@ namespace Fig
             {
                 // else if
                 next(); // consume `if`
-                Ast::Expression elifCondition;
+                Ast::Expression elifCondition = nullptr;
                 if (isThis(TokenType::LeftParen))
                 {
                     elifCondition = parseExpression(0, TokenType::RightParen);
@@ -724,7 +724,7 @@ namespace Fig
     {
         // entry: current is `while`
         next(); // consume `while`
-        Ast::Expression condition;
+        Ast::Expression condition = nullptr;
         if (isThis(TokenType::LeftParen))
         {
             next(); // consume `(`
@@ -809,9 +809,9 @@ namespace Fig
         return makeAst<Ast::BreakSt>();
     }
 
-    Ast::VarExpr Parser::__parseVarExpr(FString name)
+    Ast::VarExpr Parser::__parseVarExpr(FString name, Symbol symbol)
     {
-        return makeAst<Ast::VarExprAst>(name);
+        return makeAst<Ast::VarExprAst>(name, symbol);
     }
 
     Ast::UnaryExpr Parser::__parsePrefix(Ast::Operator op, Precedence bp)
@@ -871,13 +871,13 @@ namespace Fig
     {
         // entry: current is `{`
         next(); // consume `{`
-        std::map<Ast::Expression, Ast::Expression> val;
+        std::vector<std::pair<Ast::Expression, Ast::Expression>> val;
         while (!isThis(TokenType::RightBrace))
         {
             Ast::Expression key = parseExpression(0, TokenType::Colon);
             expect(TokenType::Colon);
             next(); // consume `:`
-            val[key] = parseExpression(0, TokenType::RightBrace, TokenType::Comma);
+            val.emplace_back(key, parseExpression(0, TokenType::RightBrace, TokenType::Comma));
             if (isThis(TokenType::Comma))
             {
                 next(); // consume `,`
@@ -885,7 +885,7 @@ namespace Fig
         }
         expect(TokenType::RightBrace);
         next(); // consume `}`
-        return makeAst<Ast::MapExprAst>(val);
+        return makeAst<Ast::MapExprAst>(std::move(val));
     }
 
     Ast::InitExpr Parser::__parseInitExpr(Ast::Expression structe)
@@ -960,7 +960,7 @@ namespace Fig
                 std::vector<std::pair<FString, Ast::Expression>> nargs;
                 for (auto &[name, exp] : args)
                 {
-                    const Ast::VarExpr var = std::static_pointer_cast<Ast::VarExprAst>(exp);
+                    const Ast::VarExpr var = static_cast<Ast::VarExpr>(exp);
                     nargs.push_back({var->name, exp});
                 }
                 args = nargs;
@@ -1029,7 +1029,9 @@ namespace Fig
         {
             next();
             Ast::Expression bodyExpr = parseExpression(0);
-            return makeAst<Ast::FunctionLiteralExprAst>(params, bodyExpr);
+            Ast::FunctionLiteralExpr fnLiteral = makeAst<Ast::FunctionLiteralExprAst>(params, bodyExpr);
+            fnLiteral->wrapExprBody(arena);
+            return fnLiteral;
         }
         expect(TokenType::LeftBrace); // `{`
         return makeAst<Ast::FunctionLiteralExprAst>(params, __parseBlockStatement());
@@ -1090,7 +1092,7 @@ namespace Fig
 
     Ast::Expression Parser::parseExpression(Precedence bp, TokenType stop, TokenType stop2, TokenType stop3)
     {
-        Ast::Expression lhs;
+        Ast::Expression lhs = nullptr;
         Ast::Operator op;
 
         Token tok = currentToken();
@@ -1131,8 +1133,9 @@ namespace Fig
         else if (tok.isIdentifier())
         {
             FString id = tok.getValue();
+            Symbol symbol = tok.getSymbol();
             next();
-            lhs = __parseVarExpr(id);
+            lhs = __parseVarExpr(id, symbol);
         }
         else if (isTokenOp(tok) && isOpUnary((op = Ast::TokenToOp.at(tok.getType()))))
         {
@@ -1194,7 +1197,7 @@ namespace Fig
                 FString member = idTok.getValue();
                 next(); // consume identifier
 
-                lhs = makeAst<Ast::MemberExprAst>(lhs, member);
+                lhs = makeAst<Ast::MemberExprAst>(lhs, member, idTok.getSymbol());
                 continue;
             }
             // index: x[expr]
@@ -3,6 +3,7 @@
 #include <Token/token.hpp>
 #include <Ast/astBase.hpp>
 #include <Ast/ast.hpp>
+#include <Ast/AstArena.hpp>
 #include <Lexer/lexer.hpp>
 #include <Core/fig_string.hpp>
 #include <Error/error.hpp>
@@ -20,6 +21,7 @@ namespace Fig
     {
     private:
         Lexer lexer;
+        Ast::Arena &arena; // owns every node this parser makes
         std::vector<Ast::AstBase> output;
         std::vector<Token> previousTokens;
 
@@ -63,7 +65,7 @@ namespace Fig
             output.push_back(node);
         }
 
-        bool isTokenSymbol(Token tok) { return Lexer::symbol_map.contains(tok.getValue()); }
+        bool isTokenSymbol(Token tok) { return Lexer::symbolType(tok.getView()) != TokenType::Illegal; }
         bool isTokenOp(Token tok) { return Ast::TokenToOp.contains(tok.getType()); }
         bool isEOF()
         {
@@ -76,7 +78,8 @@ namespace Fig
         static const std::unordered_map<Ast::Operator, std::pair<Precedence, Precedence>> opPrecedence;
         static const std::unordered_map<Ast::Operator, Precedence> unaryOpPrecedence;
 
-        Parser(const Lexer &_lexer, FString _sourcePath, std::vector<FString> _sourceLines) : lexer(_lexer)
+        Parser(const Lexer &_lexer, FString _sourcePath, std::vector<FString> _sourceLines, Ast::Arena &_arena) :
+            lexer(_lexer), arena(_arena)
         {
             sourcePathPtr = std::make_shared<FString>(_sourcePath);
             sourceLinesPtr = std::make_shared<std::vector<FString>>(_sourceLines);
@@ -191,9 +194,9 @@ namespace Fig
         //     return std::shared_ptr<_Tp>(new _Tp(node));
         // }
         template <class _Tp, class... Args>
-        std::shared_ptr<_Tp> makeAst(Args &&...args)
+        _Tp *makeAst(Args &&...args)
         {
-            std::shared_ptr<_Tp> ptr = std::make_shared<_Tp>(std::forward<Args>(args)...);
+            _Tp *ptr = arena.make<_Tp>(std::forward<Args>(args)...);
             ptr->setAAI(currentAAI);
             return ptr;
         }
@@ -279,7 +282,7 @@ namespace Fig
         bool isNext(TokenType type) { return peekToken().getType() == type; }
         bool isThis(TokenType type) { return currentToken().getType() == type; }
 
-        static constexpr FString varDefTypeFollowed = u8"(Followed)";
+        inline static const FString varDefTypeFollowed = u8"(Followed)";
 
         Ast::VarDef __parseVarDef(bool); // entry: current is keyword `var` or `const` (isConst: Bool)
         ObjectPtr __parseValue();
@@ -294,7 +297,7 @@ namespace Fig
         Ast::Break __parseBreak();                           // entry: current is Token::Break
         Ast::Continue __parseContinue();                     // entry: current is Token::Continue
 
-        Ast::VarExpr __parseVarExpr(FString);
+        Ast::VarExpr __parseVarExpr(FString, Symbol);
         Ast::FunctionDef __parseFunctionDef(bool); // entry: current is Token::Identifier (isPublic: Bool)
         Ast::StructDef __parseStructDef(bool); // entry: current is Token::Identifier (struct name) arg(isPublic: bool)
         Ast::InterfaceDef
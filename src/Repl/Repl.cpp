@@ -1,9 +1,12 @@
 #include <Evaluator/Value/Type.hpp>
 #include <Ast/astBase.hpp>
+#include <Ast/AstArena.hpp>
 #include <Error/error.hpp>
 #include <Error/errorLog.hpp>
 #include <Core/fig_string.hpp>
 #include <Repl/Repl.hpp>
+#include <Module/ModuleRegistry.hpp>
+#include <memory>
 #include <vector>
 
 namespace Fig
@@ -15,7 +18,14 @@ namespace Fig
         const FString &sourcePath = u8"<stdin>";
         const std::vector<FString> &sourceLines{};
 
+        // one tree per line, all kept: functions defined on earlier lines still point into theirs
+        std::vector<std::unique_ptr<Ast::Arena>> lineTrees;
+
         Evaluator evaluator;
+        Resolver resolver(true); // global is shared between lines
+
+        // modules may be edited between lines, `import` always runs them again
+        ModuleRegistry::getInstance().setReevaluate(true);
 
         evaluator.CreateGlobalContext();
         evaluator.RegisterBuiltinsValue();
@@ -29,20 +39,22 @@ namespace Fig
             if (line == u8"!exit") { break; }
 
             Lexer lexer(line, sourcePath, sourceLines);
-            Parser parser(lexer, sourcePath, sourceLines);
+            Parser parser(lexer, sourcePath, sourceLines, *lineTrees.emplace_back(std::make_unique<Ast::Arena>()));
 
             std::vector<AstBase> program;
             try
             {
                 program = parser.parseAll();
+                resolver.resolve(program);
 
                 StatementResult sr = evaluator.Run(program);
-                ObjectPtr result = sr.result;
-                if (result->is<ValueType::NullClass>())
+                Output::stdOut().flush(); // the line's own prints go before its result
+                const Value &result = sr.result;
+                if (result.is<ValueType::NullClass>())
                 {
                     continue;
                 }
-                ostream << result->toString().toBasicString() << '\n';
+                ostream << result.toString().toBasicString() << '\n';
             }
             catch (AddressableError &e)
             {
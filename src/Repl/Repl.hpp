@@ -1,8 +1,10 @@
 #pragma once
 
 #include <Core/core.hpp>
+#include <Core/Output.hpp>
 #include <Lexer/lexer.hpp>
 #include <Parser/parser.hpp>
+#include <Resolver/resolver.hpp>
 #include <Evaluator/evaluator.hpp>
 #include <Utils/AstPrinter.hpp>
 #include <Utils/utils.hpp>
@@ -30,6 +32,7 @@ namespace Fig
 
         FString readline() const
         {
+            Output::stdOut().flush();
             std::string buf;
             std::getline(istream, buf);
 
@@ -0,0 +1,367 @@
+#include <Resolver/resolver.hpp>
+
+namespace Fig
+{
+    void Resolver::pushScope(bool isBoundary)
+    {
+        Scope scope;
+        scope.isBoundary = isBoundary;
+        scopes.push_back(std::move(scope));
+    }
+
+    void Resolver::popScope()
+    {
+        scopes.pop_back();
+    }
+
+    int Resolver::declare(const FString &name)
+    {
+        Scope &scope = current();
+        if (scope.isOpen)
+        {
+            scope.names[name] = -1;
+            return -1;
+        }
+        auto it = scope.names.find(name);
+        if (it != scope.names.end()) { return it->second; } // if/else branches may define the same name
+        int slot = scope.slotCount++;
+        scope.names[name] = slot;
+        return slot;
+    }
+
+    void Resolver::declareDynamic(const FString &name)
+    {
+        current().names[name] = -1;
+    }
+
+    void Resolver::hoist(const std::vector<Ast::Statement> &stmts)
+    {
+        // pre-declare every name a scope will ever define, so forward references (function calling
+        // a function defined later) are resolvable. an unfilled slot falls back to hash lookup at runtime,
+        // so use-before-define still behaves like before
+        using enum Ast::AstType;
+        for (const auto &stmt : stmts)
+        {
+            switch (stmt->getType())
+            {
+                case VarDefSt: declare(static_cast<Ast::VarDefAst *>(stmt)->name); break;
+                case FunctionDefSt: declare(static_cast<Ast::FunctionDefSt *>(stmt)->name); break;
+                case StructSt: declare(static_cast<Ast::StructDefSt *>(stmt)->name); break;
+                case InterfaceDefSt: declare(static_cast<Ast::InterfaceDefAst *>(stmt)->name); break;
+                case ImportSt: {
+                    auto i = static_cast<Ast::ImportSt *>(stmt);
+                    if (i->path.back() == u8"_builtins") { break; } // defined into global, by name
+                    if (!i->names.empty())
+                    {
+                        for (const FString &name : i->names) { declareDynamic(name); }
+                    }
+                    else
+                    {
+                        declareDynamic(i->rename.empty() ? i->path.back() : i->rename);
+                    }
+                    break;
+                }
+                case IfSt: {
+                    // if bodies are evaluated in the same context
+                    auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                    hoist(ifSt->body->stmts);
+                    for (const auto &elif : ifSt->elifs) { hoist(elif->body->stmts); }
+                    if (ifSt->els) { hoist(ifSt->els->body->stmts); }
+                    break;
+                }
+                case TrySt: {
+                    // so does finally block
+                    auto tryst = static_cast<Ast::TrySt *>(stmt);
+                    if (tryst->finallyBlock) { hoist(tryst->finallyBlock->stmts); }
+                    break;
+                }
+                default: break;
+            }
+        }
+    }
+
+    void Resolver::resolveVar(const Ast::VarExpr &var)
+    {
+        int depth = 0;
+        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it, ++depth)
+        {
+            const Scope &scope = *it;
+            if (scope.isOpen) { return; }
+
+            auto nit = scope.names.find(var->name);
+            if (nit != scope.names.end())
+            {
+                if (nit->second >= 0)
+                {
+                    var->depth = depth;
+                    var->slot = nit->second;
+                }
+                return;
+            }
+            if (scope.isBoundary) { return; }
+        }
+        // not found: builtins or undeclared, leave it to runtime
+    }
+
+    void Resolver::resolveFunction(const Ast::FunctionParameters &paras,
+                                   const std::vector<Ast::Statement> &body,
+                                   bool isBoundary)
+    {
+        pushScope(isBoundary);
+
+        // same order as Evaluator::evalFunctionCall defines them
+        if (paras.variadic) { declare(paras.variadicPara); }
+        else
+        {
+            for (const auto &[name, _] : paras.posParas) { declare(name); }
+            for (const auto &[name, _] : paras.defParas) { declare(name); }
+        }
+
+        resolveStatements(body);
+        popScope();
+    }
+
+    void Resolver::resolveStatements(const std::vector<Ast::Statement> &stmts)
+    {
+        hoist(stmts);
+        for (const auto &stmt : stmts) { resolveStatement(stmt); }
+    }
+
+    void Resolver::resolveStatement(const Ast::Statement &stmt)
+    {
+        if (!stmt) return;
+
+        using enum Ast::AstType;
+        switch (stmt->getType())
+        {
+            case VarDefSt: {
+                auto varDef = static_cast<Ast::VarDefAst *>(stmt);
+                resolveExpression(varDef->declaredType);
+                resolveExpression(varDef->expr);
+                varDef->slot = declare(varDef->name);
+                break;
+            }
+            case FunctionDefSt: {
+                auto fnDef = static_cast<Ast::FunctionDefSt *>(stmt);
+                fnDef->slot = declare(fnDef->name);
+
+                // parameter types, default values and return type are evaluated in the defining context
+                for (const auto &[_, typeExp] : fnDef->paras.posParas) { resolveExpression(typeExp); }
+                for (const auto &[_, p] : fnDef->paras.defParas)
+                {
+                    resolveExpression(p.first);
+                    resolveExpression(p.second);
+                }
+                resolveExpression(fnDef->retType);
+
+                resolveFunction(fnDef->paras, fnDef->body->stmts);
+                break;
+            }
+            case StructSt: {
+                auto stDef = static_cast<Ast::StructDefSt *>(stmt);
+                stDef->slot = declare(stDef->name);
+
+                for (const auto &field : stDef->fields) { resolveExpression(field.declaredType); }
+                // field default values run in the struct definition context, methods run with
+                // struct instance context as closure. only their own frames are resolvable
+                for (const auto &st : stDef->body->stmts)
+                {
+                    if (st->getType() != FunctionDefSt) continue;
+                    auto method = static_cast<Ast::FunctionDefSt *>(st);
+                    resolveFunction(method->paras, method->body->stmts, true);
+                }
+                break;
+            }
+            case InterfaceDefSt: {
+                auto ifd = static_cast<Ast::InterfaceDefAst *>(stmt);
+                ifd->slot = declare(ifd->name);
+
+                for (const auto &exp : ifd->bundles) { resolveExpression(exp); }
+                for (const auto &method : ifd->methods)
+                {
+                    if (method.hasDefaultBody()) { resolveFunction(method.paras, method.defaultBody->stmts, true); }
+                }
+                break;
+            }
+            case ImplementSt: {
+                auto ip = static_cast<Ast::ImplementAst *>(stmt);
+                for (const auto &method : ip->methods) { resolveFunction(method.paras, method.body->stmts, true); }
+                break;
+            }
+
+            case IfSt: {
+                auto ifSt = static_cast<Ast::IfSt *>(stmt);
+                resolveExpression(ifSt->condition);
+                for (const auto &st : ifSt->body->stmts) { resolveStatement(st); }
+                for (const auto &elif : ifSt->elifs)
+                {
+                    resolveExpression(elif->condition);
+                    for (const auto &st : elif->body->stmts) { resolveStatement(st); }
+                }
+                if (ifSt->els)
+                {
+                    for (const auto &st : ifSt->els->body->stmts) { resolveStatement(st); }
+                }
+                break;
+            }
+            case WhileSt: {
+                auto whileSt = static_cast<Ast::WhileSt *>(stmt);
+                resolveExpression(whileSt->condition);
+
+                pushScope(); // every loop has its own context
+                resolveStatements(whileSt->body->stmts);
+                popScope();
+                break;
+            }
+            case ForSt: {
+                auto forSt = static_cast<Ast::ForSt *>(stmt);
+
+                pushScope(); // loop context: init, condition, increment
+                if (forSt->initSt) { resolveStatements({forSt->initSt}); }
+                resolveExpression(forSt->condition);
+                resolveStatement(forSt->incrementSt);
+
+                pushScope(); // iteration context
+                resolveStatements(forSt->body->stmts);
+                popScope();
+
+                popScope();
+                break;
+            }
+            case TrySt: {
+                auto tryst = static_cast<Ast::TrySt *>(stmt);
+
+                pushScope();
+                resolveStatements(tryst->body->stmts);
+                popScope();
+
+                for (const auto &cat : tryst->catches)
+                {
+                    pushScope();
+                    declareDynamic(cat.errVarName);
+                    resolveStatements(cat.body->stmts);
+                    popScope();
+                }
+                if (tryst->finallyBlock)
+                {
+                    for (const auto &st : tryst->finallyBlock->stmts) { resolveStatement(st); }
+                }
+                break;
+            }
+            case BlockStatement: {
+                auto block = static_cast<Ast::BlockStatementAst *>(stmt);
+                pushScope();
+                resolveStatements(block->stmts);
+                popScope();
+                break;
+            }
+
+            case ThrowSt: resolveExpression(static_cast<Ast::ThrowSt *>(stmt)->value); break;
+            case ReturnSt: resolveExpression(static_cast<Ast::ReturnSt *>(stmt)->retValue); break;
+            case ExpressionStmt: resolveExpression(static_cast<Ast::ExpressionStmtAst *>(stmt)->exp); break;
+
+            default: break; // import, break, continue...
+        }
+    }
+
+    void Resolver::resolveExpression(const Ast::Expression &exp)
+    {
+        if (!exp) return;
+
+        using enum Ast::AstType;
+        switch (exp->getType())
+        {
+            case VarExpr: resolveVar(static_cast<Ast::VarExprAst *>(exp)); break;
+            case UnaryExpr: resolveExpression(static_cast<Ast::UnaryExprAst *>(exp)->exp); break;
+            case BinaryExpr: {
+                auto bin = static_cast<Ast::BinaryExprAst *>(exp);
+                resolveExpression(bin->lexp);
+                resolveExpression(bin->rexp);
+                break;
+            }
+            case TernaryExpr: {
+                auto te = static_cast<Ast::TernaryExprAst *>(exp);
+                resolveExpression(te->condition);
+                resolveExpression(te->valueT);
+                resolveExpression(te->valueF);
+                break;
+            }
+            case MemberExpr: resolveExpression(static_cast<Ast::MemberExprAst *>(exp)->base); break;
+            case IndexExpr: {
+                auto ie = static_cast<Ast::IndexExprAst *>(exp);
+                resolveExpression(ie->base);
+                resolveExpression(ie->index);
+                break;
+            }
+            case FunctionCall: {
+                auto call = static_cast<Ast::FunctionCallExpr *>(exp);
+                resolveExpression(call->callee);
+                for (const auto &arg : call->arg.argv) { resolveExpression(arg); }
+                break;
+            }
+            case FunctionLiteralExpr: {
+                auto fnLiteral = static_cast<Ast::FunctionLiteralExprAst *>(exp);
+                for (const auto &[_, typeExp] : fnLiteral->paras.posParas) { resolveExpression(typeExp); }
+                for (const auto &[_, p] : fnLiteral->paras.defParas)
+                {
+                    resolveExpression(p.first);
+                    resolveExpression(p.second);
+                }
+                if (fnLiteral->isExprMode())
+                {
+                    pushScope();
+                    if (fnLiteral->paras.variadic) { declare(fnLiteral->paras.variadicPara); }
+                    else
+                    {
+                        for (const auto &[name, _] : fnLiteral->paras.posParas) { declare(name); }
+                        for (const auto &[name, _] : fnLiteral->paras.defParas) { declare(name); }
+                    }
+                    resolveExpression(fnLiteral->getExprBody());
+                    popScope();
+                }
+                else
+                {
+                    resolveFunction(fnLiteral->paras, fnLiteral->getBlockBody()->stmts);
+                }
+                break;
+            }
+            case InitExpr: {
+                auto initExpr = static_cast<Ast::InitExprAst *>(exp);
+                resolveExpression(initExpr->structe);
+                for (const auto &[_, argExp] : initExpr->args) { resolveExpression(argExp); }
+                break;
+            }
+            case ListExpr: {
+                for (const auto &e : static_cast<Ast::ListExprAst *>(exp)->val) { resolveExpression(e); }
+                break;
+            }
+            case TupleExpr: {
+                for (const auto &e : static_cast<Ast::TupleExprAst *>(exp)->val) { resolveExpression(e); }
+                break;
+            }
+            case MapExpr: {
+                for (const auto &[k, v] : static_cast<Ast::MapExprAst *>(exp)->val)
+                {
+                    resolveExpression(k);
+                    resolveExpression(v);
+                }
+                break;
+            }
+            default: break; // ValueExpr
+        }
+    }
+
+    void Resolver::resolve(const std::vector<Ast::AstBase> &asts)
+    {
+        scopes.clear();
+        pushScope();
+        current().isOpen = openGlobal;
+
+        std::vector<Ast::Statement> stmts;
+        stmts.reserve(asts.size());
+        for (const auto &ast : asts) { stmts.push_back(static_cast<Ast::StatementAst *>(ast)); }
+
+        resolveStatements(stmts);
+        popScope();
+    }
+}; // namespace Fig
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Ast/ast.hpp>
+#include <Core/fig_string.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Fig
+{
+    /*
+        Resolver
+        runs between Parser::parseAll() and Evaluator::Run()
+
+        annotate every VarExprAst with (depth, slot):
+            depth -> how many Context::parent hops from the using scope
+            slot  -> index in Context::slots
+
+        scopes here must mirror the Contexts that Evaluator creates at runtime,
+        anything we can't prove statically is left unresolved (slot = -1),
+        Evaluator falls back to hash lookup for them (module members, struct instance fields, builtins...)
+    */
+    class Resolver
+    {
+    private:
+        struct Scope
+        {
+            std::unordered_map<FString, int> names; // name -> slot, -1: defined at runtime without slot
+            int slotCount = 0;
+
+            bool isOpen = false;     // layout unknown (REPL global), never resolve into it
+            bool isBoundary = false; // runtime parent is not the lexical one (methods), stop here
+        };
+
+        std::vector<Scope> scopes;
+        bool openGlobal;
+
+        Scope &current() { return scopes.back(); }
+
+        void pushScope(bool isBoundary = false);
+        void popScope();
+
+        int declare(const FString &name);
+        void declareDynamic(const FString &name);
+
+        void hoist(const std::vector<Ast::Statement> &stmts);
+        void resolveVar(const Ast::VarExpr &var);
+
+        void resolveFunction(const Ast::FunctionParameters &paras,
+                             const std::vector<Ast::Statement> &body,
+                             bool isBoundary = false);
+        void resolveStatements(const std::vector<Ast::Statement> &stmts);
+        void resolveStatement(const Ast::Statement &stmt);
+        void resolveExpression(const Ast::Expression &exp);
+
+    public:
+        // openGlobal: global scope is shared between several resolve() calls (REPL)
+        Resolver(bool _openGlobal = false) : openGlobal(_openGlobal) {}
+
+        void resolve(const std::vector<Ast::AstBase> &asts);
+    };
+}; // namespace Fig
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <format>
 #include <Utils/magic_enum/magic_enum.hpp>
 
 #include <Core/fig_string.hpp>
+#include <Core/Symbol.hpp>
 
 namespace Fig
 {
@@ -116,21 +118,28 @@ namespace Fig
         TripleDot, // ... for variadic parameter
     };
 
+    /*
+        a token does not own its text: value views the lexer's source (or a decoded string literal kept by the
+        lexer), so tokens are valid as long as the Lexer that produced them
+    */
     class Token final
     {
         friend bool operator==(const Token &l, const Token &r);
 
     private:
-        FString value;
+        FStringView value;
         TokenType type;
+        Symbol symbol; // Identifier: interned by the lexer
 
     public:
         size_t line, column;
 
         inline Token() {};
-        inline Token(const FString &_value, TokenType _type) :
+        inline Token(FStringView _value, TokenType _type) :
             value(_value), type(_type) {}
-        inline Token(const FString &_value, TokenType _type, size_t _line, size_t _column) :
+        inline Token(FStringView _value, Symbol _symbol) :
+            value(_value), type(TokenType::Identifier), symbol(_symbol) {}
+        inline Token(FStringView _value, TokenType _type, size_t _line, size_t _column) :
             value(_value), type(_type)
         {
             line = _line;
@@ -142,19 +151,29 @@ namespace Fig
             column = _column;
             return *this;
         }
-        size_t getLength()
+        size_t getLength() const
         {
-            return value.length();
+            // code points
+            return std::count_if(value.begin(), value.end(), [](char8_t c) { return (c & 0xC0) != 0x80; });
         }
-        const FString& getValue() const
+        // copies the text, use getView() when a view is enough
+        FString getValue() const
+        {
+            return FString(value);
+        }
+        FStringView getView() const
         {
             return value;
         }
+        Symbol getSymbol() const
+        {
+            return symbol;
+        }
         inline FString toString() const
         {
             return FString(std::format(
                 "Token('{}',{})",
-                this->value.toBasicString(),
+                this->value.toBasicStringView(),
                 magic_enum::enum_name(type)));
         }
 
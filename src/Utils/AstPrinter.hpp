@@ -16,34 +16,34 @@ public:
         switch (node->getType())
         {
             case AstType::BinaryExpr:
-                printBinaryExpr(std::static_pointer_cast<BinaryExprAst>(node), indent);
+                printBinaryExpr(static_cast<BinaryExprAst *>(node), indent);
                 break;
             case AstType::UnaryExpr:
-                printUnaryExpr(std::static_pointer_cast<UnaryExprAst>(node), indent);
+                printUnaryExpr(static_cast<UnaryExprAst *>(node), indent);
                 break;
             case AstType::ValueExpr:
-                printValueExpr(std::static_pointer_cast<ValueExprAst>(node), indent);
+                printValueExpr(static_cast<ValueExprAst *>(node), indent);
                 break;
             case AstType::VarDefSt:
-                printVarDef(std::static_pointer_cast<VarDefAst>(node), indent);
+                printVarDef(static_cast<VarDefAst *>(node), indent);
                 break;
             case AstType::VarExpr:
-                printVarExpr(std::static_pointer_cast<VarExprAst>(node), indent);
+                printVarExpr(static_cast<VarExprAst *>(node), indent);
                 break;
             case AstType::BlockStatement:
-                printBlockStatement(std::static_pointer_cast<BlockStatementAst>(node), indent);
+                printBlockStatement(static_cast<BlockStatementAst *>(node), indent);
                 break;
             case AstType::FunctionCall:
-                printFunctionCall(std::static_pointer_cast<FunctionCallExpr>(node), indent);
+                printFunctionCall(static_cast<FunctionCallExpr *>(node), indent);
                 break;
             case AstType::FunctionDefSt:
-                printFunctionSt(std::static_pointer_cast<FunctionDefSt>(node), indent);
+                printFunctionSt(static_cast<FunctionDefSt *>(node), indent);
                 break;
             case AstType::IfSt:
-                printIfSt(std::static_pointer_cast<IfSt>(node), indent);
+                printIfSt(static_cast<IfSt *>(node), indent);
                 break;
             case AstType::TernaryExpr:
-                printTernaryExpr(std::static_pointer_cast<TernaryExprAst>(node), indent);
+                printTernaryExpr(static_cast<TernaryExprAst *>(node), indent);
                 break;
             default:
                 printIndent(indent);
@@ -72,7 +72,7 @@ private:
         std::cout << "Enum: " << magic_enum::enum_name(value) << "\n";
     }
 
-    void printBinaryExpr(const std::shared_ptr<BinaryExprAst> &node, int indent)
+    void printBinaryExpr(BinaryExprAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "BinaryExpr\n";
@@ -85,7 +85,7 @@ private:
         print(node->rexp, indent + 4);
     }
 
-    void printUnaryExpr(const std::shared_ptr<UnaryExprAst> &node, int indent)
+    void printUnaryExpr(UnaryExprAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "UnaryExpr\n";
@@ -95,14 +95,14 @@ private:
         print(node->exp, indent + 4);
     }
 
-    void printValueExpr(const std::shared_ptr<ValueExprAst> &node, int indent)
+    void printValueExpr(ValueExprAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "ValueExpr\n";
         printFString(node->val->toString(), indent + 2);
     }
 
-    void printVarDef(const std::shared_ptr<VarDefAst> &node, int indent)
+    void printVarDef(VarDefAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "VarDef\n";
@@ -120,7 +120,7 @@ private:
         }
     }
 
-    void printVarExpr(const std::shared_ptr<VarExprAst> &node, int indent)
+    void printVarExpr(VarExprAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "VarExpr\n";
@@ -129,7 +129,7 @@ private:
         printFString(node->name, 0);
     }
 
-    void printBlockStatement(const std::shared_ptr<BlockStatementAst> &node, int indent)
+    void printBlockStatement(BlockStatementAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "BlockStatement\n";
@@ -139,7 +139,7 @@ private:
         }
     }
 
-    void printFunctionCall(const std::shared_ptr<FunctionCallExpr> &node, int indent)
+    void printFunctionCall(FunctionCallExpr *node, int indent)
     {
         printIndent(indent);
         std::cout << "FunctionCall\n";
@@ -147,7 +147,7 @@ private:
         printIndent(indent + 2);
     }
 
-    void printFunctionSt(const std::shared_ptr<FunctionDefSt> &node, int indent)
+    void printFunctionSt(FunctionDefSt *node, int indent)
     {
         printIndent(indent);
         std::cout << "FunctionSt\n";
@@ -160,7 +160,7 @@ private:
         print(node->body, indent + 4);
     }
 
-    void printIfSt(const std::shared_ptr<IfSt> &node, int indent)
+    void printIfSt(IfSt *node, int indent)
     {
         printIndent(indent);
         std::cout << "IfSt\n";
@@ -170,7 +170,7 @@ private:
         printIndent(indent + 2);
     }
 
-    void printTernaryExpr(const std::shared_ptr<TernaryExprAst> &node, int indent)
+    void printTernaryExpr(TernaryExprAst *node, int indent)
     {
         printIndent(indent);
         std::cout << "TernaryExpr\n";
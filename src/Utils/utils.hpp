@@ -11,28 +11,17 @@
 namespace Fig::Utils
 {
 
-    inline std::vector<FString> splitSource(FString source)
+    inline std::vector<FString> splitSource(const FString &source)
     {
-        UTF8Iterator it(source);
+        // '\n' never occurs inside a multi-byte sequence, splitting bytes is enough
         std::vector<FString> lines;
-        FString currentLine;
-        while (!it.isEnd())
+        size_t start = 0;
+        while (start < source.size())
         {
-            UTF8Char c = *it;
-            if (c == U'\n')
-            {
-                lines.push_back(currentLine);
-                currentLine = FString(u8"");
-            }
-            else
-            {
-                currentLine += c.getString();
-            }
-            ++it;
-        }
-        if (!currentLine.empty())
-        {
-            lines.push_back(currentLine);
+            size_t end = source.find(u8'\n', start);
+            if (end == FString::npos) { end = source.size(); }
+            lines.emplace_back(std::u8string(source.data() + start, end - start));
+            start = end + 1;
         }
         return lines;
     }
@@ -0,0 +1,394 @@
+// VirtualMachine interpreter loop body
+// no #pragma once: included once per dispatch mode by VirtualMachine.cpp, inside a member function,
+// with VM_THREADED defined as 0 (switch) or 1 (labels-as-values)
+
+#if VM_THREADED
+    #define VM_TARGET(op) op_##op:
+    #define VM_NEXT()                                                                                                  \
+        do                                                                                                             \
+        {                                                                                                              \
+            if (ip >= codeEnd) goto vm_end;                                                                            \
+            ins = ip++;                                                                                                \
+            goto *dispatchTable[static_cast<u8>(ins->code)];                                                           \
+        } while (0)
+#else
+    #define VM_TARGET(op) case OpCode::op:
+    #define VM_NEXT() continue
+#endif
+
+// current frame cache, reloaded after CALL / RETURN
+#define VM_LOAD_FRAME()                                                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        code = currentFrame->fn->chunk.ins.data();                                                                     \
+        codeEnd = code + currentFrame->fn->chunk.ins.size();                                                           \
+        ip = code + currentFrame->ip;                                                                                  \
+        constants = currentFrame->fn->chunk.constants.data();                                                          \
+        slots = stack.data() + currentFrame->base;                                                                     \
+    } while (0)
+
+{
+    const Instruction *code;
+    const Instruction *codeEnd;
+    const Instruction *ip;
+    const Object *constants;
+    Object *slots;
+    Object *top = stack.data() + sp; // one past the top value
+
+    const Instruction *ins = nullptr;
+
+    // CALL / CALL_CONST / CALL_GLOBAL -> vm_call
+    const Object *callee;
+    Object *args;
+    uint64_t argCount;
+
+    VM_LOAD_FRAME();
+
+#if VM_THREADED
+    // same order as OpCode
+    static void *dispatchTable[] = {
+        &&op_HALT,        &&op_RETURN,      &&op_LOAD_LOCAL, &&op_LOAD_CONST, &&op_LOAD_GLOBAL, &&op_STORE_LOCAL,
+        &&op_STORE_GLOBAL, &&op_POP,        &&op_DUP,        &&op_LT,         &&op_LTET,        &&op_GT,
+        &&op_GTET,        &&op_EQ,          &&op_NEQ,        &&op_ADD,        &&op_SUB,         &&op_MUL,
+        &&op_DIV,         &&op_MOD,         &&op_NOT,        &&op_NEG,        &&op_JUMP,        &&op_JUMP_IF_FALSE,
+        &&op_CALL,        &&op_CALL_CONST,  &&op_CALL_GLOBAL,
+    };
+    static_assert(sizeof(dispatchTable) / sizeof(void *) == static_cast<size_t>(getLastOpCode()) + 1,
+                  "dispatchTable out of sync with OpCode");
+
+    VM_NEXT();
+#else
+    for (;;)
+    {
+        if (ip >= codeEnd) goto vm_end;
+        ins = ip++;
+
+        switch (ins->code)
+        {
+#endif
+
+            VM_TARGET(HALT)
+            {
+                sp = top - stack.data();
+                return *Object::getNullInstance();
+            }
+            VM_TARGET(RETURN)
+            {
+                Object ret = std::move(*(top - 1));
+
+                uint64_t base = currentFrame->base;
+                popFrame();
+
+                if (frames.empty())
+                {
+                    sp = base;
+                    return ret;
+                }
+
+                top = stack.data() + base; // 清除函数的临时值
+                *top++ = std::move(ret);
+
+                VM_LOAD_FRAME();
+                VM_NEXT();
+            }
+            VM_TARGET(LOAD_LOCAL)
+            {
+                // LOCAL编号都为正数
+                *top++ = slots[ins->operand];
+                VM_NEXT();
+            }
+            VM_TARGET(LOAD_CONST)
+            {
+                // CONST编号都为正数
+                *top++ = constants[ins->operand];
+                VM_NEXT();
+            }
+            VM_TARGET(LOAD_GLOBAL)
+            {
+                *top++ = globals[ins->operand];
+                VM_NEXT();
+            }
+            VM_TARGET(STORE_LOCAL)
+            {
+                slots[ins->operand] = std::move(*--top);
+                VM_NEXT();
+            }
+            VM_TARGET(STORE_GLOBAL)
+            {
+                globals[ins->operand] = std::move(*--top);
+                VM_NEXT();
+            }
+            VM_TARGET(POP)
+            {
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(DUP)
+            {
+                *top = *(top - 1);
+                ++top;
+                VM_NEXT();
+            }
+
+            // binary operators: lhs = top[-2], rhs = top[-1], result written over lhs
+            VM_TARGET(LT)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs < *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(LTET)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs <= *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(GT)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs > *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(GTET)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs >= *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(EQ)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs == *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(NEQ)
+            {
+                Object &lhs = *(top - 2);
+                lhs = Object(lhs != *(top - 1));
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(ADD)
+            {
+                Object &lhs = *(top - 2);
+                const Object &rhs = *(top - 1);
+
+                if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>())
+                {
+                    lhs.as<ValueType::IntClass>() += rhs.as<ValueType::IntClass>();
+                }
+                else
+                {
+                    lhs = lhs + rhs;
+                }
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(SUB)
+            {
+                Object &lhs = *(top - 2);
+                const Object &rhs = *(top - 1);
+
+                if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>())
+                {
+                    lhs.as<ValueType::IntClass>() -= rhs.as<ValueType::IntClass>();
+                }
+                else
+                {
+                    lhs = lhs - rhs;
+                }
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(MUL)
+            {
+                Object &lhs = *(top - 2);
+                const Object &rhs = *(top - 1);
+
+                if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>())
+                {
+                    lhs.as<ValueType::IntClass>() *= rhs.as<ValueType::IntClass>();
+                }
+                else
+                {
+                    lhs = lhs * rhs;
+                }
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(DIV)
+            {
+                Object &lhs = *(top - 2);
+                const Object &rhs = *(top - 1);
+
+                // by zero: operator/ raises the error
+                if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>()
+                    && rhs.as<ValueType::IntClass>() != 0)
+                {
+                    ValueType::DoubleClass result =
+                        (double)lhs.as<ValueType::IntClass>() / (double)rhs.as<ValueType::IntClass>();
+                    lhs = Object(result);
+                }
+                else
+                {
+                    lhs = lhs / rhs;
+                }
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(MOD)
+            {
+                Object &lhs = *(top - 2);
+                const Object &rhs = *(top - 1);
+
+                if (lhs.is<ValueType::IntClass>() && rhs.is<ValueType::IntClass>())
+                {
+                    // same as Evaluator: floor modulo, the result has the sign of rv
+                    ValueType::IntClass lv = lhs.as<ValueType::IntClass>();
+                    ValueType::IntClass rv = rhs.as<ValueType::IntClass>();
+                    if (rv == 0) { throw ValueError(FString(std::format("Modulo by zero: {} % {}", lv, rv))); }
+                    ValueType::IntClass r = lv % rv;
+                    if (r != 0 && ((r < 0) != (rv < 0))) { r += rv; }
+                    lhs.as<ValueType::IntClass>() = r;
+                }
+                else
+                {
+                    lhs = lhs % rhs;
+                }
+                --top;
+                VM_NEXT();
+            }
+            VM_TARGET(NOT)
+            {
+                Object &v = *(top - 1);
+                v = !v;
+                VM_NEXT();
+            }
+            VM_TARGET(NEG)
+            {
+                Object &v = *(top - 1);
+                if (v.is<ValueType::IntClass>()) { v.as<ValueType::IntClass>() = -v.as<ValueType::IntClass>(); }
+                else
+                {
+                    v = -v;
+                }
+                VM_NEXT();
+            }
+            VM_TARGET(JUMP)
+            {
+                ip += ins->operand;
+                VM_NEXT();
+            }
+            VM_TARGET(JUMP_IF_FALSE)
+            {
+                const Object &cond = *--top;
+
+                if (!cond.is<bool>()) { throw RuntimeError(FString(u8"Condition must be boolean!")); }
+                if (!cond.as<bool>())
+                {
+                    // cond is falsity
+                    ip += ins->operand;
+                }
+                VM_NEXT();
+            }
+            VM_TARGET(CALL)
+            {
+                argCount = static_cast<uint64_t>(ins->operand);
+                assert(static_cast<uint64_t>(top - stack.data()) > argCount && "stack does not have enough arguments");
+                callee = top - 1;
+                args = top - 1 - argCount;
+                goto vm_call;
+            }
+            VM_TARGET(CALL_CONST)
+            {
+                argCount = callArgCount(ins->operand);
+                callee = &constants[callIndex(ins->operand)]; // in place, no Function copy
+                args = top - argCount;
+                goto vm_call;
+            }
+            VM_TARGET(CALL_GLOBAL)
+            {
+                argCount = callArgCount(ins->operand);
+                callee = &globals[callIndex(ins->operand)];
+                args = top - argCount;
+                goto vm_call;
+            }
+            vm_call:
+            {
+                if (!callee->is<Function>())
+                {
+                    throw RuntimeError(FString(std::format("{} is not callable", callee->toString().toBasicString())));
+                }
+
+                const Function &fn_obj = callee->as<Function>();
+                uint64_t base = args - stack.data();
+
+                if (fn_obj.type == Function::Builtin)
+                {
+                    // builtins take Value arguments, only non-scalar arguments are boxed
+                    if (fn_obj.builtinParamCount != -1 && fn_obj.builtinParamCount != argCount)
+                    {
+                        throw RuntimeError(
+                            FString(std::format("Builtin function '{}' expects {} arguments, but {} were provided",
+                                                fn_obj.name.toBasicString(),
+                                                fn_obj.builtinParamCount,
+                                                argCount)));
+                    }
+                    std::vector<Value> argv;
+                    argv.reserve(argCount);
+                    for (uint64_t i = 0; i < argCount; ++i) { argv.emplace_back(args[i]); }
+                    Object ret = *fn_obj.builtin(argv).toObject();
+
+                    top = args; // pop arguments and function
+                    *top++ = std::move(ret);
+                    VM_NEXT();
+                }
+                if (fn_obj.type != Function::Compiled)
+                {
+                    throw RuntimeError(FString(
+                        std::format("Function '{}' is not compiled, VM cannot call it", fn_obj.name.toBasicString())));
+                }
+
+                // not owned: the Function came from a constant pool, which outlives every frame of it
+                const CompiledFunction *fn = fn_obj.compiled.get();
+                if (fn->posArgCount != argCount)
+                {
+                    throw RuntimeError(FString(std::format("Function '{}' expects {} arguments, but {} were provided",
+                                                           fn->name.toBasicString(),
+                                                           fn->posArgCount,
+                                                           argCount)));
+                }
+                assert(fn->slotCount >= argCount && "slotCount < argCount");
+                checkFrameFits(base, *fn);
+
+                top = args + argCount; // pop function (CALL), 参数已经在栈上, base为第一个参数
+                for (Object *localsEnd = args + fn->slotCount; top < localsEnd; ++top)
+                {
+                    *top = Object(); // locals
+                }
+
+                currentFrame->ip = ip - code; // save caller
+                addFrame(CallFrame{0, base, fn});
+
+                VM_LOAD_FRAME();
+                VM_NEXT();
+            }
+
+#if !VM_THREADED
+        }
+    }
+#endif
+
+vm_end:
+    sp = top - stack.data();
+    return *Object::getNullInstance();
+}
+
+#undef VM_TARGET
+#undef VM_NEXT
+#undef VM_LOAD_FRAME
@@ -5,71 +5,108 @@
 
 #include <vector>
 
+// labels-as-values dispatch (GNU extension, clang / gcc), switch otherwise
+#ifndef FIG_VM_COMPUTED_GOTO
+    #if defined(__GNUC__) || defined(__clang__)
+        #define FIG_VM_COMPUTED_GOTO 1
+    #else
+        #define FIG_VM_COMPUTED_GOTO 0
+    #endif
+#endif
+
 namespace Fig
 {
     class VirtualMachine
     {
     private:
-        std::vector<CallFrame> frames;
+        static constexpr uint64_t STACK_SIZE = 65536; // values, preallocated
+        static constexpr uint64_t MAX_FRAMES = 4096;  // frames, preallocated
+
+        std::vector<CallFrame> frames; // capacity fixed, never reallocates
         CallFrame *currentFrame;
 
-        std::vector<Object> stack;
-        Object *stack_top;
+        std::vector<Object> stack; // [0, sp) alive
+        uint64_t sp = 0;
+
+        std::vector<Object> globals; // top level names, slots assigned by Compiler
 
     public:
         void Clean()
         {
             frames.clear();
-            stack.clear();
+            globals.clear();
 
             currentFrame = nullptr;
-            stack_top = nullptr;
+            sp = 0;
         }
 
         void addFrame(const CallFrame &_frame)
         {
+            if (frames.size() >= MAX_FRAMES)
+            {
+                throw RuntimeError(FString(std::format("Call stack overflow ({} frames)", MAX_FRAMES)));
+            }
             frames.push_back(_frame);
             currentFrame = &frames.back();
         }
 
-        CallFrame popFrame()
+        void popFrame()
         {
             assert((!frames.empty()) && "frames is empty!");
 
-            CallFrame back = *currentFrame;
             frames.pop_back();
             currentFrame = (frames.empty() ? nullptr : &frames.back());
-
-            return back;
         }
 
         void push(const Object &_object)
         {
-            stack.push_back(_object);
-            stack_top = &stack.back();
+            assert(sp < STACK_SIZE && "stack overflow");
+            stack[sp++] = _object;
         }
 
-        void nextIns(CallFrame &frame) const
+        Object &top()
         {
-            frame.ip += 1;
+            assert(sp > 0 && "stack is empty!");
+            return stack[sp - 1];
         }
 
-        Object pop()
+        void drop(uint64_t n = 1)
         {
-            assert((!stack.empty()) && "stack is empty!");
+            assert(sp >= n && "stack is empty!");
+            sp -= n;
+        }
 
-            Object back = *stack_top;
-            stack.pop_back();
-            stack_top = (stack.empty() ? nullptr : &stack.back());
+        void setGlobalCount(uint64_t count)
+        {
+            globals.resize(count);
+        }
 
-            return back;
+        // a frame at `base` has its slots and its deepest operand stack below STACK_SIZE, or this throws:
+        // the dispatch loop pushes without checking
+        static void checkFrameFits(uint64_t base, const CompiledFunction &fn)
+        {
+            if (base + fn.slotCount + fn.maxStack > STACK_SIZE)
+            {
+                throw RuntimeError(FString(std::format("Stack overflow calling '{}'", fn.name.toBasicString())));
+            }
         }
 
-        VirtualMachine(const CallFrame &_frame) 
+        VirtualMachine(const CallFrame &_frame) : stack(STACK_SIZE)
         {
+            checkFrameFits(_frame.base, *_frame.fn);
+            frames.reserve(MAX_FRAMES);
             addFrame(_frame);
+            for (uint64_t i = 0; i < _frame.fn->slotCount; ++i)
+            {
+                push(*Object::getNullInstance()); // entry frame locals
+            }
         }
 
-        Object Execute();
+        Object Execute(); // threaded when available
+
+        Object ExecuteSwitch(); // portable fallback
+#if FIG_VM_COMPUTED_GOTO
+        Object ExecuteThreaded();
+#endif
     };
-};
\ No newline at end of file
+};
@@ -29,12 +29,18 @@ This software is licensed under the MIT License. See LICENSE.txt for details.
 
 #include <Utils/argparse/argparse.hpp>
 // #include <print>
+#include <algorithm>
 #include <fstream>
 
 #include <Core/core.hpp>
+#include <Core/Output.hpp>
+#include <Ast/AstCache.hpp>
 #include <Lexer/lexer.hpp>
 #include <Parser/parser.hpp>
+#include <Resolver/resolver.hpp>
 #include <Evaluator/evaluator.hpp>
+#include <Compiler/Compiler.hpp>
+#include <VirtualMachine/VirtualMachine.hpp>
 #include <Utils/AstPrinter.hpp>
 #include <Utils/utils.hpp>
 #include <Error/errorLog.hpp>
@@ -59,6 +65,21 @@ int main(int argc, char **argv)
         .help("start repl")
         .default_value(false)
         .implicit_value(true);
+    program.add_argument("--vm")
+        .help("compile to bytecode and run on the virtual machine")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--profile")
+        .help("sample the script, write folded stacks and print a per-function time table at exit")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--profile-out")
+        .help("folded stacks file for --profile, <source>.folded by default")
+        .default_value(std::string(""));
+    program.add_argument("--profile-interval")
+        .help("--profile sampling interval in microseconds of CPU time")
+        .default_value(static_cast<int>(Fig::Profiler::DefaultIntervalUs))
+        .scan<'i', int>();
     // program.add_argument("-v", "--version")
     //     .help("get the version of Fig Interpreter")
     //     .default_value(false)
@@ -99,25 +120,22 @@ int main(int argc, char **argv)
         std::cerr << "Could not open file: " << sourcePath.toBasicString() << '\n';
         return 1;
     }
-    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     file.close();
 
-    std::vector<FString> sourceLines = Fig::Utils::splitSource(Fig::FString(source));
-
-    Fig::Lexer lexer((Fig::FString(source)), sourcePath, sourceLines);
-
-    // Token tok;
-    // while ((tok = lexer.nextToken()).getType() != TokenType::EndOfFile)
-    // {
-    //     std::println("{}", tok.toString().toBasicString());
-    // }
-
-    Fig::Parser parser(lexer, sourcePath, sourceLines);
+    std::unique_ptr<Fig::Ast::Arena> astArena; // owns `asts`, outlives the evaluator below
+    std::vector<FString> sourceLines;
     std::vector<Fig::Ast::AstBase> asts;
 
     try
     {
-        asts = parser.parseAll();
+        // parsed tree comes from <source>c (.figc) when it is fresh
+        Fig::AstCache::Unit unit = Fig::AstCache::loadOrParse(sourcePath.toBasicString(), sourcePath);
+        astArena = std::move(unit.arena);
+        sourceLines = std::move(unit.sourceLines);
+        asts = std::move(unit.asts);
+
+        Fig::Resolver resolver;
+        resolver.resolve(asts);
     }
     catch (const Fig::AddressableError &e)
     {
@@ -137,6 +155,37 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    if (program.get<bool>("--vm"))
+    {
+        try
+        {
+            Fig::Compiler compiler(sourcePath, sourceLines);
+            auto entry = compiler.compile(asts);
+
+            Fig::VirtualMachine vm(Fig::CallFrame{0, 0, entry.get()});
+            vm.setGlobalCount(compiler.getGlobalCount());
+            vm.Execute();
+        }
+        catch (const Fig::AddressableError &e)
+        {
+            addressableErrorCount++;
+            ErrorLog::logAddressableError(e);
+            return 1;
+        }
+        catch (const Fig::UnaddressableError &e)
+        {
+            unaddressableErrorCount++;
+            ErrorLog::logUnaddressableError(e);
+            return 1;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "uncaught exception of: " << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
     // AstPrinter printer;
     // std::print("<Debug> AST:\n");
     // for (const auto &node : ast)
@@ -144,6 +193,18 @@ int main(int argc, char **argv)
     //     printer.print(node);
     // }
 
+    if (program.get<bool>("--profile"))
+    {
+        std::string profileOut = program.get<std::string>("--profile-out");
+        if (profileOut.empty()) { profileOut = sourcePath.toBasicString() + ".folded"; }
+        int interval = program.get<int>("--profile-interval");
+        // before the evaluator: it takes the active profiler when constructed
+        if (!Fig::Profiler::getInstance().start(profileOut, static_cast<unsigned>(std::max(interval, 1))))
+        {
+            std::cerr << "--profile is not supported on this platform, running without it\n";
+        }
+    }
+
     Fig::Evaluator evaluator;
 
     evaluator.SetSourcePath(sourcePath);
@@ -171,6 +232,7 @@ int main(int argc, char **argv)
     }
     catch (const std::exception &e)
     {
+        Fig::Output::stdOut().flush();
         std::cerr << "uncaught exception of: " << e.what() << '\n';
         evaluator.printStackTrace();
         return 1;
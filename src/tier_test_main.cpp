@@ -0,0 +1,276 @@
+#include <Ast/AstArena.hpp>
+#include <Ast/AstCache.hpp>
+#include <Compiler/Compiler.hpp>
+#include <Core/Output.hpp>
+#include <Evaluator/evaluator.hpp>
+#include <IR/IRInterpreter.hpp>
+#include <IR/IR.hpp>
+#include <IR/Lowering.hpp>
+#include <IR/Passes.hpp>
+#include <Lexer/lexer.hpp>
+#include <Parser/parser.hpp>
+#include <Resolver/resolver.hpp>
+#include <Utils/utils.hpp>
+#include <VirtualMachine/VirtualMachine.hpp>
+
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace Fig;
+
+/*
+    the same expression on every tier: tree walker (Evaluator), bytecode (Compiler + VirtualMachine) and
+    register IR (Lowering + IR::VirtualMachine, plain and optimized). each result must have the same type
+    and value, or every tier must fail
+
+    then whole scripts (arguments, ExampleCodes/SpeedTest/fib.fig by default, run from the repository root
+    with Library next to the binary like Fig): `--vm` has to print exactly what the tree walker prints
+*/
+
+static const char *prelude = R"(
+func mod(a, b) { return a % b; }
+func div(a, b) { return a / b; }
+func deadDiv(a, b) { var unused := a / b; return 1; }
+func deadZero() { var unused := 1 / 0; return 1; }
+func deadAdd() { var unused := true + 1; return 1; }
+func deadSum() { var unused := 2 * 3 + 0.5; return 1; }
+)";
+
+struct Unit
+{
+    FString sourcePath{u8"<tier_test>"};
+    std::vector<FString> sourceLines;
+    Ast::Arena arena;
+    std::vector<Ast::AstBase> asts;
+
+    explicit Unit(const std::string &source)
+    {
+        FString text(source);
+        sourceLines = Utils::splitSource(text);
+        Lexer lexer(text, sourcePath, sourceLines);
+        Parser parser(lexer, sourcePath, sourceLines, arena);
+        asts = parser.parseAll();
+
+        Resolver resolver;
+        resolver.resolve(asts);
+    }
+};
+
+// nullopt: the tier raised an error
+using Result = std::optional<Object>;
+
+static Result onEvaluator(Unit &unit)
+{
+    try
+    {
+        Evaluator evaluator;
+        evaluator.SetSourcePath(unit.sourcePath);
+        evaluator.SetSourceLines(unit.sourceLines);
+        evaluator.CreateGlobalContext();
+        evaluator.RegisterBuiltinsValue();
+        return *evaluator.Run(unit.asts).result.toObject();
+    }
+    catch (const std::exception &) { return std::nullopt; }
+}
+
+static Result onVM(Unit &unit)
+{
+    try
+    {
+        Compiler compiler(unit.sourcePath, unit.sourceLines);
+        auto entry = compiler.compile(unit.asts);
+
+        VirtualMachine vm(CallFrame{0, 0, entry.get()});
+        vm.setGlobalCount(compiler.getGlobalCount());
+        return vm.Execute();
+    }
+    catch (const std::exception &) { return std::nullopt; }
+}
+
+static Result onIR(Unit &unit, bool optimize)
+{
+    try
+    {
+        IR::Lowering lowering(unit.sourcePath, unit.sourceLines);
+        IR::Module module = lowering.lower(unit.asts);
+        if (optimize) { IR::optimize(module); }
+
+        IR::VirtualMachine vm;
+        vm.load(module);
+        IR::Value v = vm.execute(module.get(u8"entry"), nullptr, 0);
+        switch (v.kind)
+        {
+            case IR::Value::Kind::Int: return Object(static_cast<ValueType::IntClass>(v.i));
+            case IR::Value::Kind::Double: return Object(static_cast<ValueType::DoubleClass>(v.d));
+            case IR::Value::Kind::Bool: return Object(v.b);
+            default: return Object();
+        }
+    }
+    catch (const std::exception &) { return std::nullopt; }
+}
+
+// a script file on the tree walker or, `vm`, on the VM
+static bool runScript(const std::string &path, bool vm)
+{
+    try
+    {
+        FString sourcePath(path);
+        AstCache::Unit unit = AstCache::loadOrParse(path, sourcePath);
+        Resolver resolver;
+        resolver.resolve(unit.asts);
+
+        if (vm)
+        {
+            Compiler compiler(sourcePath, unit.sourceLines);
+            auto entry = compiler.compile(unit.asts);
+
+            VirtualMachine machine(CallFrame{0, 0, entry.get()});
+            machine.setGlobalCount(compiler.getGlobalCount());
+            machine.Execute();
+            return true;
+        }
+        Evaluator evaluator;
+        evaluator.SetSourcePath(sourcePath);
+        evaluator.SetSourceLines(unit.sourceLines);
+        evaluator.CreateGlobalContext();
+        evaluator.RegisterBuiltinsValue();
+        evaluator.Run(unit.asts);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << (vm ? "vm: " : "evaluator: ") << e.what() << "\n";
+        return false;
+    }
+}
+
+// what `run` prints through Output, nullopt if it fails
+template <class Run>
+static std::optional<std::string> captureStdout(Run run)
+{
+    Output::stdOut().flush();
+    std::FILE *capture = std::tmpfile();
+    int saved = dup(fileno(stdout));
+    dup2(fileno(capture), fileno(stdout));
+
+    bool ok = run();
+
+    Output::stdOut().flush();
+    dup2(saved, fileno(stdout));
+    close(saved);
+
+    std::string text;
+    std::rewind(capture);
+    char buffer[4096];
+    for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), capture)) != 0;) { text.append(buffer, n); }
+    std::fclose(capture);
+
+    if (!ok) return std::nullopt;
+    return text;
+}
+
+static std::string show(const Result &r)
+{
+    return (r ? std::format("{} ({})", r->toString().toBasicString(), r->getTypeInfo().toString().toBasicString())
+              : std::string("<error>"));
+}
+
+static bool same(const Result &l, const Result &r)
+{
+    if (!l || !r) return !l && !r;
+    return l->data.index() == r->data.index() && *l == *r;
+}
+
+int main(int argc, char **argv)
+{
+    // floor modulo: the result has the sign of the divisor. Int / Int is a Double
+    struct Case
+    {
+        const char *expression;
+        const char *expected; // as show() prints it
+    };
+    std::vector<Case> cases{
+        {"mod(7, 3)", "1 (Int)"},
+        {"mod(-7, 3)", "2 (Int)"},
+        {"mod(7, -3)", "-2 (Int)"},
+        {"mod(-7, -3)", "-1 (Int)"},
+        {"mod(6, -3)", "0 (Int)"},
+        {"mod(-1, 5)", "4 (Int)"},
+        {"mod(7.5, 2)", "1.5 (Double)"},
+        {"mod(-7.5, 2)", "-1.5 (Double)"},
+        {"mod(-7, 2.5)", "-2 (Double)"},
+        {"mod(5, 0)", "<error>"},
+        {"div(7, 2)", "3.5 (Double)"},
+        {"div(-7, 2)", "-3.5 (Double)"},
+        {"div(7, -2)", "-3.5 (Double)"},
+        {"div(-7, -2)", "3.5 (Double)"},
+        {"div(6, 3)", "2 (Double)"},
+        {"div(5, 0)", "<error>"},
+        {"(-7) % 3", "2 (Int)"},
+        {"7 % (-3)", "-2 (Int)"},
+        {"-7 % 3", "-1 (Int)"}, // unary minus binds looser than %
+        {"(-7) % 3 + (-7) / 2", "-1.5 (Double)"},
+        // an unused result that raises still raises under -O
+        {"deadDiv(1, 0)", "<error>"},
+        {"deadDiv(1, 2)", "1 (Int)"},
+        {"deadZero()", "<error>"},
+        {"deadAdd()", "<error>"},
+        {"deadSum()", "1 (Int)"},
+    };
+
+    int failed = 0;
+    for (const auto &[expression, expected] : cases)
+    {
+        Unit unit(std::format("{}\nfunc entry() {{ return {}; }}\nreturn entry();\n", prelude, expression));
+
+        Result evaluated = onEvaluator(unit);
+        std::vector<std::pair<const char *, Result>> others{
+            {"vm", onVM(unit)},
+            {"ir", onIR(unit, false)},
+            {"ir -O", onIR(unit, true)},
+        };
+
+        bool ok = (show(evaluated) == expected);
+        for (const auto &[tier, result] : others) { ok = ok && same(evaluated, result); }
+        if (!ok) ++failed;
+
+        std::cout << (ok ? "  ok   " : "  FAIL ") << expression << " -> evaluator " << show(evaluated);
+        if (show(evaluated) != expected) std::cout << " expected " << expected;
+        for (const auto &[tier, result] : others)
+        {
+            if (!same(evaluated, result)) std::cout << ", " << tier << " " << show(result);
+        }
+        std::cout << "\n";
+    }
+
+    std::vector<std::string> scripts(argv + 1, argv + argc);
+    if (scripts.empty()) { scripts.push_back("ExampleCodes/SpeedTest/fib.fig"); }
+    for (const std::string &script : scripts)
+    {
+        std::optional<std::string> evaluated = captureStdout([&]() { return runScript(script, false); });
+        std::optional<std::string> compiled = captureStdout([&]() { return runScript(script, true); });
+
+        bool ok = (evaluated && compiled && *evaluated == *compiled);
+        if (!ok) ++failed;
+
+        std::cout << (ok ? "  ok   " : "  FAIL ") << script << " --vm";
+        if (ok) { std::cout << ", " << evaluated->size() << " bytes of output\n"; }
+        else
+        {
+            std::cout << "\n  evaluator: " << (evaluated ? *evaluated : std::string("<error>\n"))
+                      << "  vm: " << (compiled ? *compiled : std::string("<error>\n"));
+        }
+    }
+
+    return (failed == 0 ? 0 : 1);
+}
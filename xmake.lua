@@ -30,10 +30,12 @@ add_files("src/Core/runtimeTime.cpp")
 
 add_files("src/Lexer/lexer.cpp")
 add_files("src/Parser/parser.cpp")
+add_files("src/Resolver/resolver.cpp")
 
 add_files("src/Module/builtins.cpp")
 
 add_files("src/Evaluator/Value/value.cpp")
+add_files("src/Evaluator/Context/Collector.cpp")
 add_includedirs("src")
 
 add_defines("__FCORE_COMPILE_TIME=\"" .. os.date("%Y-%m-%d %H:%M:%S") .. "\"")
@@ -42,6 +44,8 @@ target("Fig")
     set_kind("binary")
 
     add_files("src/Evaluator/Core/*.cpp")
+    add_files("src/Ast/AstCache.cpp")
+    add_files("src/Compiler/Compiler.cpp")
     add_files("src/VirtualMachine/VirtualMachine.cpp")
     add_files("src/Evaluator/evaluator.cpp")
     add_files("src/Repl/Repl.cpp")
@@ -57,17 +61,75 @@ target("vm_test_main")
     
     set_warnings("all")
 
+target("vm_bench")
+    set_kind("binary")
+
+    add_files("src/VirtualMachine/VirtualMachine.cpp")
+    add_files("src/Bytecode/vm_bench_main.cpp")
+    
+    set_warnings("all")
+
 target("ir_test_main")
     set_kind("binary")
 
+    add_files("src/IR/Lowering.cpp")
+    add_files("src/IR/Passes.cpp")
     add_files("src/IR/ir_test_main.cpp")
     
     set_warnings("all")
 
+target("tier_test_main")
+    set_kind("binary")
+
+    add_files("src/Evaluator/Core/*.cpp")
+    add_files("src/Ast/AstCache.cpp")
+    add_files("src/Compiler/Compiler.cpp")
+    add_files("src/VirtualMachine/VirtualMachine.cpp")
+    add_files("src/Evaluator/evaluator.cpp")
+    add_files("src/IR/Lowering.cpp")
+    add_files("src/IR/Passes.cpp")
+    add_files("src/tier_test_main.cpp")
+
+    set_warnings("all")
+
 target("StringTest")
     set_kind("binary")
     
     add_files("src/Core/StringTest.cpp")
 
     set_warnings("all")
-    
\ No newline at end of file
+    
+target("StringBench")
+    set_kind("binary")
+    
+    add_files("src/Core/StringBench.cpp")
+
+    set_warnings("all")
+
+target("LexerBench")
+    set_kind("binary")
+    
+    add_files("src/Lexer/LexerBench.cpp")
+
+    set_warnings("all")
+
+target("FileBench")
+    set_kind("binary")
+
+    add_files("src/Module/CppLibrary/File/FileBench.cpp")
+
+    set_warnings("all")
+
+target("BinaryOpsBench")
+    set_kind("binary")
+
+    add_files("src/Evaluator/BinaryOpsBench.cpp")
+
+    set_warnings("all")
+
+target("MapBench")
+    set_kind("binary")
+
+    add_files("src/Evaluator/Value/MapBench.cpp")
+
+    set_warnings("all")